@@ -16,11 +16,20 @@
 #include "entities/car.h"
 #include "entities/human.h"
 #include "gameplay.h"
+#include "ghost.h"
 #include "input.h"
 #include "obj_map.h"
+#include "particles.h"
 #include "path_util.h"
 #include "physics.h"
+#include "physics_debug.h"
+#include "racers.h"
+#include "render/lighting.h"
 #include "render/pipeline.h"
+#include "replay.h"
+#include "sim_scheduler.h"
+#include "static_sdf.h"
+#include "terrain.h"
 #include "triggers.h"
 #include "ui.h"
 
@@ -29,6 +38,7 @@ static SDL_GLContext g_gl = NULL;
 static int g_w = APP_DEFAULT_WIDTH, g_h = APP_DEFAULT_HEIGHT;
 
 static AmeCamera g_cam;
+static AmeCamera g_cam2;  // split-screen: follows the entity the player is not controlling
 static atomic_bool g_should_quit = false;
 
 // Audio
@@ -42,31 +52,51 @@ static uint64_t g_music_id = 1, g_car_rear_audio_id = 2, g_ball_audio_id = 3,
 // Simple ball for spatial audio demo
 static b2Body* g_ball_body = NULL;
 static AmeLocalMesh g_map_mesh = {0};
-
-static SDL_Thread* g_logic_thread = NULL;
-static atomic_bool g_logic_running = false;
-static const float kFixedDt = APP_FIXED_DT;  // from config
+static int g_headlight = -1;
+// GAME_REPLAY: no window, GL, audio or input devices; the sim runs as fast as it can
+static bool g_headless = false;
+// g_mode belongs to the sim thread; the main thread reads this copy, published every tick
+static atomic_int g_shown_mode = CONTROL_CAR;
+// Fixed tick: APP_FIXED_DT unless GAME_TICK_HZ says otherwise
+static float g_tick_dt = APP_FIXED_DT;
+// Time trial: the best run so far, raced from every start and restart
+static Ghost* g_ghost = NULL;
+static char g_ghost_path[1024];
 
 // #define MAP_OBJ_NAME "test dimensions.obj"
 #define MAP_OBJ_NAME APP_MAP_OBJ_NAME
 
+// Width of the player's view (the left half of the window in split-screen)
+static int view_width(int window_w) {
+    return APP_SPLIT_SCREEN ? window_w / 2 : window_w;
+}
+
 static void set_viewport(int w, int h) {
-    glViewport(0, 0, w, h);
-    ame_camera_set_viewport(&g_cam, w, h);
+    if (g_gl)
+        glViewport(0, 0, w, h);
+    ame_camera_set_viewport(&g_cam, view_width(w), h);
+    ame_camera_set_viewport(&g_cam2, w - view_width(w), h);
 }
 
-static int init_gl(void) {
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
-    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
-    SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 0);
-    g_window =
-        SDL_CreateWindow(APP_WINDOW_TITLE, g_w, g_h, SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+// The window for `backend`; GL also gets its context here, Vulkan builds its swapchain in
+// pipeline_init_backend
+static int init_window(PipelineBackend backend) {
+    bool gl = backend == PIPELINE_BACKEND_GL;
+    if (gl) {
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+        SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+        SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 0);
+    }
+    SDL_WindowFlags api = gl ? SDL_WINDOW_OPENGL : SDL_WINDOW_VULKAN;
+    g_window = SDL_CreateWindow(APP_WINDOW_TITLE, g_w, g_h, api | SDL_WINDOW_RESIZABLE);
     if (!g_window) {
         SDL_Log("window: %s", SDL_GetError());
         return 0;
     }
+    if (!gl)
+        return 1;
     g_gl = SDL_GL_CreateContext(g_window);
     if (!g_gl) {
         SDL_Log("gl ctx: %s", SDL_GetError());
@@ -82,15 +112,10 @@ static int init_gl(void) {
     glDepthMask(GL_FALSE);
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    // Init UI subsystem (fonts)
-    ui_init();
-
-    set_viewport(g_w, g_h);
     return 1;
 }
 
-static void shutdown_gl(void) {
+static void shutdown_window(void) {
     if (g_gl) {
         SDL_GL_DestroyContext(g_gl);
         g_gl = NULL;
@@ -101,35 +126,12 @@ static void shutdown_gl(void) {
     }
 }
 
-static int logic_thread_main(void* ud) {
+// Fixed-tick stages, run by the sim scheduler in APP_SIM_STAGE_ORDER
+static void stage_input(float dt, void* ud) {
+    (void)dt;
     (void)ud;
-    uint64_t last = SDL_GetTicksNS();
-    double acc = 0.0;
-    atomic_store(&g_logic_running, true);
-    while (!atomic_load(&g_should_quit)) {
-        uint64_t t = SDL_GetTicksNS();
-        double frame = (double)(t - last) / 1e9;
-        last = t;
-        if (frame > 0.05)
-            frame = 0.05;
-        acc += frame;
-        int steps = 0;
-        while (acc >= kFixedDt && steps < 8) {
-            input_update();
-            if (g_mode == CONTROL_CAR) {
-                car_fixed(&g_car, kFixedDt);
-            } else {
-                human_fixed(&g_human, kFixedDt);
-            }
-            // Gameplay fixed-step (weapons, timers)
-            gameplay_fixed(&g_human, &g_car, kFixedDt);
-            acc -= kFixedDt;
-            steps++;
-        }
-        SDL_DelayNS(200000);  // ~0.2 ms
-    }
-    atomic_store(&g_logic_running, false);
-    return 0;
+    input_update();
+    replay_tick_input();
 }
 
 static void update_switch_logic(void) {
@@ -159,6 +161,106 @@ static void update_switch_logic(void) {
     }
 }
 
+// Everything that acts on input or mutates the player runs here, on the tick, so a recorded run
+// replays the same way
+static void stage_control(float dt, void* ud) {
+    (void)ud;
+    update_switch_logic();
+    atomic_store(&g_shown_mode, g_mode);
+    if (input_restart_edge()) {
+        gameplay_restart(&g_human, &g_car);
+        ghost_record_begin();
+    }
+    if (g_mode == CONTROL_CAR) {
+        car_fixed(&g_car, dt);
+    } else {
+        human_fixed(&g_human, dt);
+    }
+    // Keep human near car when driving to allow quick switch back
+    if (g_mode == CONTROL_CAR) {
+        float cx, cy;
+        car_get_position(&g_car, &cx, &cy);
+        human_set_position(&g_human, cx, cy);
+        car_update(&g_car, dt);
+    } else {
+        human_update(&g_human, dt);
+    }
+}
+
+static void stage_racers(float dt, void* ud) {
+    (void)ud;
+    float fx, fy;
+    if (g_mode == CONTROL_CAR)
+        car_get_position(&g_car, &fx, &fy);
+    else
+        human_get_position(&g_human, &fx, &fy);
+    racers_fixed(dt, fx, fy);
+}
+
+static void stage_gameplay(float dt, void* ud) {
+    (void)ud;
+    // Triggers spawn projectiles and flip gameplay state, so they run on the tick too
+    float hx, hy, cx, cy;
+    human_get_position(&g_human, &hx, &hy);
+    car_get_position(&g_car, &cx, &cy);
+    triggers_update(hx, hy, g_human.w, g_human.h, cx, cy, g_car.cfg.body_w, g_car.cfg.body_h);
+    // Gameplay fixed-step (weapons, timers)
+    gameplay_fixed(&g_human, &g_car, dt);
+}
+
+// Rebuilt terrain chunks are swapped in right before the step that first sees them
+static void stage_terrain(float dt, void* ud) {
+    (void)dt;
+    (void)ud;
+    terrain_apply();
+}
+
+static void stage_physics(float dt, void* ud) {
+    (void)ud;
+    physics_step(dt);
+}
+
+// Sampled after the step, from the snapshot the step just published
+static void stage_ghost(float dt, void* ud) {
+    (void)ud;
+    ghost_record_tick(&g_car, dt);
+}
+
+// Record or check the state checksum of the finished tick
+static void stage_replay(float dt, void* ud) {
+    (void)dt;
+    (void)ud;
+    uint64_t h = gameplay_state_hash(REPLAY_HASH_SEED ^ (uint64_t)g_mode, &g_human, &g_car);
+    replay_tick_end(physics_state_hash(h));
+}
+
+// Sim overload transitions: cheaper physics under the reduce-quality policy, and the world lock
+// wait so far to tell lock contention apart from plain step cost
+static void sim_on_overload(const SimOverloadEvent* ev, void* ud) {
+    (void)ud;
+    if (ev->policy == SIM_OVERLOAD_REDUCE_QUALITY) {
+        if (ev->overloaded)
+            physics_set_iterations(APP_PHYS_OVERLOAD_VELOCITY_ITERATIONS,
+                                   APP_PHYS_OVERLOAD_POSITION_ITERATIONS);
+        else
+            physics_set_iterations(APP_PHYS_VELOCITY_ITERATIONS, APP_PHYS_POSITION_ITERATIONS);
+    }
+    PhysicsLockStats ls;
+    physics_get_lock_stats(&ls);
+    SDL_Log("sim overload %s: world lock waits %.2f ms read, %.2f ms write since start",
+            ev->overloaded ? "entered" : "cleared", ls.read_wait_ns / 1.0e6,
+            ls.write_wait_ns / 1.0e6);
+}
+
+// Sim idle check: the world has settled and no movement input is held
+static bool sim_is_quiet(void* ud) {
+    (void)ud;
+    if (input_move_dir() || input_accel_dir() || input_yaw_dir() || input_jump_down() ||
+        input_boost_down())
+        return false;
+    return physics_world_at_rest();
+}
+
 static void on_trigger_unlock(const char* name, void* user) {
     (void)user;
     if (!name)
@@ -175,27 +277,7 @@ static void on_trigger_unlock(const char* name, void* user) {
     }
 }
 
-int game_app_init(void) {
-    if (!SDL_Init(SDL_INIT_VIDEO))
-        return 0;
-    if (!init_gl())
-        return 0;
-    ame_camera_init(&g_cam);
-    g_cam.zoom = APP_DEFAULT_ZOOM;
-    ame_camera_set_viewport(&g_cam, g_w, g_h);
-    if (!input_init())
-        return 0;
-    if (!physics_init())
-        return 0;  // physics thread (1000Hz)
-    // Cache base path once for all asset lookups
-    pathutil_init();
-    if (!pipeline_init())
-        return 0;
-    if (!ame_audio_init(48000))
-        return 0;
-    if (!gameplay_init())
-        return 0;
-
+static void init_audio_and_dialogue(void) {
     // Init dialogue manager and optionally start an introduction scene
     dialogue_manager_init();
 
@@ -218,8 +300,6 @@ int game_app_init(void) {
     // Ball rolling tone (spatial by pan)
     ame_audio_source_init_sigmoid(&g_ball_audio, 220.0f, 6.0f, 0.12f);
     g_ball_audio.pan = 0.0f;
-    abilities_init();
-    triggers_init();
 
     // Register dialogue-driven triggers (manual fire via dialogue_trigger_hook)
     Aabb dummy = {0, 0, 0, 0};
@@ -229,9 +309,125 @@ int game_app_init(void) {
 
     // Optionally auto-start a default scene if available
     dialogue_start_scene("introduction");
+}
+
+// Load the best run and start recording this one
+static void start_time_trial(void) {
+    SDL_snprintf(g_ghost_path, sizeof(g_ghost_path), "%s" APP_GHOST_FILE, pathutil_base());
+    if (!ghost_recorder_init())
+        return;
+    g_ghost = ghost_load(g_ghost_path);
+    if (g_ghost)
+        SDL_Log("ghost: best run %.2f s", ghost_duration(g_ghost));
+    ghost_record_begin();
+}
+
+// Finish line: a run faster than the ghost (or the first one) becomes the new ghost
+static void finish_time_trial(void) {
+    size_t size = 0;
+    float duration = 0.0f;
+    uint8_t* stream = ghost_record_take(&size, &duration);
+    if (!stream)
+        return;
+    SDL_Log("ghost: run %.2f s, %zu bytes", duration, size);
+    if (!g_ghost || duration < ghost_duration(g_ghost)) {
+        if (!SDL_SaveFile(g_ghost_path, stream, size))
+            SDL_Log("ghost: cannot save %s: %s", g_ghost_path, SDL_GetError());
+        Ghost* best = ghost_decode(stream, size);
+        if (best) {
+            ghost_free(g_ghost);
+            g_ghost = best;
+        }
+    }
+    SDL_free(stream);
+}
+
+static void init_tick_rate(void) {
+    const char* hz_env = SDL_getenv("GAME_TICK_HZ");
+    if (hz_env && hz_env[0]) {
+        int hz = SDL_atoi(hz_env);
+        if (hz >= APP_TICK_HZ_MIN && hz <= APP_TICK_HZ_MAX)
+            g_tick_dt = 1.0f / (float)hz;
+        else
+            SDL_Log("GAME_TICK_HZ=%s out of range %d..%d", hz_env, APP_TICK_HZ_MIN,
+                    APP_TICK_HZ_MAX);
+    }
+    SDL_Log("sim: %.0f Hz", 1.0 / (double)g_tick_dt);
+}
+
+// GAME_REPLAY=path replays a recording headless and exits with its verdict; GAME_RECORD=path
+// records this session
+static bool start_replay(void) {
+    const char* replay_path = SDL_getenv("GAME_REPLAY");
+    const char* record_path = SDL_getenv("GAME_RECORD");
+    if (replay_path && replay_path[0]) {
+        g_headless = true;
+        return replay_start_playback(replay_path, g_tick_dt);
+    }
+    if (record_path && record_path[0] && !replay_start_recording(record_path, g_tick_dt))
+        SDL_Log("recording disabled");
+    return true;
+}
+
+// Window, renderer, input devices and audio; none of it exists in a headless replay
+static int init_frontend(void) {
+    if (!SDL_Init(SDL_INIT_VIDEO))
+        return 0;
+    PipelineBackend backend = pipeline_backend_from_env();
+    if (!init_window(backend))
+        return 0;
+    if (!pipeline_init_backend(backend, g_window)) {
+        if (backend != PIPELINE_BACKEND_VULKAN)
+            return 0;
+        SDL_Log("Vulkan backend unavailable, falling back to GL");
+        shutdown_window();
+        if (!init_window(PIPELINE_BACKEND_GL) || !pipeline_init())
+            return 0;
+    }
+    ame_camera_init(&g_cam);
+    g_cam.zoom = APP_DEFAULT_ZOOM;
+    ame_camera_init(&g_cam2);
+    g_cam2.zoom = APP_DEFAULT_ZOOM;
+    set_viewport(g_w, g_h);
+    ui_init();  // fonts
+    if (!input_init())
+        return 0;
+    if (!lighting_init())
+        return 0;
+    lighting_set_ambient(APP_AMBIENT_LIGHT_R, APP_AMBIENT_LIGHT_G, APP_AMBIENT_LIGHT_B);
+    const char* phys_debug_env = SDL_getenv("GAME_PHYS_DEBUG");
+    physics_debug_set_enabled(phys_debug_env ? SDL_strcmp(phys_debug_env, "0") != 0
+                                             : APP_PHYS_DEBUG_DRAW != 0);
+    if (!particles_init())
+        return 0;
+    if (!ame_audio_init(48000))
+        return 0;
+    return 1;
+}
+
+int game_app_init(void) {
+    // Cache base path once for all asset lookups
+    pathutil_init();
+    init_tick_rate();
+    if (!start_replay())
+        return 0;
+    if (g_headless ? !SDL_Init(0) : !init_frontend())
+        return 0;
+    if (!physics_init())
+        return 0;  // stepped by the sim scheduler
+    if (!gameplay_init())
+        return 0;
+    abilities_init();
+    // Before the map load adds its volumes; triggers run on the tick, headless included
+    triggers_init();
+    if (!g_headless)
+        init_audio_and_dialogue();
 
     human_init(&g_human);
     car_init(&g_car);
+    if (!g_headless)
+        g_headlight = lighting_add_cone(0.0f, 0.0f, APP_HEADLIGHT_RADIUS, 0.0f,
+                                        APP_HEADLIGHT_HALF_ANGLE, 1.0f, 0.95f, 0.8f, 1.0f);
 
     // Create a small "ball" as a dynamic box to demonstrate spatial audio
     g_ball_body = physics_create_dynamic_box(200.0f, 150.0f, 6.0f, 6.0f, 0.5f, 0.6f);
@@ -271,16 +467,48 @@ int game_app_init(void) {
                 "Failed to load map car_village.obj after trying executable-relative and "
                 "working-directory paths");
         }
+        // Destructible chunks first: they are part of the distance field but keep their own
+        // occluder groups. Static colliders double as light occluders and feed the field.
+        terrain_build();
+        if (!g_headless)
+            lighting_build_occluders_from_physics();
+        static_sdf_bake(APP_SDF_CELL, APP_SDF_MARGIN);
     }
 
     // Spawn points.
     gameplay_add_spawn_point(APP_DEFAULT_SPAWN_X, APP_DEFAULT_SPAWN_Y);  // default spawn
     car_set_position(&g_car, APP_START_CAR_X, APP_START_CAR_Y);
     human_set_position(&g_human, APP_START_HUMAN_X, APP_START_HUMAN_Y);
-
-    g_logic_thread = SDL_CreateThread(logic_thread_main, "logic", NULL);
-    if (!g_logic_thread) {
-        SDL_Log("failed to start logic thread: %s", SDL_GetError());
+    racers_init(&g_car, APP_START_CAR_X, APP_START_CAR_Y, APP_RACER_COUNT);
+
+    // One fixed tick drives input, control, gameplay and the physics step in a defined order
+    sim_scheduler_init(g_tick_dt);
+    sim_scheduler_add_stage("input", stage_input, NULL, 50, 0);
+    sim_scheduler_add_stage("control", stage_control, NULL, 100, 0);
+    sim_scheduler_add_stage("racers", stage_racers, NULL, 100, 0);
+    sim_scheduler_add_stage("gameplay", stage_gameplay, NULL, 200, 0);
+    sim_scheduler_add_stage("terrain", stage_terrain, NULL, APP_TERRAIN_APPLY_BUDGET_US, 0);
+    sim_scheduler_add_stage("physics", stage_physics, NULL, 500, 0);
+    if (!g_headless) {
+        sim_scheduler_add_stage("ghost", stage_ghost, NULL, 50, 0);
+        start_time_trial();
+    }
+    // Recorded and replayed runs must take identical steps: no quality or time step changes under
+    // load, and craters land on the tick of their explosion
+    bool replaying = replay_mode() != REPLAY_OFF;
+    if (replaying) {
+        sim_scheduler_add_stage("replay", stage_replay, NULL, 50, 0);
+        terrain_set_deterministic(true);
+    }
+    sim_scheduler_set_order(APP_SIM_STAGE_ORDER);
+    sim_scheduler_set_idle(sim_is_quiet, NULL, APP_SIM_IDLE_HZ, APP_SIM_IDLE_AFTER_SEC);
+    physics_set_iterations(APP_PHYS_VELOCITY_ITERATIONS, APP_PHYS_POSITION_ITERATIONS);
+    sim_scheduler_set_overload(replaying ? SIM_OVERLOAD_NONE : APP_SIM_OVERLOAD_POLICY,
+                               APP_SIM_OVERLOAD_ENTER, APP_SIM_OVERLOAD_EXIT, sim_on_overload,
+                               NULL);
+    // Headless replay ticks from game_app_iterate instead
+    if (!g_headless && !sim_scheduler_start()) {
+        SDL_Log("failed to start sim thread: %s", SDL_GetError());
         return 0;
     }
     return 1;
@@ -297,6 +525,9 @@ int game_app_event(void* appstate, void* evp) {
         g_h = event->window.data2;
         set_viewport(g_w, g_h);
     }
+    if (event->type == SDL_EVENT_KEY_DOWN && !event->key.repeat &&
+        event->key.key == APP_PHYS_DEBUG_KEY)
+        physics_debug_set_enabled(!physics_debug_enabled());
     return SDL_APP_CONTINUE;
 }
 
@@ -309,24 +540,18 @@ int game_app_iterate(void* appstate) {
     float dt = (float)((t - prev) / 1e9);
     prev = t;
 
+    if (g_headless) {
+        sim_scheduler_run_ticks(APP_REPLAY_TICKS_PER_ITERATE);
+        if (replay_diverged())
+            return SDL_APP_FAILURE;
+        return replay_finished() ? SDL_APP_SUCCESS : SDL_APP_CONTINUE;
+    }
+
     // Check for quit request
     if (input_quit_requested()) {
         return SDL_APP_SUCCESS;
     }
-
-    update_switch_logic();
-
-    // Restart on R
-    if (input_restart_edge()) {
-        gameplay_restart(&g_human, &g_car);
-    }
-
-    // Keep human near car when driving to allow quick switch back
-    if (g_mode == CONTROL_CAR) {
-        float cx, cy;
-        car_get_position(&g_car, &cx, &cy);
-        human_set_position(&g_human, cx, cy);
-    }
+    ControlMode mode = (ControlMode)atomic_load(&g_shown_mode);
 
     // Dialogue input handling (advance or choose)
     if (dialogue_is_active()) {
@@ -342,17 +567,11 @@ int game_app_iterate(void* appstate) {
         }
     }
 
-    if (g_mode == CONTROL_CAR) {
-        car_update(&g_car, dt);
-    } else {
-        human_update(&g_human, dt);
-    }
-
     // Update ball panning based on screen position relative to camera
     float bx = 0, by = 0;
     physics_get_position(g_ball_body, &bx, &by);
     // Map horizontal offset to pan in [-1,1] using viewport width and zoom
-    float half_w = (float)g_w * 0.5f / g_cam.zoom;
+    float half_w = (float)view_width(g_w) * 0.5f / g_cam.zoom;
     float pan = 0.0f;                        // left negative, right positive
     pan = (bx - g_cam.x - half_w) / half_w;  // center at camera middle
     if (pan < -1.0f)
@@ -368,7 +587,7 @@ int game_app_iterate(void* appstate) {
     float dy_ = cary_ - g_cam.y;
     bool too_far_ = (dx_ * dx_ + dy_ * dy_) > (1000.0f * 1000.0f);
 
-    if (g_mode == CONTROL_CAR && !too_far_) {
+    if (mode == CONTROL_CAR && !too_far_) {
         // Rear wheel
         float rear_w = car_get_rear_wheel_angular_speed(&g_car);
         float r_freq = 0.0f, r_gain = 0.0f;
@@ -420,44 +639,96 @@ int game_app_iterate(void* appstate) {
     refs[rc++] = (AmeAudioSourceRef){&g_car_front_audio, g_car_front_audio_id};
     // Collect gameplay-managed sources (explosions, saws, etc.)
     rc += gameplay_collect_audio_refs(refs + rc, (int)(sizeof(refs) / sizeof(refs[0])) - rc,
-                                      g_cam.x, g_cam.y, (float)g_w, g_cam.zoom, dt);
+                                      g_cam.x, g_cam.y, (float)view_width(g_w), g_cam.zoom,
+                                      dt);
     ame_audio_sync_sources_refs(refs, (size_t)rc);
 
-    // Update triggers (AABB overlap only)
-    float hx, hy, cx, cy;
-    human_get_position(&g_human, &hx, &hy);
-    car_get_position(&g_car, &cx, &cy);
-    triggers_update(hx, hy, g_human.w, g_human.h, cx, cy, g_car.cfg.body_w, g_car.cfg.body_h);
+    // Reactions to triggers that fired on the sim tick
+    if (gameplay_finish_reached())
+        finish_time_trial();
+    const char* scene = gameplay_take_dialogue_request();
+    if (scene)
+        dialogue_start_scene(scene);
 
     // Gameplay update (audio panning, cleanup)
-    gameplay_update(&g_human, &g_car, g_cam.x, g_cam.y, (float)g_w, g_cam.zoom, dt);
+    gameplay_update(&g_human, &g_car, g_cam.x, g_cam.y, (float)view_width(g_w), g_cam.zoom,
+                    dt);
+
+    // Everything drawn from here on (cameras included) sits between the last two ticks
+    float alpha = sim_scheduler_alpha();
+    physics_render_begin(alpha);
 
     // Smooth camera follow of active entity
     float tx, ty;
-    if (g_mode == CONTROL_CAR) {
-        car_get_position(&g_car, &tx, &ty);
+    if (mode == CONTROL_CAR) {
+        physics_get_render_position(g_car.body, &tx, &ty);
     } else {
-        human_get_position(&g_human, &tx, &ty);
+        physics_get_render_position(g_human.body, &tx, &ty);
     }
     ame_camera_set_target(&g_cam, tx, ty);
     ame_camera_update(&g_cam, dt);
+    if (APP_SPLIT_SCREEN) {
+        if (mode == CONTROL_CAR) {
+            physics_get_render_position(g_human.body, &tx, &ty);
+        } else {
+            physics_get_render_position(g_car.body, &tx, &ty);
+        }
+        ame_camera_set_target(&g_cam2, tx, ty);
+        ame_camera_update(&g_cam2, dt);
+    }
 
-    glClearColor(0.15f, 0.2f, 0.25f, 1);
-    glClear(GL_COLOR_BUFFER_BIT);
-    pipeline_begin(&g_cam, g_w, g_h);
+    // Headlight follows the car's nose
+    if (g_car.body) {
+        float hlx, hly;
+        physics_get_render_position(g_car.body, &hlx, &hly);
+        float ang = physics_get_render_angle(g_car.body);
+        float nose = g_car.cfg.body_w * 0.5f;
+        lighting_set_light_transform(g_headlight, hlx + cosf(ang) * nose, hly + sinf(ang) * nose,
+                                     ang);
+    }
+    lighting_update(dt);
+    // Particles simulate on their worker while the main thread prepares the frame
+    particles_update(dt);
+
+    // One submission for all views; split-screen draws it a second time through g_cam2
+    int view_w = view_width(g_w);
+    pipeline_views_begin(g_w, g_h);
+    pipeline_clear(0.15f, 0.2f, 0.25f);
     if (g_map_mesh.count > 0) {
         pipeline_mesh_submit(&g_map_mesh, 0, 0, 0, 1, 1, 1, 0.8f, 0.8f, 0.8f, 1.0f);
     }
+    {
+        // Chunks in any view: the union of both camera rects in split-screen
+        float tx0 = g_cam.x, ty0 = g_cam.y;
+        float tx1 = g_cam.x + (float)view_w / g_cam.zoom, ty1 = g_cam.y + (float)g_h / g_cam.zoom;
+        if (APP_SPLIT_SCREEN) {
+            tx0 = fminf(tx0, g_cam2.x);
+            ty0 = fminf(ty0, g_cam2.y);
+            tx1 = fmaxf(tx1, g_cam2.x + (float)(g_w - view_w) / g_cam2.zoom);
+            ty1 = fmaxf(ty1, g_cam2.y + (float)g_h / g_cam2.zoom);
+        }
+        terrain_render(tx0, ty0, tx1, ty1);
+    }
+    particles_render();
+    racers_render();
+    ghost_render(g_ghost, ghost_record_time() - g_tick_dt * (1.0f - alpha), &g_car,
+                 APP_GHOST_ALPHA);
     car_render(&g_car);
     human_render(&g_human);
     gameplay_render();
+    if (physics_debug_enabled()) {
+        float x1 = g_cam.x + (float)view_w / g_cam.zoom, y1 = g_cam.y + (float)g_h / g_cam.zoom;
+        physics_debug_render(g_cam.x, g_cam.y, x1, y1, g_cam.zoom, g_car.body);
+    }
 
-    // HUD and Dialogue UI
-    ui_render_hud(&g_cam, g_w, g_h, &g_car, &g_human, &g_mode);
-    ui_render_dialogue(&g_cam, g_w, g_h, dialogue_get_runtime(), dialogue_is_active());
+    // HUD and Dialogue UI (player view only)
+    pipeline_set_submit_view(0);
+    ui_render_hud(&g_cam, view_w, g_h, &g_car, &g_human, &mode);
+    ui_render_dialogue(&g_cam, view_w, g_h, dialogue_get_runtime(), dialogue_is_active());
 
-    pipeline_end();
-    SDL_GL_SwapWindow(g_window);
+    PipelineView views[2] = {{&g_cam, 0, 0, view_w, g_h}, {&g_cam2, view_w, 0, g_w - view_w, g_h}};
+    pipeline_views_end(views, APP_SPLIT_SCREEN ? 2 : 1);
+    pipeline_present(g_window);
     return SDL_APP_CONTINUE;
 }
 
@@ -465,19 +736,32 @@ void game_app_quit(void* appstate, int result) {
     (void)appstate;
     (void)result;
     atomic_store(&g_should_quit, true);
-    if (g_logic_thread) {
-        SDL_WaitThread(g_logic_thread, NULL);
-        g_logic_thread = NULL;
-    }
+    sim_scheduler_shutdown();
+    replay_stop();
+    ghost_free(g_ghost);
+    g_ghost = NULL;
+    ghost_recorder_shutdown();
+    racers_shutdown();
+    terrain_shutdown();
     car_shutdown(&g_car);
     human_shutdown(&g_human);
-    pipeline_shutdown();
+    if (!g_headless) {
+        particles_shutdown();
+        physics_debug_shutdown();
+        pipeline_shutdown();
+    }
+    lighting_shutdown();  // also holds the terrain occluder groups in a headless run
     free_obj_map(&g_map_mesh);
+    static_sdf_shutdown();
     gameplay_shutdown();
-    dialogue_manager_shutdown();
-    ui_shutdown();
+    if (!g_headless) {
+        dialogue_manager_shutdown();
+        ui_shutdown();
+    }
     physics_shutdown();
-    input_shutdown();
-    ame_audio_shutdown();
-    shutdown_gl();
+    if (!g_headless) {
+        input_shutdown();
+        ame_audio_shutdown();
+    }
+    shutdown_window();
 }
@@ -0,0 +1,215 @@
+#include "character_controller.h"
+#include <box2d/box2d.h>
+#include <cmath>
+#include "physics.h"
+
+struct CastHit {
+    bool hit;
+    float lambda;   // fraction of the translation travelled before contact
+    b2Vec2 normal;  // surface normal, pointing at the swept box
+    b2Body* body;
+};
+
+// Sweeps a box through the world and keeps the earliest hit on a static or kinematic fixture
+struct SweepQuery : public b2QueryCallback {
+    const b2Body* self = nullptr;
+    b2DistanceProxy proxy;
+    b2Transform xf;
+    b2Vec2 translation;
+    b2AABB sweep;
+    CastHit best{};
+    bool ReportFixture(b2Fixture* f) override {
+        if (f->IsSensor())
+            return true;
+        b2Body* b = f->GetBody();
+        if (b == self || b->GetType() == b2_dynamicBody)
+            return true;
+        const b2Shape* sh = f->GetShape();
+        for (int32 i = 0; i < sh->GetChildCount(); i++) {
+            if (!b2TestOverlap(f->GetAABB(i), sweep))
+                continue;
+            b2ShapeCastInput in;
+            in.proxyA.Set(sh, i);
+            in.proxyB = proxy;
+            in.transformA = b->GetTransform();
+            in.transformB = xf;
+            in.translationB = translation;
+            b2ShapeCastOutput out;
+            if (!b2ShapeCast(&out, &in))
+                continue;
+            if (!best.hit || out.lambda < best.lambda)
+                best = CastHit{true, out.lambda, out.normal, b};
+        }
+        return true;
+    }
+};
+
+// Caller holds the world lock (shared)
+static CastHit sweep_box(b2World* world,
+                         const b2Body* self,
+                         const b2Vec2& center,
+                         float hx,
+                         float hy,
+                         const b2Vec2& d) {
+    b2PolygonShape box;
+    box.SetAsBox(hx, hy);
+    SweepQuery q;
+    q.self = self;
+    q.proxy.Set(&box, 0);
+    q.xf.Set(center, 0.0f);
+    q.translation = d;
+    q.sweep.lowerBound.Set(center.x - hx + fminf(d.x, 0.0f), center.y - hy + fminf(d.y, 0.0f));
+    q.sweep.upperBound.Set(center.x + hx + fmaxf(d.x, 0.0f), center.y + hy + fmaxf(d.y, 0.0f));
+    world->QueryAABB(&q, q.sweep);
+    // Starting in contact gives lambda 0 and possibly no normal: treat it as facing the sweep
+    if (q.best.hit && q.best.normal.LengthSquared() < 1e-6f) {
+        q.best.normal = -d;
+        q.best.normal.Normalize();
+    }
+    return q.best;
+}
+
+CharacterControllerConfig character_controller_default_config(float w, float h) {
+    CharacterControllerConfig c;
+    c.half_w = w * 0.5f;
+    c.half_h = h * 0.5f;
+    c.max_slope_deg = 50.0f;
+    c.step_height = h * 0.25f;
+    c.ground_probe = 2.0f;
+    c.wall_probe = 1.5f;
+    c.skin = 0.1f;
+    c.coyote_time = 0.1f;
+    return c;
+}
+
+void character_controller_init(CharacterController* cc,
+                               b2Body* body,
+                               const CharacterControllerConfig* cfg) {
+    if (!cc)
+        return;
+    *cc = CharacterController{};
+    cc->body = body;
+    cc->cfg = cfg ? *cfg : character_controller_default_config(10.0f, 10.0f);
+    cc->min_ground_ny = cosf(cc->cfg.max_slope_deg * b2_pi / 180.0f);
+    if (body && physics_get_world()) {
+        physics_lock();
+        body->SetFixedRotation(true);
+        physics_unlock();
+    }
+}
+
+void character_controller_update(CharacterController* cc, float dt) {
+    if (!cc || !cc->body)
+        return;
+    b2World* world = physics_get_world();
+    if (!world)
+        return;
+    const CharacterControllerConfig& c = cc->cfg;
+    CastHit ground{}, right{}, left{};
+    physics_lock_shared();
+    b2Body* body = cc->body;
+    b2Vec2 p = body->GetPosition();
+    b2Vec2 v = body->GetLinearVelocity();
+    if (body->IsEnabled()) {
+        float hx = c.half_w - c.skin, hy = c.half_h - c.skin;
+        ground = sweep_box(world, body, p, hx, hy, b2Vec2(0.0f, -(c.ground_probe + c.skin)));
+        // Shorter box for walls so floor and ceiling edges do not register
+        float probe = c.wall_probe + c.skin;
+        right = sweep_box(world, body, p, hx, c.half_h * 0.7f, b2Vec2(probe, 0.0f));
+        left = sweep_box(world, body, p, hx, c.half_h * 0.7f, b2Vec2(-probe, 0.0f));
+    }
+    physics_unlock_shared();
+
+    // Walkable surface, and not already moving away from it (the tick after a jump)
+    cc->grounded = ground.hit && ground.normal.y >= cc->min_ground_ny &&
+                   b2Dot(v, ground.normal) <= 1.0f;
+    cc->ground_nx = cc->grounded ? ground.normal.x : 0.0f;
+    cc->ground_ny = cc->grounded ? ground.normal.y : 1.0f;
+    // The cast box is shrunk by skin, so a body at rest hits after skin
+    cc->ground_gap = cc->grounded ? ground.lambda * (c.ground_probe + c.skin) - c.skin : 0.0f;
+    cc->ground_body = cc->grounded ? ground.body : nullptr;
+
+    cc->wall_dir = 0;
+    if (right.hit && right.normal.x < -0.7f)
+        cc->wall_dir = 1;
+    else if (left.hit && left.normal.x > 0.7f)
+        cc->wall_dir = -1;
+
+    if (cc->grounded) {
+        cc->coyote_timer = c.coyote_time;
+        cc->jumped = false;
+    } else {
+        cc->coyote_timer = fmaxf(cc->coyote_timer - dt, 0.0f);
+    }
+}
+
+// Height to climb so the box can continue past a ledge ahead, 0 when it is too tall.
+// Caller holds the world lock (shared).
+static float step_up_height(const CharacterController* cc, b2World* world, float dx) {
+    const CharacterControllerConfig& c = cc->cfg;
+    const b2Body* body = cc->body;
+    float hx = c.half_w - c.skin, hy = c.half_h - c.skin;
+    b2Vec2 p = body->GetPosition();
+    // Room above, room ahead at that height, then find the ledge top below
+    CastHit up = sweep_box(world, body, p, hx, hy, b2Vec2(0.0f, c.step_height));
+    float rise = up.hit ? up.lambda * c.step_height : c.step_height;
+    b2Vec2 raised(p.x, p.y + rise);
+    if (sweep_box(world, body, raised, hx, hy, b2Vec2(dx, 0.0f)).hit)
+        return 0.0f;
+    b2Vec2 ahead(raised.x + dx, raised.y);
+    CastHit down = sweep_box(world, body, ahead, hx, hy, b2Vec2(0.0f, -rise));
+    if (!down.hit || down.normal.y < cc->min_ground_ny)
+        return 0.0f;
+    return rise * (1.0f - down.lambda);
+}
+
+void character_controller_move(CharacterController* cc, float target_vx, float dt) {
+    if (!cc || !cc->body || dt <= 0.0f)
+        return;
+    b2World* world = physics_get_world();
+    if (!world)
+        return;
+    const CharacterControllerConfig& c = cc->cfg;
+    float dir = target_vx > 0.0f ? 1.0f : (target_vx < 0.0f ? -1.0f : 0.0f);
+    if (dir != 0.0f) {
+        // Sweep this tick's motion (plus the wall probe) with the full box
+        float dx = dir * (fabsf(target_vx) * dt + c.wall_probe + c.skin);
+        float climb = 0.0f;
+        bool blocked = false;
+        physics_lock_shared();
+        b2Vec2 p = cc->body->GetPosition();
+        CastHit ahead = sweep_box(world, cc->body, p, c.half_w - c.skin, c.half_h - c.skin,
+                                  b2Vec2(dx, 0.0f));
+        if (ahead.hit && ahead.normal.y < cc->min_ground_ny && ahead.normal.x * dir < 0.0f) {
+            blocked = true;
+            if (cc->grounded)
+                climb = step_up_height(cc, world, dx);
+        }
+        physics_unlock_shared();
+        if (climb > c.skin) {
+            // Lift over the ledge across four ticks while keeping the walking speed
+            physics_set_velocity(cc->body, target_vx, climb / (4.0f * dt));
+            return;
+        }
+        if (blocked) {
+            // Slide: drop the component into the wall, keep falling/rising
+            physics_set_velocity_x(cc->body, 0.0f);
+            return;
+        }
+    }
+    if (cc->grounded && cc->ground_gap <= c.skin) {
+        // Walk along the ground tangent so slopes neither launch nor slow the body
+        physics_set_velocity(cc->body, cc->ground_ny * target_vx, -cc->ground_nx * target_vx);
+        return;
+    }
+    physics_set_velocity_x(cc->body, target_vx);
+}
+
+bool character_controller_try_jump(CharacterController* cc) {
+    if (!cc || cc->jumped || (!cc->grounded && cc->coyote_timer <= 0.0f))
+        return false;
+    cc->jumped = true;
+    cc->grounded = false;
+    cc->coyote_timer = 0.0f;
+    return true;
+}
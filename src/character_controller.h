@@ -0,0 +1,59 @@
+#pragma once
+#include <stdbool.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Character controller for box-shaped dynamic bodies (the Human). Ground and wall state is
+// computed once per tick from Box2D shape casts (b2ShapeCast) against the static and kinematic
+// world, under a single shared world lock, and cached for the rest of the tick.
+// - Ground: the feet box swept down a short distance; only surfaces within max_slope count
+// - Walls: the body box swept sideways; steep surfaces block movement and enable wall jumps
+// - Move-and-slide: walking follows the ground tangent, stops at walls and steps up ledges
+//   up to step_height
+// - Coyote time: jumping stays allowed for a moment after walking off a ledge
+// Velocity changes go through the queued physics mutators (physics.h).
+
+typedef struct b2Body b2Body;
+
+typedef struct {
+    float half_w, half_h;  // collision box half extents (world units)
+    float max_slope_deg;   // steepest surface that still counts as ground
+    float step_height;     // tallest ledge climbed while walking
+    float ground_probe;    // distance below the feet searched for ground
+    float wall_probe;      // distance beside the body searched for walls
+    float skin;            // casts use a box shrunk by this much to ignore resting contact
+    float coyote_time;     // seconds after leaving the ground that a jump is still allowed
+} CharacterControllerConfig;
+
+typedef struct {
+    b2Body* body;
+    CharacterControllerConfig cfg;
+    float min_ground_ny;  // cos(max_slope)
+    // Cached by character_controller_update
+    bool grounded;
+    float ground_nx, ground_ny;  // ground normal while grounded
+    float ground_gap;            // distance from the feet down to the ground while grounded
+    b2Body* ground_body;
+    int wall_dir;  // -1 wall on the left, +1 on the right, 0 none
+    float coyote_timer;
+    bool jumped;  // a jump was used since the last time the body was grounded
+} CharacterController;
+
+CharacterControllerConfig character_controller_default_config(float w, float h);
+// Also locks the body's rotation: the controller assumes an upright box
+void character_controller_init(CharacterController* cc,
+                               b2Body* body,
+                               const CharacterControllerConfig* cfg);
+// Refresh ground/wall state for this tick
+void character_controller_update(CharacterController* cc, float dt);
+// Walk at target_vx (world units/s) using the cached state: follows slopes, slides along walls
+// and steps up low ledges. Only a body standing on the ground (within skin) is held to the ground
+// tangent; one still dropping onto it keeps falling.
+void character_controller_move(CharacterController* cc, float target_vx, float dt);
+// True (and consumes the jump) when grounded or within coyote time
+bool character_controller_try_jump(CharacterController* cc);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,312 @@
+#include "collider_opt.h"
+#include <SDL3/SDL.h>
+#include <cmath>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Vec {
+    float x, y;
+};
+
+typedef std::vector<int> Poly;
+
+static float cross3(const Vec& o, const Vec& a, const Vec& b) {
+    return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+}
+
+static uint64_t pair_key(int a, int b) {
+    return ((uint64_t)(uint32_t)a << 32) | (uint32_t)b;
+}
+
+// Grid hash with eps-sized cells; a new point joins any existing vertex within eps
+struct Welder {
+    float eps;
+    std::vector<Vec> verts;
+    std::unordered_map<uint64_t, std::vector<int>> cells;
+
+    int add(float x, float y) {
+        int cx = (int)floorf(x / eps), cy = (int)floorf(y / eps);
+        for (int dy = -1; dy <= 1; dy++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                auto it = cells.find(pair_key(cx + dx, cy + dy));
+                if (it == cells.end())
+                    continue;
+                for (int idx : it->second) {
+                    float ex = verts[idx].x - x, ey = verts[idx].y - y;
+                    if (ex * ex + ey * ey <= eps * eps)
+                        return idx;
+                }
+            }
+        }
+        int idx = (int)verts.size();
+        verts.push_back(Vec{x, y});
+        cells[pair_key(cx, cy)].push_back(idx);
+        return idx;
+    }
+};
+
+// Drop vertices that do not turn (collinear or repeated). area_eps scales with the mesh.
+static void remove_collinear(const std::vector<Vec>& v, Poly* p, float area_eps) {
+    bool changed = true;
+    while (changed && p->size() > 3) {
+        changed = false;
+        for (size_t i = 0; i < p->size() && p->size() > 3; i++) {
+            size_t n = p->size();
+            const Vec& a = v[(*p)[(i + n - 1) % n]];
+            const Vec& b = v[(*p)[i]];
+            const Vec& c = v[(*p)[(i + 1) % n]];
+            if (fabsf(cross3(a, b, c)) <= area_eps) {
+                p->erase(p->begin() + (long)i);
+                changed = true;
+            }
+        }
+    }
+}
+
+static bool is_convex(const std::vector<Vec>& v, const Poly& p, float area_eps) {
+    size_t n = p.size();
+    if (n < 3 || n > COLLIDER_OPT_MAX_POLY_VERTS)
+        return false;
+    for (size_t i = 0; i < n; i++) {
+        if (cross3(v[p[i]], v[p[(i + 1) % n]], v[p[(i + 2) % n]]) <= area_eps)
+            return false;
+    }
+    return true;
+}
+
+// Join P and Q across their shared edge (u,v): P has u->v, Q has v->u
+static bool merge_across(const std::vector<Vec>& v,
+                         const Poly& P,
+                         const Poly& Q,
+                         int a,
+                         int b,
+                         float area_eps,
+                         Poly* out) {
+    size_t np = P.size(), nq = Q.size();
+    size_t i = np;
+    for (size_t k = 0; k < np; k++) {
+        int p0 = P[k], p1 = P[(k + 1) % np];
+        if ((p0 == a && p1 == b) || (p0 == b && p1 == a)) {
+            i = k;
+            break;
+        }
+    }
+    if (i == np)
+        return false;
+    int u = P[i], w = P[(i + 1) % np];
+    size_t j = nq;
+    for (size_t k = 0; k < nq; k++) {
+        if (Q[k] == w && Q[(k + 1) % nq] == u) {
+            j = k;
+            break;
+        }
+    }
+    if (j == nq)
+        return false;
+    out->clear();
+    // w ... u around P, then Q's vertices after u up to (not including) w
+    for (size_t k = 0; k < np; k++) {
+        out->push_back(P[(i + 1 + k) % np]);
+    }
+    for (size_t k = 2; k < nq; k++) {
+        out->push_back(Q[(j + k) % nq]);
+    }
+    remove_collinear(v, out, area_eps);
+    return is_convex(v, *out, area_eps);
+}
+
+static int find_root(std::vector<int>& parent, int i) {
+    while (parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+    }
+    return i;
+}
+
+}  // namespace
+
+ColliderOptConfig collider_opt_default_config(void) {
+    ColliderOptConfig c;
+    c.weld_eps = 0.01f;
+    c.merge_polygons = true;
+    c.boundary_loops = false;
+    return c;
+}
+
+bool collider_opt_build(const float* tri_xy,
+                        int vertex_count,
+                        const ColliderOptConfig* cfg,
+                        ColliderOptMesh* out) {
+    if (!out)
+        return false;
+    SDL_memset(out, 0, sizeof(*out));
+    if (!tri_xy || vertex_count < 3)
+        return false;
+    ColliderOptConfig c = cfg ? *cfg : collider_opt_default_config();
+    if (c.weld_eps <= 0.0f)
+        c.weld_eps = 1e-4f;
+
+    // Weld and collect counter-clockwise triangles
+    Welder welder;
+    welder.eps = c.weld_eps;
+    std::vector<Poly> polys;
+    polys.reserve((size_t)vertex_count / 3);
+    float minx = tri_xy[0], maxx = tri_xy[0], miny = tri_xy[1], maxy = tri_xy[1];
+    for (int i = 0; i < vertex_count; i++) {
+        minx = fminf(minx, tri_xy[i * 2 + 0]);
+        maxx = fmaxf(maxx, tri_xy[i * 2 + 0]);
+        miny = fminf(miny, tri_xy[i * 2 + 1]);
+        maxy = fmaxf(maxy, tri_xy[i * 2 + 1]);
+    }
+    // Turns smaller than this (twice the triangle area) count as straight
+    float extent = fmaxf(maxx - minx, maxy - miny);
+    float area_eps = fmaxf(extent * 1e-6f, c.weld_eps * c.weld_eps);
+    for (int t = 0; t + 2 < vertex_count; t += 3) {
+        out->stats.triangles_in++;
+        int ia = welder.add(tri_xy[t * 2 + 0], tri_xy[t * 2 + 1]);
+        int ib = welder.add(tri_xy[t * 2 + 2], tri_xy[t * 2 + 3]);
+        int ic = welder.add(tri_xy[t * 2 + 4], tri_xy[t * 2 + 5]);
+        const std::vector<Vec>& v = welder.verts;
+        float area2 = cross3(v[ia], v[ib], v[ic]);
+        if (ia == ib || ib == ic || ia == ic || fabsf(area2) <= area_eps) {
+            out->stats.triangles_dropped++;
+            continue;
+        }
+        if (area2 < 0.0f)
+            polys.push_back(Poly{ia, ic, ib});
+        else
+            polys.push_back(Poly{ia, ib, ic});
+    }
+    const std::vector<Vec>& v = welder.verts;
+
+    // Directed edges of all triangles; an edge whose reverse exists is interior
+    std::unordered_map<uint64_t, int> edge_tri;
+    edge_tri.reserve(polys.size() * 3);
+    for (size_t t = 0; t < polys.size(); t++) {
+        for (int k = 0; k < 3; k++) {
+            edge_tri[pair_key(polys[t][k], polys[t][(k + 1) % 3])] = (int)t;
+        }
+    }
+
+    if (c.merge_polygons) {
+        std::vector<int> parent(polys.size());
+        for (size_t t = 0; t < polys.size(); t++) {
+            parent[t] = (int)t;
+        }
+        Poly merged;
+        // Walk the original triangle edges (polys[] is rewritten as merges happen) and visit each
+        // interior edge once, from the side where a < b
+        std::vector<Poly> tri = polys;
+        for (size_t t = 0; t < tri.size(); t++) {
+            for (int k = 0; k < 3; k++) {
+                int a = tri[t][k], b = tri[t][(k + 1) % 3];
+                if (a > b)
+                    continue;
+                auto it = edge_tri.find(pair_key(b, a));
+                if (it == edge_tri.end())
+                    continue;
+                int p = find_root(parent, (int)t), q = find_root(parent, it->second);
+                if (p == q)
+                    continue;
+                if (!merge_across(v, polys[p], polys[q], a, b, area_eps, &merged))
+                    continue;
+                polys[p].swap(merged);
+                polys[q].clear();
+                parent[q] = p;
+            }
+        }
+    }
+
+    std::vector<std::vector<int>> loops;
+    if (c.boundary_loops) {
+        // Boundary edges have no reverse twin; chain them head to tail
+        std::unordered_multimap<int, int> next;
+        for (const auto& e : edge_tri) {
+            int a = (int)(e.first >> 32), b = (int)(uint32_t)e.first;
+            if (edge_tri.find(pair_key(b, a)) == edge_tri.end())
+                next.emplace(a, b);
+        }
+        while (!next.empty()) {
+            auto start = next.begin();
+            int first = start->first;
+            int cur = start->second;
+            next.erase(start);
+            Poly loop{first};
+            bool closed = false;
+            while (loop.size() <= v.size()) {
+                if (cur == first) {
+                    closed = true;
+                    break;
+                }
+                loop.push_back(cur);
+                auto it = next.find(cur);
+                if (it == next.end())
+                    break;
+                cur = it->second;
+                next.erase(it);
+            }
+            if (!closed)
+                continue;
+            remove_collinear(v, &loop, area_eps);
+            if (loop.size() >= 3)
+                loops.push_back(loop);
+        }
+    }
+
+    // Flatten
+    size_t total = 0;
+    for (const Poly& p : polys) {
+        total += p.size();
+        out->poly_count += p.empty() ? 0 : 1;
+    }
+    for (const Poly& l : loops) {
+        total += l.size();
+    }
+    out->loop_count = (int)loops.size();
+    out->xy = (float*)SDL_malloc(sizeof(float) * 2 * (total ? total : 1));
+    out->poly_counts = (int*)SDL_malloc(sizeof(int) * (size_t)(out->poly_count + 1));
+    out->loop_counts = (int*)SDL_malloc(sizeof(int) * (size_t)(out->loop_count + 1));
+    if (!out->xy || !out->poly_counts || !out->loop_counts) {
+        collider_opt_free(out);
+        return false;
+    }
+    size_t n = 0;
+    int pi = 0;
+    for (const Poly& p : polys) {
+        if (p.empty())
+            continue;
+        out->poly_counts[pi++] = (int)p.size();
+        for (int idx : p) {
+            out->xy[n * 2 + 0] = v[idx].x;
+            out->xy[n * 2 + 1] = v[idx].y;
+            n++;
+        }
+    }
+    for (size_t l = 0; l < loops.size(); l++) {
+        out->loop_counts[l] = (int)loops[l].size();
+        for (int idx : loops[l]) {
+            out->xy[n * 2 + 0] = v[idx].x;
+            out->xy[n * 2 + 1] = v[idx].y;
+            n++;
+        }
+    }
+    out->stats.polygons_out = out->poly_count;
+    out->stats.loops_out = out->loop_count;
+    return out->poly_count > 0 || out->loop_count > 0;
+}
+
+void collider_opt_free(ColliderOptMesh* mesh) {
+    if (!mesh)
+        return;
+    SDL_free(mesh->xy);
+    SDL_free(mesh->poly_counts);
+    SDL_free(mesh->loop_counts);
+    mesh->xy = NULL;
+    mesh->poly_counts = NULL;
+    mesh->loop_counts = NULL;
+    mesh->poly_count = 0;
+    mesh->loop_count = 0;
+}
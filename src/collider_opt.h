@@ -0,0 +1,48 @@
+#pragma once
+#include <stdbool.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Load-time optimizer for triangle mesh colliders. Welds coincident vertices, drops degenerate
+// triangles and merges adjacent triangles into convex polygons of up to
+// COLLIDER_OPT_MAX_POLY_VERTS vertices (Hertel-Mehlhorn: remove shared diagonals while the result
+// stays convex). Optionally extracts the mesh boundary as closed loops for chain shapes.
+// Loops keep the winding of the (counter-clockwise) triangles, so the solid is on their left.
+
+#define COLLIDER_OPT_MAX_POLY_VERTS 8  // b2_maxPolygonVertices
+
+typedef struct {
+    float weld_eps;       // vertices closer than this become one
+    bool merge_polygons;  // false keeps one polygon per triangle
+    bool boundary_loops;  // also output the boundary loops
+} ColliderOptConfig;
+
+typedef struct {
+    int triangles_in;
+    int triangles_dropped;  // degenerate after welding
+    int polygons_out;
+    int loops_out;
+} ColliderOptStats;
+
+typedef struct {
+    float* xy;         // (x,y) pairs: all polygons first, then all loops
+    int* poly_counts;  // vertices per polygon (counter-clockwise, convex)
+    int poly_count;
+    int* loop_counts;  // vertices per boundary loop (not repeating the first)
+    int loop_count;
+    ColliderOptStats stats;
+} ColliderOptMesh;
+
+ColliderOptConfig collider_opt_default_config(void);
+// tri_xy holds vertex_count (x,y) points, three per triangle. Returns false when nothing usable
+// remains; out must be released with collider_opt_free either way.
+bool collider_opt_build(const float* tri_xy,
+                        int vertex_count,
+                        const ColliderOptConfig* cfg,
+                        ColliderOptMesh* out);
+void collider_opt_free(ColliderOptMesh* mesh);
+
+#ifdef __cplusplus
+}
+#endif
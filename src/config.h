@@ -9,9 +9,86 @@
 
 // Camera
 #define APP_DEFAULT_ZOOM 3.0f
+// Split-screen: 1 = left half follows the controlled entity, right half follows the other one
+#define APP_SPLIT_SCREEN 0
 
-// Timing
-#define APP_FIXED_DT 0.001f  // 1000 Hz
+// Timing: sim and physics tick rate (e.g. 120, 240, 500, 1000). Rendering interpolates between
+// the last two ticks, so a lower rate costs a tick of latency rather than smoothness.
+// GAME_TICK_HZ overrides it at startup within MIN..MAX.
+#define APP_TICK_HZ 1000
+#define APP_TICK_HZ_MIN 60
+#define APP_TICK_HZ_MAX 2000
+#define APP_FIXED_DT (1.0f / APP_TICK_HZ)
+// Per-tick stage order of the sim scheduler (names registered in app.c)
+#define APP_SIM_STAGE_ORDER "input,control,racers,gameplay,terrain,physics,ghost,replay"
+// Idle mode: sim wakeups per second once the world has been at rest without input for a while
+// (each wakeup still runs every tick that fell due, so game time is unaffected)
+#define APP_SIM_IDLE_HZ 60.0f
+#define APP_SIM_IDLE_AFTER_SEC 0.5f
+// Overload: when the sim tick's cost stays above ENTER of its period, apply the policy (none,
+// halve rate, reduce quality, slow time; see sim_scheduler.h) until it is back under EXIT
+#define APP_SIM_OVERLOAD_POLICY SIM_OVERLOAD_REDUCE_QUALITY
+#define APP_SIM_OVERLOAD_ENTER 0.9f
+#define APP_SIM_OVERLOAD_EXIT 0.6f
+// Headless replay (GAME_REPLAY): sim ticks run per app iteration
+#define APP_REPLAY_TICKS_PER_ITERATE 1000
+// Physics solver iterations, and the reduced set used while overloaded
+#define APP_PHYS_VELOCITY_ITERATIONS 8
+#define APP_PHYS_POSITION_ITERATIONS 3
+#define APP_PHYS_OVERLOAD_VELOCITY_ITERATIONS 4
+#define APP_PHYS_OVERLOAD_POSITION_ITERATIONS 2
+
+// Static mesh colliders: merge MeshCollider triangles into convex polygons at load (0 = one
+// fixture per triangle)
+#define APP_COLLIDER_MERGE 1
+// Use the outer boundary of untagged mesh colliders as chain loops instead of solid polygons
+// (hollow: one-sided edges, nothing inside the loop collides)
+#define APP_COLLIDER_CHAINS 0
+// Vertices closer than this are welded before merging (world units)
+#define APP_COLLIDER_WELD_EPS 0.01f
+// Static distance field (rocket probes, explosion audio occlusion): grid spacing and the margin
+// baked around the level bounds, in world units
+#define APP_SDF_CELL 2.0f
+#define APP_SDF_MARGIN 64.0f
+// AI racers (0 = none). Up to FULL_SLOTS of them near the player run as full Box2D cars (promoted
+// inside PROMOTE_DIST, demoted past DEMOTE_DIST), the rest follow the racing line sampled from the
+// map with a kinematic model ticked at LOD_HZ. SPEED is the flat-ground cruise speed.
+#define APP_RACER_COUNT 12
+#define APP_RACER_FULL_SLOTS 2
+#define APP_RACER_PROMOTE_DIST 450.0f
+#define APP_RACER_DEMOTE_DIST 650.0f
+#define APP_RACER_LOD_HZ 20.0f
+#define APP_RACER_SPEED 220.0f
+#define APP_RACER_SPACING 60.0f      // along the line at the start
+#define APP_RACER_LINE_STEP 8.0f     // racing line sample spacing (x)
+#define APP_RACER_LINE_LENGTH 8000.0f
+
+// Time-trial ghost: best run (start or restart to the "Trigger Finish" volume), stored next to the
+// executable and drawn as a tinted car
+#define APP_GHOST_HZ 10  // transform samples per second (interpolated when drawn)
+#define APP_GHOST_FILE "ghost_best.ghost"
+#define APP_GHOST_ALPHA 0.45f
+#define APP_GHOST_TINT_R 0.6f
+#define APP_GHOST_TINT_G 0.8f
+#define APP_GHOST_TINT_B 1.0f
+// Destructible terrain (map shapes tagged "Destructible"): chunk size in world units, sides of
+// the carve polygon, carved pieces under MIN_AREA are dropped, and the sim-thread time per tick
+// spent swapping rebuilt chunk bodies in (at least one chunk per tick)
+#define APP_TERRAIN_CHUNK 64.0f
+#define APP_TERRAIN_CARVE_SIDES 12
+#define APP_TERRAIN_MIN_AREA 0.5f
+#define APP_TERRAIN_APPLY_BUDGET_US 250
+// Physics debug overlay (fixtures, AABBs, contacts, joints and world counters in the log). The
+// GAME_PHYS_DEBUG environment variable overrides the default; the key toggles it at runtime.
+#define APP_PHYS_DEBUG_DRAW 0
+#define APP_PHYS_DEBUG_KEY SDLK_F3
+
+// Lighting: ambient multiplier for the scene (1,1,1 = unlit look, lower for night levels)
+#define APP_AMBIENT_LIGHT_R 1.0f
+#define APP_AMBIENT_LIGHT_G 1.0f
+#define APP_AMBIENT_LIGHT_B 1.0f
+#define APP_HEADLIGHT_RADIUS 260.0f
+#define APP_HEADLIGHT_HALF_ANGLE 0.45f
 
 // Content
 #define APP_MAP_OBJ_NAME "car_village.obj"
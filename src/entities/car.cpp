@@ -7,24 +7,21 @@
 #include <string.h>
 #include "../abilities.h"
 #include "../input.h"
+#include "../particles.h"
 #include "../path_util.h"
 #include "../physics.h"
 #include "../render/pipeline.h"
 
 static GLuint make_color_tex(unsigned char r, unsigned char g, unsigned char b) {
+    if (pipeline_get_backend() == PIPELINE_BACKEND_NONE)
+        return 0;  // headless replay
     unsigned char px[4] = {r, g, b, 255};
-    GLuint t;
-    glGenTextures(1, &t);
-    glBindTexture(GL_TEXTURE_2D, t);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, px);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    return t;
+    return pipeline_texture_create(1, 1, px, false);
 }
 
 static GLuint load_texture_once(const char* filename) {
+    if (pipeline_get_backend() == PIPELINE_BACKEND_NONE)
+        return 0;
     SDL_Surface* surf = IMG_Load(filename);
     if (!surf) {
         return 0;
@@ -35,15 +32,7 @@ static GLuint load_texture_once(const char* filename) {
         SDL_Log("Failed to convert surface for %s: %s", filename, SDL_GetError());
         return 0;
     }
-    GLuint tex;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, conv->w, conv->h, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                 conv->pixels);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLuint tex = pipeline_texture_create(conv->w, conv->h, conv->pixels, false);
     SDL_DestroySurface(conv);
     return tex;
 }
@@ -70,52 +59,40 @@ static GLuint load_texture_from_file(const char* relpath) {
     return t;
 }
 
-void car_init(Car* c) {
-    if (!c)
-        return;
+CarConfig car_default_config(void) {
+    CarConfig cfg;
+    // Defaults similar to reference
+    cfg.body_w = 35.0f;
+    cfg.body_h = 20.0f;
+    cfg.wheel_radius = 6.0f;
+    cfg.axle_offset_x_b = 8.0f;
+    cfg.axle_offset_x_f = 12.0f;
+    cfg.suspension_hz = 4.0f;
+    cfg.suspension_damping = 0.7f;
+    // Increase motor parameters to ensure visible wheel spin and movement
+    cfg.motor_speed = 500.0f;      // rad/s
+    cfg.motor_torque = 200000.0f;  // stronger torque
+    cfg.jump_impulse = 120000.0f;
+    cfg.boost_mul = 50.0f;
+    cfg.fly_impulse = 12000.0f;
+    cfg.gyro_torque = 4000000.0f;
+    return cfg;
+}
+
+static void car_defaults(Car* c) {
     memset(c, 0, sizeof(*c));
     c->max_hp = 200.0f;
     c->hp = c->max_hp;
     c->max_fuel = 10000.0f;
     c->fuel = c->max_fuel;
-    // Defaults similar to reference
-    c->cfg.body_w = 35.0f;
-    c->cfg.body_h = 20.0f;
-    c->cfg.wheel_radius = 6.0f;
-    c->cfg.axle_offset_x_b = 8.0f;
-    c->cfg.axle_offset_x_f = 12.0f;
-    c->cfg.suspension_hz = 4.0f;
-    c->cfg.suspension_damping = 0.7f;
-    // Increase motor parameters to ensure visible wheel spin and movement
-    c->cfg.motor_speed = 500.0f;      // rad/s
-    c->cfg.motor_torque = 200000.0f;  // stronger torque
-    c->cfg.jump_impulse = 120000.0f;
-    c->cfg.boost_mul = 50.0f;
-    c->cfg.fly_impulse = 12000.0f;
-    c->cfg.gyro_torque = 4000000.0f;
-
-    // Temporarily enable abilities here
-    ability_set_car_boost(true);
-    // ability_set_car_fly(true);
-    // ability_set_car_jump(true);
-
-    // Try to load texture files via executable-relative and CWD; log only once on failure
-    c->tex_body = load_texture_from_file("assets/CarForBrackeyJam.png");
-    if (c->tex_body == 0) {
-        SDL_Log("Using fallback color texture for car body");
-        c->tex_body = make_color_tex(60, 160, 255);
-    }
-    c->tex_wheel = load_texture_from_file("assets/CarWheelForBrackeysJam.png");
-    if (c->tex_wheel == 0) {
-        SDL_Log("Using fallback color texture for car wheel");
-        c->tex_wheel = make_color_tex(30, 30, 30);
-    }
+    c->cfg = car_default_config();
+}
 
+// Chassis, wheels and wheel joints with the wheels resting on y
+static void car_create_bodies(Car* c, float base_x, float base_y) {
     b2World* w = physics_get_world();
     if (!w)
         return;
-    // Place car such that wheels rest on ground at y
-    float base_x = 120.0f, base_y = 120.0f;
     physics_lock();
     // body
     {
@@ -180,22 +157,59 @@ void car_init(Car* c) {
     physics_unlock();
 }
 
-void car_shutdown(Car* c) {
+void car_init(Car* c) {
     if (!c)
         return;
+    car_defaults(c);
+
+    // Temporarily enable abilities here
+    ability_set_car_boost(true);
+    // ability_set_car_fly(true);
+    // ability_set_car_jump(true);
+
+    // Try to load texture files via executable-relative and CWD; log only once on failure
+    c->tex_body = load_texture_from_file("assets/CarForBrackeyJam.png");
+    if (c->tex_body == 0) {
+        SDL_Log("Using fallback color texture for car body");
+        c->tex_body = make_color_tex(60, 160, 255);
+    }
+    c->tex_wheel = load_texture_from_file("assets/CarWheelForBrackeysJam.png");
+    if (c->tex_wheel == 0) {
+        SDL_Log("Using fallback color texture for car wheel");
+        c->tex_wheel = make_color_tex(30, 30, 30);
+    }
+
+    // Place car such that wheels rest on ground at y
+    car_create_bodies(c, 120.0f, 120.0f);
+}
+
+void car_init_shared(Car* c, const Car* look, float x, float y) {
+    if (!c)
+        return;
+    car_defaults(c);
+    if (look) {
+        c->tex_body = look->tex_body;
+        c->tex_wheel = look->tex_wheel;
+        c->shared_textures = true;
+    }
+    car_create_bodies(c, x, y);
+}
+
+void car_shutdown(Car* c) {
+    if (!c || c->shared_textures)
+        return;
     // Clean up textures
     if (c->tex_body != 0) {
-        glDeleteTextures(1, &c->tex_body);
+        pipeline_texture_destroy(c->tex_body);
         c->tex_body = 0;
     }
     if (c->tex_wheel != 0) {
-        glDeleteTextures(1, &c->tex_wheel);
+        pipeline_texture_destroy(c->tex_wheel);
         c->tex_wheel = 0;
     }
 }
 
 void car_fixed(Car* c, float dt) {
-    (void)dt;
     if (!c || !c->body)
         return;
     if (c->pending_teleport) {
@@ -204,19 +218,30 @@ void car_fixed(Car* c, float dt) {
         c->pending_teleport = 0;
     }
     // Use W/S for acceleration, A/D for yaw/spin
-    int accel = input_accel_dir();
-    int yaw = input_yaw_dir();
-    float boost = (ability_get_car_boost() && input_boost_down()) ? c->cfg.boost_mul : 1.0f;
+    CarControls ctl;
+    ctl.throttle = (float)input_accel_dir();
+    ctl.yaw = (float)input_yaw_dir();
+    ctl.boost = ability_get_car_boost() && input_boost_down();
+    ctl.jump = ability_get_car_jump() && input_jump_edge();
+    ctl.fly = ability_get_car_fly() && input_jump_down();
+    car_drive(c, &ctl, dt);
+}
+
+void car_drive(Car* c, const CarControls* ctl, float dt) {
+    if (!c || !c->body || !ctl)
+        return;
+    float accel = ctl->throttle;
+    float boost = ctl->boost ? c->cfg.boost_mul : 1.0f;
     // Fuel consumption: only when applying acceleration or boosting
-    if (accel != 0) {
+    if (accel != 0.0f) {
         float base_use = 10.0f;  // units per second at full throttle
-        float use = base_use * (boost > 1.0f ? 1.5f : 1.0f) * dt;
+        float use = base_use * (boost > 1.0f ? 1.5f : 1.0f) * fabsf(accel) * dt;
         c->fuel -= use;
         if (c->fuel < 0.0f)
             c->fuel = 0.0f;
     }
     // If out of fuel, disable motors regardless of input
-    float speed = (c->fuel > 0.0f) ? (-c->cfg.motor_speed * boost * (float)accel) : 0.0f;
+    float speed = (c->fuel > 0.0f) ? (-c->cfg.motor_speed * boost * accel) : 0.0f;
     physics_lock();
     if (c->joint_b) {
         c->joint_b->EnableMotor(true);
@@ -229,16 +254,26 @@ void car_fixed(Car* c, float dt) {
         c->joint_f->SetMotorSpeed(speed);
     }
     // Apply yaw torque regardless of grounded state
-    float torque = -c->cfg.gyro_torque * (float)yaw;  // stronger yaw torque for noticeable rotation
+    float torque = -c->cfg.gyro_torque * ctl->yaw;  // stronger yaw torque for noticeable rotation
     c->body->ApplyTorque(torque, true);
     // Jump/hop (unlockable) - grounded condition only needed for jumping
-    if (ability_get_car_jump() && input_jump_edge() && physics_is_grounded(c->body)) {
+    if (ctl->jump && physics_is_grounded(c->body)) {
         c->body->ApplyLinearImpulseToCenter(b2Vec2(0.0f, c->cfg.jump_impulse), true);
     }
     // Helicopter-like fly (unlockable): hold Space to get gentle upward force
-    if (ability_get_car_fly() && input_jump_down()) {
+    if (ctl->fly) {
         c->body->ApplyForceToCenter(b2Vec2(0.0f, c->cfg.fly_impulse), true);
     }
+    // Boost exhaust puffs from the tail (~120 bursts/s)
+    bool boosting = boost > 1.0f && accel != 0.0f && c->fuel > 0.0f;
+    c->exhaust_timer = boosting ? c->exhaust_timer + dt : 0.0f;
+    if (c->exhaust_timer >= 1.0f / 120.0f) {
+        c->exhaust_timer = 0.0f;
+        float side = accel > 0.0f ? 1.0f : -1.0f;
+        b2Vec2 tail = c->body->GetWorldPoint(b2Vec2(-c->cfg.body_w * 0.5f * side, 0.0f));
+        b2Vec2 v = c->body->GetLinearVelocity();
+        particles_emit(PARTICLE_EXHAUST, tail.x, tail.y, v.x * 0.5f, v.y * 0.5f, 30.0f, 3);
+    }
     physics_unlock();
 }
 
@@ -246,7 +281,9 @@ void car_update(Car* c, float dt) {
     (void)dt;
     if (!c)
         return;
-    if (c->body->GetPosition().y < -10000)
+    float px, py;
+    physics_get_position(c->body, &px, &py);
+    if (py < -10000)
         c->hp = 0;
     if (c->hp < 0.0f)
         c->hp = 0.0f;
@@ -259,23 +296,24 @@ void car_update(Car* c, float dt) {
 void car_render(const Car* c) {
     if (!c || !c->body)
         return;
-    physics_lock();
-    b2Vec2 p = c->body->GetPosition();
-    float ang = c->body->GetAngle();
-    pipeline_sprite_quad_rot(p.x, p.y, c->cfg.body_w, c->cfg.body_h, ang, c->tex_body, 1, 1, 1, 1);
+    // Snapshot reads: no world lock, so rendering never waits for a physics step
+    float px, py;
+    physics_get_render_position(c->body, &px, &py);
+    float ang = physics_get_render_angle(c->body);
+    pipeline_sprite_quad_rot(px, py, c->cfg.body_w, c->cfg.body_h, ang, c->tex_body, 1, 1, 1, 1);
+    float d = c->cfg.wheel_radius * 2.0f;
     if (c->wheel_b) {
-        b2Vec2 wb = c->wheel_b->GetPosition();
-        float d = c->cfg.wheel_radius * 2.0f;
-        float wang = c->wheel_b->GetAngle();
-        pipeline_sprite_quad_rot(wb.x, wb.y, d, d, wang, c->tex_wheel, 1, 1, 1, 1);
+        float wx, wy;
+        physics_get_render_position(c->wheel_b, &wx, &wy);
+        float wang = physics_get_render_angle(c->wheel_b);
+        pipeline_sprite_quad_rot(wx, wy, d, d, wang, c->tex_wheel, 1, 1, 1, 1);
     }
     if (c->wheel_f) {
-        b2Vec2 wf = c->wheel_f->GetPosition();
-        float d = c->cfg.wheel_radius * 2.0f;
-        float wang = c->wheel_f->GetAngle();
-        pipeline_sprite_quad_rot(wf.x, wf.y, d, d, wang, c->tex_wheel, 1, 1, 1, 1);
+        float wx, wy;
+        physics_get_render_position(c->wheel_f, &wx, &wy);
+        float wang = physics_get_render_angle(c->wheel_f);
+        pipeline_sprite_quad_rot(wx, wy, d, d, wang, c->tex_wheel, 1, 1, 1, 1);
     }
-    physics_unlock();
 }
 
 void car_set_boost(bool val) {
@@ -291,10 +329,9 @@ void car_set_fly(bool val) {
 void car_set_position(Car* c, float x, float y) {
     if (!c)
         return;
-    // If the Box2D body is already created, teleport immediately so gameplay logic
-    // (like switching distance checks) sees the correct position right away.
+    // If the Box2D body is already created, teleport now (applied before the next physics
+    // step) so gameplay logic like switching distance checks sees the new position right away.
     if (c->body) {
-        physics_lock();
         physics_teleport_body(c->body, x, y + c->cfg.wheel_radius + c->cfg.body_h * 0.5f);
         // Keep wheels roughly aligned with body height so suspension settles quickly
         if (c->wheel_b) {
@@ -303,7 +340,6 @@ void car_set_position(Car* c, float x, float y) {
         if (c->wheel_f) {
             physics_teleport_body(c->wheel_f, x + c->cfg.axle_offset_x_f, y + c->cfg.wheel_radius);
         }
-        physics_unlock();
         c->pending_teleport = 0;
     } else {
         c->pending_teleport = 1;
@@ -319,33 +355,21 @@ void car_get_position(const Car* c, float* x, float* y) {
             *y = 0;
         return;
     }
-    physics_lock();
-    b2Vec2 p = c->body->GetPosition();
-    if (x)
-        *x = p.x;
-    if (y)
-        *y = p.y;
-    physics_unlock();
+    physics_get_position(c->body, x, y);
 }
 
 float car_get_rear_wheel_angular_speed(const Car* c) {
     if (!c || !c->wheel_b)
         return 0.0f;
-    physics_lock();
-    // Get the angular velocity of the rear wheel in rad/s
-    float angular_speed = fabsf(c->wheel_b->GetAngularVelocity());  // absolute value for audio
-    physics_unlock();
-    return angular_speed;
+    // Angular velocity of the rear wheel in rad/s, absolute value for audio
+    return fabsf(physics_get_angular_velocity(c->wheel_b));
 }
 
 float car_get_front_wheel_angular_speed(const Car* c) {
     if (!c || !c->wheel_f)
         return 0.0f;
-    physics_lock();
-    // Get the angular velocity of the front wheel in rad/s
-    float angular_speed = fabsf(c->wheel_f->GetAngularVelocity());  // absolute value for audio
-    physics_unlock();
-    return angular_speed;
+    // Angular velocity of the front wheel in rad/s, absolute value for audio
+    return fabsf(physics_get_angular_velocity(c->wheel_f));
 }
 
 void car_apply_damage(Car* c, float dmg) {
@@ -48,11 +48,31 @@ typedef struct {
     // Pending teleport request (applied in car_fixed)
     int pending_teleport;
     float pending_tx, pending_ty;
+    // Boost exhaust emission accumulator (seconds)
+    float exhaust_timer;
+    // Textures borrowed from another car (car_init_shared); car_shutdown leaves them alone
+    bool shared_textures;
 } Car;
 
+// One tick of driver input: throttle and yaw in [-1,1] (W/S and A/D for the player)
+typedef struct {
+    float throttle;  // motor speed is cfg.motor_speed * throttle (times boost_mul when boosting)
+    float yaw;
+    bool boost;
+    bool jump;  // hop if grounded
+    bool fly;   // upward force while set
+} CarControls;
+
+CarConfig car_default_config(void);
 void car_init(Car* c);
+// Another car with the default config and its bodies resting on (x,y); textures are borrowed
+// from look (may be NULL)
+void car_init_shared(Car* c, const Car* look, float x, float y);
 void car_shutdown(Car* c);
+// Player car tick: applies a pending teleport and drives from input and abilities
 void car_fixed(Car* c, float dt);
+// Apply one tick of controls (sim thread)
+void car_drive(Car* c, const CarControls* ctl, float dt);
 void car_update(Car* c, float dt);
 void car_render(const Car* c);
 void car_set_position(Car* c, float x, float y);
@@ -4,10 +4,14 @@
 #include <stdlib.h>
 #include <string.h>
 #include "../input.h"
+#include "../particles.h"
 #include "../physics.h"
 #include "../render/pipeline.h"
 
 static GLuint upload_subtexture_rgba8(const unsigned char* pixels, int w, int h, int stride_bytes) {
+    // Headless replay: the sheet is still sliced (frame count and size), only the upload is skipped
+    if (pipeline_get_backend() == PIPELINE_BACKEND_NONE)
+        return 0;
     // Make a tightly packed buffer if stride != w*4
     unsigned char* tmp = NULL;
     const unsigned char* src = pixels;
@@ -19,14 +23,7 @@ static GLuint upload_subtexture_rgba8(const unsigned char* pixels, int w, int h,
         }
         src = tmp;
     }
-    GLuint t;
-    glGenTextures(1, &t);
-    glBindTexture(GL_TEXTURE_2D, t);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, src);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLuint t = pipeline_texture_create(w, h, src, false);
     if (tmp)
         SDL_free(tmp);
     return t;
@@ -101,6 +98,7 @@ void human_init(Human* h) {
     h->anim_time = 0.0f;
     h->facing = 1;  // face right initially
     h->was_grounded = true;
+    h->air_time = 0.0f;
     h->jump_anim_playing = 0;
     h->jump_anim_time = 0.0f;
 
@@ -129,6 +127,8 @@ void human_init(Human* h) {
         float offset_y = -h->h * 0.5f - 1.0f;
         physics_add_sensor_box(h->body, sensor_w, sensor_h, offset_x, offset_y);
     }
+    CharacterControllerConfig ccfg = character_controller_default_config(h->w, h->h);
+    character_controller_init(&h->cc, h->body, &ccfg);
 }
 
 void human_shutdown(Human* h) {
@@ -144,7 +144,16 @@ void human_fixed(Human* h, float dt) {
     }
     int dir = input_move_dir();
     float target_vx = 50.0f * (float)dir;
-    bool grounded = physics_is_grounded(h->body);
+    character_controller_update(&h->cc, dt);
+    bool grounded = h->cc.grounded;
+
+    // Landing dust after a real fall (ignore grounded flicker on slopes)
+    if (grounded && !h->was_grounded && h->air_time > 0.2f) {
+        float px, py;
+        physics_get_position(h->body, &px, &py);
+        particles_emit(PARTICLE_DUST, px, py - h->h * 0.5f, 0.0f, 10.0f, 60.0f, 20);
+    }
+    h->air_time = grounded ? 0.0f : h->air_time + dt;
 
     // Update facing when input present
     if (dir > 0)
@@ -160,7 +169,7 @@ void human_fixed(Human* h, float dt) {
     }
     // Apply desired horizontal velocity only if not in control lock
     if (h->x_control_lock <= 0.0f) {
-        physics_set_velocity_x(h->body, target_vx);
+        character_controller_move(&h->cc, target_vx, dt);
     }
 
     // Animation selection using centralized config
@@ -210,12 +219,13 @@ void human_fixed(Human* h, float dt) {
         h->jump_anim_playing = 1;
         h->jump_anim_time = 0.0f;
         h->current_frame = (h->cfg.jump_first < h->frame_count ? h->cfg.jump_first : h->cfg.idle);
-        if (grounded) {
+        if (character_controller_try_jump(&h->cc)) {
+            // Grounded or just walked off a ledge (coyote time)
             physics_apply_impulse(h->body, 0.0f, 50000.0f);
             grounded = false;  // treat as airborne now for anim purposes
         } else {
-            int wall_dir = 0;
-            if (physics_is_touching_wall(h->body, &wall_dir) && wall_dir != 0) {
+            int wall_dir = h->cc.wall_dir;
+            if (wall_dir != 0) {
                 // Wall jump: set horizontal velocity away from wall and add vertical impulse
                 float vx, vy;
                 physics_get_velocity(h->body, &vx, &vy);
@@ -245,7 +255,7 @@ void human_render(const Human* h) {
     if (!h || h->hidden)
         return;
     float x = 0, y = 0;
-    physics_get_position(h->body, &x, &y);
+    physics_get_render_position(h->body, &x, &y);
     GLuint tex = h->frames[h->current_frame % (h->frame_count > 0 ? h->frame_count : 1)];
     // Human currently unrotated; pass 0 angle but use rotated sprite API
     pipeline_sprite_quad_rot(x, y, h->w * (float)h->facing, h->h, 0.0f, tex, 1, 1, 1, 1);
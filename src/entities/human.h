@@ -2,6 +2,7 @@
 #include <glad/gl.h>
 #include <stdbool.h>
 #include <stdint.h>
+#include "../character_controller.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -79,6 +80,7 @@ typedef struct {
     int facing;
     // Grounded state tracking for animation resets
     bool was_grounded;
+    float air_time;  // seconds airborne, for landing effects
     // Jump takeoff one-shot animation state (2 frames)
     int jump_anim_playing;   // 1 while playing the 2-frame takeoff
     float jump_anim_time;    // time accumulator for jump takeoff
@@ -87,6 +89,8 @@ typedef struct {
     // Pending teleport request to be applied in human_fixed
     int pending_teleport;
     float pending_tx, pending_ty;
+    // Movement, ground and wall state (refreshed once per fixed tick)
+    CharacterController cc;
     // Temporarily disable horizontal control after a wall jump so impulse isn't overridden
     float x_control_lock;  // seconds remaining; when >0, horizontal velocity isn't forced
     // Health
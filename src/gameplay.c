@@ -3,28 +3,27 @@
 #include <SDL3_image/SDL_image.h>
 #include <glad/gl.h>
 #include <math.h>
+#include <stdatomic.h>
 #include <string.h>
 #include "ame/audio.h"
-#include "dialogue_manager.h"
 #include "entities/car.h"
 #include "entities/human.h"
+#include "particles.h"
 #include "physics.h"
+#include "racers.h"
+#include "render/lighting.h"
 #include "render/pipeline.h"
+#include "static_sdf.h"
+#include "terrain.h"
 
 // Simple color textures
 static GLuint tex_grenade = 0, tex_mine = 0, tex_turret = 0, tex_rocket = 0;
 static GLuint tex_spawn_active = 0, tex_spawn_inactive = 0;
 static GLuint make_color_tex(unsigned char r, unsigned char g, unsigned char b) {
+    if (pipeline_get_backend() == PIPELINE_BACKEND_NONE)
+        return 0;  // headless replay
     unsigned char px[4] = {r, g, b, 255};
-    GLuint t;
-    glGenTextures(1, &t);
-    glBindTexture(GL_TEXTURE_2D, t);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, px);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    return t;
+    return pipeline_texture_create(1, 1, px, false);
 }
 
 // Audio assets
@@ -119,38 +118,160 @@ static Mine mines_[MAX_MINES];
 static Turret turrets[MAX_TURRETS];
 static Rocket rockets[MAX_ROCKETS];
 
-static void
-explosion_effect(float x, float y, float radius, float dmg, float impulse, Human* human, Car* car) {
-    // Damage and impulse to human
-    if (human && human->body) {
-        float hx, hy;
-        physics_get_position(human->body, &hx, &hy);
-        float dx = hx - x, dy = hy - y;
-        float d2 = dx * dx + dy * dy;
-        if (d2 < radius * radius) {
-            float d = sqrtf(fmaxf(d2, 1.0f));
-            float falloff = 1.0f - (d / radius);
-            human_apply_damage(human, dmg * falloff);
-            float ix = (dx / d) * impulse * falloff;
-            float iy = (dy / d) * impulse * falloff;
-            physics_apply_impulse(human->body, ix, iy);
+// Projectile bodies are pooled per archetype: every grenade and rocket slot owns a body created at
+// load and parked disabled. Spawning re-enables and teleports the slot's body and dying disables
+// it again, so spawns allocate nothing and the world's body list stays bounded.
+typedef struct {
+    const char* name;
+    float w, h, density, friction;
+    int live;        // slots in use
+    int high_water;  // most slots in use at once
+} ProjectilePool;
+
+static ProjectilePool g_grenade_pool = {"grenade", 6.0f, 6.0f, 0.5f, 0.5f, 0, 0};
+static ProjectilePool g_rocket_pool = {"rocket", 4.0f, 4.0f, 0.1f, 0.2f, 0, 0};
+
+static b2Body* pool_create_body(const ProjectilePool* p) {
+    b2Body* b = physics_create_dynamic_box(0.0f, 0.0f, p->w, p->h, p->density, p->friction);
+    physics_set_body_enabled(b, false);
+    return b;
+}
+
+static void pool_acquire(ProjectilePool* p, b2Body* b, float x, float y, float vx, float vy) {
+    physics_set_body_enabled(b, true);
+    physics_teleport_body(b, x, y);  // also clears the previous projectile's velocities
+    physics_set_velocity(b, vx, vy);
+    p->live++;
+    if (p->live > p->high_water)
+        p->high_water = p->live;
+}
+
+static void pool_release(ProjectilePool* p, b2Body* b) {
+    physics_set_body_enabled(b, false);
+    p->live--;
+}
+
+static void pools_recount(void) {
+    g_grenade_pool.live = 0;
+    for (int i = 0; i < MAX_GRENADES; i++)
+        g_grenade_pool.live += grenades[i].alive ? 1 : 0;
+    g_rocket_pool.live = 0;
+    for (int i = 0; i < MAX_ROCKETS; i++)
+        g_rocket_pool.live += rockets[i].alive ? 1 : 0;
+}
+
+// Checkpoint: the entity arrays and a physics world snapshot in one contiguous blob. Saved on the
+// first tick and whenever a new spawn point activates; restarts and deaths restore it in place.
+// Audio state and spawn progress are not part of it.
+typedef struct {
+    int alive;
+    float cut_cooldown;
+} SawState;
+
+typedef struct {
+    Grenade grenades[MAX_GRENADES];
+    Mine mines[MAX_MINES];
+    Turret turrets[MAX_TURRETS];
+    Rocket rockets[MAX_ROCKETS];
+    FuelPickup fuels[MAX_FUEL];
+    SawState saws[MAX_SAWS];
+    size_t physics_size;  // world snapshot bytes following the struct, 0 = none
+} Checkpoint;
+
+static Checkpoint* g_checkpoint = NULL;
+static size_t g_checkpoint_cap = 0;
+static bool g_checkpoint_pending = true;  // save at the start of the next tick
+static atomic_bool g_restart_requested;   // set by gameplay_restart, handled on the sim thread
+static atomic_bool g_finish_reached;      // "Trigger Finish" touched since the last poll
+static _Atomic(const char*) g_dialogue_request;  // scene of a TriggerDialogue, for the main thread
+
+static void checkpoint_save(void) {
+    size_t phys = physics_snapshot_save(NULL, 0);
+    // Retry once if bodies were created between sizing and saving
+    for (int attempt = 0; attempt < 2; attempt++) {
+        size_t need = sizeof(Checkpoint) + phys;
+        if (need > g_checkpoint_cap) {
+            Checkpoint* c = (Checkpoint*)SDL_realloc(g_checkpoint, need);
+            if (!c)
+                return;
+            g_checkpoint = c;
+            g_checkpoint_cap = need;
         }
+        phys = physics_snapshot_save(g_checkpoint + 1, g_checkpoint_cap - sizeof(Checkpoint));
+        if (phys <= g_checkpoint_cap - sizeof(Checkpoint))
+            break;
     }
-    // Damage and impulse to car
-    if (car && car->body) {
-        float cx, cy;
-        car_get_position(car, &cx, &cy);
-        float dx = cx - x, dy = cy - y;
-        float d2 = dx * dx + dy * dy;
-        if (d2 < radius * radius) {
-            float d = sqrtf(fmaxf(d2, 1.0f));
-            float falloff = 1.0f - (d / radius);
-            car_apply_damage(car, dmg * falloff);
-            float ix = (dx / d) * impulse * falloff;
-            float iy = (dy / d) * impulse * falloff;
-            physics_apply_impulse(car->body, ix, iy);
-        }
+    Checkpoint* c = g_checkpoint;
+    c->physics_size = phys <= g_checkpoint_cap - sizeof(Checkpoint) ? phys : 0;
+    memcpy(c->grenades, grenades, sizeof(grenades));
+    memcpy(c->mines, mines_, sizeof(mines_));
+    memcpy(c->turrets, turrets, sizeof(turrets));
+    memcpy(c->rockets, rockets, sizeof(rockets));
+    memcpy(c->fuels, fuels, sizeof(fuels));
+    for (int i = 0; i < MAX_SAWS; i++) {
+        c->saws[i].alive = saws[i].alive;
+        c->saws[i].cut_cooldown = saws[i].cut_cooldown;
+    }
+}
+
+static bool checkpoint_restore(void) {
+    Checkpoint* c = g_checkpoint;
+    if (!c || !c->physics_size)
+        return false;
+    if (!physics_snapshot_restore(c + 1, c->physics_size))
+        return false;
+    memcpy(grenades, c->grenades, sizeof(grenades));
+    memcpy(mines_, c->mines, sizeof(mines_));
+    memcpy(turrets, c->turrets, sizeof(turrets));
+    memcpy(rockets, c->rockets, sizeof(rockets));
+    memcpy(fuels, c->fuels, sizeof(fuels));
+    pools_recount();
+    racers_world_restored();
+    for (int i = 0; i < MAX_SAWS; i++) {
+        saws[i].alive = c->saws[i].alive;
+        saws[i].cut_cooldown = c->saws[i].cut_cooldown;
+        saws[i].cut_timer = 0.0f;
+        saws[i].cut.playing = false;
+    }
+    return true;
+}
+
+// Back to the checkpoint, then the car and human onto the active spawn with full health
+static void respawn(Human* human, Car* car) {
+    checkpoint_restore();
+    if (active_spawn < 0)
+        return;
+    float sx = spawns[active_spawn].x, sy = spawns[active_spawn].y;
+    if (car) {
+        car_set_position(car, sx, sy);
+        car->hp = car->max_hp;
+        car->fuel = car->max_fuel;
     }
+    if (human) {
+        human_set_position(human, sx, sy + 20.0f);
+        human->health.hp = human->health.max_hp;
+    }
+}
+
+#define EXPLOSION_MAX_HITS 64
+
+static void
+explosion_effect(float x, float y, float radius, float dmg, float impulse, Human* human, Car* car) {
+    // Impulse to every dynamic body in range; damage to the human and car among them
+    RadiusHit hits[EXPLOSION_MAX_HITS];
+    int n = physics_explode(x, y, radius, impulse, GAME_EXPLOSION_MAX_SPEED, hits,
+                            EXPLOSION_MAX_HITS);
+    for (int i = 0; i < n && i < EXPLOSION_MAX_HITS; i++) {
+        if (human && human->body && hits[i].body == human->body)
+            human_apply_damage(human, dmg * hits[i].falloff);
+        else if (car && car->body && hits[i].body == car->body)
+            car_apply_damage(car, dmg * hits[i].falloff);
+    }
+    terrain_carve(x, y, radius * GAME_EXPLOSION_CARVE_SCALE);
+    lighting_flash(x, y, radius * 3.0f, 1.0f, 0.6f, 0.25f, 0.35f);
+    particles_emit(PARTICLE_FIRE, x, y, 0.0f, 20.0f, radius * 4.0f, 160);
+    particles_emit(PARTICLE_SPARK, x, y, 0.0f, 60.0f, radius * 8.0f, 80);
+    particles_emit(PARTICLE_SMOKE, x, y, 0.0f, 30.0f, radius * 1.5f, 40);
     // Play explosion audio (one-shot)
     if (g_audio_ready) {
         // Find a free one-shot
@@ -179,6 +300,33 @@ explosion_effect(float x, float y, float radius, float dmg, float impulse, Human
     }
 }
 
+// Sparks thrown tangentially off a spinning saw where it meets a target
+static void saw_sparks(const Saw* s, float sx, float sy, float tx, float ty) {
+    float dx = tx - sx, dy = ty - sy;
+    float d = sqrtf(fmaxf(dx * dx + dy * dy, 1.0f));
+    float px = sx + dx / d * s->r, py = sy + dy / d * s->r;
+    float tangential = s->ang_vel * s->r;
+    particles_emit(PARTICLE_SPARK, px, py, -dy / d * tangential, dx / d * tangential,
+                   fabsf(tangential) * 0.3f + 40.0f, 24);
+}
+
+// Rays against the static world only: the baked distance field when there is one (no lock),
+// otherwise Box2D. Rays near terrain carved but not yet re-baked go to Box2D as well.
+static void static_raycast_batch(const RayQuery* rays, RaycastCallback* out, int n) {
+    if (!static_sdf_ready()) {
+        physics_raycast_batch(rays, out, n, PHYS_RAY_IGNORE_DYNAMIC);
+        return;
+    }
+    for (int i = 0; i < n; i++) {
+        if (!static_sdf_covers(rays[i].x0, rays[i].y0, rays[i].x1, rays[i].y1)) {
+            physics_raycast_batch(&rays[i], &out[i], 1, PHYS_RAY_IGNORE_DYNAMIC);
+            continue;
+        }
+        StaticSdfHit h = static_sdf_raycast(rays[i].x0, rays[i].y0, rays[i].x1, rays[i].y1);
+        out[i] = (RaycastCallback){h.hit, h.x, h.y, h.nx, h.ny, h.fraction, NULL};
+    }
+}
+
 static int first_free_grenade(void) {
     for (int i = 0; i < MAX_GRENADES; i++)
         if (!grenades[i].alive)
@@ -205,6 +353,8 @@ static int first_free_rocket(void) {
 }
 
 static GLuint load_texture_once_local(const char* filename) {
+    if (pipeline_get_backend() == PIPELINE_BACKEND_NONE)
+        return 0;
     SDL_Surface* surf = IMG_Load(filename);
     if (!surf)
         return 0;
@@ -212,15 +362,7 @@ static GLuint load_texture_once_local(const char* filename) {
     SDL_DestroySurface(surf);
     if (!conv)
         return 0;
-    GLuint tex = 0;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, conv->w, conv->h, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                 conv->pixels);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLuint tex = pipeline_texture_create(conv->w, conv->h, conv->pixels, false);
     SDL_DestroySurface(conv);
     return tex;
 }
@@ -230,6 +372,12 @@ bool gameplay_init(void) {
     memset(mines_, 0, sizeof(mines_));
     memset(turrets, 0, sizeof(turrets));
     memset(rockets, 0, sizeof(rockets));
+    for (int i = 0; i < MAX_GRENADES; i++)
+        grenades[i].body = pool_create_body(&g_grenade_pool);
+    for (int i = 0; i < MAX_ROCKETS; i++)
+        rockets[i].body = pool_create_body(&g_rocket_pool);
+    g_grenade_pool.live = g_grenade_pool.high_water = 0;
+    g_rocket_pool.live = g_rocket_pool.high_water = 0;
     tex_grenade = load_texture_once_local("assets/Cherry.png");
     tex_mine = load_texture_once_local("assets/CookieMine.png");
     tex_turret = make_color_tex(80, 160, 80);
@@ -243,6 +391,10 @@ bool gameplay_init(void) {
     memset(saws, 0, sizeof(saws));
     saw_count = 0;
     memset(fuels, 0, sizeof(fuels));
+    g_checkpoint_pending = true;
+    atomic_store(&g_restart_requested, false);
+    atomic_store(&g_finish_reached, false);
+    atomic_store(&g_dialogue_request, NULL);
     tex_fuel = make_color_tex(240, 200, 40);
     // Try to load saw texture
     tex_saw = load_texture_once_local("assets/SawBlade.png");
@@ -263,25 +415,29 @@ bool gameplay_init(void) {
 }
 
 void gameplay_shutdown(void) {
-    if (tex_grenade)
-        glDeleteTextures(1, &tex_grenade);
-    if (tex_mine)
-        glDeleteTextures(1, &tex_mine);
-    if (tex_turret)
-        glDeleteTextures(1, &tex_turret);
-    if (tex_rocket)
-        glDeleteTextures(1, &tex_rocket);
+    pipeline_texture_destroy(tex_grenade);
+    pipeline_texture_destroy(tex_mine);
+    pipeline_texture_destroy(tex_turret);
+    pipeline_texture_destroy(tex_rocket);
+    SDL_Log("projectile pools: %s high water %d/%d, %s high water %d/%d",
+            g_grenade_pool.name,
+            g_grenade_pool.high_water,
+            MAX_GRENADES,
+            g_rocket_pool.name,
+            g_rocket_pool.high_water,
+            MAX_ROCKETS);
+    SDL_free(g_checkpoint);
+    g_checkpoint = NULL;
+    g_checkpoint_cap = 0;
 }
 
 void spawn_grenade(float x, float y, float vx, float vy, float fuse_sec) {
     int i = first_free_grenade();
-    if (i < 0)
+    if (i < 0 || !grenades[i].body)
         return;
     grenades[i].alive = 1;
     grenades[i].fuse = fuse_sec > 0.0f ? fuse_sec : 2.0f;
-    b2Body* b = physics_create_dynamic_box(x, y, 6.0f, 6.0f, 0.5f, 0.5f);
-    physics_set_velocity(b, vx, vy);
-    grenades[i].body = b;
+    pool_acquire(&g_grenade_pool, grenades[i].body, x, y, vx, vy);
 }
 
 void spawn_mine(float x, float y) {
@@ -306,13 +462,11 @@ void spawn_turret(float x, float y) {
 
 void spawn_rocket(float x, float y, float vx, float vy, float life_sec) {
     int i = first_free_rocket();
-    if (i < 0)
+    if (i < 0 || !rockets[i].body)
         return;
     rockets[i].alive = 1;
     rockets[i].life = life_sec > 0.0f ? life_sec : 4.0f;
-    b2Body* b = physics_create_dynamic_box(x, y, 4.0f, 4.0f, 0.1f, 0.2f);
-    physics_set_velocity(b, vx, vy);
-    rockets[i].body = b;
+    pool_acquire(&g_rocket_pool, rockets[i].body, x, y, vx, vy);
 }
 
 static void grenade_fixed_all(Human* human, Car* car, float dt) {
@@ -324,7 +478,7 @@ static void grenade_fixed_all(Human* human, Car* car, float dt) {
             float gx = 0, gy = 0;
             physics_get_position(grenades[i].body, &gx, &gy);
             explosion_effect(gx, gy, 40.0f, GAME_GRENADE_DAMAGE, 12000.0f, human, car);
-            physics_set_body_enabled(grenades[i].body, false);
+            pool_release(&g_grenade_pool, grenades[i].body);
             grenades[i].alive = 0;
         }
     }
@@ -351,6 +505,10 @@ static void mine_fixed_all(Human* human, Car* car) {
 }
 
 static void turret_fixed_all(Human* human, Car* car, float dt) {
+    // Aim every turret that is ready, then resolve all shots as one ray batch
+    RayQuery shots[MAX_TURRETS];
+    RaycastCallback hits[MAX_TURRETS];
+    int shot_count = 0;
     for (int i = 0; i < MAX_TURRETS; i++) {
         if (!turrets[i].alive)
             continue;
@@ -387,16 +545,11 @@ static void turret_fixed_all(Human* human, Car* car, float dt) {
                 float d = sqrtf(fmaxf(dx * dx + dy * dy, 1.0f));
                 float nx = dx / d, ny = dy / d;
                 turrets[i].ang = atan2f(ny, nx);
+                lighting_flash(ox + nx * 6.0f, oy + ny * 6.0f, 60.0f, 1.0f, 0.9f, 0.5f, 0.08f);
                 // Hitscan ray (bullet)
                 float range = 400.0f;
-                RaycastCallback rc = physics_raycast(ox, oy, ox + nx * range, oy + ny * range);
-                if (rc.hit && rc.body) {
-                    if (human && rc.body == human->body) {
-                        human_apply_damage(human, GAME_TURRET_SHOT_DAMAGE);
-                    } else if (car && rc.body == car->body) {
-                        car_apply_damage(car, GAME_TURRET_SHOT_DAMAGE);
-                    }
-                }
+                shots[shot_count++] =
+                    (RayQuery){ox, oy, ox + nx * range, oy + ny * range, NULL};
             } else {
                 // No target in range; just face right
                 turrets[i].ang = 0.0f;
@@ -404,11 +557,26 @@ static void turret_fixed_all(Human* human, Car* car, float dt) {
             turrets[i].cooldown = 2.0f;  // fire every 2 seconds
         }
     }
+    if (shot_count == 0)
+        return;
+    physics_raycast_batch(shots, hits, shot_count, 0);
+    for (int i = 0; i < shot_count; i++) {
+        if (!hits[i].hit || !hits[i].body)
+            continue;
+        if (human && hits[i].body == human->body) {
+            human_apply_damage(human, GAME_TURRET_SHOT_DAMAGE);
+        } else if (car && hits[i].body == car->body) {
+            car_apply_damage(car, GAME_TURRET_SHOT_DAMAGE);
+        }
+    }
 }
 
 static void rocket_fixed_all(Human* human, Car* car, float dt) {
-    (void)human;
-    (void)car;
+    // Forward probes of the surviving rockets are cast together after the proximity checks
+    RayQuery probes[MAX_ROCKETS];
+    RaycastCallback hits[MAX_ROCKETS];
+    int probe_rocket[MAX_ROCKETS];
+    int probe_count = 0;
     for (int i = 0; i < MAX_ROCKETS; i++) {
         if (!rockets[i].alive)
             continue;
@@ -417,7 +585,7 @@ static void rocket_fixed_all(Human* human, Car* car, float dt) {
             float rx = 0, ry = 0;
             physics_get_position(rockets[i].body, &rx, &ry);
             explosion_effect(rx, ry, 35.0f, GAME_ROCKET_DAMAGE, 9000.0f, human, car);
-            physics_set_body_enabled(rockets[i].body, false);
+            pool_release(&g_rocket_pool, rockets[i].body);
             rockets[i].alive = 0;
             continue;
         }
@@ -430,7 +598,7 @@ static void rocket_fixed_all(Human* human, Car* car, float dt) {
             float dx = hx - rx, dy = hy - ry;
             if (dx * dx + dy * dy < 8.0f * 8.0f) {
                 explosion_effect(rx, ry, 35.0f, GAME_ROCKET_DAMAGE, 9000.0f, human, car);
-                physics_set_body_enabled(rockets[i].body, false);
+                pool_release(&g_rocket_pool, rockets[i].body);
                 rockets[i].alive = 0;
                 continue;
             }
@@ -441,7 +609,7 @@ static void rocket_fixed_all(Human* human, Car* car, float dt) {
             float dx = cx - rx, dy = cy - ry;
             if (dx * dx + dy * dy < 10.0f * 10.0f) {
                 explosion_effect(rx, ry, 35.0f, GAME_ROCKET_DAMAGE, 9000.0f, human, car);
-                physics_set_body_enabled(rockets[i].body, false);
+                pool_release(&g_rocket_pool, rockets[i].body);
                 rockets[i].alive = 0;
                 continue;
             }
@@ -453,12 +621,21 @@ static void rocket_fixed_all(Human* human, Car* car, float dt) {
         if (d < 1.0f)
             d = 1.0f;
         float nx = vx / d, ny = vy / d;
-        RaycastCallback rc = physics_raycast(rx, ry, rx + nx * 6.0f, ry + ny * 6.0f);
-        if (rc.hit && rc.body && rc.body != rockets[i].body) {
-            explosion_effect(rx, ry, 35.0f, GAME_ROCKET_DAMAGE, 9000.0f, human, car);
-            physics_set_body_enabled(rockets[i].body, false);
-            rockets[i].alive = 0;
-        }
+        probes[probe_count] =
+            (RayQuery){rx, ry, rx + nx * 6.0f, ry + ny * 6.0f, rockets[i].body};
+        probe_rocket[probe_count++] = i;
+    }
+    if (probe_count == 0)
+        return;
+    static_raycast_batch(probes, hits, probe_count);
+    for (int k = 0; k < probe_count; k++) {
+        if (!hits[k].hit)
+            continue;
+        int i = probe_rocket[k];
+        explosion_effect(probes[k].x0, probes[k].y0, 35.0f, GAME_ROCKET_DAMAGE, 9000.0f, human,
+                         car);
+        pool_release(&g_rocket_pool, rockets[i].body);
+        rockets[i].alive = 0;
     }
 }
 
@@ -505,6 +682,13 @@ void gameplay_spawn_saw(float x, float y, float radius) {
 }
 
 void gameplay_fixed(Human* human, Car* car, float dt) {
+    // Physics is between steps here, so the world and the entity arrays agree
+    if (atomic_exchange(&g_restart_requested, false)) {
+        respawn(human, car);
+    } else if (g_checkpoint_pending) {
+        checkpoint_save();
+        g_checkpoint_pending = false;
+    }
     // Update timers
     for (int i = 0; i < saw_count; i++) {
         if (saws[i].cut_cooldown > 0.0f)
@@ -559,6 +743,9 @@ void gameplay_fixed(Human* human, Car* car, float dt) {
                     saws[i].cut.playing = true;
                     saws[i].cut_timer = 0.085f;  // Set the timer for burst duration
                     saws[i].cut_cooldown = 0.09f;
+                    float hx, hy;
+                    human_get_position(human, &hx, &hy);
+                    saw_sparks(&saws[i], sx, sy, hx, hy);
                 }
             }
         }
@@ -591,6 +778,9 @@ void gameplay_fixed(Human* human, Car* car, float dt) {
                     saws[i].cut.playing = true;
                     saws[i].cut_timer = 0.09f;  // Set the timer for burst duration
                     saws[i].cut_cooldown = 0.09f;
+                    float cx, cy;
+                    car_get_position(car, &cx, &cy);
+                    saw_sparks(&saws[i], sx, sy, cx, cy);
                 }
             }
         }
@@ -618,8 +808,9 @@ void gameplay_fixed(Human* human, Car* car, float dt) {
         const float activate_r2 = GAME_SPAWN_ACTIVATE_RADIUS * GAME_SPAWN_ACTIVATE_RADIUS;
         for (int i = 0; i < spawn_count; i++) {
             float dx = spawns[i].x - cx, dy = spawns[i].y - cy;
-            if (dx * dx + dy * dy <= activate_r2) {
+            if (dx * dx + dy * dy <= activate_r2 && active_spawn != i) {
                 active_spawn = i;
+                g_checkpoint_pending = true;
             }
         }
     }
@@ -648,16 +839,7 @@ void gameplay_fixed(Human* human, Car* car, float dt) {
 
     // Respawn if dead
     if (((human && human->health.hp <= 0.0f) || (car && car->hp <= 0.0f)) && active_spawn >= 0) {
-        float sx = spawns[active_spawn].x, sy = spawns[active_spawn].y;
-        if (car) {
-            car_set_position(car, sx, sy);
-            car->hp = car->max_hp;
-            car->fuel = car->max_fuel;
-        }
-        if (human) {
-            human_set_position(human, sx, sy + 20.0f);
-            human->health.hp = human->health.max_hp;
-        }
+        respawn(human, car);
     }
 }
 
@@ -708,6 +890,11 @@ void gameplay_update(Human* human,
     if (g_audio_ready) {
         float listener_x = cam_x + half_w;
         float listener_y = cam_y;
+        // Occlusion rays for all live explosions go out as one batch
+        RayQuery occl[MAX_EXPLOSION_SOURCES];
+        RaycastCallback hits[MAX_EXPLOSION_SOURCES];
+        int occl_src[MAX_EXPLOSION_SOURCES];
+        int occl_count = 0;
         for (int i = 0; i < MAX_EXPLOSION_SOURCES; i++) {
             if (!g_expl_pool[i].active)
                 continue;
@@ -721,15 +908,20 @@ void gameplay_update(Human* human,
                 pan = -1.0f;
             if (pan > 1.0f)
                 pan = 1.0f;
-            RaycastCallback ray =
-                physics_raycast(g_expl_pool[i].x, g_expl_pool[i].y, listener_x, listener_y);
+            g_expl_pool[i].src.pan = pan;
+            occl[occl_count] =
+                (RayQuery){g_expl_pool[i].x, g_expl_pool[i].y, listener_x, listener_y, NULL};
+            occl_src[occl_count++] = i;
+        }
+        if (occl_count > 0)
+            static_raycast_batch(occl, hits, occl_count);
+        for (int k = 0; k < occl_count; k++) {
             float base_gain = 0.9f;
             float gain = base_gain;
-            if (ray.hit && ray.fraction < 0.98f) {
+            if (hits[k].hit && hits[k].fraction < 0.98f) {
                 gain *= 0.35f;
             }
-            g_expl_pool[i].src.pan = pan;
-            g_expl_pool[i].src.gain = gain;
+            g_expl_pool[occl_src[k]].src.gain = gain;
         }
     }
 }
@@ -741,6 +933,11 @@ void gameplay_on_trigger(const char* name, void* user) {
     if (!name)
         return;
 
+    if (SDL_strcmp(name, "Finish") == 0) {
+        atomic_store(&g_finish_reached, true);
+        return;
+    }
+
     // Dialogue start via prefix: "TriggerDialogue" with optional spaces and a scene name
     if (SDL_strncmp(name, "TriggerDialogue", 15) == 0) {
         const char* scene = name + 15;  // after prefix
@@ -749,7 +946,7 @@ void gameplay_on_trigger(const char* name, void* user) {
             scene++;
         if (scene && scene[0]) {
             SDL_Log("Trigger: starting dialogue scene '%s'", scene);
-            dialogue_start_scene(scene);
+            atomic_store(&g_dialogue_request, scene);
         } else {
             SDL_Log("TriggerDialogue missing scene name in trigger '%s'", name);
         }
@@ -827,18 +1024,76 @@ int gameplay_collect_audio_refs(AmeAudioSourceRef* out,
 }
 
 void gameplay_restart(Human* human, Car* car) {
-    if (active_spawn >= 0) {
-        float sx = spawns[active_spawn].x, sy = spawns[active_spawn].y;
-        if (car) {
-            car_set_position(car, sx, sy);
-            car->hp = car->max_hp;
-            car->fuel = car->max_fuel;
+    // The human and car are the ones passed to gameplay_fixed; the restore runs there
+    (void)human;
+    (void)car;
+    atomic_store(&g_restart_requested, true);
+}
+
+bool gameplay_finish_reached(void) {
+    return atomic_exchange(&g_finish_reached, false);
+}
+
+const char* gameplay_take_dialogue_request(void) {
+    return atomic_exchange(&g_dialogue_request, NULL);
+}
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// Field by field: the structs carry padding, audio handles and textures
+#define HASH_FIELD(h, v) fnv1a((h), &(v), sizeof(v))
+
+uint64_t gameplay_state_hash(uint64_t h, const Human* human, const Car* car) {
+    for (int i = 0; i < MAX_GRENADES; i++) {
+        h = HASH_FIELD(h, grenades[i].alive);
+        if (grenades[i].alive)
+            h = HASH_FIELD(h, grenades[i].fuse);
+    }
+    for (int i = 0; i < MAX_MINES; i++) {
+        h = HASH_FIELD(h, mines_[i].alive);
+        if (mines_[i].alive) {
+            h = HASH_FIELD(h, mines_[i].armed);
+            h = HASH_FIELD(h, mines_[i].x);
+            h = HASH_FIELD(h, mines_[i].y);
         }
-        if (human) {
-            human_set_position(human, sx, sy + 20.0f);
-            human->health.hp = human->health.max_hp;
+    }
+    for (int i = 0; i < MAX_TURRETS; i++) {
+        h = HASH_FIELD(h, turrets[i].alive);
+        if (turrets[i].alive) {
+            h = HASH_FIELD(h, turrets[i].cooldown);
+            h = HASH_FIELD(h, turrets[i].ang);
         }
     }
+    for (int i = 0; i < MAX_ROCKETS; i++) {
+        h = HASH_FIELD(h, rockets[i].alive);
+        if (rockets[i].alive)
+            h = HASH_FIELD(h, rockets[i].life);
+    }
+    for (int i = 0; i < MAX_FUEL; i++)
+        h = HASH_FIELD(h, fuels[i].alive);
+    for (int i = 0; i < spawn_count; i++)
+        h = HASH_FIELD(h, spawns[i].active);
+    h = HASH_FIELD(h, active_spawn);
+    for (int i = 0; i < saw_count; i++) {
+        h = HASH_FIELD(h, saws[i].alive);
+        h = HASH_FIELD(h, saws[i].ang_vel);
+    }
+    if (human) {
+        h = HASH_FIELD(h, human->health.hp);
+        h = HASH_FIELD(h, human->hidden);
+    }
+    if (car) {
+        h = HASH_FIELD(h, car->hp);
+        h = HASH_FIELD(h, car->fuel);
+    }
+    return h;
 }
 
 void gameplay_render(void) {
@@ -846,7 +1101,7 @@ void gameplay_render(void) {
     for (int i = 0; i < MAX_GRENADES; i++)
         if (grenades[i].alive) {
             float x = 0, y = 0;
-            physics_get_position(grenades[i].body, &x, &y);
+            physics_get_render_position(grenades[i].body, &x, &y);
             pipeline_sprite_quad_rot(x, y, 6, 6, 0, tex_grenade, 1, 1, 1, 1);
         }
     // Mines
@@ -870,8 +1125,8 @@ void gameplay_render(void) {
         if (!saws[i].alive || !saws[i].body)
             continue;
         float sx, sy;
-        physics_get_position(saws[i].body, &sx, &sy);
-        float ang = physics_get_angle(saws[i].body);
+        physics_get_render_position(saws[i].body, &sx, &sy);
+        float ang = physics_get_render_angle(saws[i].body);
         float d = saws[i].r * 2.0f;
         pipeline_sprite_quad_rot(sx, sy, d, d, ang, tex_saw, 1, 1, 1, 1);
     }
@@ -879,7 +1134,7 @@ void gameplay_render(void) {
     for (int i = 0; i < MAX_ROCKETS; i++)
         if (rockets[i].alive) {
             float x = 0, y = 0;
-            physics_get_position(rockets[i].body, &x, &y);
+            physics_get_render_position(rockets[i].body, &x, &y);
             pipeline_sprite_quad_rot(x, y, 6, 3, 0, tex_rocket, 1, 1, 1, 1);
         }
     // Fuel pickups
@@ -1,5 +1,6 @@
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -25,7 +26,7 @@ static Car g_car;
 bool gameplay_init(void);
 void gameplay_shutdown(void);
 
-// Fixed-step simulation (1000 Hz like physics thread)
+// Fixed-step simulation (sim tick, APP_TICK_HZ)
 void gameplay_fixed(Human* human, Car* car, float dt);
 // Frame update for audio panning and cleanup
 void gameplay_update(Human* human,
@@ -62,7 +63,19 @@ void gameplay_on_trigger(const char* name, void* user);
 void gameplay_add_spawn_point(float x, float y);
 
 // Restart helpers
+// Restore the last checkpoint (entities and physics bodies, saved at start and on each spawn
+// activation) and respawn at the active spawn. Safe from any thread: applied on the next tick.
 void gameplay_restart(Human* human, Car* car);
+// Time trial: true when a map "Trigger Finish" volume was touched since the last call (it keeps
+// firing while overlapped)
+bool gameplay_finish_reached(void);
+// Scene name of a TriggerDialogue touched since the last call, or NULL. Triggers fire on the sim
+// tick; the dialogue itself starts on the main thread.
+const char* gameplay_take_dialogue_request(void);
+
+// Fold the gameplay state (projectiles, mines, turrets, pickups, spawns, saws, player health and
+// fuel) into an FNV-1a hash (replay checksums). Sim thread, after the tick.
+uint64_t gameplay_state_hash(uint64_t h, const Human* human, const Car* car);
 
 // (Spike hazards handled via collider flags; no AABB registration)
 
@@ -79,6 +92,10 @@ void gameplay_restart(Human* human, Car* car);
 #define GAME_GRENADE_DAMAGE 40.0f
 #define GAME_MINE_DAMAGE 50.0f
 #define GAME_ROCKET_DAMAGE 35.0f
+// Cap on the velocity an explosion adds to any body (keeps light props and projectiles sane)
+#define GAME_EXPLOSION_MAX_SPEED 300.0f
+// Crater carved into destructible terrain, as a fraction of the explosion radius
+#define GAME_EXPLOSION_CARVE_SCALE 0.6f
 
 // Turret hitscan shot
 #define GAME_TURRET_SHOT_DAMAGE 20.0f
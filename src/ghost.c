@@ -0,0 +1,405 @@
+#include "ghost.h"
+#include <SDL3/SDL.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "config.h"
+#include "physics.h"
+#include "render/pipeline.h"
+
+#define GHOST_MAGIC "GHST"
+#define GHOST_VERSION 2
+#define GHOST_HEADER_MAX 16  // magic, version, rate, position shift, sample count varint
+#define GHOST_TOKEN_NIBBLES 11  // longest nibble varint (32 bits)
+#define GHOST_PI 3.14159265358979f
+#define GHOST_ANGLE_STEPS 65536.0f
+
+// Channels of one sample: body x, y, angle, then per wheel (back, front) its suspension offset
+// (along the body's up axis) and its angle. The along-axle offset is fixed by the wheel joint and
+// comes from CarConfig at playback.
+#define CH_COUNT 7
+#define CH_BACK_SPIN 4
+#define CH_FRONT_SPIN 6
+static const bool kChannelIsAngle[CH_COUNT] = {false, false, true, false, true, false, true};
+static const int32_t kChannelTol[CH_COUNT] = {GHOST_POS_TOL, GHOST_POS_TOL,   GHOST_ANGLE_TOL,
+                                              GHOST_POS_TOL, GHOST_WHEEL_TOL, GHOST_POS_TOL,
+                                              GHOST_WHEEL_TOL};
+
+typedef struct {
+    float v[CH_COUNT];  // world units and radians (angles unwrapped)
+} GhostPose;
+
+struct Ghost {
+    GhostPose* poses;
+    int count;
+    float hz;
+};
+
+// Predictor state shared by the encoder and the decoder: both run it on decoded values
+typedef struct {
+    int32_t prev[2][CH_COUNT];
+    uint32_t n;
+} Predictor;
+
+// dec holds the channels of this sample decoded so far: both wheels usually spin alike, so the
+// front wheel also takes the back wheel's correction
+static int32_t predict(const Predictor* p, const int32_t* dec, int c) {
+    if (p->n == 0)
+        return 0;
+    if (p->n == 1)
+        return p->prev[0][c];
+    int32_t v = 2 * p->prev[0][c] - p->prev[1][c];
+    if (c == CH_FRONT_SPIN)
+        v += dec[CH_BACK_SPIN] - (2 * p->prev[0][CH_BACK_SPIN] - p->prev[1][CH_BACK_SPIN]);
+    return v;
+}
+
+static void push(Predictor* p, const int32_t* v) {
+    memcpy(p->prev[1], p->prev[0], sizeof(p->prev[0]));
+    memcpy(p->prev[0], v, sizeof(p->prev[0]));
+    p->n++;
+}
+
+// Step a residual is quantized to: the decoded value is then within tol of the sampled one. The
+// first sample is stored exactly.
+static int32_t residual_step(const Predictor* p, int c) {
+    return p->n > 0 ? 2 * kChannelTol[c] + 1 : 1;
+}
+
+static uint32_t zigzag(int32_t v) {
+    return ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+}
+
+static int32_t unzigzag(uint32_t v) {
+    return (int32_t)(v >> 1) ^ -(int32_t)(v & 1);
+}
+
+static size_t put_varint(uint8_t* out, uint32_t v) {
+    size_t n = 0;
+    while (v >= 0x80) {
+        out[n++] = (uint8_t)(v | 0x80);
+        v >>= 7;
+    }
+    out[n++] = (uint8_t)v;
+    return n;
+}
+
+// Residual tokens are nibble varints: 3 value bits per nibble, the high bit set when more follow.
+// Most tokens are small, so they cost half a byte instead of one. nib counts nibbles.
+static void put_nibbles(uint8_t* buf, size_t* nib, uint32_t v) {
+    for (;;) {
+        uint8_t n = (uint8_t)((v & 7) | (v >= 8 ? 8 : 0));
+        if (*nib & 1)
+            buf[*nib >> 1] |= (uint8_t)(n << 4);
+        else
+            buf[*nib >> 1] = n;
+        (*nib)++;
+        if (v < 8)
+            return;
+        v >>= 3;
+    }
+}
+
+static bool get_nibbles(const uint8_t* data, size_t size, size_t* nib, uint32_t* out) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 33; shift += 3) {
+        if ((*nib >> 1) >= size)
+            return false;
+        uint8_t n = (uint8_t)((data[*nib >> 1] >> ((*nib & 1) * 4)) & 15);
+        (*nib)++;
+        v |= (uint32_t)(n & 7) << shift;
+        if (!(n & 8)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool get_varint(const uint8_t* data, size_t size, size_t* pos, uint32_t* out) {
+    uint32_t v = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (*pos >= size)
+            return false;
+        uint8_t b = data[(*pos)++];
+        v |= (uint32_t)(b & 0x7f) << shift;
+        if (!(b & 0x80)) {
+            *out = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+// Recorder. tick runs on the sim thread, take on the main thread; the mutex is only taken when a
+// sample is written (APP_GHOST_HZ), so the sim never waits on a frame.
+static struct {
+    SDL_Mutex* mtx;
+    bool recording;
+    // Microseconds: samples land exactly every 1/APP_GHOST_HZ of sim time, and the predictor
+    // sees no interval jitter
+    uint64_t time_us;
+    uint64_t next_sample_us;
+    _Atomic float published_time;
+    Predictor pred;
+    uint32_t samples;
+    uint32_t zero_run;  // zero residuals not written yet
+    uint8_t* buf;
+    size_t nibbles;  // token stream length
+    size_t cap;      // buf size in bytes
+} g_rec;
+
+static bool rec_reserve_token(void) {
+    size_t need = (g_rec.nibbles + GHOST_TOKEN_NIBBLES + 1) / 2;
+    if (need <= g_rec.cap)
+        return true;
+    size_t cap = g_rec.cap ? g_rec.cap * 2 : 4096;
+    while (cap < need)
+        cap *= 2;
+    uint8_t* buf = (uint8_t*)SDL_realloc(g_rec.buf, cap);
+    if (!buf)
+        return false;
+    g_rec.buf = buf;
+    g_rec.cap = cap;
+    return true;
+}
+
+// Token stream (nibble varints): even = a run of (t >> 1) zero residuals, odd = one quantized
+// residual, zigzag((t >> 1) + 1)
+static void rec_flush_zeros(void) {
+    if (g_rec.zero_run == 0 || !rec_reserve_token())
+        return;
+    put_nibbles(g_rec.buf, &g_rec.nibbles, g_rec.zero_run << 1);
+    g_rec.zero_run = 0;
+}
+
+static void rec_residual(int32_t r) {
+    if (r == 0) {
+        g_rec.zero_run++;
+        return;
+    }
+    rec_flush_zeros();
+    if (!rec_reserve_token())
+        return;
+    put_nibbles(g_rec.buf, &g_rec.nibbles, ((zigzag(r) - 1) << 1) | 1);
+}
+
+static void rec_sample(const Car* car) {
+    float x, y;
+    physics_get_position(car->body, &x, &y);
+    float a = physics_get_angle(car->body);
+    float ca = cosf(a), sa = sinf(a);
+    float pos_scale = (float)(1 << GHOST_POS_SHIFT);
+    float ang_scale = GHOST_ANGLE_STEPS / (2.0f * GHOST_PI);
+    float v[CH_COUNT] = {x * pos_scale, y * pos_scale, a * ang_scale};
+    b2Body* wheels[2] = {car->wheel_b, car->wheel_f};
+    for (int w = 0; w < 2; w++) {
+        float wx = x, wy = y, wa = a;
+        if (wheels[w]) {
+            physics_get_position(wheels[w], &wx, &wy);
+            wa = physics_get_angle(wheels[w]);
+        }
+        v[3 + w * 2] = (-(wx - x) * sa + (wy - y) * ca) * pos_scale;
+        v[4 + w * 2] = wa * ang_scale;
+    }
+    int32_t dec[CH_COUNT];
+    for (int c = 0; c < CH_COUNT; c++) {
+        int32_t q = (int32_t)lrintf(v[c]);
+        int32_t p = predict(&g_rec.pred, dec, c);
+        // Angles are 16 bit on the wire: the residual wraps, the decoded angle stays continuous
+        int32_t r = kChannelIsAngle[c] ? (int32_t)(int16_t)(uint16_t)(q - p) : q - p;
+        int32_t step = residual_step(&g_rec.pred, c);
+        int32_t half = step / 2;
+        int32_t qr = r >= 0 ? (r + half) / step : -((half - r) / step);
+        rec_residual(qr);
+        dec[c] = p + qr * step;
+    }
+    push(&g_rec.pred, dec);
+    g_rec.samples++;
+}
+
+bool ghost_recorder_init(void) {
+    memset(&g_rec, 0, sizeof(g_rec));
+    g_rec.mtx = SDL_CreateMutex();
+    return g_rec.mtx != NULL;
+}
+
+void ghost_recorder_shutdown(void) {
+    if (g_rec.mtx)
+        SDL_DestroyMutex(g_rec.mtx);
+    SDL_free(g_rec.buf);
+    memset(&g_rec, 0, sizeof(g_rec));
+}
+
+void ghost_record_begin(void) {
+    if (!g_rec.mtx)
+        return;
+    SDL_LockMutex(g_rec.mtx);
+    g_rec.recording = true;
+    g_rec.time_us = 0;
+    g_rec.next_sample_us = 0;
+    memset(&g_rec.pred, 0, sizeof(g_rec.pred));
+    g_rec.samples = 0;
+    g_rec.zero_run = 0;
+    g_rec.nibbles = 0;
+    SDL_UnlockMutex(g_rec.mtx);
+    atomic_store_explicit(&g_rec.published_time, 0.0f, memory_order_relaxed);
+}
+
+void ghost_record_tick(const Car* car, float dt) {
+    if (!g_rec.mtx)
+        return;
+    uint64_t dt_us = (uint64_t)lrintf(dt * 1.0e6f);
+    // Half a tick of slack: tick lengths rounded to whole microseconds (e.g. 120 Hz) must not
+    // push a sample to the next tick
+    if (g_rec.time_us + dt_us / 2 >= g_rec.next_sample_us) {
+        SDL_LockMutex(g_rec.mtx);
+        if (g_rec.recording && car && car->body)
+            rec_sample(car);
+        SDL_UnlockMutex(g_rec.mtx);
+        g_rec.next_sample_us += 1000000u / APP_GHOST_HZ;
+    }
+    g_rec.time_us += dt_us;
+    atomic_store_explicit(&g_rec.published_time, (float)(g_rec.time_us / 1.0e6),
+                          memory_order_relaxed);
+}
+
+float ghost_record_time(void) {
+    return atomic_load_explicit(&g_rec.published_time, memory_order_relaxed);
+}
+
+uint8_t* ghost_record_take(size_t* size, float* duration) {
+    if (!g_rec.mtx)
+        return NULL;
+    SDL_LockMutex(g_rec.mtx);
+    uint8_t* out = NULL;
+    if (g_rec.recording && g_rec.samples > 1) {
+        rec_flush_zeros();
+        out = (uint8_t*)SDL_malloc(GHOST_HEADER_MAX + (g_rec.nibbles + 1) / 2);
+    }
+    if (out) {
+        memcpy(out, GHOST_MAGIC, 4);
+        size_t n = 4;
+        out[n++] = GHOST_VERSION;
+        out[n++] = (uint8_t)APP_GHOST_HZ;
+        out[n++] = GHOST_POS_SHIFT;
+        n += put_varint(out + n, g_rec.samples);
+        size_t len = (g_rec.nibbles + 1) / 2;
+        memcpy(out + n, g_rec.buf, len);
+        *size = n + len;
+        *duration = (float)(g_rec.samples - 1) / (float)APP_GHOST_HZ;
+    }
+    g_rec.recording = false;
+    SDL_UnlockMutex(g_rec.mtx);
+    return out;
+}
+
+Ghost* ghost_decode(const uint8_t* data, size_t size) {
+    if (!data || size < 8 || memcmp(data, GHOST_MAGIC, 4) != 0 || data[4] != GHOST_VERSION)
+        return NULL;
+    float hz = (float)data[5];
+    int shift = data[6];
+    size_t pos = 7;
+    uint32_t count = 0;
+    if (hz <= 0.0f || !get_varint(data, size, &pos, &count) || count < 2)
+        return NULL;
+    Ghost* g = (Ghost*)SDL_calloc(1, sizeof(Ghost));
+    if (!g)
+        return NULL;
+    g->poses = (GhostPose*)SDL_malloc((size_t)count * sizeof(GhostPose));
+    if (!g->poses) {
+        SDL_free(g);
+        return NULL;
+    }
+    g->hz = hz;
+    float pos_scale = 1.0f / (float)(1 << shift);
+    float ang_scale = 2.0f * GHOST_PI / GHOST_ANGLE_STEPS;
+    Predictor pred;
+    memset(&pred, 0, sizeof(pred));
+    uint32_t zeros = 0;
+    size_t nib = pos * 2;
+    for (uint32_t i = 0; i < count; i++) {
+        int32_t dec[CH_COUNT];
+        for (int c = 0; c < CH_COUNT; c++) {
+            int32_t r = 0;
+            if (zeros > 0) {
+                zeros--;
+            } else {
+                uint32_t t;
+                if (!get_nibbles(data, size, &nib, &t) || t == 0) {
+                    ghost_free(g);
+                    return NULL;
+                }
+                if (t & 1)
+                    r = unzigzag((t >> 1) + 1);
+                else
+                    zeros = (t >> 1) - 1;
+            }
+            int32_t p = predict(&pred, dec, c);
+            dec[c] = p + r * residual_step(&pred, c);
+            g->poses[i].v[c] = (float)dec[c] * (kChannelIsAngle[c] ? ang_scale : pos_scale);
+        }
+        push(&pred, dec);
+    }
+    g->count = (int)count;
+    return g;
+}
+
+Ghost* ghost_load(const char* path) {
+    size_t size = 0;
+    uint8_t* data = (uint8_t*)SDL_LoadFile(path, &size);
+    if (!data)
+        return NULL;
+    Ghost* g = ghost_decode(data, size);
+    if (!g)
+        SDL_Log("ghost: %s is not a ghost stream", path);
+    SDL_free(data);
+    return g;
+}
+
+void ghost_free(Ghost* g) {
+    if (!g)
+        return;
+    SDL_free(g->poses);
+    SDL_free(g);
+}
+
+float ghost_duration(const Ghost* g) {
+    return g ? (float)(g->count - 1) / g->hz : 0.0f;
+}
+
+static float catmull_rom(float p0, float p1, float p2, float p3, float t) {
+    float t2 = t * t, t3 = t2 * t;
+    return 0.5f * (2.0f * p1 + (p2 - p0) * t + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * t2 +
+                   (3.0f * p1 - p0 - 3.0f * p2 + p3) * t3);
+}
+
+void ghost_render(const Ghost* g, float t, const Car* look, float alpha) {
+    if (!g || !look || t < 0.0f || t > ghost_duration(g))
+        return;
+    float f = t * g->hz;
+    int i = (int)f;
+    if (i > g->count - 2)
+        i = g->count - 2;
+    float u = f - (float)i;
+    const GhostPose* p0 = &g->poses[i > 0 ? i - 1 : 0];
+    const GhostPose* p1 = &g->poses[i];
+    const GhostPose* p2 = &g->poses[i + 1];
+    const GhostPose* p3 = &g->poses[i + 2 < g->count ? i + 2 : i + 1];
+    float v[CH_COUNT];
+    for (int c = 0; c < CH_COUNT; c++) {
+        v[c] = catmull_rom(p0->v[c], p1->v[c], p2->v[c], p3->v[c], u);
+    }
+    pipeline_sprite_quad_rot(v[0], v[1], look->cfg.body_w, look->cfg.body_h, v[2], look->tex_body,
+                             APP_GHOST_TINT_R, APP_GHOST_TINT_G, APP_GHOST_TINT_B, alpha);
+    float ca = cosf(v[2]), sa = sinf(v[2]);
+    float d = look->cfg.wheel_radius * 2.0f;
+    float axle[2] = {-look->cfg.axle_offset_x_b, look->cfg.axle_offset_x_f};
+    for (int w = 0; w < 2; w++) {
+        const float* wv = &v[3 + w * 2];
+        float wx = v[0] + axle[w] * ca - wv[0] * sa;
+        float wy = v[1] + axle[w] * sa + wv[0] * ca;
+        pipeline_sprite_quad_rot(wx, wy, d, d, wv[1], look->tex_wheel, APP_GHOST_TINT_R,
+                                 APP_GHOST_TINT_G, APP_GHOST_TINT_B, alpha);
+    }
+}
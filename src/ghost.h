@@ -0,0 +1,48 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "entities/car.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Ghost cars for time trials. The recorder samples the car body and both wheels from the physics
+// snapshot at APP_GHOST_HZ and encodes them as a quantized stream: fixed-point body position,
+// 16-bit angles and, per wheel, only its suspension travel (the along-axle offset is fixed by the
+// wheel joint and taken from CarConfig when drawn). Each value is predicted from the two before it
+// (constant velocity) and the residual is quantized to the channel tolerance (the prediction runs
+// on the decoded values, so the error never builds up). Residuals are nibble varints and runs of
+// zero residuals collapse into one, so steady motion costs next to nothing.
+// Playback decodes a stream once into poses and draws a ghost as three tinted sprites,
+// interpolated (Catmull-Rom) between samples. No Box2D, no per-ghost state: a ghost is a lookup.
+
+#define GHOST_POS_SHIFT 3     // positions in 1/8 world units
+#define GHOST_POS_TOL 1       // max error in position steps (residuals quantized to 2 * tol + 1)
+#define GHOST_ANGLE_TOL 24    // ... body angle steps (65536 per turn, ~0.13 degrees)
+#define GHOST_WHEEL_TOL 256   // ... wheel spin angle steps (~1.4 degrees)
+
+typedef struct Ghost Ghost;
+
+// Run clock and recorder. begin/tick on the sim thread; the clock restarts on every begin.
+bool ghost_recorder_init(void);
+void ghost_recorder_shutdown(void);
+void ghost_record_begin(void);
+void ghost_record_tick(const Car* car, float dt);
+// Any thread: seconds since the last begin (the time to draw ghosts at)
+float ghost_record_time(void);
+// Main thread: stop recording and take the encoded stream (SDL_free it) and its length in
+// seconds. NULL when nothing is being recorded. The run clock keeps going.
+uint8_t* ghost_record_take(size_t* size, float* duration);
+
+Ghost* ghost_decode(const uint8_t* data, size_t size);
+Ghost* ghost_load(const char* path);
+void ghost_free(Ghost* g);
+float ghost_duration(const Ghost* g);
+// Main thread, between pipeline begin/end: draw g at run time t with the sprites and sizes of
+// look. Nothing is drawn outside [0, duration].
+void ghost_render(const Ghost* g, float t, const Car* look, float alpha);
+
+#ifdef __cplusplus
+}
+#endif
@@ -25,6 +25,10 @@ static _Atomic int prev_e = 0, prev_ins = 0;
 static _Atomic int edge_g = 0, edge_m = 0, edge_t = 0, edge_r = 0;
 static _Atomic int prev_g = 0, prev_m = 0, prev_t = 0, prev_r = 0;
 
+// Frame override (sim thread only): getters read it instead of the devices while set
+static bool g_frame_set = false;
+static InputFrame g_frame;
+
 static void on_input(const struct ni_event* ev, void* ud) {
     (void)ud;
     if (ev->type != NI_EV_KEY)
@@ -177,36 +181,61 @@ void input_update(void) {
 }
 
 // Left/Right for human walking
-int input_move_dir(void) {
+static int device_move_dir(void) {
     int r = (atomic_load(&a_right) || atomic_load(&a_d)) ? 1 : 0;
     int l = (atomic_load(&a_left) || atomic_load(&a_a)) ? 1 : 0;
     return r - l;
 }
 
 // W/S for car acceleration (S = -1, W = +1)
-int input_accel_dir(void) {
+static int device_accel_dir(void) {
     int up = atomic_load(&a_w) ? 1 : 0;
     int dn = atomic_load(&a_s) ? 1 : 0;
     return up - dn;
 }
 
 // A/D for car yaw (A = -1, D = +1)
-int input_yaw_dir(void) {
+static int device_yaw_dir(void) {
     int rr = atomic_load(&a_d) ? 1 : 0;
     int ll = atomic_load(&a_a) ? 1 : 0;
     return rr - ll;
 }
 
+// Edge of the override frame, reported once
+static bool frame_edge(uint8_t bit) {
+    bool e = (g_frame.buttons & bit) != 0;
+    g_frame.buttons &= (uint8_t)~bit;
+    return e;
+}
+
+int input_move_dir(void) {
+    return g_frame_set ? g_frame.move : device_move_dir();
+}
+int input_accel_dir(void) {
+    return g_frame_set ? g_frame.accel : device_accel_dir();
+}
+int input_yaw_dir(void) {
+    return g_frame_set ? g_frame.yaw : device_yaw_dir();
+}
+
 bool input_jump_edge(void) {
+    if (g_frame_set)
+        return frame_edge(INPUT_BTN_JUMP_EDGE);
     return atomic_exchange(&edge_jump, 0) != 0;
 }
 bool input_jump_down(void) {
+    if (g_frame_set)
+        return (g_frame.buttons & INPUT_BTN_JUMP) != 0;
     return atomic_load(&a_space) != 0;
 }
 bool input_boost_down(void) {
+    if (g_frame_set)
+        return (g_frame.buttons & INPUT_BTN_BOOST) != 0;
     return atomic_load(&a_shift) != 0;
 }
 bool input_pressed_switch(void) {
+    if (g_frame_set)
+        return frame_edge(INPUT_BTN_SWITCH_EDGE);
     return atomic_exchange(&edge_switch, 0) != 0;
 }
 bool input_quit_requested(void) {
@@ -222,6 +251,34 @@ bool input_choice_edge(int index_1_to_9) {
 }
 
 bool input_restart_edge(void) {
+    if (g_frame_set)
+        return frame_edge(INPUT_BTN_RESTART_EDGE);
     return atomic_exchange(&edge_r, 0) != 0;
 }
 
+void input_capture_frame(InputFrame* out) {
+    if (!out)
+        return;
+    out->move = (int8_t)device_move_dir();
+    out->accel = (int8_t)device_accel_dir();
+    out->yaw = (int8_t)device_yaw_dir();
+    uint8_t b = 0;
+    if (atomic_load(&a_space))
+        b |= INPUT_BTN_JUMP;
+    if (atomic_load(&a_shift))
+        b |= INPUT_BTN_BOOST;
+    if (atomic_exchange(&edge_jump, 0))
+        b |= INPUT_BTN_JUMP_EDGE;
+    if (atomic_exchange(&edge_switch, 0))
+        b |= INPUT_BTN_SWITCH_EDGE;
+    if (atomic_exchange(&edge_r, 0))
+        b |= INPUT_BTN_RESTART_EDGE;
+    out->buttons = b;
+}
+
+void input_set_frame(const InputFrame* frame) {
+    g_frame_set = frame != NULL;
+    if (frame)
+        g_frame = *frame;
+}
+
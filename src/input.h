@@ -1,5 +1,6 @@
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -26,6 +27,23 @@ bool input_choice_edge(int index_1_to_9);  // Number keys 1..9 edge
 // Misc
 bool input_restart_edge(void);  // R key edge
 
+// Per-tick input as the simulation sees it (recorded and replayed by replay.h)
+#define INPUT_BTN_JUMP (1 << 0)  // held
+#define INPUT_BTN_BOOST (1 << 1)  // held
+#define INPUT_BTN_JUMP_EDGE (1 << 2)
+#define INPUT_BTN_SWITCH_EDGE (1 << 3)
+#define INPUT_BTN_RESTART_EDGE (1 << 4)
+typedef struct {
+    int8_t move, accel, yaw;  // -1,0,1 as the getters above
+    uint8_t buttons;          // INPUT_BTN_*
+} InputFrame;
+
+// Sim thread: latch the device state for this tick, consuming the jump, switch and restart edges
+void input_capture_frame(InputFrame* out);
+// Sim thread: the movement, jump, boost, switch and restart getters report frame (each edge once)
+// instead of the devices, until the next call; NULL returns them to the devices
+void input_set_frame(const InputFrame* frame);
+
 #ifdef __cplusplus
 }
 #endif
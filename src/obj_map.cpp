@@ -16,11 +16,14 @@ Prefixes:
 - "EdgeCollider"        -> Static edge from the first two vertices
 - "ChainCollider[Loop|Closed]" -> Static chain from all vertices; closed if name contains
 Loop/Closed
-- "MeshCollider"        -> Static triangle mesh collider from the shape's triangles
+- "MeshCollider"        -> Static mesh collider from the shape's triangles (merged into convex
+polygons or boundary chains at load, see APP_COLLIDER_* in config.h)
 
 Tags (substring anywhere in name):
 - "Saw"                 -> Spawns a saw (radius from shape size). Visual mesh not used.
 - "Spike"               -> Marks triangles as spike colliders; still contributes to visual mesh.
+- "Destructible"        -> Solid, visible terrain carved by explosions at runtime (terrain.h);
+drawn by the terrain chunks instead of the map mesh. Combines with "Spike".
 */
 #include "obj_map.h"
 #include <SDL3/SDL.h>
@@ -29,8 +32,11 @@ Tags (substring anywhere in name):
 #include <cstring>
 #include <string>
 #include <vector>
+#include "collider_opt.h"
+#include "config.h"
 #include "gameplay.h"
 #include "physics.h"
+#include "terrain.h"
 #include "triggers.h"
 #define TINYOBJLOADER_IMPLEMENTATION
 #include "tiny_obj_loader.h"
@@ -42,6 +48,52 @@ static bool has_tag(const std::string& s, const char* t) {
     return s.find(t) != std::string::npos;
 }
 
+// Mesh colliders go through the collider optimizer: triangles merged into convex polygons and,
+// when enabled for untagged meshes, the boundary added as chain loops instead of solid fixtures
+static void create_mesh_collider(const std::string& name,
+                                 const std::vector<float>& tri,
+                                 int flags,
+                                 int* total_in,
+                                 int* total_out) {
+    int vertex_count = (int)(tri.size() / 2);
+#if APP_COLLIDER_MERGE
+    ColliderOptConfig oc = collider_opt_default_config();
+    oc.weld_eps = APP_COLLIDER_WELD_EPS;
+    oc.boundary_loops = APP_COLLIDER_CHAINS && flags == 0;
+    ColliderOptMesh m;
+    if (collider_opt_build(tri.data(), vertex_count, &oc, &m)) {
+        int fixtures = 0;
+        if (oc.boundary_loops) {
+            const float* loop = m.xy;
+            for (int i = 0; i < m.poly_count; i++) {
+                loop += (size_t)m.poly_counts[i] * 2;
+            }
+            for (int i = 0; i < m.loop_count; i++) {
+                physics_create_static_chain(loop, m.loop_counts[i], true, 0.8f);
+                loop += (size_t)m.loop_counts[i] * 2;
+            }
+            fixtures = m.loop_count;
+        } else {
+            fixtures = physics_create_static_polygons(m.xy, m.poly_counts, m.poly_count, 0.8f,
+                                                      flags);
+        }
+        SDL_Log("OBJ map: %s: %d triangles -> %d %s (%d degenerate dropped)", name.c_str(),
+                m.stats.triangles_in, fixtures, oc.boundary_loops ? "chain loops" : "polygons",
+                m.stats.triangles_dropped);
+        *total_in += m.stats.triangles_in;
+        *total_out += fixtures;
+        collider_opt_free(&m);
+        return;
+    }
+    collider_opt_free(&m);
+#else
+    (void)name;
+#endif
+    physics_create_static_mesh_triangles_tagged(tri.data(), vertex_count, 0.8f, flags);
+    *total_in += vertex_count / 3;
+    *total_out += vertex_count / 3;
+}
+
 static std::string dirname_from_path(const char* path) {
     if (!path)
         return std::string();
@@ -52,6 +104,8 @@ static std::string dirname_from_path(const char* path) {
 }
 
 static GLuint load_texture_absolute(const char* filename) {
+    if (pipeline_get_backend() == PIPELINE_BACKEND_NONE)
+        return 0;  // headless replay
     SDL_Surface* surf = IMG_Load(filename);
     if (!surf)
         return 0;
@@ -59,15 +113,7 @@ static GLuint load_texture_absolute(const char* filename) {
     SDL_DestroySurface(surf);
     if (!conv)
         return 0;
-    GLuint tex = 0;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, conv->w, conv->h, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                 conv->pixels);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLuint tex = pipeline_texture_create(conv->w, conv->h, conv->pixels, true);
     SDL_DestroySurface(conv);
     return tex;
 }
@@ -93,6 +139,7 @@ bool load_obj_map(const char* path, AmeLocalMesh* out_mesh) {
     std::vector<float> uvs;
     vis.reserve(1024);
     uvs.reserve(1024);
+    int collider_tris = 0, collider_fixtures = 0;
 
     for (const auto& sh : shapes) {
         std::string name = sh.name;
@@ -138,7 +185,9 @@ bool load_obj_map(const char* path, AmeLocalMesh* out_mesh) {
             // Not once: can keep firing when overlapped
             // Duplicate name to keep it valid beyond this function
             char* trig_copy = SDL_strdup(trig_name.c_str());
-            triggers_add(trig_copy ? trig_copy : trig_name.c_str(), box, 1, gameplay_on_trigger,
+            // The finish line keeps firing: every restart is a new time-trial attempt
+            int once = trig_name != "Finish";
+            triggers_add(trig_copy ? trig_copy : trig_name.c_str(), box, once, gameplay_on_trigger,
                          (void*)u);
             continue;
         }
@@ -196,6 +245,24 @@ bool load_obj_map(const char* path, AmeLocalMesh* out_mesh) {
             gameplay_add_spawn_point(cx, cy);
             continue;
         }
+        if (has_tag(name, "Destructible")) {
+            std::vector<float> xyz, uv;
+            xyz.reserve(sh.mesh.indices.size() * 3);
+            uv.reserve(sh.mesh.indices.size() * 2);
+            for (const auto& idx : sh.mesh.indices) {
+                size_t vi = size_t(idx.vertex_index) * 3;
+                xyz.push_back(attrib.vertices[vi + 0]);
+                xyz.push_back(attrib.vertices[vi + 1]);
+                xyz.push_back(attrib.vertices[vi + 2]);
+                size_t ti = size_t(idx.texcoord_index) * 2;
+                bool has_uv = idx.texcoord_index >= 0 && attrib.texcoords.size() > ti + 1;
+                uv.push_back(has_uv ? attrib.texcoords[ti + 0] : 0.0f);
+                uv.push_back(has_uv ? attrib.texcoords[ti + 1] : 0.0f);
+            }
+            terrain_add_region(xyz.data(), uv.data(), (int)(xyz.size() / 3),
+                               has_tag(name, "Spike") ? PHYS_FLAG_SPIKE : 0);
+            continue;
+        }
         if (has_tag(name, "Saw") || has_tag(name, "Spike")) {
             float cx = 0.5f * (minx + maxx);
             float cy = 0.5f * (miny + maxy);
@@ -211,8 +278,8 @@ bool load_obj_map(const char* path, AmeLocalMesh* out_mesh) {
                         tri.push_back(xs[i]);
                         tri.push_back(ys[i]);
                     }
-                    physics_create_static_mesh_triangles_tagged(tri.data(), (int)xs.size(), 0.8f,
-                                                                PHYS_FLAG_SPIKE);
+                    create_mesh_collider(name, tri, PHYS_FLAG_SPIKE, &collider_tris,
+                                         &collider_fixtures);
                 }
                 // do not continue; allow visual geometry accumulation
             } else {
@@ -266,7 +333,7 @@ bool load_obj_map(const char* path, AmeLocalMesh* out_mesh) {
                     tri.push_back(xs[i]);
                     tri.push_back(ys[i]);
                 }
-                physics_create_static_mesh_triangles(tri.data(), (int)xs.size(), 0.8f);
+                create_mesh_collider(name, tri, 0, &collider_tris, &collider_fixtures);
             }
             continue;
         }
@@ -320,6 +387,12 @@ bool load_obj_map(const char* path, AmeLocalMesh* out_mesh) {
         }
     }
 
+    terrain_set_texture(map_tex);
+
+    if (collider_tris > 0)
+        SDL_Log("OBJ map: mesh colliders: %d triangles -> %d fixtures", collider_tris,
+                collider_fixtures);
+
     if (out_mesh && !vis.empty()) {
         float* pos = (float*)malloc(vis.size() * sizeof(float));
         memcpy(pos, vis.data(), vis.size() * sizeof(float));
@@ -332,6 +405,15 @@ bool load_obj_map(const char* path, AmeLocalMesh* out_mesh) {
             out_mesh->uv = uv;
         }
         out_mesh->texture = map_tex;  // 0 if none loaded; pipeline will fallback to white
+        // SoA copy of positions for contiguous loads in the mesh transform kernel
+        size_t n = out_mesh->count;
+        float* soa = (float*)malloc(n * 3 * sizeof(float));
+        for (size_t i = 0; i < n; i++) {
+            soa[i] = pos[i * 3 + 0];
+            soa[n + i] = pos[i * 3 + 1];
+            soa[2 * n + i] = pos[i * 3 + 2];
+        }
+        out_mesh->pos_soa = soa;
     }
     return true;
 }
@@ -341,11 +423,11 @@ void free_obj_map(AmeLocalMesh* mesh) {
         return;
     free(mesh->pos);
     free(mesh->uv);
-    if (mesh->texture) {
-        glDeleteTextures(1, &mesh->texture);
-    }
+    free(mesh->pos_soa);
+    pipeline_texture_destroy(mesh->texture);
     mesh->pos = nullptr;
     mesh->uv = nullptr;
+    mesh->pos_soa = nullptr;
     mesh->texture = 0;
     mesh->count = 0;
 }
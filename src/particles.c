@@ -0,0 +1,350 @@
+#include "particles.h"
+#include <SDL3/SDL.h>
+#include <glad/gl.h>
+#include <math.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "render/pipeline.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLES_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define PARTICLES_NEON 1
+#include <arm_neon.h>
+#endif
+
+#define PARTICLE_MAX_EMITS 1024  // queued bursts between two updates
+#define PARTICLE_TEX_SIZE 16
+
+typedef struct {
+    int capacity;
+    float gravity;              // world units / s^2 (Y-up)
+    float drag;                 // velocity decay rate per second
+    float life_min, life_max;   // seconds
+    float size_birth, size_death;
+    unsigned char col_birth[4];
+    unsigned char col_death[4];
+} ParticleTypeDesc;
+
+// capacity, gravity, drag, life range, size birth/death, color birth/death
+static const ParticleTypeDesc kTypes[PARTICLE_TYPE_COUNT] = {
+    [PARTICLE_SMOKE] = {16384, 25.0f, 1.5f, 0.8f, 1.6f, 6.0f, 18.0f,
+                        {90, 90, 90, 160}, {60, 60, 60, 0}},
+    [PARTICLE_DUST] = {8192, -60.0f, 4.0f, 0.3f, 0.6f, 3.0f, 7.0f,
+                       {170, 150, 120, 200}, {150, 130, 110, 0}},
+    [PARTICLE_EXHAUST] = {16384, 15.0f, 3.0f, 0.25f, 0.5f, 2.5f, 8.0f,
+                          {120, 170, 255, 220}, {80, 80, 90, 0}},
+    [PARTICLE_FIRE] = {32768, 40.0f, 3.5f, 0.2f, 0.5f, 7.0f, 2.0f,
+                       {255, 230, 120, 255}, {200, 50, 10, 0}},
+    [PARTICLE_SPARK] = {32768, -220.0f, 0.8f, 0.15f, 0.45f, 1.5f, 1.0f,
+                        {255, 250, 200, 255}, {255, 120, 20, 0}},
+};
+
+// SoA pool: life counts down to 0, inv_life = 1 / initial life
+typedef struct {
+    float* x;
+    float* y;
+    float* vx;
+    float* vy;
+    float* life;
+    float* inv_life;
+    int count;
+} ParticlePool;
+
+typedef struct {
+    ParticleType type;
+    float x, y, vx, vy, spread;
+    int count;
+} ParticleEmit;
+
+static ParticlePool g_pools[PARTICLE_TYPE_COUNT];
+
+// Emission queue (any thread)
+static SDL_Mutex* g_emit_mtx = NULL;
+static ParticleEmit g_emits[PARTICLE_MAX_EMITS];
+static int g_emit_count = 0;
+static ParticleEmit g_emits_local[PARTICLE_MAX_EMITS];  // worker-owned copy
+
+// Worker handshake: main posts g_kick, worker posts g_done
+static SDL_Thread* g_worker = NULL;
+static SDL_Semaphore* g_kick = NULL;
+static SDL_Semaphore* g_done = NULL;
+static atomic_bool g_quit = false;
+static bool g_in_flight = false;
+static float g_step_dt = 0.0f;
+
+// Render output written by the worker, read by the main thread after g_done
+static PipelineInstance* g_instances = NULL;
+static int g_instance_count = 0;
+static atomic_int g_live = 0;
+
+static GLuint g_tex = 0;
+static uint32_t g_rng = 0x9E3779B9u;
+
+static inline float frand(void) {
+    // xorshift32, worker thread only
+    g_rng ^= g_rng << 13;
+    g_rng ^= g_rng >> 17;
+    g_rng ^= g_rng << 5;
+    return (float)(g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static GLuint make_soft_dot_texture(void) {
+    unsigned char px[PARTICLE_TEX_SIZE * PARTICLE_TEX_SIZE * 4];
+    for (int y = 0; y < PARTICLE_TEX_SIZE; y++) {
+        for (int x = 0; x < PARTICLE_TEX_SIZE; x++) {
+            float dx = ((float)x + 0.5f) / PARTICLE_TEX_SIZE * 2.0f - 1.0f;
+            float dy = ((float)y + 0.5f) / PARTICLE_TEX_SIZE * 2.0f - 1.0f;
+            float a = 1.0f - sqrtf(dx * dx + dy * dy);
+            a = a < 0.0f ? 0.0f : a;
+            unsigned char* p = px + (y * PARTICLE_TEX_SIZE + x) * 4;
+            p[0] = p[1] = p[2] = 255;
+            p[3] = (unsigned char)(fminf(a * 1.5f, 1.0f) * 255.0f);
+        }
+    }
+    return pipeline_texture_create(PARTICLE_TEX_SIZE, PARTICLE_TEX_SIZE, px, true);
+}
+
+// Simulation (worker thread) ------------------------------------------------------------------
+
+static void spawn(const ParticleEmit* e) {
+    const ParticleTypeDesc* d = &kTypes[e->type];
+    ParticlePool* p = &g_pools[e->type];
+    int n = e->count;
+    if (n > d->capacity - p->count)
+        n = d->capacity - p->count;
+    for (int k = 0; k < n; k++) {
+        int i = p->count++;
+        float a = frand() * 6.2831853f;
+        float s = e->spread * sqrtf(frand());
+        float life = d->life_min + (d->life_max - d->life_min) * frand();
+        p->x[i] = e->x;
+        p->y[i] = e->y;
+        p->vx[i] = e->vx + cosf(a) * s;
+        p->vy[i] = e->vy + sinf(a) * s;
+        p->life[i] = life;
+        p->inv_life[i] = 1.0f / life;
+    }
+}
+
+// v *= decay; vy += g*dt; p += v*dt; life -= dt
+static void integrate(ParticlePool* p, float dt, float decay, float gdt) {
+    int n = p->count;
+    int i = 0;
+#if defined(PARTICLES_SSE2)
+    const __m128 vdt = _mm_set1_ps(dt), vdecay = _mm_set1_ps(decay), vg = _mm_set1_ps(gdt);
+    for (; i + 4 <= n; i += 4) {
+        __m128 vx = _mm_mul_ps(_mm_loadu_ps(p->vx + i), vdecay);
+        __m128 vy = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(p->vy + i), vdecay), vg);
+        _mm_storeu_ps(p->vx + i, vx);
+        _mm_storeu_ps(p->vy + i, vy);
+        _mm_storeu_ps(p->x + i, _mm_add_ps(_mm_loadu_ps(p->x + i), _mm_mul_ps(vx, vdt)));
+        _mm_storeu_ps(p->y + i, _mm_add_ps(_mm_loadu_ps(p->y + i), _mm_mul_ps(vy, vdt)));
+        _mm_storeu_ps(p->life + i, _mm_sub_ps(_mm_loadu_ps(p->life + i), vdt));
+    }
+#elif defined(PARTICLES_NEON)
+    const float32x4_t vdt = vdupq_n_f32(dt), vg = vdupq_n_f32(gdt);
+    for (; i + 4 <= n; i += 4) {
+        float32x4_t vx = vmulq_n_f32(vld1q_f32(p->vx + i), decay);
+        float32x4_t vy = vaddq_f32(vmulq_n_f32(vld1q_f32(p->vy + i), decay), vg);
+        vst1q_f32(p->vx + i, vx);
+        vst1q_f32(p->vy + i, vy);
+        vst1q_f32(p->x + i, vaddq_f32(vld1q_f32(p->x + i), vmulq_f32(vx, vdt)));
+        vst1q_f32(p->y + i, vaddq_f32(vld1q_f32(p->y + i), vmulq_f32(vy, vdt)));
+        vst1q_f32(p->life + i, vsubq_f32(vld1q_f32(p->life + i), vdt));
+    }
+#endif
+    for (; i < n; i++) {
+        p->vx[i] *= decay;
+        p->vy[i] = p->vy[i] * decay + gdt;
+        p->x[i] += p->vx[i] * dt;
+        p->y[i] += p->vy[i] * dt;
+        p->life[i] -= dt;
+    }
+}
+
+// Swap-remove dead particles (order within a pool does not matter)
+static void compact(ParticlePool* p) {
+    int i = 0;
+    while (i < p->count) {
+        if (p->life[i] > 0.0f) {
+            i++;
+            continue;
+        }
+        int last = --p->count;
+        p->x[i] = p->x[last];
+        p->y[i] = p->y[last];
+        p->vx[i] = p->vx[last];
+        p->vy[i] = p->vy[last];
+        p->life[i] = p->life[last];
+        p->inv_life[i] = p->inv_life[last];
+    }
+}
+
+static inline unsigned int lerp_rgba(const unsigned char* a, const unsigned char* b, float t) {
+    // t = 1 at birth (a), 0 at death (b)
+    unsigned int out = 0;
+    for (int c = 0; c < 4; c++) {
+        float v = (float)b[c] + ((float)a[c] - (float)b[c]) * t;
+        out |= (unsigned int)(v + 0.5f) << (c * 8);
+    }
+    return out;
+}
+
+static void write_instances(void) {
+    int n = 0;
+    for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+        const ParticleTypeDesc* d = &kTypes[t];
+        const ParticlePool* p = &g_pools[t];
+        for (int i = 0; i < p->count; i++) {
+            float f = p->life[i] * p->inv_life[i];
+            PipelineInstance* o = &g_instances[n++];
+            o->x = p->x[i];
+            o->y = p->y[i];
+            o->size = d->size_death + (d->size_birth - d->size_death) * f;
+            o->rgba = lerp_rgba(d->col_birth, d->col_death, f);
+        }
+    }
+    g_instance_count = n;
+    atomic_store(&g_live, n);
+}
+
+static void step(float dt) {
+    SDL_LockMutex(g_emit_mtx);
+    int ne = g_emit_count;
+    memcpy(g_emits_local, g_emits, (size_t)ne * sizeof(ParticleEmit));
+    g_emit_count = 0;
+    SDL_UnlockMutex(g_emit_mtx);
+
+    for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+        const ParticleTypeDesc* d = &kTypes[t];
+        integrate(&g_pools[t], dt, expf(-d->drag * dt), d->gravity * dt);
+        compact(&g_pools[t]);
+    }
+    for (int i = 0; i < ne; i++) {
+        spawn(&g_emits_local[i]);
+    }
+    write_instances();
+}
+
+static int particles_worker(void* ud) {
+    (void)ud;
+    for (;;) {
+        SDL_WaitSemaphore(g_kick);
+        if (atomic_load(&g_quit))
+            break;
+        step(g_step_dt);
+        SDL_SignalSemaphore(g_done);
+    }
+    return 0;
+}
+
+// Public API ----------------------------------------------------------------------------------
+
+bool particles_init(void) {
+    int total = 0;
+    for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+        int cap = kTypes[t].capacity;
+        ParticlePool* p = &g_pools[t];
+        p->x = (float*)calloc((size_t)cap, sizeof(float));
+        p->y = (float*)calloc((size_t)cap, sizeof(float));
+        p->vx = (float*)calloc((size_t)cap, sizeof(float));
+        p->vy = (float*)calloc((size_t)cap, sizeof(float));
+        p->life = (float*)calloc((size_t)cap, sizeof(float));
+        p->inv_life = (float*)calloc((size_t)cap, sizeof(float));
+        p->count = 0;
+        total += cap;
+    }
+    g_instances = (PipelineInstance*)malloc((size_t)total * sizeof(PipelineInstance));
+    g_emit_mtx = SDL_CreateMutex();
+    g_kick = SDL_CreateSemaphore(0);
+    g_done = SDL_CreateSemaphore(0);
+    atomic_store(&g_quit, false);
+    g_worker = SDL_CreateThread(particles_worker, "particles", NULL);
+    g_tex = make_soft_dot_texture();
+    SDL_Log("particles: %d slots across %d pools", total, (int)PARTICLE_TYPE_COUNT);
+    return g_instances && g_emit_mtx && g_kick && g_done && g_worker;
+}
+
+void particles_shutdown(void) {
+    if (g_in_flight) {
+        SDL_WaitSemaphore(g_done);
+        g_in_flight = false;
+    }
+    if (g_worker) {
+        atomic_store(&g_quit, true);
+        SDL_SignalSemaphore(g_kick);
+        SDL_WaitThread(g_worker, NULL);
+        g_worker = NULL;
+    }
+    if (g_kick)
+        SDL_DestroySemaphore(g_kick);
+    if (g_done)
+        SDL_DestroySemaphore(g_done);
+    if (g_emit_mtx)
+        SDL_DestroyMutex(g_emit_mtx);
+    g_kick = g_done = NULL;
+    g_emit_mtx = NULL;
+    for (int t = 0; t < PARTICLE_TYPE_COUNT; t++) {
+        ParticlePool* p = &g_pools[t];
+        free(p->x);
+        free(p->y);
+        free(p->vx);
+        free(p->vy);
+        free(p->life);
+        free(p->inv_life);
+        memset(p, 0, sizeof(*p));
+    }
+    free(g_instances);
+    g_instances = NULL;
+    g_instance_count = 0;
+    if (g_tex) {
+        pipeline_texture_destroy(g_tex);
+        g_tex = 0;
+    }
+}
+
+void particles_emit(ParticleType type,
+                    float x,
+                    float y,
+                    float vx,
+                    float vy,
+                    float spread,
+                    int count) {
+    if (!g_emit_mtx || count <= 0 || type < 0 || type >= PARTICLE_TYPE_COUNT)
+        return;
+    SDL_LockMutex(g_emit_mtx);
+    if (g_emit_count < PARTICLE_MAX_EMITS) {
+        g_emits[g_emit_count++] = (ParticleEmit){type, x, y, vx, vy, spread, count};
+    }
+    SDL_UnlockMutex(g_emit_mtx);
+}
+
+void particles_update(float dt) {
+    if (!g_worker)
+        return;
+    if (g_in_flight)
+        SDL_WaitSemaphore(g_done);  // previous frame was never rendered
+    // Clamp long hitches so bursts don't teleport
+    g_step_dt = dt > 0.05f ? 0.05f : dt;
+    g_in_flight = true;
+    SDL_SignalSemaphore(g_kick);
+}
+
+void particles_render(void) {
+    if (!g_worker)
+        return;
+    if (g_in_flight) {
+        SDL_WaitSemaphore(g_done);
+        g_in_flight = false;
+    }
+    // g_instances stays untouched until the next particles_update, after pipeline_end
+    pipeline_sprite_instances(g_instances, (unsigned int)g_instance_count, g_tex);
+}
+
+int particles_live_count(void) {
+    return atomic_load(&g_live);
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <stdbool.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Visual-only particle system (never touches the Box2D world).
+// - SoA storage in fixed-capacity pools, one pool per particle type
+// - Emission is queued from any thread (logic thread gameplay events)
+// - Simulation runs on a worker thread kicked by particles_update and joined by particles_render
+// - Rendering is a single instanced draw through the pipeline
+
+// Pools are drawn in enum order (smoke at the back, sparks on top)
+typedef enum {
+    PARTICLE_SMOKE,
+    PARTICLE_DUST,
+    PARTICLE_EXHAUST,
+    PARTICLE_FIRE,
+    PARTICLE_SPARK,
+    PARTICLE_TYPE_COUNT
+} ParticleType;
+
+bool particles_init(void);
+void particles_shutdown(void);
+
+// Queue a burst of count particles at (x,y) with base velocity (vx,vy) and random extra speed up
+// to spread in any direction. Thread-safe; bursts beyond the pool capacity are dropped.
+void particles_emit(ParticleType type,
+                    float x,
+                    float y,
+                    float vx,
+                    float vy,
+                    float spread,
+                    int count);
+
+// Main thread, once per frame: start simulating dt on the worker
+void particles_update(float dt);
+// Main thread, between pipeline begin/end: wait for the worker and submit live particles
+void particles_render(void);
+
+// Live particles after the last completed update
+int particles_live_count(void);
+
+#ifdef __cplusplus
+}
+#endif
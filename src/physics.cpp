@@ -2,69 +2,799 @@
 #include <SDL3/SDL.h>
 #include <box2d/box2d.h>
 #include <stdlib.h>
+#include <algorithm>
 #include <atomic>
 #include <cfloat>
 #include <cmath>
 #include <vector>
-#include <unordered_map>
 #include "ame/physics.h"
 
-// Internal registry for gameplay flags per fixture (avoids Box2D user-data API differences)
-static std::unordered_map<const b2Fixture*, int> g_fixture_flags;
-
 static b2World* g_world = nullptr;
-static SDL_Thread* g_thread = NULL;
-static std::atomic_bool g_running{false};
-static float g_dt = 0.001f;  // 1000 Hz
-static SDL_Mutex* g_world_mtx = NULL;
+static std::atomic<int> g_velocity_iterations{8};
+static std::atomic<int> g_position_iterations{3};
+// World access goes through a reader-writer lock. physics_step and the mutators take it
+// exclusively; read-only queries (raycasts, overlaps, contact reads, locked getters) take it shared
+// and run concurrently between steps. The write lock is reentrant for its owner, and read requests
+// from the owner pass through, so queries still work while physics_lock is held.
+static SDL_RWLock* g_world_lock = NULL;
+static std::atomic<SDL_ThreadID> g_world_writer{0};
+static int g_world_write_depth = 0;  // touched by the owner only
 
-static int physics_thread(void* ud) {
-    (void)ud;
-    uint64_t last = SDL_GetTicksNS();
-    double acc = 0.0;
-    g_running.store(true);
-    while (g_running.load()) {
-        uint64_t t = SDL_GetTicksNS();
-        double frame = (double)(t - last) / 1e9;
-        last = t;
-        if (frame > 0.05)
-            frame = 0.05;
-        acc += frame;
-        int steps = 0;
-        while (acc >= g_dt && steps < 8) {
-            if (g_world) {
-                SDL_LockMutex(g_world_mtx);
-                g_world->Step(g_dt, 8, 3);
-                SDL_UnlockMutex(g_world_mtx);
+static std::atomic<uint64_t> g_lock_reads{0}, g_lock_reads_contended{0};
+static std::atomic<uint64_t> g_lock_writes{0}, g_lock_writes_contended{0};
+static std::atomic<uint64_t> g_lock_read_wait_ns{0}, g_lock_write_wait_ns{0};
+
+static bool world_owned_by_me(void) {
+    return g_world_writer.load(std::memory_order_relaxed) == SDL_GetCurrentThreadID();
+}
+
+static void world_read_lock(void) {
+    if (world_owned_by_me())
+        return;
+    g_lock_reads.fetch_add(1, std::memory_order_relaxed);
+    if (SDL_TryLockRWLockForReading(g_world_lock))
+        return;
+    Uint64 t0 = SDL_GetTicksNS();
+    SDL_LockRWLockForReading(g_world_lock);
+    g_lock_reads_contended.fetch_add(1, std::memory_order_relaxed);
+    g_lock_read_wait_ns.fetch_add(SDL_GetTicksNS() - t0, std::memory_order_relaxed);
+}
+
+static void world_read_unlock(void) {
+    if (!world_owned_by_me())
+        SDL_UnlockRWLock(g_world_lock);
+}
+
+static void world_write_lock(void) {
+    if (world_owned_by_me()) {
+        g_world_write_depth++;
+        return;
+    }
+    g_lock_writes.fetch_add(1, std::memory_order_relaxed);
+    if (!SDL_TryLockRWLockForWriting(g_world_lock)) {
+        Uint64 t0 = SDL_GetTicksNS();
+        SDL_LockRWLockForWriting(g_world_lock);
+        g_lock_writes_contended.fetch_add(1, std::memory_order_relaxed);
+        g_lock_write_wait_ns.fetch_add(SDL_GetTicksNS() - t0, std::memory_order_relaxed);
+    }
+    g_world_writer.store(SDL_GetCurrentThreadID(), std::memory_order_relaxed);
+    g_world_write_depth = 1;
+}
+
+static void world_write_unlock(void) {
+    if (--g_world_write_depth > 0)
+        return;
+    g_world_writer.store(0, std::memory_order_relaxed);
+    SDL_UnlockRWLock(g_world_lock);
+}
+
+// Lock-free body state snapshot. The thread that owns the world lock (normally the sim thread
+// right after each step) publishes position/angle/velocity of every non-static body into a
+// seqlock-protected slot; read-only getters on other threads copy from it without locking.
+// Slots are found through an open-addressing table keyed by body pointer; the slot index is the
+// stable handle of the body. Bodies not published yet fall back to a locked read.
+// Each slot also keeps the transform of the step before and the step it was published at, for
+// render interpolation (physics_render_begin).
+#define PHYSICS_SNAPSHOT_CAPACITY 2048  // power of two
+
+struct BodySnapshot {
+    std::atomic<uint32_t> seq{0};  // odd while a write is in progress
+    std::atomic<float> x{0.0f}, y{0.0f}, angle{0.0f};
+    std::atomic<float> vx{0.0f}, vy{0.0f}, av{0.0f};
+    std::atomic<float> px{0.0f}, py{0.0f}, pangle{0.0f};  // previous step
+    std::atomic<uint32_t> step{0};
+};
+
+struct BodyState {
+    float x, y, angle;
+    float vx, vy, av;
+};
+
+static std::atomic<const b2Body*> g_snap_keys[PHYSICS_SNAPSHOT_CAPACITY];
+static BodySnapshot g_snap[PHYSICS_SNAPSHOT_CAPACITY];
+// Steps published so far (snapshot stamp) and the count latched for the frame being drawn
+static std::atomic<uint32_t> g_step_count{0};
+static uint32_t g_render_step = 0;
+static float g_render_alpha = 1.0f;
+
+// What a publish does with the previous transform
+enum SnapPrev {
+    SNAP_PREV_STEP,   // after a step: the current transform becomes the previous one
+    SNAP_PREV_KEEP,   // same step (velocity commands): keep it
+    SNAP_PREV_RESET,  // moved outside a step (teleport, restore, new body): no interpolation
+};
+
+// Slot generation: even while the body is alive, odd once it has been destroyed. A destroyed
+// slot keeps its key and comes back to life (next even generation) if Box2D reuses the pointer.
+static std::atomic<uint32_t> g_snap_gen[PHYSICS_SNAPSHOT_CAPACITY];
+
+static uint32_t snap_hash(const b2Body* body) {
+    uint64_t k = (uint64_t)(uintptr_t)body >> 4;
+    return (uint32_t)((k * 0x9E3779B97F4A7C15ull) >> 40) & (PHYSICS_SNAPSHOT_CAPACITY - 1);
+}
+
+// Slot of an already published body, or -1
+static int snap_find(const b2Body* body) {
+    uint32_t i = snap_hash(body);
+    for (int n = 0; n < PHYSICS_SNAPSHOT_CAPACITY; n++) {
+        const b2Body* k = g_snap_keys[i].load(std::memory_order_acquire);
+        if (k == body)
+            return (int)i;
+        if (!k)
+            return -1;
+        i = (i + 1) & (PHYSICS_SNAPSHOT_CAPACITY - 1);
+    }
+    return -1;
+}
+
+// Caller holds the world write lock (single writer)
+static void snap_publish(const b2Body* body, SnapPrev prev) {
+    int slot = snap_find(body);
+    if (slot < 0) {
+        prev = SNAP_PREV_RESET;
+        uint32_t i = snap_hash(body);
+        for (int n = 0; n < PHYSICS_SNAPSHOT_CAPACITY; n++) {
+            if (!g_snap_keys[i].load(std::memory_order_relaxed)) {
+                slot = (int)i;
+                break;
             }
-            acc -= g_dt;
-            steps++;
+            i = (i + 1) & (PHYSICS_SNAPSHOT_CAPACITY - 1);
+        }
+        if (slot < 0)
+            return;  // table full: getters keep using the locked path for this body
+    } else if (g_snap_gen[slot].load(std::memory_order_relaxed) & 1u) {
+        g_snap_gen[slot].fetch_add(1, std::memory_order_release);
+        prev = SNAP_PREV_RESET;
+    }
+    BodySnapshot& e = g_snap[slot];
+    const b2Vec2& p = body->GetPosition();
+    const b2Vec2& v = body->GetLinearVelocity();
+    uint32_t seq = e.seq.load(std::memory_order_relaxed);
+    e.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    if (prev == SNAP_PREV_STEP) {
+        e.px.store(e.x.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        e.py.store(e.y.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        e.pangle.store(e.angle.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    } else if (prev == SNAP_PREV_RESET) {
+        e.px.store(p.x, std::memory_order_relaxed);
+        e.py.store(p.y, std::memory_order_relaxed);
+        e.pangle.store(body->GetAngle(), std::memory_order_relaxed);
+    }
+    e.step.store(g_step_count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    e.x.store(p.x, std::memory_order_relaxed);
+    e.y.store(p.y, std::memory_order_relaxed);
+    e.angle.store(body->GetAngle(), std::memory_order_relaxed);
+    e.vx.store(v.x, std::memory_order_relaxed);
+    e.vy.store(v.y, std::memory_order_relaxed);
+    e.av.store(body->GetAngularVelocity(), std::memory_order_relaxed);
+    e.seq.store(seq + 2, std::memory_order_release);
+    // Key goes in last so readers never see a slot before its first complete write
+    if (g_snap_keys[slot].load(std::memory_order_relaxed) != body)
+        g_snap_keys[slot].store(body, std::memory_order_release);
+}
+
+static void snap_publish_world(void) {
+    g_step_count.fetch_add(1, std::memory_order_release);
+    for (b2Body* b = g_world->GetBodyList(); b; b = b->GetNext()) {
+        if (b->GetType() != b2_staticBody)
+            snap_publish(b, SNAP_PREV_STEP);
+    }
+}
+
+static bool snap_read(const b2Body* body, BodyState* out) {
+    int slot = snap_find(body);
+    if (slot < 0)
+        return false;
+    const BodySnapshot& e = g_snap[slot];
+    for (;;) {
+        uint32_t s0 = e.seq.load(std::memory_order_acquire);
+        if (s0 & 1u)
+            continue;  // writer mid-update, a handful of stores away from done
+        out->x = e.x.load(std::memory_order_relaxed);
+        out->y = e.y.load(std::memory_order_relaxed);
+        out->angle = e.angle.load(std::memory_order_relaxed);
+        out->vx = e.vx.load(std::memory_order_relaxed);
+        out->vy = e.vy.load(std::memory_order_relaxed);
+        out->av = e.av.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e.seq.load(std::memory_order_relaxed) == s0)
+            return true;
+    }
+}
+
+// Snapshot read with a locked fallback for bodies that were never published (static bodies,
+// or bodies created directly through physics_get_world before the next step)
+static void body_state(const b2Body* body, BodyState* out) {
+    if (snap_read(body, out))
+        return;
+    world_read_lock();
+    out->x = body->GetPosition().x;
+    out->y = body->GetPosition().y;
+    out->angle = body->GetAngle();
+    out->vx = body->GetLinearVelocity().x;
+    out->vy = body->GetLinearVelocity().y;
+    out->av = body->GetAngularVelocity();
+    world_read_unlock();
+}
+
+// Transform of a body alpha of the way between its last two published steps, shifted to the step
+// latched by physics_render_begin. Bodies never published fall back to the current state.
+static void snap_read_render(const b2Body* body, float* x, float* y, float* angle) {
+    int slot = snap_find(body);
+    if (slot < 0) {
+        BodyState st;
+        body_state(body, &st);
+        *x = st.x;
+        *y = st.y;
+        *angle = st.angle;
+        return;
+    }
+    const BodySnapshot& e = g_snap[slot];
+    float cx, cy, ca, px, py, pa;
+    uint32_t step;
+    for (;;) {
+        uint32_t s0 = e.seq.load(std::memory_order_acquire);
+        if (s0 & 1u)
+            continue;
+        cx = e.x.load(std::memory_order_relaxed);
+        cy = e.y.load(std::memory_order_relaxed);
+        ca = e.angle.load(std::memory_order_relaxed);
+        px = e.px.load(std::memory_order_relaxed);
+        py = e.py.load(std::memory_order_relaxed);
+        pa = e.pangle.load(std::memory_order_relaxed);
+        step = e.step.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e.seq.load(std::memory_order_relaxed) == s0)
+            break;
+    }
+    // A step that landed after the latch is blended back (t < 0) so every body of the frame is
+    // drawn at the same moment
+    float t = g_render_alpha + (float)(int32_t)(g_render_step - step);
+    t = t < -1.0f ? -1.0f : (t > 1.0f ? 1.0f : t);
+    *x = px + (cx - px) * t;
+    *y = py + (cy - py) * t;
+    *angle = pa + (ca - pa) * t;  // Box2D angles are not wrapped
+}
+
+// Contact cache. A b2ContactListener keeps, for every body that touches something, a small table
+// of its current touching contacts: the other body, the other fixture's gameplay flags and the
+// contact-point speeds, refreshed once after each step. Touch and flag queries are lookups into
+// the body's own table instead of walks over the contact list with a world manifold per query.
+// Gameplay flags live in the fixture user data; a body's table index lives in its user data
+// (index + 1, 0 = no table yet). Begin/end events are also pushed to a ring for
+// physics_poll_contact_events.
+#define PHYSICS_EVENT_CAPACITY 1024  // power of two
+
+struct BodyContact {
+    b2Contact* contact;
+    b2Body* other;
+    int other_flags;
+    bool my_sensor;
+    bool other_sensor;
+    float speed;      // max speed of this body at the contact points
+    float rel_speed;  // max relative speed of the two bodies at the contact points
+};
+
+struct BodyContacts {
+    std::vector<BodyContact> list;
+};
+
+static std::vector<BodyContacts> g_body_contacts;
+static std::vector<uint32_t> g_body_contacts_free;
+
+static PhysicsContactEvent g_events[PHYSICS_EVENT_CAPACITY];
+static std::atomic<uint32_t> g_event_head{0};  // physics_step (listener)
+static std::atomic<uint32_t> g_event_tail{0};  // physics_poll_contact_events
+static std::atomic<uint32_t> g_event_dropped{0};
+
+static int fixture_flags(const b2Fixture* f) {
+    return (int)f->GetUserData().pointer;
+}
+
+static BodyContacts* body_contacts(const b2Body* body) {
+    uintptr_t idx = body->GetUserData().pointer;
+    return idx ? &g_body_contacts[idx - 1] : nullptr;
+}
+
+static BodyContacts* body_contacts_acquire(b2Body* body) {
+    BodyContacts* bc = body_contacts(body);
+    if (bc)
+        return bc;
+    uint32_t idx;
+    if (!g_body_contacts_free.empty()) {
+        idx = g_body_contacts_free.back();
+        g_body_contacts_free.pop_back();
+    } else {
+        idx = (uint32_t)g_body_contacts.size();
+        g_body_contacts.emplace_back();
+    }
+    body->GetUserData().pointer = (uintptr_t)idx + 1;
+    return &g_body_contacts[idx];
+}
+
+// Caller holds the world write lock. Box2D reports EndContact for every touching contact first.
+static void destroy_body(b2Body* body) {
+    uintptr_t idx = body->GetUserData().pointer;
+    g_world->DestroyBody(body);
+    if (idx) {
+        g_body_contacts[idx - 1].list.clear();
+        g_body_contacts_free.push_back((uint32_t)(idx - 1));
+    }
+}
+
+// Max point speed of a (and of a relative to b) over the manifold points; sensor contacts have
+// no points and use the body centers instead
+static void contact_speeds(b2Contact* c, b2Body* a, b2Body* b, float* speed_a, float* rel) {
+    b2WorldManifold wm;
+    int count = c->GetManifold()->pointCount;
+    if (count > 0)
+        c->GetWorldManifold(&wm);
+    float sa = 0.0f, sr = 0.0f;
+    for (int i = 0; i < (count > 0 ? count : 1); i++) {
+        b2Vec2 va, vb;
+        if (count > 0) {
+            va = a->GetLinearVelocityFromWorldPoint(wm.points[i]);
+            vb = b->GetLinearVelocityFromWorldPoint(wm.points[i]);
+        } else {
+            va = a->GetLinearVelocity();
+            vb = b->GetLinearVelocity();
+        }
+        sa = fmaxf(sa, va.Length());
+        sr = fmaxf(sr, (va - vb).Length());
+    }
+    *speed_a = sa;
+    *rel = sr;
+}
+
+static void event_push(const PhysicsContactEvent& e) {
+    uint32_t head = g_event_head.load(std::memory_order_relaxed);
+    if (head - g_event_tail.load(std::memory_order_acquire) >= PHYSICS_EVENT_CAPACITY) {
+        g_event_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    g_events[head & (PHYSICS_EVENT_CAPACITY - 1)] = e;
+    g_event_head.store(head + 1, std::memory_order_release);
+}
+
+static void contact_remove(BodyContacts* bc, const b2Contact* c) {
+    if (!bc)
+        return;
+    for (size_t i = 0; i < bc->list.size(); i++) {
+        if (bc->list[i].contact == c) {
+            bc->list[i] = bc->list.back();
+            bc->list.pop_back();
+            return;
+        }
+    }
+}
+
+struct ContactCache : public b2ContactListener {
+    void BeginContact(b2Contact* c) override {
+        b2Fixture* fa = c->GetFixtureA();
+        b2Fixture* fb = c->GetFixtureB();
+        b2Body* a = fa->GetBody();
+        b2Body* b = fb->GetBody();
+        float speed_a, speed_b, rel;
+        contact_speeds(c, a, b, &speed_a, &rel);
+        contact_speeds(c, b, a, &speed_b, &rel);
+        body_contacts_acquire(a)->list.push_back(
+            {c, b, fixture_flags(fb), fa->IsSensor(), fb->IsSensor(), speed_a, rel});
+        body_contacts_acquire(b)->list.push_back(
+            {c, a, fixture_flags(fa), fb->IsSensor(), fa->IsSensor(), speed_b, rel});
+
+        PhysicsContactEvent e{};
+        e.type = PHYS_CONTACT_BEGIN;
+        e.body_a = a;
+        e.body_b = b;
+        e.flags_a = fixture_flags(fa);
+        e.flags_b = fixture_flags(fb);
+        e.sensor = fa->IsSensor() || fb->IsSensor();
+        e.speed = rel;
+        if (c->GetManifold()->pointCount > 0) {
+            b2WorldManifold wm;
+            c->GetWorldManifold(&wm);
+            e.x = wm.points[0].x;
+            e.y = wm.points[0].y;
+        } else {
+            e.x = a->GetPosition().x;
+            e.y = a->GetPosition().y;
+        }
+        event_push(e);
+    }
+
+    void EndContact(b2Contact* c) override {
+        b2Fixture* fa = c->GetFixtureA();
+        b2Fixture* fb = c->GetFixtureB();
+        contact_remove(body_contacts(fa->GetBody()), c);
+        contact_remove(body_contacts(fb->GetBody()), c);
+
+        PhysicsContactEvent e{};
+        e.type = PHYS_CONTACT_END;
+        e.body_a = fa->GetBody();
+        e.body_b = fb->GetBody();
+        e.flags_a = fixture_flags(fa);
+        e.flags_b = fixture_flags(fb);
+        e.sensor = fa->IsSensor() || fb->IsSensor();
+        event_push(e);
+    }
+};
+
+static ContactCache g_contact_cache;
+
+// Caller holds the world write lock; runs once after each step so queries never touch manifolds
+static void contacts_refresh(void) {
+    for (BodyContacts& bc : g_body_contacts) {
+        for (BodyContact& e : bc.list) {
+            b2Body* me = e.contact->GetFixtureA()->GetBody();
+            if (me == e.other)
+                me = e.contact->GetFixtureB()->GetBody();
+            contact_speeds(e.contact, me, e.other, &e.speed, &e.rel_speed);
+        }
+    }
+}
+
+// Ray queries. A batch is resolved under one shared hold of the world lock. b2World::RayCast only
+// reads the broadphase, so while the lock keeps writers out, large batches are split into chunks
+// that a small worker pool resolves concurrently with the calling thread.
+#define PHYSICS_RAY_MAX_WORKERS 3
+#define PHYSICS_RAY_CHUNK 32  // rays per job; batches up to one chunk stay on the caller
+
+// Closest non-sensor hit, optionally skipping one body and dynamic bodies
+struct ClosestRayCastCB : public b2RayCastCallback {
+    bool hit = false;
+    float fraction_min = 1e9f;
+    b2Vec2 point{};
+    b2Vec2 normal{};
+    b2Body* body = nullptr;
+    const b2Body* ignore = nullptr;
+    int filter = 0;
+    float ReportFixture(b2Fixture* fixture,
+                        const b2Vec2& point_,
+                        const b2Vec2& normal_,
+                        float fraction) override {
+        if (fixture->IsSensor()) {
+            return -1.0f;  // ignore sensors completely
+        }
+        b2Body* b = fixture->GetBody();
+        if (b == ignore)
+            return -1.0f;
+        if ((filter & PHYS_RAY_IGNORE_DYNAMIC) && b->GetType() == b2_dynamicBody)
+            return -1.0f;
+        if (fraction < fraction_min) {
+            fraction_min = fraction;
+            hit = true;
+            point = point_;
+            normal = normal_;
+            body = b;
+        }
+        return fraction;  // clip the ray to this point and continue to find closer
+    }
+};
+
+static struct {
+    SDL_Thread* threads[PHYSICS_RAY_MAX_WORKERS];
+    int count;
+    SDL_Semaphore* work;
+    SDL_Semaphore* done;
+    SDL_Mutex* busy;  // one batch at a time; concurrent readers resolve their batch inline
+    std::atomic<bool> quit;
+    // Current batch, valid between posting work and collecting done
+    std::atomic<int> next_chunk;
+    int chunks;
+    const RayQuery* rays;
+    RaycastCallback* out;
+    int n;
+    int filter;
+} g_ray_pool;
+
+static void ray_resolve(const RayQuery& q, RaycastCallback* out, int filter) {
+    ClosestRayCastCB cb;
+    cb.ignore = q.ignore;
+    cb.filter = filter;
+    *out = RaycastCallback{};
+    b2Vec2 p0(q.x0, q.y0), p1(q.x1, q.y1);
+    if ((p1 - p0).LengthSquared() <= 0.0f)
+        return;  // Box2D asserts on zero-length rays
+    g_world->RayCast(&cb, p0, p1);
+    if (cb.hit) {
+        out->hit = true;
+        out->x = cb.point.x;
+        out->y = cb.point.y;
+        out->nx = cb.normal.x;
+        out->ny = cb.normal.y;
+        out->fraction = cb.fraction_min;
+        out->body = cb.body;
+    }
+}
+
+static void ray_pull_chunks(void) {
+    for (;;) {
+        int c = g_ray_pool.next_chunk.fetch_add(1, std::memory_order_acq_rel);
+        if (c >= g_ray_pool.chunks)
+            break;
+        int end = SDL_min((c + 1) * PHYSICS_RAY_CHUNK, g_ray_pool.n);
+        for (int i = c * PHYSICS_RAY_CHUNK; i < end; i++) {
+            ray_resolve(g_ray_pool.rays[i], &g_ray_pool.out[i], g_ray_pool.filter);
         }
-        SDL_DelayNS(200000);  // ~0.2ms
+    }
+}
+
+static int ray_worker_main(void* ud) {
+    (void)ud;
+    for (;;) {
+        SDL_WaitSemaphore(g_ray_pool.work);
+        if (g_ray_pool.quit.load())
+            break;
+        ray_pull_chunks();
+        SDL_SignalSemaphore(g_ray_pool.done);
     }
     return 0;
 }
 
+static void ray_pool_start(void) {
+    int want = SDL_GetNumLogicalCPUCores() - 2;  // main + sim threads
+    if (want > PHYSICS_RAY_MAX_WORKERS)
+        want = PHYSICS_RAY_MAX_WORKERS;
+    if (want <= 0)
+        return;
+    g_ray_pool.work = SDL_CreateSemaphore(0);
+    g_ray_pool.done = SDL_CreateSemaphore(0);
+    g_ray_pool.busy = SDL_CreateMutex();
+    g_ray_pool.quit.store(false);
+    for (int w = 0; w < want && g_ray_pool.work && g_ray_pool.done && g_ray_pool.busy; w++) {
+        SDL_Thread* t = SDL_CreateThread(ray_worker_main, "phys_ray", NULL);
+        if (!t)
+            break;
+        g_ray_pool.threads[g_ray_pool.count++] = t;
+    }
+}
+
+static void ray_pool_stop(void) {
+    g_ray_pool.quit.store(true);
+    for (int w = 0; w < g_ray_pool.count; w++) {
+        SDL_SignalSemaphore(g_ray_pool.work);
+    }
+    for (int w = 0; w < g_ray_pool.count; w++) {
+        SDL_WaitThread(g_ray_pool.threads[w], NULL);
+        g_ray_pool.threads[w] = NULL;
+    }
+    g_ray_pool.count = 0;
+    if (g_ray_pool.work) {
+        SDL_DestroySemaphore(g_ray_pool.work);
+        g_ray_pool.work = NULL;
+    }
+    if (g_ray_pool.done) {
+        SDL_DestroySemaphore(g_ray_pool.done);
+        g_ray_pool.done = NULL;
+    }
+    if (g_ray_pool.busy) {
+        SDL_DestroyMutex(g_ray_pool.busy);
+        g_ray_pool.busy = NULL;
+    }
+}
+
+// Caller holds the world lock (shared is enough)
+static void rays_resolve(const RayQuery* rays, RaycastCallback* out, int n, int filter) {
+    int chunks = (n + PHYSICS_RAY_CHUNK - 1) / PHYSICS_RAY_CHUNK;
+    int helpers = SDL_min(g_ray_pool.count, chunks - 1);
+    if (helpers <= 0 || !SDL_TryLockMutex(g_ray_pool.busy)) {
+        for (int i = 0; i < n; i++) {
+            ray_resolve(rays[i], &out[i], filter);
+        }
+        return;
+    }
+    g_ray_pool.rays = rays;
+    g_ray_pool.out = out;
+    g_ray_pool.n = n;
+    g_ray_pool.filter = filter;
+    g_ray_pool.chunks = chunks;
+    g_ray_pool.next_chunk.store(0, std::memory_order_release);
+    for (int w = 0; w < helpers; w++) {
+        SDL_SignalSemaphore(g_ray_pool.work);
+    }
+    ray_pull_chunks();
+    for (int w = 0; w < helpers; w++) {
+        SDL_WaitSemaphore(g_ray_pool.done);
+    }
+    SDL_UnlockMutex(g_ray_pool.busy);
+}
+
+// Body mutations (impulses, velocities, teleports, enable, destroy) from the logic and main
+// threads go through a bounded lock-free MPSC ring (Vyukov) and are applied by physics_step
+// before the next Box2D step, in push order. Commands carry the body's snapshot slot
+// and generation, so commands for a body destroyed in the meantime are dropped.
+#define PHYSICS_CMD_CAPACITY 4096  // power of two
+
+enum PhysCommandType : uint8_t {
+    PHYS_CMD_IMPULSE,
+    PHYS_CMD_SET_VELOCITY,
+    PHYS_CMD_SET_VELOCITY_X,
+    PHYS_CMD_SET_ANGULAR_VELOCITY,
+    PHYS_CMD_TELEPORT,
+    PHYS_CMD_SET_ANGLE,
+    PHYS_CMD_SET_ENABLED,
+    PHYS_CMD_DESTROY,
+};
+
+struct PhysCommand {
+    PhysCommandType type;
+    int slot;      // snapshot slot, -1 when applied directly under the lock
+    uint32_t gen;  // slot generation at push time
+    b2Body* body;
+    float a, b;
+};
+
+struct CommandCell {
+    std::atomic<uint32_t> seq;
+    PhysCommand cmd;
+};
+
+static CommandCell g_cmd_ring[PHYSICS_CMD_CAPACITY];
+static std::atomic<uint32_t> g_cmd_head{0};  // producers
+static uint32_t g_cmd_tail = 0;              // physics_step only
+static std::atomic<uint32_t> g_cmd_overflow{0};
+
+static void cmd_reset(void) {
+    for (uint32_t i = 0; i < PHYSICS_CMD_CAPACITY; i++) {
+        g_cmd_ring[i].seq.store(i, std::memory_order_relaxed);
+    }
+    g_cmd_head.store(0, std::memory_order_relaxed);
+    g_cmd_tail = 0;
+}
+
+static bool cmd_push(const PhysCommand& cmd) {
+    uint32_t pos = g_cmd_head.load(std::memory_order_relaxed);
+    CommandCell* cell;
+    for (;;) {
+        cell = &g_cmd_ring[pos & (PHYSICS_CMD_CAPACITY - 1)];
+        uint32_t seq = cell->seq.load(std::memory_order_acquire);
+        int32_t dif = (int32_t)(seq - pos);
+        if (dif == 0) {
+            if (g_cmd_head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                break;
+        } else if (dif < 0) {
+            return false;  // full
+        } else {
+            pos = g_cmd_head.load(std::memory_order_relaxed);
+        }
+    }
+    cell->cmd = cmd;
+    cell->seq.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+static bool cmd_pop(PhysCommand* out) {
+    CommandCell* cell = &g_cmd_ring[g_cmd_tail & (PHYSICS_CMD_CAPACITY - 1)];
+    uint32_t seq = cell->seq.load(std::memory_order_acquire);
+    if ((int32_t)(seq - (g_cmd_tail + 1)) < 0)
+        return false;  // empty (or the next producer has not finished writing)
+    *out = cell->cmd;
+    cell->seq.store(g_cmd_tail + PHYSICS_CMD_CAPACITY, std::memory_order_release);
+    g_cmd_tail++;
+    return true;
+}
+
+// Caller holds the world write lock
+static void cmd_apply(const PhysCommand& c) {
+    if (c.slot >= 0 && g_snap_gen[c.slot].load(std::memory_order_relaxed) != c.gen)
+        return;  // body destroyed after the command was pushed
+    b2Body* body = c.body;
+    bool moved = c.type == PHYS_CMD_TELEPORT || c.type == PHYS_CMD_SET_ANGLE;
+    switch (c.type) {
+        case PHYS_CMD_IMPULSE:
+            body->ApplyLinearImpulseToCenter(b2Vec2(c.a, c.b), true);
+            break;
+        case PHYS_CMD_SET_VELOCITY:
+            body->SetLinearVelocity(b2Vec2(c.a, c.b));
+            break;
+        case PHYS_CMD_SET_VELOCITY_X: {
+            b2Vec2 v = body->GetLinearVelocity();
+            v.x = c.a;
+            body->SetLinearVelocity(v);
+            break;
+        }
+        case PHYS_CMD_SET_ANGULAR_VELOCITY:
+            body->SetAngularVelocity(c.a);
+            break;
+        case PHYS_CMD_TELEPORT:
+            body->SetTransform(b2Vec2(c.a, c.b), body->GetAngle());
+            body->SetLinearVelocity(b2Vec2(0, 0));
+            body->SetAngularVelocity(0);
+            break;
+        case PHYS_CMD_SET_ANGLE:
+            body->SetTransform(body->GetPosition(), c.a);
+            break;
+        case PHYS_CMD_SET_ENABLED:
+            body->SetEnabled(c.a != 0.0f);
+            break;
+        case PHYS_CMD_DESTROY:
+            if (c.slot >= 0)
+                g_snap_gen[c.slot].fetch_add(1, std::memory_order_release);
+            destroy_body(body);
+            return;
+    }
+    if (c.slot >= 0)
+        snap_publish(body, moved ? SNAP_PREV_RESET : SNAP_PREV_KEEP);
+}
+
+static void cmd_drain(void) {
+    PhysCommand c;
+    while (cmd_pop(&c)) {
+        cmd_apply(c);
+    }
+}
+
+static void cmd_submit(PhysCommandType type, b2Body* body, float a, float b) {
+    if (!body || !g_world)
+        return;
+    PhysCommand c{type, -1, 0, body, a, b};
+    int slot = snap_find(body);
+    if (slot >= 0) {
+        uint32_t gen = g_snap_gen[slot].load(std::memory_order_acquire);
+        if (gen & 1u)
+            return;  // already destroyed
+        c.slot = slot;
+        c.gen = gen;
+        if (cmd_push(c))
+            return;
+        g_cmd_overflow.fetch_add(1, std::memory_order_relaxed);
+    }
+    // Body not published yet (created through physics_get_world) or ring full: apply now
+    world_write_lock();
+    cmd_apply(c);
+    world_write_unlock();
+}
+
+void physics_step(float dt) {
+    if (!g_world)
+        return;
+    world_write_lock();
+    cmd_drain();
+    g_world->Step(dt, g_velocity_iterations.load(std::memory_order_relaxed),
+                  g_position_iterations.load(std::memory_order_relaxed));
+    contacts_refresh();
+    snap_publish_world();
+    world_write_unlock();
+}
+
 bool physics_init(void) {
     b2Vec2 gravity(0.0f, -100.0f);
     g_world = new b2World(gravity);
-    g_world_mtx = SDL_CreateMutex();
-    g_thread = SDL_CreateThread(physics_thread, "phys", NULL);
-    return g_world && g_thread && g_world_mtx;
+    g_world_lock = SDL_CreateRWLock();
+    g_world->SetContactListener(&g_contact_cache);
+    cmd_reset();
+    ray_pool_start();
+    return g_world && g_world_lock;
 }
 
 void physics_shutdown(void) {
-    g_running.store(false);
-    if (g_thread) {
-        SDL_WaitThread(g_thread, NULL);
-        g_thread = NULL;
+    ray_pool_stop();
+    if (g_world_lock) {
+        PhysicsLockStats st;
+        physics_get_lock_stats(&st);
+        SDL_Log("physics lock: %llu reads (%llu contended, %.2f ms waiting), %llu writes "
+                "(%llu contended, %.2f ms waiting)",
+                (unsigned long long)st.read_locks, (unsigned long long)st.read_contended,
+                st.read_wait_ns / 1.0e6, (unsigned long long)st.write_locks,
+                (unsigned long long)st.write_contended, st.write_wait_ns / 1.0e6);
     }
-    if (g_world_mtx) {
-        SDL_DestroyMutex(g_world_mtx);
-        g_world_mtx = NULL;
+    if (g_world_lock) {
+        SDL_DestroyRWLock(g_world_lock);
+        g_world_lock = NULL;
     }
     delete g_world;
     g_world = nullptr;
+    g_body_contacts.clear();
+    g_body_contacts_free.clear();
+    g_event_head.store(0, std::memory_order_relaxed);
+    g_event_tail.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < PHYSICS_SNAPSHOT_CAPACITY; i++) {
+        g_snap_keys[i].store(nullptr, std::memory_order_relaxed);
+        g_snap_gen[i].store(0, std::memory_order_relaxed);
+    }
+    g_step_count.store(0, std::memory_order_relaxed);
+    g_render_step = 0;
 }
 
 b2Body* physics_create_dynamic_box(float x,
@@ -75,7 +805,7 @@ b2Body* physics_create_dynamic_box(float x,
                                    float friction) {
     if (!g_world)
         return nullptr;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     b2BodyDef bd;
     bd.type = b2_dynamicBody;
     bd.position.Set(x, y);
@@ -87,14 +817,15 @@ b2Body* physics_create_dynamic_box(float x,
     fd.density = density;
     fd.friction = friction;
     b->CreateFixture(&fd);
-    SDL_UnlockMutex(g_world_mtx);
+    snap_publish(b, SNAP_PREV_RESET);
+    world_write_unlock();
     return b;
 }
 
 void physics_create_static_box(float x, float y, float w, float h, float friction) {
     if (!g_world)
         return;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     b2BodyDef bd;
     bd.type = b2_staticBody;
     bd.position.Set(x, y);
@@ -106,13 +837,13 @@ void physics_create_static_box(float x, float y, float w, float h, float frictio
     fd.friction = friction;
     b2Fixture* fx = b->CreateFixture(&fd);
     (void)fx;
-    SDL_UnlockMutex(g_world_mtx);
+    world_write_unlock();
 }
 
 void physics_create_static_circle(float x, float y, float r, float friction) {
     if (!g_world)
         return;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     b2BodyDef bd;
     bd.type = b2_staticBody;
     bd.position.Set(x, y);
@@ -125,13 +856,13 @@ void physics_create_static_circle(float x, float y, float r, float friction) {
     fd.friction = friction;
     b2Fixture* fx = b->CreateFixture(&fd);
     (void)fx;
-    SDL_UnlockMutex(g_world_mtx);
+    world_write_unlock();
 }
 
 void physics_create_static_edge(float x1, float y1, float x2, float y2, float friction) {
     if (!g_world)
         return;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     b2BodyDef bd;
     bd.type = b2_staticBody;
     b2Body* b = g_world->CreateBody(&bd);
@@ -142,13 +873,13 @@ void physics_create_static_edge(float x1, float y1, float x2, float y2, float fr
     fd.friction = friction;
     b2Fixture* fx = b->CreateFixture(&fd);
     (void)fx;
-    SDL_UnlockMutex(g_world_mtx);
+    world_write_unlock();
 }
 
 void physics_create_static_chain(const float* xy_pairs, int count, bool loop, float friction) {
     if (!g_world || !xy_pairs || count < 2)
         return;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     b2BodyDef bd;
     bd.type = b2_staticBody;
     b2Body* b = g_world->CreateBody(&bd);
@@ -166,7 +897,7 @@ void physics_create_static_chain(const float* xy_pairs, int count, bool loop, fl
     fd.shape = &sh;
     fd.friction = friction;
     b->CreateFixture(&fd);
-    SDL_UnlockMutex(g_world_mtx);
+    world_write_unlock();
 }
 
 static bool is_triangle_valid(const b2Vec2* v) {
@@ -192,20 +923,21 @@ static bool is_triangle_valid(const b2Vec2* v) {
 
 b2Body* physics_create_kinematic_circle(float x, float y, float r, float friction){
     if (!g_world) return nullptr;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     b2BodyDef bd; bd.type = b2_kinematicBody; bd.position.Set(x,y);
     b2Body* body = g_world->CreateBody(&bd);
     b2CircleShape sh; sh.m_p.Set(0,0); sh.m_radius = r;
     b2FixtureDef fd; fd.shape = &sh; fd.friction = friction; fd.density = 1.0f;
     body->CreateFixture(&fd);
-    SDL_UnlockMutex(g_world_mtx);
+    snap_publish(body, SNAP_PREV_RESET);
+    world_write_unlock();
     return body;
 }
 
 void physics_create_static_mesh_triangles_tagged(const float* pos, int vertex_count, float friction, int flags) {
     if (!g_world || !pos || vertex_count < 3)
         return;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     b2BodyDef bd;
     bd.type = b2_staticBody;
     b2Body* body = g_world->CreateBody(&bd);
@@ -234,10 +966,131 @@ void physics_create_static_mesh_triangles_tagged(const float* pos, int vertex_co
         b2FixtureDef fd;
         fd.shape = &sh;
         fd.friction = friction;
-        b2Fixture* fx = body->CreateFixture(&fd);
-        g_fixture_flags[fx] = flags;
+        fd.userData.pointer = (uintptr_t)flags;
+        body->CreateFixture(&fd);
+    }
+    world_write_unlock();
+}
+
+int physics_create_static_polygons(const float* xy,
+                                   const int* counts,
+                                   int polygon_count,
+                                   float friction,
+                                   int flags) {
+    if (!g_world || !xy || !counts || polygon_count <= 0)
+        return 0;
+    int created = 0;
+    world_write_lock();
+    b2BodyDef bd;
+    bd.type = b2_staticBody;
+    b2Body* body = g_world->CreateBody(&bd);
+    const float* p = xy;
+    for (int i = 0; i < polygon_count; i++) {
+        int n = counts[i];
+        const float* src = p;
+        p += (size_t)n * 2;
+        if (n < 3 || n > b2_maxPolygonVertices)
+            continue;
+        b2Vec2 v[b2_maxPolygonVertices];
+        for (int k = 0; k < n; k++) {
+            v[k].Set(src[k * 2 + 0], src[k * 2 + 1]);
+        }
+        if (n == 3 && !is_triangle_valid(v))
+            continue;
+        b2PolygonShape sh;
+        sh.Set(v, n);
+        b2FixtureDef fd;
+        fd.shape = &sh;
+        fd.friction = friction;
+        fd.userData.pointer = (uintptr_t)flags;
+        body->CreateFixture(&fd);
+        created++;
+    }
+    world_write_unlock();
+    return created;
+}
+
+struct PhysicsShapeSet {
+    std::vector<b2PolygonShape> shapes;
+    std::vector<int> flags;
+};
+
+// Box2D asserts on polygons whose hull collapses; reject them before b2PolygonShape::Set
+static bool is_polygon_valid(const b2Vec2* v, int n) {
+    if (n == 3)
+        return is_triangle_valid(v);
+    float area2 = 0.0f;
+    for (int i = 0; i < n; i++) {
+        const b2Vec2& a = v[i];
+        const b2Vec2& b = v[(i + 1) % n];
+        area2 += a.x * b.y - a.y * b.x;
+        for (int j = i + 1; j < n; j++) {
+            if ((v[i] - v[j]).LengthSquared() < b2_linearSlop * b2_linearSlop)
+                return false;
+        }
+    }
+    return fabsf(area2) > 4.0f * b2_epsilon;
+}
+
+PhysicsShapeSet* physics_shape_set_create(const float* xy,
+                                          const int* counts,
+                                          const int* flags,
+                                          int polygon_count) {
+    PhysicsShapeSet* set = new PhysicsShapeSet();
+    if (!xy || !counts || polygon_count <= 0)
+        return set;
+    set->shapes.reserve((size_t)polygon_count);
+    set->flags.reserve((size_t)polygon_count);
+    const float* p = xy;
+    for (int i = 0; i < polygon_count; i++) {
+        int n = counts[i];
+        const float* src = p;
+        p += (size_t)n * 2;
+        if (n < 3 || n > b2_maxPolygonVertices)
+            continue;
+        b2Vec2 v[b2_maxPolygonVertices];
+        for (int k = 0; k < n; k++) {
+            v[k].Set(src[k * 2 + 0], src[k * 2 + 1]);
+        }
+        if (!is_polygon_valid(v, n))
+            continue;
+        set->shapes.emplace_back();
+        set->shapes.back().Set(v, n);
+        set->flags.push_back(flags ? flags[i] : 0);
+    }
+    return set;
+}
+
+void physics_shape_set_destroy(PhysicsShapeSet* set) {
+    delete set;
+}
+
+int physics_shape_set_count(const PhysicsShapeSet* set) {
+    return set ? (int)set->shapes.size() : 0;
+}
+
+b2Body* physics_swap_static_body(b2Body* old, const PhysicsShapeSet* set, float friction) {
+    if (!g_world)
+        return nullptr;
+    b2Body* body = nullptr;
+    world_write_lock();
+    // Destroying the contacts of the old fixtures wakes whatever rested on them
+    if (old)
+        destroy_body(old);
+    if (set && !set->shapes.empty()) {
+        b2BodyDef bd;
+        bd.type = b2_staticBody;
+        body = g_world->CreateBody(&bd);
+        for (size_t i = 0; i < set->shapes.size(); i++) {
+            b2FixtureDef fd;
+            fd.shape = &set->shapes[i];
+            fd.friction = friction;
+            fd.userData.pointer = (uintptr_t)set->flags[i];
+            body->CreateFixture(&fd);
+        }
     }
-    SDL_UnlockMutex(g_world_mtx);
+    world_write_unlock();
+    return body;
 }
 
 void physics_create_static_mesh_triangles(const float* pos, int vertex_count, float friction) {
@@ -245,27 +1098,13 @@ void physics_create_static_mesh_triangles(const float* pos, int vertex_count, fl
 }
 
 void physics_apply_impulse(b2Body* body, float ix, float iy) {
-    if (!body)
-        return;
-    SDL_LockMutex(g_world_mtx);
-    body->ApplyLinearImpulseToCenter(b2Vec2(ix, iy), true);
-    SDL_UnlockMutex(g_world_mtx);
+    cmd_submit(PHYS_CMD_IMPULSE, body, ix, iy);
 }
 void physics_set_velocity(b2Body* body, float vx, float vy) {
-    if (!body)
-        return;
-    SDL_LockMutex(g_world_mtx);
-    body->SetLinearVelocity(b2Vec2(vx, vy));
-    SDL_UnlockMutex(g_world_mtx);
+    cmd_submit(PHYS_CMD_SET_VELOCITY, body, vx, vy);
 }
 void physics_set_velocity_x(b2Body* body, float vx) {
-    if (!body)
-        return;
-    SDL_LockMutex(g_world_mtx);
-    b2Vec2 v = body->GetLinearVelocity();
-    v.x = vx;
-    body->SetLinearVelocity(v);
-    SDL_UnlockMutex(g_world_mtx);
+    cmd_submit(PHYS_CMD_SET_VELOCITY_X, body, vx, 0.0f);
 }
 void physics_get_position(b2Body* body, float* x, float* y) {
     if (!body) {
@@ -275,13 +1114,12 @@ void physics_get_position(b2Body* body, float* x, float* y) {
             *y = 0;
         return;
     }
-    SDL_LockMutex(g_world_mtx);
-    b2Vec2 p = body->GetPosition();
+    BodyState st;
+    body_state(body, &st);
     if (x)
-        *x = p.x;
+        *x = st.x;
     if (y)
-        *y = p.y;
-    SDL_UnlockMutex(g_world_mtx);
+        *y = st.y;
 }
 void physics_get_velocity(b2Body* body, float* vx, float* vy) {
     if (!body) {
@@ -291,22 +1129,21 @@ void physics_get_velocity(b2Body* body, float* vx, float* vy) {
             *vy = 0;
         return;
     }
-    SDL_LockMutex(g_world_mtx);
-    b2Vec2 v = body->GetLinearVelocity();
+    BodyState st;
+    body_state(body, &st);
     if (vx)
-        *vx = v.x;
+        *vx = st.vx;
     if (vy)
-        *vy = v.y;
-    SDL_UnlockMutex(g_world_mtx);
+        *vy = st.vy;
 }
 
 bool physics_is_grounded_ex(b2Body* body, float normal_threshold, float max_upward_velocity) {
     if (!body)
         return false;
-    SDL_LockMutex(g_world_mtx);
+    world_read_lock();
     b2Vec2 vel = body->GetLinearVelocity();
     if (vel.y > max_upward_velocity) {
-        SDL_UnlockMutex(g_world_mtx);
+        world_read_unlock();
         return false;
     }
     for (b2ContactEdge* ce = body->GetContactList(); ce; ce = ce->next) {
@@ -327,11 +1164,11 @@ bool physics_is_grounded_ex(b2Body* body, float normal_threshold, float max_upwa
         if (my == b)
             n = -n;  // make normal point toward me
         if (n.y > normal_threshold) {
-            SDL_UnlockMutex(g_world_mtx);
+            world_read_unlock();
             return true;
         }
     }
-    SDL_UnlockMutex(g_world_mtx);
+    world_read_unlock();
     return false;
 }
 
@@ -339,7 +1176,7 @@ bool physics_is_grounded(b2Body* body) {
     if (!body)
         return false;
     // Use three short downward rays from the bottom of the body
-    SDL_LockMutex(g_world_mtx);
+    world_read_lock();
     const float player_size = 10.0f;
     const float px = body->GetTransform().p.x;
     const float py = body->GetTransform().p.y;
@@ -347,63 +1184,42 @@ bool physics_is_grounded(b2Body* body) {
     const float y0 = py - half - 1.0f;
     const float y1 = py - half - 12.0f;  // Y-up: cast downward from bottom of player
     const float ox[3] = {-half + 2.0f, 0.0f, half - 2.0f};
-    struct LocalCB : public b2RayCastCallback {
-        bool hit = false;
-        b2Body* me = nullptr;
-        float ReportFixture(b2Fixture* fixture,
-                            const b2Vec2& p,
-                            const b2Vec2& n,
-                            float fr) override {
-            (void)p;
-            (void)n;
-            if (fixture->IsSensor())
-                return -1.0f;
-            b2Body* b = fixture->GetBody();
-            if (b == me)
-                return -1.0f;
-            if (b->GetType() == b2_dynamicBody)
-                return -1.0f;
-            hit = true;
-            return fr;
-        }
-    } cb;
-    cb.me = body;
+    RayQuery q[3];
+    RaycastCallback hits[3];
     for (int i = 0; i < 3; ++i) {
-        cb.hit = false;
-        g_world->RayCast(&cb, b2Vec2(px + ox[i], y0), b2Vec2(px + ox[i], y1));
-        if (cb.hit) {
-            SDL_UnlockMutex(g_world_mtx);
-            return true;
-        }
+        q[i] = RayQuery{px + ox[i], y0, px + ox[i], y1, body};
     }
-    SDL_UnlockMutex(g_world_mtx);
-    return false;
+    rays_resolve(q, hits, 3, PHYS_RAY_IGNORE_DYNAMIC);
+    world_read_unlock();
+    return hits[0].hit || hits[1].hit || hits[2].hit;
 }
 
 void physics_teleport_body(b2Body* body, float x, float y) {
-    if (!body)
-        return;
-    SDL_LockMutex(g_world_mtx);
-    body->SetTransform(b2Vec2(x, y), body->GetAngle());
-    body->SetLinearVelocity(b2Vec2(0, 0));
-    body->SetAngularVelocity(0);
-    SDL_UnlockMutex(g_world_mtx);
+    cmd_submit(PHYS_CMD_TELEPORT, body, x, y);
+}
+
+void physics_set_angle(b2Body* body, float radians) {
+    cmd_submit(PHYS_CMD_SET_ANGLE, body, radians, 0.0f);
 }
 
 void physics_set_gravity(float gx, float gy) {
     if (!g_world)
         return;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     g_world->SetGravity(b2Vec2(gx, gy));
-    SDL_UnlockMutex(g_world_mtx);
+    world_write_unlock();
 }
 
 void physics_set_body_enabled(b2Body* body, bool enabled) {
-    if (!body)
-        return;
-    SDL_LockMutex(g_world_mtx);
-    body->SetEnabled(enabled);
-    SDL_UnlockMutex(g_world_mtx);
+    cmd_submit(PHYS_CMD_SET_ENABLED, body, enabled ? 1.0f : 0.0f, 0.0f);
+}
+
+void physics_destroy_body(b2Body* body) {
+    cmd_submit(PHYS_CMD_DESTROY, body, 0.0f, 0.0f);
+}
+
+unsigned int physics_command_overflows(void) {
+    return g_cmd_overflow.load(std::memory_order_relaxed);
 }
 
 bool physics_is_touching_wall(b2Body* body, int* out_dir) {
@@ -412,7 +1228,7 @@ bool physics_is_touching_wall(b2Body* body, int* out_dir) {
     if (!body)
         return false;
 
-    SDL_LockMutex(g_world_mtx);
+    world_read_lock();
 
     // Build combined AABB of this body
     b2AABB aabb;
@@ -451,50 +1267,21 @@ bool physics_is_touching_wall(b2Body* body, int* out_dir) {
     // Sample points at different heights
     float y_samples[3] = {cy - hy * 0.4f, cy, cy + hy * 0.4f};
 
-    struct LocalCB : public b2RayCastCallback {
-        bool hit = false;
-        b2Body* me = nullptr;
-        float ReportFixture(b2Fixture* fixture,
-                            const b2Vec2& p,
-                            const b2Vec2& n,
-                            float fr) override {
-            (void)p;
-            (void)n;
-            if (fixture->IsSensor())
-                return -1.0f;
-            b2Body* b = fixture->GetBody();
-            if (b == me)
-                return -1.0f;
-            if (b->GetType() == b2_dynamicBody)
-                return -1.0f;  // ignore dynamic bodies
-            hit = true;
-            return fr;  // return the fraction to get the closest hit
-        }
-    } cb;
-    cb.me = body;
-
-    // Check right side - cast from body edge outward
+    // Right side first, then left; each cast from the body edge outward
+    RayQuery q[6];
+    RaycastCallback hits[6];
     for (int i = 0; i < 3; ++i) {
-        cb.hit = false;
-        g_world->RayCast(&cb, b2Vec2(aabb.upperBound.x, y_samples[i]),
-                         b2Vec2(aabb.upperBound.x + check_dist, y_samples[i]));
-        if (cb.hit) {
-            if (out_dir)
-                *out_dir = 1;  // wall is to the right
-            SDL_UnlockMutex(g_world_mtx);
-            return true;
-        }
+        q[i] = RayQuery{aabb.upperBound.x, y_samples[i], aabb.upperBound.x + check_dist,
+                        y_samples[i], body};
+        q[i + 3] = RayQuery{aabb.lowerBound.x, y_samples[i], aabb.lowerBound.x - check_dist,
+                            y_samples[i], body};
     }
-
-    // Check left side - cast from body edge outward
-    for (int i = 0; i < 3; ++i) {
-        cb.hit = false;
-        g_world->RayCast(&cb, b2Vec2(aabb.lowerBound.x, y_samples[i]),
-                         b2Vec2(aabb.lowerBound.x - check_dist, y_samples[i]));
-        if (cb.hit) {
+    rays_resolve(q, hits, 6, PHYS_RAY_IGNORE_DYNAMIC);
+    for (int i = 0; i < 6; ++i) {
+        if (hits[i].hit) {
             if (out_dir)
-                *out_dir = -1;  // wall is to the left
-            SDL_UnlockMutex(g_world_mtx);
+                *out_dir = i < 3 ? 1 : -1;  // wall to the right / left
+            world_read_unlock();
             return true;
         }
     }
@@ -529,12 +1316,12 @@ bool physics_is_touching_wall(b2Body* body, int* out_dir) {
         if (fabsf(normal.x) > horizontal_threshold) {
             if (out_dir)
                 *out_dir = (normal.x > 0.0f) ? 1 : -1;
-            SDL_UnlockMutex(g_world_mtx);
+            world_read_unlock();
             return true;
         }
     }
 
-    SDL_UnlockMutex(g_world_mtx);
+    world_read_unlock();
     return false;
 }
 
@@ -559,7 +1346,7 @@ bool physics_overlap_aabb(float cx,
                           b2Body* ignore_b) {
     if (!g_world)
         return false;
-    SDL_LockMutex(g_world_mtx);
+    world_read_lock();
     OverlapQueryCB cb;
     cb.a = ignore_a;
     cb.b = ignore_b;
@@ -569,71 +1356,465 @@ bool physics_overlap_aabb(float cx,
     box.upperBound.Set(cx + hx, cy + hy);
     g_world->QueryAABB(&cb, box);
     bool res = cb.hit;
-    SDL_UnlockMutex(g_world_mtx);
+    world_read_unlock();
     return res;
 }
 
+// Broadphase candidates (fixture AABBs overlapping the query box), then an exact distance from
+// the centre to each fixture. Bodies with several fixtures keep their nearest one.
+struct RadiusQueryCB : public b2QueryCallback {
+    b2Vec2 center;
+    float radius = 0.0f;
+    b2DistanceProxy point;
+    std::vector<RadiusHit>* hits = nullptr;
+    bool ReportFixture(b2Fixture* f) override {
+        if (f->IsSensor())
+            return true;
+        b2Body* b = f->GetBody();
+        if (b->GetType() != b2_dynamicBody)
+            return true;
+        float d = FLT_MAX;
+        const b2Shape* sh = f->GetShape();
+        for (int32 i = 0; i < sh->GetChildCount(); i++) {
+            b2DistanceInput in;
+            in.proxyA.Set(sh, i);
+            in.proxyB = point;
+            in.transformA = b->GetTransform();
+            in.transformB.SetIdentity();
+            in.useRadii = true;
+            b2SimplexCache cache;
+            cache.count = 0;
+            b2DistanceOutput out;
+            b2Distance(&out, &cache, &in);
+            d = fminf(d, out.distance);
+        }
+        if (d > radius)
+            return true;
+        for (RadiusHit& h : *hits) {
+            if (h.body == b) {
+                h.distance = fminf(h.distance, d);
+                return true;
+            }
+        }
+        const b2Vec2& c = b->GetWorldCenter();
+        hits->push_back(RadiusHit{b, c.x, c.y, d, 0.0f});
+        return true;
+    }
+};
+
+// Caller holds the world lock (shared). Results land in a per-thread buffer.
+static std::vector<RadiusHit>& radius_query(float x, float y, float radius) {
+    static thread_local std::vector<RadiusHit> hits;
+    hits.clear();
+    RadiusQueryCB cb;
+    cb.center.Set(x, y);
+    cb.radius = radius;
+    cb.point.Set(&cb.center, 1, 0.0f);
+    cb.hits = &hits;
+    b2AABB box;
+    box.lowerBound.Set(x - radius, y - radius);
+    box.upperBound.Set(x + radius, y + radius);
+    g_world->QueryAABB(&cb, box);
+    for (RadiusHit& h : hits) {
+        h.falloff = 1.0f - h.distance / radius;
+    }
+    return hits;
+}
+
+int physics_query_radius(float x, float y, float radius, RadiusHit* out, int max) {
+    if (!g_world || radius <= 0.0f)
+        return 0;
+    world_read_lock();
+    std::vector<RadiusHit>& hits = radius_query(x, y, radius);
+    world_read_unlock();
+    int n = (int)hits.size();
+    for (int i = 0; out && i < n && i < max; i++) {
+        out[i] = hits[i];
+    }
+    return n;
+}
+
+int physics_explode(float x,
+                    float y,
+                    float radius,
+                    float impulse,
+                    float max_speed,
+                    RadiusHit* out,
+                    int max) {
+    if (!g_world || radius <= 0.0f)
+        return 0;
+    static thread_local std::vector<b2Vec2> impulses;
+    impulses.clear();
+    world_read_lock();
+    std::vector<RadiusHit>& hits = radius_query(x, y, radius);
+    // Impulse along centre -> body centre, capped to max_speed worth of momentum
+    for (const RadiusHit& h : hits) {
+        float dx = h.x - x, dy = h.y - y;
+        float len = sqrtf(dx * dx + dy * dy);
+        if (len < 1e-3f) {
+            dx = 0.0f;
+            dy = 1.0f;  // body centred on the blast: straight up
+        } else {
+            dx /= len;
+            dy /= len;
+        }
+        float j = impulse * h.falloff;
+        if (max_speed > 0.0f)
+            j = fminf(j, h.body->GetMass() * max_speed);
+        impulses.push_back(b2Vec2(dx * j, dy * j));
+    }
+    world_read_unlock();
+    // Queued like every other mutation (outside the lock: a full queue falls back to the write
+    // lock), so they land with the next step
+    int n = (int)hits.size();
+    for (int i = 0; i < n; i++) {
+        physics_apply_impulse(hits[i].body, impulses[i].x, impulses[i].y);
+    }
+    for (int i = 0; out && i < n && i < max; i++) {
+        out[i] = hits[i];
+    }
+    return n;
+}
+
+static void push_segment(float* out, int max, int* n, const b2Vec2& a, const b2Vec2& b) {
+    if (out && *n < max) {
+        float* o = out + (size_t)(*n) * 4;
+        o[0] = a.x;
+        o[1] = a.y;
+        o[2] = b.x;
+        o[3] = b.y;
+    }
+    (*n)++;
+}
+
+int physics_collect_static_segments(float* out_xyxy, int max_segments) {
+    return physics_collect_static_segments_ex(out_xyxy, max_segments, 0);
+}
+
+// Outline segments of the static fixtures, optionally only those whose bounds overlap box
+static int collect_static_segments(float* out_xyxy,
+                                   int max_segments,
+                                   int exclude_flags,
+                                   const b2AABB* box) {
+    if (!g_world)
+        return 0;
+    int n = 0;
+    world_read_lock();
+    for (b2Body* body = g_world->GetBodyList(); body; body = body->GetNext()) {
+        if (body->GetType() != b2_staticBody)
+            continue;
+        const b2Transform& xf = body->GetTransform();
+        for (b2Fixture* f = body->GetFixtureList(); f; f = f->GetNext()) {
+            if (f->IsSensor() || (fixture_flags(f) & exclude_flags))
+                continue;
+            if (box && !b2TestOverlap(*box, f->GetAABB(0)))
+                continue;
+            switch (f->GetType()) {
+                case b2Shape::e_polygon: {
+                    const b2PolygonShape* sh = (const b2PolygonShape*)f->GetShape();
+                    for (int i = 0; i < sh->m_count; i++) {
+                        b2Vec2 a = b2Mul(xf, sh->m_vertices[i]);
+                        b2Vec2 b = b2Mul(xf, sh->m_vertices[(i + 1) % sh->m_count]);
+                        push_segment(out_xyxy, max_segments, &n, a, b);
+                    }
+                    break;
+                }
+                case b2Shape::e_edge: {
+                    const b2EdgeShape* sh = (const b2EdgeShape*)f->GetShape();
+                    push_segment(out_xyxy, max_segments, &n, b2Mul(xf, sh->m_vertex1),
+                                 b2Mul(xf, sh->m_vertex2));
+                    break;
+                }
+                case b2Shape::e_chain: {
+                    // Loops already repeat the first vertex at the end
+                    const b2ChainShape* sh = (const b2ChainShape*)f->GetShape();
+                    for (int i = 0; i + 1 < sh->m_count; i++) {
+                        push_segment(out_xyxy, max_segments, &n, b2Mul(xf, sh->m_vertices[i]),
+                                     b2Mul(xf, sh->m_vertices[i + 1]));
+                    }
+                    break;
+                }
+                case b2Shape::e_circle: {
+                    const b2CircleShape* sh = (const b2CircleShape*)f->GetShape();
+                    b2Vec2 c = b2Mul(xf, sh->m_p);
+                    const int segs = 12;
+                    for (int i = 0; i < segs; i++) {
+                        float a0 = (float)i / segs * 2.0f * b2_pi;
+                        float a1 = (float)(i + 1) / segs * 2.0f * b2_pi;
+                        b2Vec2 p0(c.x + cosf(a0) * sh->m_radius, c.y + sinf(a0) * sh->m_radius);
+                        b2Vec2 p1(c.x + cosf(a1) * sh->m_radius, c.y + sinf(a1) * sh->m_radius);
+                        push_segment(out_xyxy, max_segments, &n, p0, p1);
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+        }
+    }
+    world_read_unlock();
+    return n;
+}
+
+int physics_collect_static_segments_ex(float* out_xyxy, int max_segments, int exclude_flags) {
+    return collect_static_segments(out_xyxy, max_segments, exclude_flags, nullptr);
+}
+
+int physics_collect_static_segments_in(float x0,
+                                       float y0,
+                                       float x1,
+                                       float y1,
+                                       float* out_xyxy,
+                                       int max_segments) {
+    b2AABB box;
+    box.lowerBound.Set(fminf(x0, x1), fminf(y0, y1));
+    box.upperBound.Set(fmaxf(x0, x1), fmaxf(y0, y1));
+    return collect_static_segments(out_xyxy, max_segments, 0, &box);
+}
+
+void physics_rasterize_static_solids(float x0,
+                                     float y0,
+                                     float cell,
+                                     int w,
+                                     int h,
+                                     unsigned char* out) {
+    if (!g_world || !out || w <= 0 || h <= 0 || cell <= 0.0f)
+        return;
+    world_read_lock();
+    for (b2Body* body = g_world->GetBodyList(); body; body = body->GetNext()) {
+        if (body->GetType() != b2_staticBody)
+            continue;
+        for (b2Fixture* f = body->GetFixtureList(); f; f = f->GetNext()) {
+            // Edges and chains have no inside
+            if (f->IsSensor() ||
+                (f->GetType() != b2Shape::e_polygon && f->GetType() != b2Shape::e_circle))
+                continue;
+            const b2AABB& box = f->GetAABB(0);
+            int i0 = SDL_max((int)floorf((box.lowerBound.x - x0) / cell - 0.5f), 0);
+            int j0 = SDL_max((int)floorf((box.lowerBound.y - y0) / cell - 0.5f), 0);
+            int i1 = SDL_min((int)ceilf((box.upperBound.x - x0) / cell - 0.5f), w - 1);
+            int j1 = SDL_min((int)ceilf((box.upperBound.y - y0) / cell - 0.5f), h - 1);
+            for (int j = j0; j <= j1; j++) {
+                for (int i = i0; i <= i1; i++) {
+                    unsigned char* o = &out[(size_t)j * (size_t)w + (size_t)i];
+                    if (!*o && f->TestPoint(b2Vec2(x0 + (i + 0.5f) * cell, y0 + (j + 0.5f) * cell)))
+                        *o = 1;
+                }
+            }
+        }
+    }
+    world_read_unlock();
+}
+
+bool physics_world_at_rest(void) {
+    if (!g_world)
+        return true;
+    bool rest = true;
+    world_read_lock();
+    for (b2Body* b = g_world->GetBodyList(); b && rest; b = b->GetNext()) {
+        if (!b->IsEnabled() || !b->IsAwake())
+            continue;
+        if (b->GetType() == b2_dynamicBody)
+            rest = false;  // Box2D puts settled dynamic bodies to sleep
+        else if (b->GetType() == b2_kinematicBody)
+            rest = b->GetLinearVelocity().LengthSquared() == 0.0f &&
+                   b->GetAngularVelocity() == 0.0f;
+    }
+    world_read_unlock();
+    return rest;
+}
+
+// World snapshots: one contiguous blob holding a header, a record per non-static body (sorted by
+// pointer) and a record per wheel joint motor. Records refer to live Box2D objects by pointer, so a
+// snapshot only restores into the world it was taken from.
+#define PHYSICS_WORLD_SNAPSHOT_MAGIC 0x504e5357u  // "WSNP"
+
+struct WorldSnapHeader {
+    uint32_t magic;
+    uint32_t body_count;
+    uint32_t joint_count;
+    uint32_t size;  // whole blob in bytes
+};
+
+struct WorldSnapBody {
+    b2Body* body;
+    float x, y, angle;
+    float vx, vy, av;
+    uint8_t awake, enabled;
+};
+
+struct WorldSnapJoint {
+    b2WheelJoint* joint;
+    float motor_speed;
+    float max_motor_torque;
+    uint8_t motor;
+};
+
+static size_t world_snapshot_size(uint32_t bodies, uint32_t joints) {
+    return sizeof(WorldSnapHeader) + bodies * sizeof(WorldSnapBody) +
+           joints * sizeof(WorldSnapJoint);
+}
+
+size_t physics_snapshot_save(void* buf, size_t cap) {
+    if (!g_world)
+        return 0;
+    world_write_lock();
+    // Queued commands belong before the save, as they would before the next step
+    cmd_drain();
+    uint32_t nb = 0, nj = 0;
+    for (b2Body* b = g_world->GetBodyList(); b; b = b->GetNext()) {
+        if (b->GetType() != b2_staticBody)
+            nb++;
+    }
+    for (b2Joint* j = g_world->GetJointList(); j; j = j->GetNext()) {
+        if (j->GetType() == e_wheelJoint)
+            nj++;
+    }
+    size_t size = world_snapshot_size(nb, nj);
+    if (buf && cap >= size) {
+        WorldSnapHeader* h = (WorldSnapHeader*)buf;
+        h->magic = PHYSICS_WORLD_SNAPSHOT_MAGIC;
+        h->body_count = nb;
+        h->joint_count = nj;
+        h->size = (uint32_t)size;
+        WorldSnapBody* bodies = (WorldSnapBody*)(h + 1);
+        WorldSnapBody* br = bodies;
+        for (b2Body* b = g_world->GetBodyList(); b; b = b->GetNext()) {
+            if (b->GetType() == b2_staticBody)
+                continue;
+            const b2Vec2& p = b->GetPosition();
+            const b2Vec2& v = b->GetLinearVelocity();
+            *br++ = WorldSnapBody{b,
+                                  p.x,
+                                  p.y,
+                                  b->GetAngle(),
+                                  v.x,
+                                  v.y,
+                                  b->GetAngularVelocity(),
+                                  (uint8_t)b->IsAwake(),
+                                  (uint8_t)b->IsEnabled()};
+        }
+        std::sort(bodies, br, [](const WorldSnapBody& l, const WorldSnapBody& r) {
+            return (uintptr_t)l.body < (uintptr_t)r.body;
+        });
+        WorldSnapJoint* jr = (WorldSnapJoint*)br;
+        for (b2Joint* j = g_world->GetJointList(); j; j = j->GetNext()) {
+            if (j->GetType() != e_wheelJoint)
+                continue;
+            b2WheelJoint* w = (b2WheelJoint*)j;
+            *jr++ = WorldSnapJoint{
+                w, w->GetMotorSpeed(), w->GetMaxMotorTorque(), (uint8_t)w->IsMotorEnabled()};
+        }
+    }
+    world_write_unlock();
+    return size;
+}
+
+bool physics_snapshot_restore(const void* buf, size_t size) {
+    if (!g_world || !buf || size < sizeof(WorldSnapHeader))
+        return false;
+    const WorldSnapHeader* h = (const WorldSnapHeader*)buf;
+    if (h->magic != PHYSICS_WORLD_SNAPSHOT_MAGIC || h->size != size ||
+        world_snapshot_size(h->body_count, h->joint_count) != size)
+        return false;
+    const WorldSnapBody* bodies = (const WorldSnapBody*)(h + 1);
+    const WorldSnapBody* bodies_end = bodies + h->body_count;
+    const WorldSnapJoint* joints = (const WorldSnapJoint*)bodies_end;
+    world_write_lock();
+    // Commands queued before the restore would otherwise land on top of it
+    cmd_drain();
+    // Walk the live bodies so records of bodies destroyed since the save are never touched
+    for (b2Body* b = g_world->GetBodyList(); b; b = b->GetNext()) {
+        if (b->GetType() == b2_staticBody)
+            continue;
+        const WorldSnapBody* r = std::lower_bound(
+            bodies, bodies_end, b, [](const WorldSnapBody& e, const b2Body* key) {
+                return (uintptr_t)e.body < (uintptr_t)key;
+            });
+        if (r == bodies_end || r->body != b) {
+            b->SetEnabled(false);  // created after the save
+        } else {
+            b->SetEnabled(r->enabled != 0);
+            b->SetTransform(b2Vec2(r->x, r->y), r->angle);
+            b->SetLinearVelocity(b2Vec2(r->vx, r->vy));
+            b->SetAngularVelocity(r->av);
+            b->SetAwake(r->awake != 0);
+        }
+        snap_publish(b, SNAP_PREV_RESET);
+    }
+    for (b2Joint* j = g_world->GetJointList(); j; j = j->GetNext()) {
+        if (j->GetType() != e_wheelJoint)
+            continue;
+        for (uint32_t i = 0; i < h->joint_count; i++) {
+            if (joints[i].joint != (b2WheelJoint*)j)
+                continue;
+            joints[i].joint->EnableMotor(joints[i].motor != 0);
+            joints[i].joint->SetMotorSpeed(joints[i].motor_speed);
+            joints[i].joint->SetMaxMotorTorque(joints[i].max_motor_torque);
+            break;
+        }
+    }
+    world_write_unlock();
+    return true;
+}
+
+void physics_set_iterations(int velocity, int position) {
+    g_velocity_iterations.store(velocity > 0 ? velocity : 1, std::memory_order_relaxed);
+    g_position_iterations.store(position > 0 ? position : 1, std::memory_order_relaxed);
+}
+
 b2World* physics_get_world(void) {
 return g_world;
 }
 
-bool physics_body_touching_flag(b2Body* body, int required_flags){
-    if (!body) return false;
-    bool touching = false;
-    SDL_LockMutex(g_world_mtx);
-    for (b2ContactEdge* ce = body->GetContactList(); ce; ce = ce->next) {
-        b2Contact* c = ce->contact;
-        if (!c->IsTouching()) continue;
-        b2Fixture* a = c->GetFixtureA();
-        b2Fixture* b = c->GetFixtureB();
-        b2Fixture* other = (a->GetBody() == body) ? b : a;
-        if (other->IsSensor()) continue;
-        auto it = g_fixture_flags.find(other);
-        int flags = (it != g_fixture_flags.end()) ? it->second : 0;
-        if ((flags & required_flags) == required_flags){ touching = true; break; }
-    }
-    SDL_UnlockMutex(g_world_mtx);
-    return touching;
+bool physics_body_touching_flag(b2Body* body, int required_flags) {
+    return physics_body_touching_flag_speed(body, required_flags, NULL);
 }
 
-bool physics_body_touching_flag_speed(b2Body* body, int required_flags, float* out_max_speed){
-    if (out_max_speed) *out_max_speed = 0.0f;
-    if (!body) return false;
+bool physics_body_touching_flag_speed(b2Body* body, int required_flags, float* out_max_speed) {
+    if (out_max_speed)
+        *out_max_speed = 0.0f;
+    if (!body)
+        return false;
     bool found = false;
     float max_sp = 0.0f;
-    SDL_LockMutex(g_world_mtx);
-    for (b2ContactEdge* ce = body->GetContactList(); ce; ce = ce->next) {
-        b2Contact* c = ce->contact;
-        if (!c->IsTouching()) continue;
-        b2Fixture* a = c->GetFixtureA();
-        b2Fixture* b = c->GetFixtureB();
-        b2Fixture* my = (a->GetBody() == body) ? a : b;
-        b2Fixture* other = (a->GetBody() == body) ? b : a;
-        if (other->IsSensor()) continue;
-        auto it = g_fixture_flags.find(other);
-        int flags = (it != g_fixture_flags.end()) ? it->second : 0;
-        if ((flags & required_flags) != required_flags) continue;
-        // Estimate relative speed at contact point (other is typically static)
-        b2WorldManifold wm; c->GetWorldManifold(&wm);
-        int count = c->GetManifold() ? c->GetManifold()->pointCount : 1;
-        if (count <= 0) count = 1;
-        for (int i=0;i<count && i<2;i++){
-            b2Vec2 p = wm.points[i];
-            b2Vec2 v = body->GetLinearVelocityFromWorldPoint(p);
-            float sp = v.Length();
-            if (sp > max_sp) max_sp = sp;
-        }
-        found = true;
-    }
-    SDL_UnlockMutex(g_world_mtx);
-    if (out_max_speed) *out_max_speed = max_sp;
+    world_read_lock();
+    if (const BodyContacts* bc = body_contacts(body)) {
+        for (const BodyContact& e : bc->list) {
+            if (e.other_sensor || (e.other_flags & required_flags) != required_flags)
+                continue;
+            max_sp = fmaxf(max_sp, e.speed);
+            found = true;
+        }
+    }
+    world_read_unlock();
+    if (out_max_speed)
+        *out_max_speed = max_sp;
     return found;
 }
 
+int physics_poll_contact_events(PhysicsContactEvent* out, int max) {
+    if (!out || max <= 0)
+        return 0;
+    uint32_t tail = g_event_tail.load(std::memory_order_relaxed);
+    uint32_t head = g_event_head.load(std::memory_order_acquire);
+    int n = 0;
+    while (tail != head && n < max) {
+        out[n++] = g_events[tail & (PHYSICS_EVENT_CAPACITY - 1)];
+        tail++;
+    }
+    g_event_tail.store(tail, std::memory_order_release);
+    return n;
+}
+
+unsigned int physics_contact_events_dropped(void) {
+    return g_event_dropped.load(std::memory_order_relaxed);
+}
+
 void physics_add_sensor_box(b2Body* body, float w, float h, float offset_x, float offset_y) {
     if (!body)
         return;
-    SDL_LockMutex(g_world_mtx);
+    world_write_lock();
     b2PolygonShape sh;
     sh.SetAsBox(w * 0.5f, h * 0.5f, b2Vec2(offset_x, offset_y), 0.0f);
     b2FixtureDef fd;
@@ -642,115 +1823,204 @@ void physics_add_sensor_box(b2Body* body, float w, float h, float offset_x, floa
     fd.density = 0.0f;
     b2Fixture* fx = body->CreateFixture(&fd);
     (void)fx;
-    SDL_UnlockMutex(g_world_mtx);
+    world_write_unlock();
 }
 
-// Internal raycast callback to capture closest non-sensor hit
-struct ClosestRayCastCB : public b2RayCastCallback {
-    bool hit = false;
-    float fraction_min = 1e9f;
-    b2Vec2 point{};
-    b2Vec2 normal{};
-    b2Body* body = nullptr;
-    float ReportFixture(b2Fixture* fixture,
-                        const b2Vec2& point_,
-                        const b2Vec2& normal_,
-                        float fraction) override {
-        if (fixture->IsSensor()) {
-            return -1.0f;  // ignore sensors completely
+RaycastCallback physics_raycast(float x0, float y0, float x1, float y1) {
+    RayQuery q = {x0, y0, x1, y1, nullptr};
+    RaycastCallback out;
+    physics_raycast_batch(&q, &out, 1, 0);
+    return out;
+}
+
+int physics_raycast_batch(const RayQuery* rays, RaycastCallback* out, int n, int filter) {
+    if (!rays || !out || n <= 0)
+        return 0;
+    if (!g_world) {
+        for (int i = 0; i < n; i++) {
+            out[i] = RaycastCallback{};
         }
-        if (fraction < fraction_min) {
-            fraction_min = fraction;
-            hit = true;
-            point = point_;
-            normal = normal_;
-            body = fixture->GetBody();
+        return 0;
+    }
+    world_read_lock();
+    rays_resolve(rays, out, n, filter);
+    world_read_unlock();
+    int hits = 0;
+    for (int i = 0; i < n; i++) {
+        hits += out[i].hit ? 1 : 0;
+    }
+    return hits;
+}
+
+void physics_lock(void) {
+    if (g_world_lock)
+        world_write_lock();
+}
+void physics_unlock(void) {
+    if (g_world_lock)
+        world_write_unlock();
+}
+
+void physics_lock_shared(void) {
+    if (g_world_lock)
+        world_read_lock();
+}
+void physics_unlock_shared(void) {
+    if (g_world_lock)
+        world_read_unlock();
+}
+
+void physics_get_debug_stats(PhysicsDebugStats* out) {
+    if (!out)
+        return;
+    SDL_memset(out, 0, sizeof(*out));
+    if (!g_world)
+        return;
+    world_read_lock();
+    for (const b2Body* b = g_world->GetBodyList(); b; b = b->GetNext()) {
+        out->bodies++;
+        bool is_static = b->GetType() == b2_staticBody;
+        if (!is_static && b->IsEnabled()) {
+            out->enabled_bodies++;
+            out->awake_bodies += b->IsAwake() ? 1 : 0;
+        }
+        for (const b2Fixture* f = b->GetFixtureList(); f; f = f->GetNext()) {
+            out->fixtures++;
+            out->static_fixtures += is_static ? 1 : 0;
+            out->spike_fixtures += (fixture_flags(f) & PHYS_FLAG_SPIKE) ? 1 : 0;
+            out->sensor_fixtures += f->IsSensor() ? 1 : 0;
         }
-        return fraction;  // clip the ray to this point and continue to find closer
     }
-};
+    out->proxies = g_world->GetProxyCount();
+    out->contacts = g_world->GetContactCount();
+    for (b2Contact* c = g_world->GetContactList(); c; c = c->GetNext()) {
+        out->touching += c->IsTouching() ? 1 : 0;
+    }
+    out->joints = g_world->GetJointCount();
+    world_read_unlock();
+}
 
-RaycastCallback physics_raycast(float x0, float y0, float x1, float y1) {
-    RaycastCallback out{};
-    out.hit = false;
-    out.x = out.y = out.nx = out.ny = 0.0f;
-    out.fraction = 0.0f;
-    out.body = nullptr;
+int physics_body_contact_count(b2Body* body) {
+    if (!body)
+        return 0;
+    world_read_lock();
+    const BodyContacts* bc = body_contacts(body);
+    int n = bc ? (int)bc->list.size() : 0;
+    world_read_unlock();
+    return n;
+}
+
+int physics_fixture_flags(const b2Fixture* fixture) {
+    return fixture ? fixture_flags(fixture) : 0;
+}
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+uint64_t physics_state_hash(uint64_t h) {
     if (!g_world)
-        return out;
-    SDL_LockMutex(g_world_mtx);
-    ClosestRayCastCB cb;
-    g_world->RayCast(&cb, b2Vec2(x0, y0), b2Vec2(x1, y1));
-    if (cb.hit) {
-        out.hit = true;
-        out.x = cb.point.x;
-        out.y = cb.point.y;
-        out.nx = cb.normal.x;
-        out.ny = cb.normal.y;
-        out.fraction = cb.fraction_min;
-        out.body = cb.body;
-    }
-    SDL_UnlockMutex(g_world_mtx);
-    return out;
+        return h;
+    uint32_t statics = 0;
+    world_read_lock();
+    for (const b2Body* b = g_world->GetBodyList(); b; b = b->GetNext()) {
+        if (b->GetType() == b2_staticBody) {
+            statics++;
+            continue;
+        }
+        // Floats by value: no padding gets hashed
+        const b2Transform& xf = b->GetTransform();
+        b2Vec2 v = b->GetLinearVelocity();
+        float s[7] = {xf.p.x, xf.p.y, xf.q.s, xf.q.c, v.x, v.y, b->GetAngularVelocity()};
+        unsigned char flags = (unsigned char)((b->IsAwake() ? 1 : 0) | (b->IsEnabled() ? 2 : 0));
+        h = fnv1a(h, s, sizeof(s));
+        h = fnv1a(h, &flags, 1);
+    }
+    world_read_unlock();
+    return fnv1a(h, &statics, sizeof(statics));
 }
 
-void physics_lock(void) {
-    if (g_world_mtx)
-        SDL_LockMutex(g_world_mtx);
+void physics_get_lock_stats(PhysicsLockStats* out) {
+    if (!out)
+        return;
+    out->read_locks = g_lock_reads.load(std::memory_order_relaxed);
+    out->read_contended = g_lock_reads_contended.load(std::memory_order_relaxed);
+    out->read_wait_ns = g_lock_read_wait_ns.load(std::memory_order_relaxed);
+    out->write_locks = g_lock_writes.load(std::memory_order_relaxed);
+    out->write_contended = g_lock_writes_contended.load(std::memory_order_relaxed);
+    out->write_wait_ns = g_lock_write_wait_ns.load(std::memory_order_relaxed);
 }
-void physics_unlock(void) {
-    if (g_world_mtx)
-        SDL_UnlockMutex(g_world_mtx);
-}
-
-void physics_set_angular_velocity(b2Body* body, float av){
-    if (!body) return; SDL_LockMutex(g_world_mtx); body->SetAngularVelocity(av); SDL_UnlockMutex(g_world_mtx);
-}
-
-float physics_get_angle(b2Body* body){
-    if (!body) return 0.0f; SDL_LockMutex(g_world_mtx); float a = body->GetAngle(); SDL_UnlockMutex(g_world_mtx); return a;
-}
-
-bool physics_bodies_touching(b2Body* a, b2Body* b){
-    if (!a || !b) return false;
-    bool touching = false;
-    SDL_LockMutex(g_world_mtx);
-    for (b2ContactEdge* ce = a->GetContactList(); ce; ce = ce->next){
-        b2Contact* c = ce->contact; if (!c->IsTouching()) continue;
-        b2Fixture* fa = c->GetFixtureA(); b2Fixture* fb = c->GetFixtureB();
-        b2Body* oa = fa->GetBody(); b2Body* ob = fb->GetBody();
-        if ((oa==a && ob==b) || (oa==b && ob==a)){
-            if (!fa->IsSensor() && !fb->IsSensor()){ touching = true; break; }
-        }
-    }
-    SDL_UnlockMutex(g_world_mtx);
-    return touching;
-}
-
-bool physics_bodies_contact_speed(b2Body* a, b2Body* b, float* out_max_speed){
-    if (out_max_speed) *out_max_speed = 0.0f;
-    if (!a || !b) return false;
-    bool found = false; float max_sp = 0.0f;
-    SDL_LockMutex(g_world_mtx);
-    for (b2ContactEdge* ce = a->GetContactList(); ce; ce = ce->next){
-        b2Contact* c = ce->contact; if (!c->IsTouching()) continue;
-        b2Fixture* fa = c->GetFixtureA(); b2Fixture* fb = c->GetFixtureB();
-        b2Body* oa = fa->GetBody(); b2Body* ob = fb->GetBody();
-        if (!((oa==a && ob==b) || (oa==b && ob==a))) continue;
-        if (fa->IsSensor() || fb->IsSensor()) continue;
-        b2WorldManifold wm; c->GetWorldManifold(&wm);
-        int count = c->GetManifold() ? c->GetManifold()->pointCount : 1;
-        if (count <= 0) count = 1;
-        for (int i=0;i<count && i<2;i++){
-            b2Vec2 p = wm.points[i];
-            b2Vec2 va = a->GetLinearVelocityFromWorldPoint(p);
-            b2Vec2 vb = b->GetLinearVelocityFromWorldPoint(p);
-            float sp = (va - vb).Length();
-            if (sp > max_sp) max_sp = sp;
-        }
-        found = true;
-    }
-    SDL_UnlockMutex(g_world_mtx);
-    if (out_max_speed) *out_max_speed = max_sp;
+
+void physics_set_angular_velocity(b2Body* body, float av) {
+    cmd_submit(PHYS_CMD_SET_ANGULAR_VELOCITY, body, av, 0.0f);
+}
+
+float physics_get_angle(b2Body* body) {
+    if (!body)
+        return 0.0f;
+    BodyState st;
+    body_state(body, &st);
+    return st.angle;
+}
+
+void physics_render_begin(float alpha) {
+    g_render_step = g_step_count.load(std::memory_order_acquire);
+    g_render_alpha = alpha < 0.0f ? 0.0f : (alpha > 1.0f ? 1.0f : alpha);
+}
+
+void physics_get_render_position(b2Body* body, float* x, float* y) {
+    float rx = 0.0f, ry = 0.0f, ra;
+    if (body)
+        snap_read_render(body, &rx, &ry, &ra);
+    if (x)
+        *x = rx;
+    if (y)
+        *y = ry;
+}
+
+float physics_get_render_angle(b2Body* body) {
+    if (!body)
+        return 0.0f;
+    float x, y, angle;
+    snap_read_render(body, &x, &y, &angle);
+    return angle;
+}
+
+float physics_get_angular_velocity(b2Body* body) {
+    if (!body)
+        return 0.0f;
+    BodyState st;
+    body_state(body, &st);
+    return st.av;
+}
+
+bool physics_bodies_touching(b2Body* a, b2Body* b) {
+    return physics_bodies_contact_speed(a, b, NULL);
+}
+
+bool physics_bodies_contact_speed(b2Body* a, b2Body* b, float* out_max_speed) {
+    if (out_max_speed)
+        *out_max_speed = 0.0f;
+    if (!a || !b)
+        return false;
+    bool found = false;
+    float max_sp = 0.0f;
+    world_read_lock();
+    if (const BodyContacts* bc = body_contacts(a)) {
+        for (const BodyContact& e : bc->list) {
+            if (e.other != b || e.my_sensor || e.other_sensor)
+                continue;
+            max_sp = fmaxf(max_sp, e.rel_speed);
+            found = true;
+        }
+    }
+    world_read_unlock();
+    if (out_max_speed)
+        *out_max_speed = max_sp;
     return found;
 }
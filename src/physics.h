@@ -1,18 +1,25 @@
 #pragma once
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-// Box2D-based physics; fixed 1000Hz step is managed internally on a dedicated thread.
+// Box2D-based physics. The world is stepped by the sim scheduler (see sim_scheduler.h) as one
+// stage of the fixed tick, in order with input and gameplay.
 
 bool physics_init(void);
 void physics_shutdown(void);
 
-// Threaded stepping starts implicitly in init and stops in shutdown
+// Apply queued body commands, advance the world by dt and publish the body snapshot
+void physics_step(float dt);
+// Solver iterations per step (default 8 velocity, 3 position); takes effect on the next step
+void physics_set_iterations(int velocity, int position);
 
 // Human and car bodies (opaque)
 typedef struct b2Body b2Body;
+typedef struct b2Fixture b2Fixture;
 
 b2Body* physics_create_dynamic_box(float x,
                                    float y,
@@ -29,15 +36,49 @@ void physics_create_static_chain(const float* xy_pairs, int count, bool loop, fl
 void physics_create_static_mesh_triangles(const float* pos, int vertex_count, float friction);
 // Tagged variant: flags bitfield applied to created fixtures (for hazards like spikes)
 void physics_create_static_mesh_triangles_tagged(const float* pos, int vertex_count, float friction, int flags);
+// Convex polygons (counter-clockwise, 3..8 vertices each; counts[i] vertices per polygon, xy packed
+// back to back) as fixtures of one static body. Returns the number of fixtures created.
+int physics_create_static_polygons(const float* xy,
+                                   const int* counts,
+                                   int polygon_count,
+                                   float friction,
+                                   int flags);
+// Static geometry prepared away from the world: the polygons are validated and turned into Box2D
+// shapes (hull, normals, mass data) without taking the world lock, on any thread. counts and xy
+// as in physics_create_static_polygons; flags holds one PHYS_FLAG_* set per polygon.
+typedef struct PhysicsShapeSet PhysicsShapeSet;
+PhysicsShapeSet* physics_shape_set_create(const float* xy,
+                                          const int* counts,
+                                          const int* flags,
+                                          int polygon_count);
+void physics_shape_set_destroy(PhysicsShapeSet* set);
+int physics_shape_set_count(const PhysicsShapeSet* set);
+// Replace the static body old (may be NULL) by a new static body holding the shapes of set, in
+// one hold of the write lock, so queries see either the old or the new geometry. Bodies resting
+// on the old fixtures are woken. Returns the new body, NULL when set is empty.
+b2Body* physics_swap_static_body(b2Body* old, const PhysicsShapeSet* set, float friction);
 // Kinematic helpers
 b2Body* physics_create_kinematic_circle(float x, float y, float r, float friction);
+// Body mutations are queued without locking and applied at the start of the next physics_step,
+// in submission order. Commands for a body destroyed in between are dropped.
 void physics_apply_impulse(b2Body* body, float ix, float iy);
 void physics_set_velocity(b2Body* body, float vx, float vy);
 void physics_set_velocity_x(b2Body* body, float vx);
+// Read-only body getters copy from the snapshot published after every physics step and never
+// take the world lock (values are at most one step old)
 void physics_get_position(b2Body* body, float* x, float* y);
 void physics_get_velocity(b2Body* body, float* vx, float* vy);
 void physics_set_angular_velocity(b2Body* body, float av);
 float physics_get_angle(b2Body* body);
+float physics_get_angular_velocity(b2Body* body);
+// Render interpolation, main thread only. The snapshot keeps every body's transform from the step
+// before; physics_render_begin latches the latest step and alpha (0..1, the part of a tick elapsed
+// since it, see sim_scheduler_alpha) once per frame, and the render getters return the transform
+// alpha of the way from the previous step to that one. Motion stays smooth at tick rates below
+// the frame rate, one tick behind the simulation.
+void physics_render_begin(float alpha);
+void physics_get_render_position(b2Body* body, float* x, float* y);
+float physics_get_render_angle(b2Body* body);
 
 // Ground/contact helpers (default thresholds)
 bool physics_is_grounded(b2Body* body);
@@ -49,6 +90,7 @@ bool physics_is_touching_wall(b2Body* body, int* out_dir);
 
 // Gameplay flags for fixtures
 #define PHYS_FLAG_SPIKE (1<<0)
+#define PHYS_FLAG_DESTRUCTIBLE (1<<1)  // terrain chunks rebuilt at runtime (terrain.h)
 
 // Simple raycast result used by gameplay helpers
 typedef struct RaycastCallback {
@@ -62,16 +104,55 @@ typedef struct RaycastCallback {
 // Cast a ray in world space and return the closest solid hit (sensors are ignored)
 RaycastCallback physics_raycast(float x0, float y0, float x1, float y1);
 
+// One ray of a batch; ignore (may be NULL) is skipped, e.g. the body firing the ray
+typedef struct RayQuery {
+    float x0, y0, x1, y1;
+    b2Body* ignore;
+} RayQuery;
+// Batch filter bits
+#define PHYS_RAY_IGNORE_DYNAMIC (1<<0)
+// Resolve n rays under a single world lock; large batches are split across worker threads.
+// out[i] receives the closest solid hit of rays[i]. Returns the number of rays that hit.
+int physics_raycast_batch(const RayQuery* rays, RaycastCallback* out, int n, int filter);
+
 // Add a sensor rectangle fixture to a body (for feet or side sensors). Offset is relative to body
 // center.
 void physics_add_sensor_box(b2Body* body, float w, float h, float offset_x, float offset_y);
 
-// Teleport helper
+// Teleport helper (also clears the body's velocities)
 void physics_teleport_body(b2Body* body, float x, float y);
+// Rotate in place, keeping position and velocities
+void physics_set_angle(b2Body* body, float radians);
 // Enable/disable a body (disables all its fixtures when false)
 void physics_set_body_enabled(b2Body* body, bool enabled);
+// Destroy a body (queued like the other mutations; the pointer must not be used afterwards)
+void physics_destroy_body(b2Body* body);
+// Mutations applied directly under the world lock because the command queue was full
+unsigned int physics_command_overflows(void);
 // Query if an axis-aligned box overlaps any fixture in the world, ignoring up to two bodies
 bool physics_overlap_aabb(float cx, float cy, float w, float h, b2Body* ignore_a, b2Body* ignore_b);
+// Area queries. A hit is an enabled dynamic body with a non-sensor fixture within radius of the
+// centre (exact shape distance after a broadphase AABB query), one entry per body.
+typedef struct RadiusHit {
+    b2Body* body;
+    float x, y;      // body centre of mass
+    float distance;  // from the centre to the nearest fixture, 0 when inside
+    float falloff;   // 1 - distance / radius
+} RadiusHit;
+// Writes at most max hits to out (may be NULL) and returns the total, in one shared-lock pass
+int physics_query_radius(float x, float y, float radius, RadiusHit* out, int max);
+// Same query, plus a queued impulse of impulse * falloff pushing each body away from the centre.
+// max_speed (> 0) caps the velocity change so light bodies are not launched. Hits are reported
+// for damage.
+int physics_explode(float x,
+                    float y,
+                    float radius,
+                    float impulse,
+                    float max_speed,
+                    RadiusHit* out,
+                    int max);
+// Touch queries below read a per-body contact table kept up to date by a contact listener during
+// each step (speeds are sampled right after the step) instead of walking the contact list.
 // Returns true if body is currently touching any fixture that has all bits in required_flags set
 bool physics_body_touching_flag(b2Body* body, int required_flags);
 // Returns true if touching a flagged fixture and outputs an approximate max contact-point speed
@@ -81,15 +162,107 @@ bool physics_bodies_touching(b2Body* a, b2Body* b);
 // Returns true if two bodies are touching and outputs an approximate max relative contact speed
 bool physics_bodies_contact_speed(b2Body* a, b2Body* b, float* out_max_speed);
 
+// Contact begin/end stream, produced during physics_step
+typedef enum { PHYS_CONTACT_BEGIN, PHYS_CONTACT_END } PhysicsContactEventType;
+typedef struct PhysicsContactEvent {
+    PhysicsContactEventType type;
+    b2Body* body_a;  // identity only: the body may be destroyed by the time the event is read
+    b2Body* body_b;
+    int flags_a, flags_b;  // gameplay flags of the two fixtures
+    bool sensor;           // either fixture is a sensor
+    float x, y;            // first contact point (begin only)
+    float speed;           // relative speed at the contact points (begin only)
+} PhysicsContactEvent;
+// Copy up to max pending events in order and return the count. Single consumer; when the consumer
+// falls behind by more than the ring size new events are dropped and counted.
+int physics_poll_contact_events(PhysicsContactEvent* out, int max);
+unsigned int physics_contact_events_dropped(void);
+
+// Collect outline segments (x0,y0,x1,y1) of all static non-sensor fixtures in world space, e.g.
+// for light occluders. Writes at most max_segments and returns the total; out may be NULL.
+int physics_collect_static_segments(float* out_xyxy, int max_segments);
+// Same, skipping fixtures that have any of exclude_flags (PHYS_FLAG_*)
+int physics_collect_static_segments_ex(float* out_xyxy, int max_segments, int exclude_flags);
+// Same, only fixtures whose bounds overlap the rect (x0,y0)-(x1,y1)
+int physics_collect_static_segments_in(float x0,
+                                       float y0,
+                                       float x1,
+                                       float y1,
+                                       float* out_xyxy,
+                                       int max_segments);
+
+// Set out[j * w + i] = 1 for every cell whose centre (x0 + (i + 0.5) * cell, y0 + (j + 0.5) * cell)
+// lies inside a static solid (polygon or circle) fixture; other cells are left untouched
+void physics_rasterize_static_solids(float x0,
+                                     float y0,
+                                     float cell,
+                                     int w,
+                                     int h,
+                                     unsigned char* out);
+
+// True when no enabled dynamic body is awake and no kinematic body is moving
+bool physics_world_at_rest(void);
+
+// World snapshot: transform, velocity, awake/enabled state of every non-static body and the wheel
+// joint motors, packed into one contiguous blob (buf must be 8-byte aligned, e.g. from SDL_malloc).
+// Save applies pending body commands first (a body disabled just before the save is saved
+// disabled), so call it from the thread that steps the world. Returns the size needed and writes
+// only when it fits in cap.
+size_t physics_snapshot_save(void* buf, size_t cap);
+// Restore in place under the world lock; pending body commands are applied first and then
+// overwritten. Bodies created after the save are disabled, bodies destroyed since are skipped.
+// Only valid for the world the snapshot was taken from. Returns false for a malformed blob.
+bool physics_snapshot_restore(const void* buf, size_t size);
+
+// World counters for the debug overlay, read under the shared lock (state after the last step)
+typedef struct {
+    int bodies;
+    int awake_bodies;     // enabled, awake, non-static
+    int enabled_bodies;   // enabled, non-static
+    int fixtures;
+    int static_fixtures;  // on static bodies
+    int spike_fixtures;   // PHYS_FLAG_SPIKE
+    int sensor_fixtures;
+    int proxies;          // broadphase proxies (one per chain edge)
+    int contacts;         // broadphase pairs with a contact
+    int touching;         // of those, touching
+    int joints;
+} PhysicsDebugStats;
+void physics_get_debug_stats(PhysicsDebugStats* out);
+// Touching contacts in a body's contact table after the last step
+int physics_body_contact_count(b2Body* body);
+// Gameplay flags (PHYS_FLAG_*) of a fixture
+int physics_fixture_flags(const b2Fixture* fixture);
+// FNV-1a of h and the state of every non-static body in world order (transform, velocities,
+// awake and enabled), plus the static body count. Equal inputs give equal hashes on every run
+// (replay checksums).
+uint64_t physics_state_hash(uint64_t h);
+
 // Expose gravity change, etc.
 void physics_set_gravity(float gx, float gy);
 
 // Access underlying Box2D world for advanced setups (wheels/joints)
 struct b2World* physics_get_world(void);
 
-// Thread-safety helpers: acquire before directly using Box2D and release after
+// Thread-safety helpers: acquire before directly using Box2D and release after. The world is
+// guarded by a reader-writer lock: physics_lock is exclusive (and reentrant), the shared variant
+// is for read-only access and runs concurrently with other readers and with the query API.
 void physics_lock(void);
 void physics_unlock(void);
+void physics_lock_shared(void);
+void physics_unlock_shared(void);
+
+// World lock counters since startup. Contended acquisitions had to block; wait is the time spent
+// blocked.
+typedef struct {
+    uint64_t read_locks;
+    uint64_t read_contended;
+    uint64_t read_wait_ns;
+    uint64_t write_locks;
+    uint64_t write_contended;
+    uint64_t write_wait_ns;
+} PhysicsLockStats;
+void physics_get_lock_stats(PhysicsLockStats* out);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,311 @@
+#include "physics_debug.h"
+#include <box2d/box2d.h>
+#include <SDL3/SDL.h>
+#include <glad/gl.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <vector>
+#include "physics.h"
+#include "render/pipeline.h"
+
+#define PHYS_DEBUG_CIRCLE_SEGMENTS 16
+#define PHYS_DEBUG_FILL_ALPHA 0.25f
+#define PHYS_DEBUG_LOG_INTERVAL_NS 1000000000ull
+
+namespace {
+
+// Collects everything as triangles; the line width is set per frame from the zoom
+class DebugStream : public b2Draw {
+public:
+    std::vector<float> xy;
+    std::vector<unsigned int> rgba;
+    float line = 1.0f;
+
+    void clear() {
+        xy.clear();
+        rgba.clear();
+    }
+
+    void DrawPolygon(const b2Vec2* v, int32 count, const b2Color& color) override {
+        for (int32 i = 0; i < count; i++) {
+            DrawSegment(v[i], v[(i + 1) % count], color);
+        }
+    }
+
+    void DrawSolidPolygon(const b2Vec2* v, int32 count, const b2Color& color) override {
+        unsigned int fill = pack(color, PHYS_DEBUG_FILL_ALPHA);
+        for (int32 i = 1; i + 1 < count; i++) {
+            tri(v[0], v[i], v[i + 1], fill);
+        }
+        DrawPolygon(v, count, color);
+    }
+
+    void DrawCircle(const b2Vec2& c, float radius, const b2Color& color) override {
+        b2Vec2 v[PHYS_DEBUG_CIRCLE_SEGMENTS];
+        circle_points(c, radius, v);
+        DrawPolygon(v, PHYS_DEBUG_CIRCLE_SEGMENTS, color);
+    }
+
+    void DrawSolidCircle(const b2Vec2& c,
+                         float radius,
+                         const b2Vec2& axis,
+                         const b2Color& color) override {
+        b2Vec2 v[PHYS_DEBUG_CIRCLE_SEGMENTS];
+        circle_points(c, radius, v);
+        DrawSolidPolygon(v, PHYS_DEBUG_CIRCLE_SEGMENTS, color);
+        DrawSegment(c, b2Vec2(c.x + axis.x * radius, c.y + axis.y * radius), color);
+    }
+
+    void DrawSegment(const b2Vec2& a, const b2Vec2& b, const b2Color& color) override {
+        float dx = b.x - a.x, dy = b.y - a.y;
+        float len = sqrtf(dx * dx + dy * dy);
+        if (len < 1e-6f)
+            return;
+        float h = line * 0.5f;
+        float nx = -dy / len * h, ny = dx / len * h;
+        b2Vec2 p0(a.x + nx, a.y + ny), p1(b.x + nx, b.y + ny);
+        b2Vec2 p2(b.x - nx, b.y - ny), p3(a.x - nx, a.y - ny);
+        unsigned int c = pack(color, color.a);
+        tri(p0, p1, p2, c);
+        tri(p0, p2, p3, c);
+    }
+
+    void DrawTransform(const b2Transform& xf) override {
+        float len = line * 8.0f;
+        b2Vec2 ex = b2Mul(xf.q, b2Vec2(len, 0.0f)), ey = b2Mul(xf.q, b2Vec2(0.0f, len));
+        DrawSegment(xf.p, b2Vec2(xf.p.x + ex.x, xf.p.y + ex.y), b2Color(1.0f, 0.0f, 0.0f));
+        DrawSegment(xf.p, b2Vec2(xf.p.x + ey.x, xf.p.y + ey.y), b2Color(0.0f, 1.0f, 0.0f));
+    }
+
+    // size is in pixels like b2Draw's other implementations
+    void DrawPoint(const b2Vec2& p, float size, const b2Color& color) override {
+        float h = size * line * 0.5f;
+        b2Vec2 p0(p.x - h, p.y - h), p1(p.x + h, p.y - h);
+        b2Vec2 p2(p.x + h, p.y + h), p3(p.x - h, p.y + h);
+        unsigned int c = pack(color, color.a);
+        tri(p0, p1, p2, c);
+        tri(p0, p2, p3, c);
+    }
+
+private:
+    static unsigned int pack(const b2Color& c, float alpha) {
+        auto u8 = [](float v) { return (unsigned int)(fminf(fmaxf(v, 0.0f), 1.0f) * 255.0f); };
+        return u8(c.r) | (u8(c.g) << 8) | (u8(c.b) << 16) | (u8(alpha) << 24);
+    }
+
+    static void circle_points(const b2Vec2& c, float radius, b2Vec2* out) {
+        for (int i = 0; i < PHYS_DEBUG_CIRCLE_SEGMENTS; i++) {
+            float a = (float)i * (2.0f * b2_pi / PHYS_DEBUG_CIRCLE_SEGMENTS);
+            out[i].Set(c.x + cosf(a) * radius, c.y + sinf(a) * radius);
+        }
+    }
+
+    void tri(const b2Vec2& a, const b2Vec2& b, const b2Vec2& c, unsigned int color) {
+        xy.insert(xy.end(), {a.x, a.y, b.x, b.y, c.x, c.y});
+        rgba.insert(rgba.end(), {color, color, color});
+    }
+};
+
+// Fixtures whose broadphase AABB overlaps the view
+struct ViewQueryCB : public b2QueryCallback {
+    std::vector<b2Fixture*>* out;
+    bool ReportFixture(b2Fixture* f) override {
+        out->push_back(f);
+        return true;
+    }
+};
+
+}  // namespace
+
+static std::atomic<bool> g_enabled{false};
+static std::atomic<int> g_flags{PHYS_DEBUG_ALL};
+static DebugStream g_stream;
+static std::vector<b2Fixture*> g_visible;
+static GLuint g_tex = 0;  // own 1x1 white texture: keeps the overlay in a batch of its own
+static Uint64 g_last_log_ns = 0;
+
+static b2Color fixture_color(const b2Fixture* f) {
+    const b2Body* b = f->GetBody();
+    if (f->IsSensor())
+        return b2Color(0.95f, 0.85f, 0.2f);
+    if (physics_fixture_flags(f) & PHYS_FLAG_SPIKE)
+        return b2Color(1.0f, 0.2f, 0.2f);
+    if (!b->IsEnabled())
+        return b2Color(0.35f, 0.35f, 0.3f);
+    switch (b->GetType()) {
+    case b2_staticBody:
+        return b2Color(0.5f, 0.9f, 0.5f);
+    case b2_kinematicBody:
+        return b2Color(0.5f, 0.5f, 0.9f);
+    default:
+        return b->IsAwake() ? b2Color(0.9f, 0.7f, 0.7f) : b2Color(0.6f, 0.6f, 0.6f);
+    }
+}
+
+static void draw_fixture(const b2Fixture* f, const b2Color& color) {
+    const b2Transform& xf = f->GetBody()->GetTransform();
+    const b2Shape* shape = f->GetShape();
+    switch (shape->GetType()) {
+    case b2Shape::e_circle: {
+        const b2CircleShape* c = (const b2CircleShape*)shape;
+        g_stream.DrawSolidCircle(b2Mul(xf, c->m_p), c->m_radius, b2Mul(xf.q, b2Vec2(1.0f, 0.0f)),
+                                 color);
+        break;
+    }
+    case b2Shape::e_edge: {
+        const b2EdgeShape* e = (const b2EdgeShape*)shape;
+        g_stream.DrawSegment(b2Mul(xf, e->m_vertex1), b2Mul(xf, e->m_vertex2), color);
+        break;
+    }
+    case b2Shape::e_chain: {
+        const b2ChainShape* ch = (const b2ChainShape*)shape;
+        for (int32 i = 0; i + 1 < ch->m_count; i++) {
+            g_stream.DrawSegment(b2Mul(xf, ch->m_vertices[i]), b2Mul(xf, ch->m_vertices[i + 1]),
+                                 color);
+        }
+        break;
+    }
+    case b2Shape::e_polygon: {
+        const b2PolygonShape* p = (const b2PolygonShape*)shape;
+        b2Vec2 v[b2_maxPolygonVertices];
+        for (int32 i = 0; i < p->m_count; i++) {
+            v[i] = b2Mul(xf, p->m_vertices[i]);
+        }
+        g_stream.DrawSolidPolygon(v, p->m_count, color);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void draw_aabb(const b2AABB& box, const b2Color& color) {
+    b2Vec2 v[4] = {box.lowerBound,
+                   b2Vec2(box.upperBound.x, box.lowerBound.y),
+                   box.upperBound,
+                   b2Vec2(box.lowerBound.x, box.upperBound.y)};
+    g_stream.DrawPolygon(v, 4, color);
+}
+
+static bool in_view(const b2Vec2& p, const b2AABB& view) {
+    return p.x >= view.lowerBound.x && p.y >= view.lowerBound.y && p.x <= view.upperBound.x &&
+           p.y <= view.upperBound.y;
+}
+
+static void build_stream(b2World* world, const b2AABB& view, int flags) {
+    g_visible.clear();
+    ViewQueryCB cb;
+    cb.out = &g_visible;
+    world->QueryAABB(&cb, view);
+    // A chain reports its fixture once per overlapping edge
+    std::sort(g_visible.begin(), g_visible.end());
+    g_visible.erase(std::unique(g_visible.begin(), g_visible.end()), g_visible.end());
+    if (flags & PHYS_DEBUG_SHAPES) {
+        for (const b2Fixture* f : g_visible) {
+            draw_fixture(f, fixture_color(f));
+        }
+    }
+    if (flags & PHYS_DEBUG_AABBS) {
+        b2Color c(0.9f, 0.3f, 0.9f, 0.6f);
+        for (const b2Fixture* f : g_visible) {
+            int32 children = f->GetShape()->GetChildCount();
+            for (int32 i = 0; i < children; i++) {
+                draw_aabb(f->GetAABB(i), c);
+            }
+        }
+    }
+    if (flags & PHYS_DEBUG_JOINTS) {
+        b2Color c(0.5f, 0.8f, 0.8f);
+        for (b2Joint* j = world->GetJointList(); j; j = j->GetNext()) {
+            b2Vec2 pa = j->GetBodyA()->GetPosition(), pb = j->GetBodyB()->GetPosition();
+            b2Vec2 a = j->GetAnchorA(), b = j->GetAnchorB();
+            if (!in_view(a, view) && !in_view(b, view))
+                continue;
+            g_stream.DrawSegment(pa, a, c);
+            g_stream.DrawSegment(a, b, c);
+            g_stream.DrawSegment(pb, b, c);
+        }
+    }
+    if (flags & PHYS_DEBUG_CONTACTS) {
+        b2Color point(1.0f, 0.3f, 0.1f), normal(1.0f, 0.9f, 0.3f);
+        b2WorldManifold wm;
+        for (b2Contact* c = world->GetContactList(); c; c = c->GetNext()) {
+            int32 n = c->GetManifold()->pointCount;
+            if (!c->IsTouching() || n == 0)
+                continue;
+            c->GetWorldManifold(&wm);
+            for (int32 i = 0; i < n; i++) {
+                if (!in_view(wm.points[i], view))
+                    continue;
+                g_stream.DrawPoint(wm.points[i], 4.0f, point);
+                float len = g_stream.line * 10.0f;
+                g_stream.DrawSegment(wm.points[i],
+                                     b2Vec2(wm.points[i].x + wm.normal.x * len,
+                                            wm.points[i].y + wm.normal.y * len),
+                                     normal);
+            }
+        }
+    }
+}
+
+static void log_stats(b2Body* focus) {
+    PhysicsDebugStats st;
+    physics_get_debug_stats(&st);
+    SDL_Log("physics debug: %d bodies (%d awake), %d fixtures (%d static, %d spike, %d sensor), "
+            "%d proxies, %d contacts (%d touching), %d joints, focus contacts %d, %zu debug verts",
+            st.bodies, st.awake_bodies, st.fixtures, st.static_fixtures, st.spike_fixtures,
+            st.sensor_fixtures, st.proxies, st.contacts, st.touching, st.joints,
+            physics_body_contact_count(focus), g_stream.rgba.size());
+}
+
+void physics_debug_set_enabled(bool enabled) {
+    g_enabled.store(enabled, std::memory_order_relaxed);
+    g_last_log_ns = 0;
+}
+
+bool physics_debug_enabled(void) {
+    return g_enabled.load(std::memory_order_relaxed);
+}
+
+void physics_debug_set_flags(int flags) {
+    g_flags.store(flags, std::memory_order_relaxed);
+}
+
+void physics_debug_render(float x0, float y0, float x1, float y1, float zoom, b2Body* focus) {
+    b2World* world = physics_get_world();
+    if (!physics_debug_enabled() || !world)
+        return;
+    if (!g_tex) {
+        unsigned char white[4] = {255, 255, 255, 255};
+        g_tex = pipeline_texture_create(1, 1, white, false);
+    }
+    g_stream.clear();
+    g_stream.line = zoom > 0.0f ? 1.0f / zoom : 1.0f;
+    b2AABB view;
+    view.lowerBound.Set(fminf(x0, x1), fminf(y0, y1));
+    view.upperBound.Set(fmaxf(x0, x1), fmaxf(y0, y1));
+    physics_lock_shared();
+    build_stream(world, view, g_flags.load(std::memory_order_relaxed));
+    physics_unlock_shared();
+    pipeline_sprite_triangles(g_stream.xy.data(), nullptr, g_stream.rgba.data(),
+                              (unsigned int)g_stream.rgba.size(), g_tex);
+
+    Uint64 now = SDL_GetTicksNS();
+    if (now - g_last_log_ns >= PHYS_DEBUG_LOG_INTERVAL_NS) {
+        g_last_log_ns = now;
+        log_stats(focus);
+    }
+}
+
+void physics_debug_shutdown(void) {
+    if (g_tex) {
+        pipeline_texture_destroy(g_tex);
+        g_tex = 0;
+    }
+    g_stream.clear();
+    g_stream.xy.shrink_to_fit();
+    g_stream.rgba.shrink_to_fit();
+    g_visible.clear();
+    g_visible.shrink_to_fit();
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <stdbool.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct b2Body b2Body;
+
+// Physics debug overlay. A b2Draw implementation turns the fixtures, broadphase AABBs, touching
+// contact points and joints inside the view into one triangle stream (lines become thin quads),
+// submitted as a single sprite batch with its own texture so the whole overlay is one draw call.
+// Fixtures are colored by role: static, spike (PHYS_FLAG_SPIKE), sensor, kinematic, dynamic awake
+// and asleep. Once a second while enabled the world counters (physics_get_debug_stats) are logged.
+
+#define PHYS_DEBUG_SHAPES (1 << 0)
+#define PHYS_DEBUG_AABBS (1 << 1)
+#define PHYS_DEBUG_CONTACTS (1 << 2)
+#define PHYS_DEBUG_JOINTS (1 << 3)
+#define PHYS_DEBUG_ALL \
+    (PHYS_DEBUG_SHAPES | PHYS_DEBUG_AABBS | PHYS_DEBUG_CONTACTS | PHYS_DEBUG_JOINTS)
+
+void physics_debug_set_enabled(bool enabled);
+bool physics_debug_enabled(void);
+void physics_debug_set_flags(int flags);
+
+// Build and submit the overlay for the world rect (x0,y0)-(x1,y1); zoom is pixels per world unit
+// and keeps lines one pixel wide. focus (may be NULL) gets its contact count in the periodic log.
+// Call between pipeline_views_begin and pipeline_views_end; does nothing while disabled.
+void physics_debug_render(float x0, float y0, float x1, float y1, float zoom, b2Body* focus);
+void physics_debug_shutdown(void);
+
+#ifdef __cplusplus
+}
+#endif
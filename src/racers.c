@@ -0,0 +1,469 @@
+#include "racers.h"
+#include <SDL3/SDL.h>
+#include <math.h>
+#include <string.h>
+#include "config.h"
+#include "physics.h"
+#include "render/pipeline.h"
+
+#define RACERS_MAX 32
+#define RACERS_MAX_SLOTS 8
+#define RACER_LINE_PROBE_UP 120.0f    // a step higher than this ends the line
+#define RACER_LINE_PROBE_DOWN 400.0f  // so does a drop deeper than this
+#define RACER_ACCEL 150.0f            // kinematic speed change (world units/s^2)
+#define RACER_MIN_SPEED 20.0f
+#define RACER_PROJECT_WINDOW 64       // line points searched around the racer when demoting
+
+typedef struct {
+    float x, y;   // ground point
+    float s;      // arc length from the start
+} LinePoint;
+
+typedef struct {
+    float s, v;    // position along the line and speed
+    float cruise;  // flat-ground speed
+    float spin;    // wheel angle (kinematic)
+    int slot;      // full car slot, -1 = kinematic
+} Racer;
+
+typedef struct {
+    Car car;
+    int racer;  // -1 = free
+} FullSlot;
+
+// What the main thread needs to draw a racer; published at every LOD tick
+typedef struct {
+    int slot;
+    float s, v, spin;
+} RacerView;
+
+static LinePoint* g_line = NULL;
+static int g_line_count = 0;
+static Racer g_racers[RACERS_MAX];
+static int g_racer_count = 0;
+static FullSlot g_slots[RACERS_MAX_SLOTS];
+static int g_slot_count = 0;
+static CarConfig g_cfg;
+static GLuint g_tex_body = 0, g_tex_wheel = 0;
+static float g_lod_accum = 0.0f;
+static unsigned int g_promotions = 0, g_demotions = 0;
+
+static SDL_Mutex* g_view_mtx = NULL;
+static RacerView g_views[RACERS_MAX];
+static Uint64 g_view_ns = 0;
+
+static float line_length(void) {
+    return g_line_count > 0 ? g_line[g_line_count - 1].s : 0.0f;
+}
+
+// Ground point at arc length s (clamped to the line)
+static void line_point(float s, float* x, float* y) {
+    if (s <= 0.0f || g_line_count < 2) {
+        *x = g_line[0].x;
+        *y = g_line[0].y;
+        return;
+    }
+    int lo = 0, hi = g_line_count - 1;
+    if (s >= g_line[hi].s) {
+        *x = g_line[hi].x;
+        *y = g_line[hi].y;
+        return;
+    }
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (g_line[mid].s <= s)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    const LinePoint* a = &g_line[lo];
+    const LinePoint* b = &g_line[hi];
+    float t = (b->s > a->s) ? (s - a->s) / (b->s - a->s) : 0.0f;
+    *x = a->x + (b->x - a->x) * t;
+    *y = a->y + (b->y - a->y) * t;
+}
+
+// Car pose on the line at s: chassis centre and angle, with both wheels on the ground
+static void line_pose(float s, float* cx, float* cy, float* angle) {
+    float bx, by, fx, fy;
+    line_point(s - g_cfg.axle_offset_x_b, &bx, &by);
+    line_point(s + g_cfg.axle_offset_x_f, &fx, &fy);
+    float a = atan2f(fy - by, fx - bx);
+    float c = cosf(a), sn = sinf(a);
+    // Rear wheel centre one radius above the ground, chassis centre at (axle_b, h/2) from it
+    float wx = bx - sn * g_cfg.wheel_radius, wy = by + c * g_cfg.wheel_radius;
+    float ox = g_cfg.axle_offset_x_b, oy = g_cfg.body_h * 0.5f;
+    *cx = wx + c * ox - sn * oy;
+    *cy = wy + sn * ox + c * oy;
+    *angle = a;
+}
+
+// Wheel centres for a chassis pose
+static void wheel_positions(float cx, float cy, float angle, float* xy4) {
+    float c = cosf(angle), sn = sinf(angle);
+    float oy = -g_cfg.body_h * 0.5f;
+    float ox[2] = {-g_cfg.axle_offset_x_b, g_cfg.axle_offset_x_f};
+    for (int i = 0; i < 2; i++) {
+        xy4[i * 2 + 0] = cx + c * ox[i] - sn * oy;
+        xy4[i * 2 + 1] = cy + sn * ox[i] + c * oy;
+    }
+}
+
+// Speed the racer aims for at s: slower uphill, faster downhill
+static float target_speed(const Racer* r) {
+    float x0, y0, x1, y1;
+    line_point(r->s - 16.0f, &x0, &y0);
+    line_point(r->s + 16.0f, &x1, &y1);
+    float slope = atan2f(y1 - y0, x1 - x0);
+    return SDL_max(r->cruise * (1.0f - 0.5f * sinf(slope)), RACER_MIN_SPEED);
+}
+
+// Arc length of the line point nearest (x,y), searching around s
+static float line_project(float s, float x, float y) {
+    int lo = 0, hi = g_line_count - 1;
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (g_line[mid].s <= s)
+            lo = mid;
+        else
+            hi = mid;
+    }
+    int first = SDL_max(lo - RACER_PROJECT_WINDOW, 0);
+    int last = SDL_min(lo + RACER_PROJECT_WINDOW, g_line_count - 2);
+    float best_d2 = 1e30f, best_s = s;
+    for (int i = first; i <= last; i++) {
+        const LinePoint* a = &g_line[i];
+        const LinePoint* b = &g_line[i + 1];
+        float dx = b->x - a->x, dy = b->y - a->y;
+        float len2 = dx * dx + dy * dy;
+        float t = len2 > 0.0f ? ((x - a->x) * dx + (y - a->y) * dy) / len2 : 0.0f;
+        t = fminf(fmaxf(t, 0.0f), 1.0f);
+        float ex = a->x + dx * t - x, ey = a->y + dy * t - y;
+        float d2 = ex * ex + ey * ey;
+        if (d2 < best_d2) {
+            best_d2 = d2;
+            best_s = a->s + (b->s - a->s) * t;
+        }
+    }
+    return best_s;
+}
+
+static bool build_line(float start_x, float start_y) {
+    int cap = (int)(APP_RACER_LINE_LENGTH / APP_RACER_LINE_STEP) + 1;
+    g_line = (LinePoint*)SDL_malloc(sizeof(LinePoint) * (size_t)cap);
+    if (!g_line)
+        return false;
+    g_line_count = 0;
+    float y_prev = start_y;
+    // The first probe searches further down for the floor under the spawn
+    float up = RACER_LINE_PROBE_UP, down = RACER_LINE_PROBE_DOWN * 4.0f;
+    for (int i = 0; i < cap; i++) {
+        float x = start_x + (float)i * APP_RACER_LINE_STEP;
+        RayQuery q = {x, y_prev + up, x, y_prev - down, NULL};
+        RaycastCallback hit;
+        physics_raycast_batch(&q, &hit, 1, PHYS_RAY_IGNORE_DYNAMIC);
+        // Stop at a wall (probe starts inside geometry) or a gap
+        if (!hit.hit || hit.fraction <= 0.0f)
+            break;
+        g_line[g_line_count].x = x;
+        g_line[g_line_count].y = hit.y;
+        g_line_count++;
+        y_prev = hit.y;
+        down = RACER_LINE_PROBE_DOWN;
+    }
+    if (g_line_count < 2) {
+        SDL_free(g_line);
+        g_line = NULL;
+        g_line_count = 0;
+        return false;
+    }
+    // Smooth out mesh seams, keeping the end points
+    for (int pass = 0; pass < 2; pass++) {
+        float prev = g_line[0].y;
+        for (int i = 1; i + 1 < g_line_count; i++) {
+            float cur = g_line[i].y;
+            g_line[i].y = (prev + cur * 2.0f + g_line[i + 1].y) * 0.25f;
+            prev = cur;
+        }
+    }
+    g_line[0].s = 0.0f;
+    for (int i = 1; i < g_line_count; i++) {
+        float dx = g_line[i].x - g_line[i - 1].x, dy = g_line[i].y - g_line[i - 1].y;
+        g_line[i].s = g_line[i - 1].s + sqrtf(dx * dx + dy * dy);
+    }
+    return true;
+}
+
+static void publish_views(void) {
+    SDL_LockMutex(g_view_mtx);
+    for (int i = 0; i < g_racer_count; i++) {
+        const Racer* r = &g_racers[i];
+        g_views[i] = (RacerView){r->slot, r->s, r->v, r->spin};
+    }
+    g_view_ns = SDL_GetTicksNS();
+    SDL_UnlockMutex(g_view_mtx);
+}
+
+static void promote(int ri, int slot) {
+    Racer* r = &g_racers[ri];
+    Car* c = &g_slots[slot].car;
+    float cx, cy, ang, wheels[4];
+    line_pose(r->s, &cx, &cy, &ang);
+    wheel_positions(cx, cy, ang, wheels);
+    float vx = cosf(ang) * r->v, vy = sinf(ang) * r->v;
+    b2Body* bodies[3] = {c->body, c->wheel_b, c->wheel_f};
+    float pos[6] = {cx, cy, wheels[0], wheels[1], wheels[2], wheels[3]};
+    for (int i = 0; i < 3; i++) {
+        // Queued in order: the teleport clears velocities, the later commands set them
+        physics_set_body_enabled(bodies[i], true);
+        physics_teleport_body(bodies[i], pos[i * 2], pos[i * 2 + 1]);
+        physics_set_angle(bodies[i], i == 0 ? ang : r->spin);
+        physics_set_velocity(bodies[i], vx, vy);
+        if (i > 0)
+            physics_set_angular_velocity(bodies[i], -r->v / g_cfg.wheel_radius);
+    }
+    c->fuel = c->max_fuel;
+    g_slots[slot].racer = ri;
+    r->slot = slot;
+    g_promotions++;
+}
+
+static void demote(int ri) {
+    Racer* r = &g_racers[ri];
+    Car* c = &g_slots[r->slot].car;
+    float x, y, vx, vy;
+    physics_get_position(c->body, &x, &y);
+    physics_get_velocity(c->body, &vx, &vy);
+    float ang = physics_get_angle(c->body);
+    r->s = line_project(r->s, x, y);
+    r->v = SDL_max(vx * cosf(ang) + vy * sinf(ang), 0.0f);
+    r->spin = physics_get_angle(c->wheel_b);
+    physics_set_body_enabled(c->body, false);
+    physics_set_body_enabled(c->wheel_b, false);
+    physics_set_body_enabled(c->wheel_f, false);
+    g_slots[r->slot].racer = -1;
+    r->slot = -1;
+    g_demotions++;
+}
+
+// Full racer: track its place on the line from the chassis
+static void full_track(Racer* r) {
+    const Car* c = &g_slots[r->slot].car;
+    float x, y, vx, vy;
+    physics_get_position(c->body, &x, &y);
+    physics_get_velocity(c->body, &vx, &vy);
+    r->s = line_project(r->s, x, y);
+    r->v = sqrtf(vx * vx + vy * vy);
+}
+
+static float racer_distance2(const Racer* r, float fx, float fy) {
+    float x, y;
+    if (r->slot >= 0) {
+        physics_get_position(g_slots[r->slot].car.body, &x, &y);
+    } else {
+        float ang;
+        line_pose(r->s, &x, &y, &ang);
+    }
+    return (x - fx) * (x - fx) + (y - fy) * (y - fy);
+}
+
+static void lod_tick(float dt, float fx, float fy) {
+    float len = line_length();
+    float promote2 = APP_RACER_PROMOTE_DIST * APP_RACER_PROMOTE_DIST;
+    float demote2 = APP_RACER_DEMOTE_DIST * APP_RACER_DEMOTE_DIST;
+    // Racers demoted this tick keep their kinematic state until the next one, or a racer at the
+    // line end next to the player would be promoted straight back
+    bool demoted[RACERS_MAX] = {false};
+    // Kinematic model, and full racers that left the player behind or reached the end
+    for (int i = 0; i < g_racer_count; i++) {
+        Racer* r = &g_racers[i];
+        if (r->slot >= 0) {
+            full_track(r);
+            bool at_end = r->s >= len - APP_RACER_LINE_STEP;
+            if (at_end || racer_distance2(r, fx, fy) > demote2) {
+                demote(i);
+                demoted[i] = true;
+                if (at_end)
+                    r->s = 0.0f;  // back to the start, like the kinematic model
+            }
+            continue;
+        }
+        float target = target_speed(r);
+        float dv = fminf(fmaxf(target - r->v, -RACER_ACCEL * dt), RACER_ACCEL * dt);
+        r->v += dv;
+        r->s += r->v * dt;
+        r->spin -= r->v * dt / g_cfg.wheel_radius;
+        if (r->s >= len)
+            r->s = 0.0f;  // back to the start
+    }
+    // Free slots go to the nearest kinematic racers inside the promote distance
+    for (;;) {
+        int slot = -1;
+        for (int k = 0; k < g_slot_count && slot < 0; k++) {
+            if (g_slots[k].racer < 0)
+                slot = k;
+        }
+        if (slot < 0)
+            break;
+        int best = -1;
+        float best_d2 = promote2;
+        for (int i = 0; i < g_racer_count; i++) {
+            if (g_racers[i].slot >= 0 || demoted[i])
+                continue;
+            float d2 = racer_distance2(&g_racers[i], fx, fy);
+            if (d2 < best_d2) {
+                best_d2 = d2;
+                best = i;
+            }
+        }
+        if (best < 0)
+            break;
+        promote(best, slot);
+    }
+    publish_views();
+}
+
+bool racers_init(const Car* look, float start_x, float start_y, int count) {
+    g_cfg = car_default_config();
+    count = SDL_min(count, RACERS_MAX);
+    if (count <= 0)
+        return false;
+    if (!build_line(start_x, start_y)) {
+        SDL_Log("racers: no ground under (%.0f, %.0f), racers disabled", start_x, start_y);
+        return false;
+    }
+    g_view_mtx = SDL_CreateMutex();
+    if (!g_view_mtx)
+        return false;
+    g_tex_body = look ? look->tex_body : 0;
+    g_tex_wheel = look ? look->tex_wheel : 0;
+    g_slot_count = SDL_min(APP_RACER_FULL_SLOTS, RACERS_MAX_SLOTS);
+    for (int k = 0; k < g_slot_count; k++) {
+        FullSlot* fs = &g_slots[k];
+        car_init_shared(&fs->car, look, g_line[0].x, g_line[0].y);
+        physics_set_body_enabled(fs->car.body, false);
+        physics_set_body_enabled(fs->car.wheel_b, false);
+        physics_set_body_enabled(fs->car.wheel_f, false);
+        fs->racer = -1;
+    }
+    g_racer_count = count;
+    for (int i = 0; i < count; i++) {
+        Racer* r = &g_racers[i];
+        // Staggered grid with a spread of cruise speeds
+        r->s = fminf((float)(count - i) * APP_RACER_SPACING, line_length());
+        r->cruise = APP_RACER_SPEED * (0.9f + 0.02f * (float)((i * 7) % 11));
+        r->v = 0.0f;
+        r->spin = 0.0f;
+        r->slot = -1;
+    }
+    g_lod_accum = 0.0f;
+    publish_views();
+    SDL_Log("racers: %d racers, %d full slots, line of %d points (%.0f units)", count,
+            g_slot_count, g_line_count, line_length());
+    return true;
+}
+
+void racers_shutdown(void) {
+    if (g_racer_count > 0)
+        SDL_Log("racers: %u promotions, %u demotions", g_promotions, g_demotions);
+    // Slot bodies go down with the world; textures belong to the look car
+    SDL_free(g_line);
+    g_line = NULL;
+    g_line_count = 0;
+    g_racer_count = 0;
+    g_slot_count = 0;
+    if (g_view_mtx) {
+        SDL_DestroyMutex(g_view_mtx);
+        g_view_mtx = NULL;
+    }
+}
+
+void racers_fixed(float dt, float focus_x, float focus_y) {
+    if (g_racer_count == 0)
+        return;
+    // Full racers: hold the cruise speed on the wheel motors and keep the chassis parallel to
+    // the line with the yaw torque
+    for (int k = 0; k < g_slot_count; k++) {
+        FullSlot* fs = &g_slots[k];
+        if (fs->racer < 0)
+            continue;
+        const Racer* r = &g_racers[fs->racer];
+        float cx, cy, line_ang;
+        line_pose(r->s, &cx, &cy, &line_ang);
+        float err = physics_get_angle(fs->car.body) - line_ang;
+        err = atan2f(sinf(err), cosf(err));
+        float av = physics_get_angular_velocity(fs->car.body);
+        CarControls ctl = {0};
+        ctl.throttle =
+            fminf(target_speed(r) / (g_cfg.motor_speed * g_cfg.wheel_radius), 1.0f);
+        ctl.yaw = fminf(fmaxf(err * 1.5f + av * 0.25f, -1.0f), 1.0f);
+        car_drive(&fs->car, &ctl, dt);
+    }
+    g_lod_accum += dt;
+    float lod_dt = 1.0f / APP_RACER_LOD_HZ;
+    if (g_lod_accum >= lod_dt) {
+        lod_tick(g_lod_accum, focus_x, focus_y);
+        g_lod_accum = 0.0f;
+    }
+}
+
+void racers_world_restored(void) {
+    // The snapshot put the slot bodies back as they were; hand every racer to the kinematic model
+    // from its own state and park all slots again
+    for (int k = 0; k < g_slot_count; k++) {
+        FullSlot* fs = &g_slots[k];
+        if (fs->racer >= 0) {
+            g_racers[fs->racer].slot = -1;
+            fs->racer = -1;
+            g_demotions++;
+        }
+        physics_set_body_enabled(fs->car.body, false);
+        physics_set_body_enabled(fs->car.wheel_b, false);
+        physics_set_body_enabled(fs->car.wheel_f, false);
+    }
+    if (g_racer_count > 0)
+        publish_views();
+}
+
+void racers_render(void) {
+    if (g_racer_count == 0)
+        return;
+    RacerView views[RACERS_MAX];
+    SDL_LockMutex(g_view_mtx);
+    memcpy(views, g_views, sizeof(RacerView) * (size_t)g_racer_count);
+    Uint64 published = g_view_ns;
+    SDL_UnlockMutex(g_view_mtx);
+    // Extrapolate at most two LOD ticks (the sim may be paused or slowed)
+    float ahead = (float)((SDL_GetTicksNS() - published) / 1.0e9);
+    ahead = fminf(ahead, 2.0f / APP_RACER_LOD_HZ);
+    float d = g_cfg.wheel_radius * 2.0f;
+    for (int i = 0; i < g_racer_count; i++) {
+        const RacerView* v = &views[i];
+        if (v->slot >= 0) {
+            car_render(&g_slots[v->slot].car);
+            continue;
+        }
+        float s = fminf(v->s + v->v * ahead, line_length());
+        float spin = v->spin - v->v * ahead / g_cfg.wheel_radius;
+        float cx, cy, ang, wheels[4];
+        line_pose(s, &cx, &cy, &ang);
+        wheel_positions(cx, cy, ang, wheels);
+        pipeline_sprite_quad_rot(cx, cy, g_cfg.body_w, g_cfg.body_h, ang, g_tex_body, 1, 1, 1, 1);
+        pipeline_sprite_quad_rot(wheels[0], wheels[1], d, d, spin, g_tex_wheel, 1, 1, 1, 1);
+        pipeline_sprite_quad_rot(wheels[2], wheels[3], d, d, spin, g_tex_wheel, 1, 1, 1, 1);
+    }
+}
+
+void racers_get_stats(RacerStats* out) {
+    if (!out)
+        return;
+    out->racers = g_racer_count;
+    out->full = 0;
+    for (int k = 0; k < g_slot_count; k++) {
+        out->full += g_slots[k].racer >= 0 ? 1 : 0;
+    }
+    out->promotions = g_promotions;
+    out->demotions = g_demotions;
+    out->line_points = g_line_count;
+    out->line_length = line_length();
+}
@@ -0,0 +1,41 @@
+#pragma once
+#include <stdbool.h>
+#include "entities/car.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// AI racers with simulation level of detail. A racing line is sampled once from the static ground
+// (downward probes against the static colliders) starting at the spawn. Far from the player
+// a racer is a point on that line advanced by a kinematic speed model at APP_RACER_LOD_HZ, drawn
+// with the car sprites; no Box2D bodies. Near the player it takes one of APP_RACER_FULL_SLOTS
+// full cars (chassis, wheels and wheel joints created at load and parked disabled, like the
+// projectile pools) and drives it with motor and yaw controls. Promotion hands over pose, speed
+// and wheel spin; demotion projects the chassis back onto the line. Distances use hysteresis.
+
+typedef struct {
+    int racers;
+    int full;  // racers on full bodies right now
+    unsigned int promotions;
+    unsigned int demotions;
+    int line_points;
+    float line_length;
+} RacerStats;
+
+// Sample the racing line from (start_x, start_y) and place count racers along its start. Needs
+// the map colliders. Car sprites are borrowed from look.
+bool racers_init(const Car* look, float start_x, float start_y, int count);
+void racers_shutdown(void);
+
+// Sim thread, every tick: drive the full racers. The kinematic model and the LOD decisions run at
+// APP_RACER_LOD_HZ. (focus_x, focus_y) is the player.
+void racers_fixed(float dt, float focus_x, float focus_y);
+// Sim thread, after a physics snapshot restore: every racer returns to the kinematic model
+void racers_world_restored(void);
+// Main thread, between pipeline begin/end. Kinematic racers are extrapolated from the last tick.
+void racers_render(void);
+void racers_get_stats(RacerStats* out);
+
+#ifdef __cplusplus
+}
+#endif
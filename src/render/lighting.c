@@ -0,0 +1,838 @@
+#include "lighting.h"
+#include <SDL3/SDL.h>
+#include <glad/gl.h>
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ame/camera.h"
+#include "physics.h"
+
+// Occluder grid cell size in world units
+#define LIGHT_GRID_CELL 128.0f
+// Upper bound on occluders considered per light (keeps the O(n^2) polygon build bounded)
+#define LIGHT_MAX_CANDIDATES 1024
+#define LIGHT_MAX_PENDING_FLASHES 32
+#define LIGHT_ANGLE_EPS 1e-4f
+#define LIGHT_PI 3.14159265358979f
+
+static const char* LIGHT_VS =
+    "#version 450 core\n"
+    "layout(location=0) in vec2 a_pos;\n"
+    "layout(location=1) in vec3 a_light;  // center x,y and radius\n"
+    "layout(location=2) in vec3 a_col;\n"
+    "uniform vec2 u_res;\n"
+    "uniform vec4 u_cam; // x,y,zoom,rot\n"
+    "out vec2 v_world;\n"
+    "out vec3 v_light;\n"
+    "out vec3 v_col;\n"
+    "void main(){\n"
+    "  vec2 p = (a_pos - u_cam.xy) * u_cam.z;\n"
+    "  gl_Position = vec4((p.x/u_res.x)*2.0 - 1.0, (p.y/u_res.y)*2.0 - 1.0, 0.0, 1.0);\n"
+    "  v_world = a_pos;\n"
+    "  v_light = a_light;\n"
+    "  v_col = a_col;\n"
+    "}\n";
+
+static const char* LIGHT_FS =
+    "#version 450 core\n"
+    "in vec2 v_world;\n"
+    "in vec3 v_light;\n"
+    "in vec3 v_col;\n"
+    "out vec4 frag;\n"
+    "void main(){\n"
+    "  float d = clamp(length(v_world - v_light.xy) / v_light.z, 0.0, 1.0);\n"
+    "  float att = (1.0 - d) * (1.0 - d);\n"
+    "  frag = vec4(v_col * att, 1.0);\n"
+    "}\n";
+
+// Multiply pass: fullscreen triangle sampling the lightmap
+static const char* APPLY_VS =
+    "#version 450 core\n"
+    "out vec2 v_uv;\n"
+    "void main(){\n"
+    "  vec2 pos;\n"
+    "  if (gl_VertexID == 0) { pos = vec2(-1.0, -1.0); v_uv = vec2(0.0, 0.0); }\n"
+    "  else if (gl_VertexID == 1) { pos = vec2( 3.0, -1.0); v_uv = vec2(2.0, 0.0); }\n"
+    "  else { pos = vec2(-1.0,  3.0); v_uv = vec2(0.0, 2.0); }\n"
+    "  gl_Position = vec4(pos, 0.0, 1.0);\n"
+    "}\n";
+
+static const char* APPLY_FS =
+    "#version 450 core\n"
+    "in vec2 v_uv;\n"
+    "uniform sampler2D u_tex;\n"
+    "out vec4 frag;\n"
+    "void main(){ frag = vec4(texture(u_tex, v_uv).rgb, 1.0); }\n";
+
+typedef struct {
+    float x0, y0, x1, y1;
+} Segment;
+
+typedef struct {
+    Segment* segs;
+    int count;
+    float bounds[4];  // min x, min y, max x, max y
+} OccluderGroup;
+
+typedef LightingVertex LightVtx;
+
+typedef struct {
+    bool used;
+    bool enabled;
+    bool cone;
+    float x, y, radius;
+    float dir, half_angle;
+    float r, g, b, intensity;
+    float ttl, duration;  // duration > 0 marks a transient flash
+    // Cached visibility polygon (ring of world-space points around the light)
+    float* ring;
+    int ring_count;
+    int ring_cap;
+    bool cache_valid;
+    unsigned int cache_version;
+} Light;
+
+typedef struct {
+    float x, y, radius, r, g, b, duration;
+} PendingFlash;
+
+static struct {
+    bool ready;
+    bool gl_ready, gl_failed;  // GL objects exist only once lighting_apply has run
+    float ambient_r, ambient_g, ambient_b;
+
+    // Occluders and uniform grid index (CSR layout)
+    Segment* segs;
+    int seg_count;
+    unsigned int geom_version;
+    float grid_x0, grid_y0;
+    int grid_w, grid_h;
+    int* cell_start;  // grid_w*grid_h + 1
+    int* cell_items;
+    unsigned int* seg_stamp;
+    unsigned int query_stamp;
+    // Occluder groups, replaced one at a time (lighting_set_occluder_group)
+    OccluderGroup* groups;
+    int group_count;
+    int group_seg_count;
+
+    Light lights[LIGHTING_MAX_LIGHTS];
+
+    // Flashes queued from other threads, drained in lighting_update
+    SDL_Mutex* flash_mtx;
+    PendingFlash pending[LIGHT_MAX_PENDING_FLASHES];
+    int pending_count;
+
+    // Scratch buffers reused across frames
+    Segment* cand;
+    int cand_cap;
+    float* angles;
+    int angles_cap;
+    LightVtx* verts;
+    size_t verts_cap;
+
+    // GL objects
+    GLuint light_prog, apply_prog;
+    GLint light_u_res, light_u_cam, apply_u_tex;
+    GLuint vao, vbo, apply_vao;
+    GLuint fbo, tex;
+    int tex_w, tex_h;
+
+    LightingStats stats;
+} g_light = {0};
+
+static GLuint compile_shader(GLenum type, const char* src) {
+    GLuint sh = glCreateShader(type);
+    glShaderSource(sh, 1, &src, NULL);
+    glCompileShader(sh);
+    GLint ok = 0;
+    glGetShaderiv(sh, GL_COMPILE_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        GLsizei n = 0;
+        glGetShaderInfoLog(sh, 1024, &n, log);
+        SDL_Log("Lighting shader compile error: %.*s", (int)n, log);
+    }
+    return sh;
+}
+
+static GLuint build_program(const char* vs_src, const char* fs_src) {
+    GLuint vs = compile_shader(GL_VERTEX_SHADER, vs_src);
+    GLuint fs = compile_shader(GL_FRAGMENT_SHADER, fs_src);
+    GLuint prog = glCreateProgram();
+    glAttachShader(prog, vs);
+    glAttachShader(prog, fs);
+    glLinkProgram(prog);
+    GLint ok = 0;
+    glGetProgramiv(prog, GL_LINK_STATUS, &ok);
+    if (!ok) {
+        char log[1024];
+        GLsizei n = 0;
+        glGetProgramInfoLog(prog, 1024, &n, log);
+        SDL_Log("Lighting program link error: %.*s", (int)n, log);
+    }
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+    return prog;
+}
+
+bool lighting_init(void) {
+    memset(&g_light, 0, sizeof(g_light));
+    g_light.ambient_r = g_light.ambient_g = g_light.ambient_b = 1.0f;
+    g_light.flash_mtx = SDL_CreateMutex();
+    g_light.ready = g_light.flash_mtx != NULL;
+    return g_light.ready;
+}
+
+// Programs and vertex state for lighting_apply, created on first use so that a Vulkan pipeline
+// (which only calls lighting_build_view) never needs a GL context
+static bool ensure_gl(void) {
+    if (g_light.gl_ready || g_light.gl_failed)
+        return g_light.gl_ready;
+    g_light.light_prog = build_program(LIGHT_VS, LIGHT_FS);
+    g_light.apply_prog = build_program(APPLY_VS, APPLY_FS);
+    g_light.light_u_res = glGetUniformLocation(g_light.light_prog, "u_res");
+    g_light.light_u_cam = glGetUniformLocation(g_light.light_prog, "u_cam");
+    g_light.apply_u_tex = glGetUniformLocation(g_light.apply_prog, "u_tex");
+
+    glGenVertexArrays(1, &g_light.vao);
+    glGenBuffers(1, &g_light.vbo);
+    glBindVertexArray(g_light.vao);
+    glBindBuffer(GL_ARRAY_BUFFER, g_light.vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(LightVtx), (void*)offsetof(LightVtx, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(LightVtx),
+                          (void*)offsetof(LightVtx, lx));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(LightVtx), (void*)offsetof(LightVtx, r));
+    glGenVertexArrays(1, &g_light.apply_vao);
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    g_light.gl_ready = g_light.light_prog && g_light.apply_prog;
+    g_light.gl_failed = !g_light.gl_ready;
+    return g_light.gl_ready;
+}
+
+static void free_grid(void) {
+    free(g_light.segs);
+    free(g_light.cell_start);
+    free(g_light.cell_items);
+    free(g_light.seg_stamp);
+    g_light.segs = NULL;
+    g_light.cell_start = NULL;
+    g_light.cell_items = NULL;
+    g_light.seg_stamp = NULL;
+    g_light.seg_count = 0;
+    g_light.grid_w = g_light.grid_h = 0;
+}
+
+void lighting_shutdown(void) {
+    for (int i = 0; i < LIGHTING_MAX_LIGHTS; i++) {
+        free(g_light.lights[i].ring);
+    }
+    free_grid();
+    for (int i = 0; i < g_light.group_count; i++) {
+        free(g_light.groups[i].segs);
+    }
+    free(g_light.groups);
+    free(g_light.cand);
+    free(g_light.angles);
+    free(g_light.verts);
+    if (g_light.tex)
+        glDeleteTextures(1, &g_light.tex);
+    if (g_light.fbo)
+        glDeleteFramebuffers(1, &g_light.fbo);
+    if (g_light.vbo)
+        glDeleteBuffers(1, &g_light.vbo);
+    if (g_light.vao)
+        glDeleteVertexArrays(1, &g_light.vao);
+    if (g_light.apply_vao)
+        glDeleteVertexArrays(1, &g_light.apply_vao);
+    if (g_light.light_prog)
+        glDeleteProgram(g_light.light_prog);
+    if (g_light.apply_prog)
+        glDeleteProgram(g_light.apply_prog);
+    if (g_light.flash_mtx)
+        SDL_DestroyMutex(g_light.flash_mtx);
+    memset(&g_light, 0, sizeof(g_light));
+}
+
+// Occluder set ------------------------------------------------------------------------------
+
+typedef struct {
+    int64_t k[4];  // quantized endpoints, ordered so shared edges compare equal
+    int index;
+} SegKey;
+
+static int compare_seg_key(const void* a, const void* b) {
+    const SegKey* ka = (const SegKey*)a;
+    const SegKey* kb = (const SegKey*)b;
+    for (int i = 0; i < 4; i++) {
+        if (ka->k[i] < kb->k[i])
+            return -1;
+        if (ka->k[i] > kb->k[i])
+            return 1;
+    }
+    return 0;
+}
+
+static int grid_cell_x(float x) {
+    int cx = (int)floorf((x - g_light.grid_x0) / LIGHT_GRID_CELL);
+    return cx < 0 ? 0 : (cx >= g_light.grid_w ? g_light.grid_w - 1 : cx);
+}
+
+static int grid_cell_y(float y) {
+    int cy = (int)floorf((y - g_light.grid_y0) / LIGHT_GRID_CELL);
+    return cy < 0 ? 0 : (cy >= g_light.grid_h ? g_light.grid_h - 1 : cy);
+}
+
+// Weld: triangulated colliders produce every interior edge twice; those never bound a shadow.
+// out receives the remaining segments (room for count) and their bounds; returns their number.
+static int weld_segments(const float* xyxy, int count, Segment* out, float* bounds) {
+    SegKey* keys = malloc((size_t)count * sizeof(SegKey));
+    int nk = 0;
+    for (int i = 0; i < count; i++) {
+        const float* s = xyxy + (size_t)i * 4;
+        int64_t ax = llroundf(s[0] * 64.0f), ay = llroundf(s[1] * 64.0f);
+        int64_t bx = llroundf(s[2] * 64.0f), by = llroundf(s[3] * 64.0f);
+        if (ax == bx && ay == by)
+            continue;
+        bool swap = (bx < ax) || (bx == ax && by < ay);
+        keys[nk].k[0] = swap ? bx : ax;
+        keys[nk].k[1] = swap ? by : ay;
+        keys[nk].k[2] = swap ? ax : bx;
+        keys[nk].k[3] = swap ? ay : by;
+        keys[nk].index = i;
+        nk++;
+    }
+    qsort(keys, (size_t)nk, sizeof(SegKey), compare_seg_key);
+
+    int n = 0;
+    float minx = INFINITY, miny = INFINITY, maxx = -INFINITY, maxy = -INFINITY;
+    for (int i = 0; i < nk;) {
+        int j = i + 1;
+        while (j < nk && compare_seg_key(&keys[i], &keys[j]) == 0)
+            j++;
+        if (j - i == 1) {
+            const float* s = xyxy + (size_t)keys[i].index * 4;
+            out[n++] = (Segment){s[0], s[1], s[2], s[3]};
+            minx = fminf(minx, fminf(s[0], s[2]));
+            miny = fminf(miny, fminf(s[1], s[3]));
+            maxx = fmaxf(maxx, fmaxf(s[0], s[2]));
+            maxy = fmaxf(maxy, fmaxf(s[1], s[3]));
+        }
+        i = j;
+    }
+    free(keys);
+    bounds[0] = minx;
+    bounds[1] = miny;
+    bounds[2] = maxx;
+    bounds[3] = maxy;
+    return n;
+}
+
+void lighting_set_occluders(const float* xyxy, int count) {
+    free_grid();
+    g_light.geom_version++;
+    if (!xyxy || count <= 0)
+        return;
+
+    g_light.segs = malloc((size_t)count * sizeof(Segment));
+    float bounds[4];
+    g_light.seg_count = weld_segments(xyxy, count, g_light.segs, bounds);
+    if (g_light.seg_count == 0)
+        return;
+    float minx = bounds[0], miny = bounds[1], maxx = bounds[2], maxy = bounds[3];
+
+    // Bucket segments into every cell their bounding box touches
+    g_light.grid_x0 = minx;
+    g_light.grid_y0 = miny;
+    g_light.grid_w = (int)((maxx - minx) / LIGHT_GRID_CELL) + 1;
+    g_light.grid_h = (int)((maxy - miny) / LIGHT_GRID_CELL) + 1;
+    int cells = g_light.grid_w * g_light.grid_h;
+    g_light.cell_start = calloc((size_t)cells + 1, sizeof(int));
+    for (int pass = 0; pass < 2; pass++) {
+        for (int i = 0; i < g_light.seg_count; i++) {
+            const Segment* s = &g_light.segs[i];
+            int cx0 = grid_cell_x(fminf(s->x0, s->x1)), cx1 = grid_cell_x(fmaxf(s->x0, s->x1));
+            int cy0 = grid_cell_y(fminf(s->y0, s->y1)), cy1 = grid_cell_y(fmaxf(s->y0, s->y1));
+            for (int cy = cy0; cy <= cy1; cy++) {
+                for (int cx = cx0; cx <= cx1; cx++) {
+                    int c = cy * g_light.grid_w + cx;
+                    if (pass == 0)
+                        g_light.cell_start[c + 1]++;
+                    else
+                        g_light.cell_items[g_light.cell_start[c]++] = i;
+                }
+            }
+        }
+        if (pass == 0) {
+            for (int c = 0; c < cells; c++)
+                g_light.cell_start[c + 1] += g_light.cell_start[c];
+            g_light.cell_items = malloc((size_t)g_light.cell_start[cells] * sizeof(int));
+        } else {
+            // Second pass advanced every start to the next cell's start; shift back
+            for (int c = cells; c > 0; c--)
+                g_light.cell_start[c] = g_light.cell_start[c - 1];
+            g_light.cell_start[0] = 0;
+        }
+    }
+    g_light.seg_stamp = calloc((size_t)g_light.seg_count, sizeof(unsigned int));
+    g_light.query_stamp = 0;
+    g_light.stats.segments = (unsigned int)(g_light.seg_count + g_light.group_seg_count);
+    SDL_Log("lighting: %d occluder segments (%d before welding), grid %dx%d", g_light.seg_count,
+            count, g_light.grid_w, g_light.grid_h);
+}
+
+void lighting_build_occluders_from_physics(void) {
+    int n = physics_collect_static_segments(NULL, 0);
+    if (n <= 0) {
+        lighting_set_occluders(NULL, 0);
+        return;
+    }
+    float* segs = malloc((size_t)n * 4 * sizeof(float));
+    n = physics_collect_static_segments_ex(segs, n, PHYS_FLAG_DESTRUCTIBLE);
+    lighting_set_occluders(segs, n);
+    free(segs);
+}
+
+void lighting_set_occluder_group(int group, const float* xyxy, int count) {
+    if (group < 0)
+        return;
+    if (group >= g_light.group_count) {
+        if (count <= 0)
+            return;
+        int cap = group + 1;
+        OccluderGroup* groups = realloc(g_light.groups, (size_t)cap * sizeof(OccluderGroup));
+        if (!groups)
+            return;
+        memset(groups + g_light.group_count, 0,
+               (size_t)(cap - g_light.group_count) * sizeof(OccluderGroup));
+        g_light.groups = groups;
+        g_light.group_count = cap;
+    }
+    OccluderGroup* g = &g_light.groups[group];
+    g_light.group_seg_count -= g->count;
+    free(g->segs);
+    g->segs = NULL;
+    g->count = 0;
+    g_light.geom_version++;
+    if (!xyxy || count <= 0)
+        return;
+    g->segs = malloc((size_t)count * sizeof(Segment));
+    g->count = weld_segments(xyxy, count, g->segs, g->bounds);
+    g_light.group_seg_count += g->count;
+    g_light.stats.segments = (unsigned int)(g_light.seg_count + g_light.group_seg_count);
+}
+
+void lighting_set_ambient(float r, float g, float b) {
+    g_light.ambient_r = r;
+    g_light.ambient_g = g;
+    g_light.ambient_b = b;
+}
+
+// Lights ------------------------------------------------------------------------------------
+
+static int alloc_light(void) {
+    for (int i = 0; i < LIGHTING_MAX_LIGHTS; i++) {
+        if (!g_light.lights[i].used) {
+            Light* L = &g_light.lights[i];
+            float* ring = L->ring;
+            int cap = L->ring_cap;
+            memset(L, 0, sizeof(*L));
+            L->ring = ring;  // keep the allocation for reuse
+            L->ring_cap = cap;
+            L->used = true;
+            L->enabled = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+static Light* get_light(int id) {
+    if (id < 0 || id >= LIGHTING_MAX_LIGHTS || !g_light.lights[id].used)
+        return NULL;
+    return &g_light.lights[id];
+}
+
+int lighting_add_point(float x, float y, float radius, float r, float g, float b, float intensity) {
+    int id = alloc_light();
+    if (id < 0)
+        return -1;
+    Light* L = &g_light.lights[id];
+    L->x = x;
+    L->y = y;
+    L->radius = radius;
+    L->r = r;
+    L->g = g;
+    L->b = b;
+    L->intensity = intensity;
+    return id;
+}
+
+int lighting_add_cone(float x,
+                      float y,
+                      float radius,
+                      float dir,
+                      float half_angle,
+                      float r,
+                      float g,
+                      float b,
+                      float intensity) {
+    int id = lighting_add_point(x, y, radius, r, g, b, intensity);
+    if (id < 0)
+        return -1;
+    Light* L = &g_light.lights[id];
+    L->cone = true;
+    L->dir = dir;
+    L->half_angle = fminf(half_angle, LIGHT_PI);
+    return id;
+}
+
+void lighting_set_light_transform(int id, float x, float y, float dir) {
+    Light* L = get_light(id);
+    if (!L)
+        return;
+    if (L->x != x || L->y != y || (L->cone && L->dir != dir))
+        L->cache_valid = false;
+    L->x = x;
+    L->y = y;
+    L->dir = dir;
+}
+
+void lighting_set_light_enabled(int id, bool enabled) {
+    Light* L = get_light(id);
+    if (L)
+        L->enabled = enabled;
+}
+
+void lighting_remove(int id) {
+    Light* L = get_light(id);
+    if (L)
+        L->used = false;
+}
+
+void lighting_flash(float x, float y, float radius, float r, float g, float b, float duration) {
+    if (!g_light.ready || duration <= 0.0f)
+        return;
+    SDL_LockMutex(g_light.flash_mtx);
+    if (g_light.pending_count < LIGHT_MAX_PENDING_FLASHES) {
+        g_light.pending[g_light.pending_count++] = (PendingFlash){x, y, radius, r, g, b, duration};
+    }
+    SDL_UnlockMutex(g_light.flash_mtx);
+}
+
+void lighting_update(float dt) {
+    if (!g_light.ready)
+        return;
+    PendingFlash pending[LIGHT_MAX_PENDING_FLASHES];
+    SDL_LockMutex(g_light.flash_mtx);
+    int np = g_light.pending_count;
+    memcpy(pending, g_light.pending, (size_t)np * sizeof(PendingFlash));
+    g_light.pending_count = 0;
+    SDL_UnlockMutex(g_light.flash_mtx);
+
+    for (int i = 0; i < LIGHTING_MAX_LIGHTS; i++) {
+        Light* L = &g_light.lights[i];
+        if (!L->used || L->duration <= 0.0f)
+            continue;
+        L->ttl -= dt;
+        if (L->ttl <= 0.0f)
+            L->used = false;
+    }
+    for (int i = 0; i < np; i++) {
+        const PendingFlash* f = &pending[i];
+        int id = lighting_add_point(f->x, f->y, f->radius, f->r, f->g, f->b, 1.0f);
+        if (id < 0)
+            break;
+        g_light.lights[id].duration = f->duration;
+        g_light.lights[id].ttl = f->duration;
+    }
+}
+
+const LightingStats* lighting_get_stats(void) {
+    return &g_light.stats;
+}
+
+// Visibility polygons -----------------------------------------------------------------------
+
+static void push_candidate(int* n, Segment s) {
+    if (*n >= g_light.cand_cap) {
+        g_light.cand_cap = g_light.cand_cap ? g_light.cand_cap * 2 : 256;
+        g_light.cand = realloc(g_light.cand, (size_t)g_light.cand_cap * sizeof(Segment));
+    }
+    g_light.cand[(*n)++] = s;
+}
+
+static void push_angle(int* n, float a) {
+    if (*n >= g_light.angles_cap) {
+        g_light.angles_cap = g_light.angles_cap ? g_light.angles_cap * 2 : 512;
+        g_light.angles = realloc(g_light.angles, (size_t)g_light.angles_cap * sizeof(float));
+    }
+    g_light.angles[(*n)++] = a;
+}
+
+static int compare_float(const void* a, const void* b) {
+    float fa = *(const float*)a, fb = *(const float*)b;
+    return (fa > fb) - (fa < fb);
+}
+
+// Angle relative to the polygon start, wrapped into [0, 2pi)
+static float wrap_angle(float a) {
+    a = fmodf(a, 2.0f * LIGHT_PI);
+    return a < 0.0f ? a + 2.0f * LIGHT_PI : a;
+}
+
+static float cast_ray(float ox, float oy, float dx, float dy, int n) {
+    float best = INFINITY;
+    for (int i = 0; i < n; i++) {
+        const Segment* s = &g_light.cand[i];
+        float ex = s->x1 - s->x0, ey = s->y1 - s->y0;
+        float denom = dx * ey - dy * ex;
+        if (fabsf(denom) < 1e-9f)
+            continue;
+        float wx = s->x0 - ox, wy = s->y0 - oy;
+        float t = (wx * ey - wy * ex) / denom;
+        float u = (wx * dy - wy * dx) / denom;
+        if (t >= 0.0f && u >= 0.0f && u <= 1.0f && t < best)
+            best = t;
+    }
+    return best;
+}
+
+static void light_rebuild(Light* L) {
+    float R = L->radius;
+    int n = 0;
+
+    // Nearby occluders from the grid (stamped so segments spanning several cells come once)
+    if (g_light.seg_count > 0) {
+        if (++g_light.query_stamp == 0) {
+            memset(g_light.seg_stamp, 0, (size_t)g_light.seg_count * sizeof(unsigned int));
+            g_light.query_stamp = 1;
+        }
+        int cx0 = grid_cell_x(L->x - R), cx1 = grid_cell_x(L->x + R);
+        int cy0 = grid_cell_y(L->y - R), cy1 = grid_cell_y(L->y + R);
+        for (int cy = cy0; cy <= cy1 && n < LIGHT_MAX_CANDIDATES; cy++) {
+            for (int cx = cx0; cx <= cx1 && n < LIGHT_MAX_CANDIDATES; cx++) {
+                int c = cy * g_light.grid_w + cx;
+                for (int k = g_light.cell_start[c]; k < g_light.cell_start[c + 1]; k++) {
+                    int si = g_light.cell_items[k];
+                    if (g_light.seg_stamp[si] == g_light.query_stamp)
+                        continue;
+                    g_light.seg_stamp[si] = g_light.query_stamp;
+                    const Segment* s = &g_light.segs[si];
+                    if (fmaxf(s->x0, s->x1) < L->x - R || fminf(s->x0, s->x1) > L->x + R ||
+                        fmaxf(s->y0, s->y1) < L->y - R || fminf(s->y0, s->y1) > L->y + R)
+                        continue;
+                    push_candidate(&n, *s);
+                    if (n >= LIGHT_MAX_CANDIDATES)
+                        break;
+                }
+            }
+        }
+    }
+    for (int gi = 0; gi < g_light.group_count && n < LIGHT_MAX_CANDIDATES; gi++) {
+        const OccluderGroup* g = &g_light.groups[gi];
+        if (g->count == 0 || g->bounds[2] < L->x - R || g->bounds[0] > L->x + R ||
+            g->bounds[3] < L->y - R || g->bounds[1] > L->y + R)
+            continue;
+        for (int k = 0; k < g->count && n < LIGHT_MAX_CANDIDATES; k++) {
+            const Segment* s = &g->segs[k];
+            if (fmaxf(s->x0, s->x1) < L->x - R || fminf(s->x0, s->x1) > L->x + R ||
+                fmaxf(s->y0, s->y1) < L->y - R || fminf(s->y0, s->y1) > L->y + R)
+                continue;
+            push_candidate(&n, *s);
+        }
+    }
+    // Bounding square so every ray terminates
+    float x0 = L->x - R, y0 = L->y - R, x1 = L->x + R, y1 = L->y + R;
+    push_candidate(&n, (Segment){x0, y0, x1, y0});
+    push_candidate(&n, (Segment){x1, y0, x1, y1});
+    push_candidate(&n, (Segment){x1, y1, x0, y1});
+    push_candidate(&n, (Segment){x0, y1, x0, y0});
+
+    // Rays toward every endpoint, plus slightly to each side to see past corners
+    float base = L->cone ? L->dir - L->half_angle : 0.0f;
+    float span = L->cone ? 2.0f * L->half_angle : 2.0f * LIGHT_PI;
+    int na = 0;
+    for (int i = 0; i < n; i++) {
+        const Segment* s = &g_light.cand[i];
+        for (int e = 0; e < 2; e++) {
+            float px = e ? s->x1 : s->x0, py = e ? s->y1 : s->y0;
+            float a = wrap_angle(atan2f(py - L->y, px - L->x) - base);
+            for (int k = -1; k <= 1; k++) {
+                float ak = wrap_angle(a + (float)k * LIGHT_ANGLE_EPS);
+                if (!L->cone || ak <= span)
+                    push_angle(&na, ak);
+            }
+        }
+    }
+    if (L->cone) {
+        push_angle(&na, 0.0f);
+        push_angle(&na, span);
+    }
+    qsort(g_light.angles, (size_t)na, sizeof(float), compare_float);
+
+    if (na > L->ring_cap) {
+        L->ring_cap = na;
+        L->ring = realloc(L->ring, (size_t)L->ring_cap * 2 * sizeof(float));
+    }
+    L->ring_count = 0;
+    float prev = -1.0f;
+    for (int i = 0; i < na; i++) {
+        float a = g_light.angles[i];
+        if (a - prev < 1e-6f)
+            continue;  // duplicate direction
+        prev = a;
+        float dx = cosf(base + a), dy = sinf(base + a);
+        float t = cast_ray(L->x, L->y, dx, dy, n);
+        if (!isfinite(t))
+            t = R;
+        L->ring[L->ring_count * 2 + 0] = L->x + dx * t;
+        L->ring[L->ring_count * 2 + 1] = L->y + dy * t;
+        L->ring_count++;
+    }
+    L->cache_valid = true;
+    L->cache_version = g_light.geom_version;
+}
+
+static void push_vertex(size_t* n, const Light* L, float x, float y) {
+    if (*n >= g_light.verts_cap) {
+        g_light.verts_cap = g_light.verts_cap ? g_light.verts_cap * 2 : 4096;
+        g_light.verts = realloc(g_light.verts, g_light.verts_cap * sizeof(LightVtx));
+    }
+    float k = L->intensity;
+    if (L->duration > 0.0f)
+        k *= L->ttl / L->duration;
+    g_light.verts[(*n)++] = (LightVtx){x, y, L->x, L->y, L->radius, L->r * k, L->g * k, L->b * k};
+}
+
+static void ensure_lightmap(int w, int h) {
+    if (w < 1)
+        w = 1;
+    if (h < 1)
+        h = 1;
+    if (g_light.tex && g_light.tex_w == w && g_light.tex_h == h)
+        return;
+    if (g_light.tex)
+        glDeleteTextures(1, &g_light.tex);
+    if (g_light.fbo)
+        glDeleteFramebuffers(1, &g_light.fbo);
+    glGenTextures(1, &g_light.tex);
+    glBindTexture(GL_TEXTURE_2D, g_light.tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glGenFramebuffers(1, &g_light.fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, g_light.fbo);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, g_light.tex, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    g_light.tex_w = w;
+    g_light.tex_h = h;
+}
+
+bool lighting_build_view(const AmeCamera* cam,
+                         int viewport_w,
+                         int viewport_h,
+                         const LightingVertex** verts,
+                         size_t* count,
+                         float ambient[3]) {
+    g_light.stats.visible_lights = 0;
+    g_light.stats.rebuilt_lights = 0;
+    *verts = NULL;
+    *count = 0;
+    if (!g_light.ready || !cam || cam->zoom <= 0.0f)
+        return false;
+    // Lights only add, so a white ambient saturates everything: nothing to do
+    if (g_light.ambient_r >= 1.0f && g_light.ambient_g >= 1.0f && g_light.ambient_b >= 1.0f)
+        return false;
+
+    // World-space view rectangle (same mapping as the sprite shader)
+    float vx0 = cam->x, vy0 = cam->y;
+    float vx1 = vx0 + (float)viewport_w / cam->zoom;
+    float vy1 = vy0 + (float)viewport_h / cam->zoom;
+
+    size_t nv = 0;
+    for (int i = 0; i < LIGHTING_MAX_LIGHTS; i++) {
+        Light* L = &g_light.lights[i];
+        if (!L->used || !L->enabled || L->radius <= 0.0f)
+            continue;
+        if (L->x + L->radius < vx0 || L->x - L->radius > vx1 || L->y + L->radius < vy0 ||
+            L->y - L->radius > vy1)
+            continue;
+        g_light.stats.visible_lights++;
+        if (!L->cache_valid || L->cache_version != g_light.geom_version) {
+            light_rebuild(L);
+            g_light.stats.rebuilt_lights++;
+        }
+        int rc = L->ring_count;
+        int tris = L->cone ? rc - 1 : rc;
+        for (int t = 0; t < tris; t++) {
+            int a = t, b = (t + 1) % rc;
+            push_vertex(&nv, L, L->x, L->y);
+            push_vertex(&nv, L, L->ring[a * 2], L->ring[a * 2 + 1]);
+            push_vertex(&nv, L, L->ring[b * 2], L->ring[b * 2 + 1]);
+        }
+    }
+    *verts = g_light.verts;
+    *count = nv;
+    ambient[0] = g_light.ambient_r;
+    ambient[1] = g_light.ambient_g;
+    ambient[2] = g_light.ambient_b;
+    return true;
+}
+
+void lighting_apply(const AmeCamera* cam,
+                    int view_x,
+                    int view_y,
+                    int viewport_w,
+                    int viewport_h) {
+    const LightVtx* verts;
+    size_t nv;
+    float ambient[3];
+    if (!lighting_build_view(cam, viewport_w, viewport_h, &verts, &nv, ambient) || !ensure_gl())
+        return;
+
+    ensure_lightmap(viewport_w / LIGHTING_DOWNSCALE, viewport_h / LIGHTING_DOWNSCALE);
+    glBindFramebuffer(GL_FRAMEBUFFER, g_light.fbo);
+    glViewport(0, 0, g_light.tex_w, g_light.tex_h);
+    glClearColor(ambient[0], ambient[1], ambient[2], 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    if (nv > 0) {
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_ONE, GL_ONE);
+        glUseProgram(g_light.light_prog);
+        glBindVertexArray(g_light.vao);
+        if (g_light.light_u_res >= 0)
+            glUniform2f(g_light.light_u_res, (float)viewport_w, (float)viewport_h);
+        if (g_light.light_u_cam >= 0)
+            glUniform4f(g_light.light_u_cam, cam->x, cam->y, cam->zoom, cam->rotation);
+        glBindBuffer(GL_ARRAY_BUFFER, g_light.vbo);
+        glBufferData(GL_ARRAY_BUFFER, nv * sizeof(LightVtx), verts, GL_STREAM_DRAW);
+        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)nv);
+    }
+
+    // Multiply the lightmap over the scene
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(view_x, view_y, viewport_w, viewport_h);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_DST_COLOR, GL_ZERO);
+    glUseProgram(g_light.apply_prog);
+    glBindVertexArray(g_light.apply_vao);
+    if (g_light.apply_u_tex >= 0)
+        glUniform1i(g_light.apply_u_tex, 0);
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, g_light.tex);
+    glDrawArrays(GL_TRIANGLES, 0, 3);
+
+    glDisable(GL_BLEND);
+    glBindVertexArray(0);
+}
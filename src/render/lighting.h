@@ -0,0 +1,94 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Forward declare camera from engine C API
+typedef struct AmeCamera AmeCamera;
+
+// 2D dynamic lighting:
+// - Static occluder segments are extracted once (e.g. from map colliders) into a uniform grid
+// - Each visible light builds a visibility polygon against nearby segments; the polygon is cached
+//   while the light and the occluder set are unchanged
+// - The lightmap starts at the ambient color, lights are added on top, and the result multiplies
+//   the composited scene. At full white ambient (the default) the pass is skipped.
+
+#ifndef LIGHTING_MAX_LIGHTS
+#define LIGHTING_MAX_LIGHTS 64
+#endif
+// Lightmap is rendered at 1/N of the viewport resolution (it is smooth, so this is invisible)
+#define LIGHTING_DOWNSCALE 2
+
+bool lighting_init(void);
+void lighting_shutdown(void);
+
+// Replace the occluder set (x0,y0,x1,y1 per segment). Edges shared by two triangles are dropped.
+void lighting_set_occluders(const float* xyxy, int count);
+// Extract occluders from all static physics colliders (destructible terrain excluded: its chunks
+// keep their own groups)
+void lighting_build_occluders_from_physics(void);
+// Occluder group (e.g. one destructible terrain chunk) kept beside the static set, so it can be
+// replaced without rebuilding the grid. Shared edges are welded the same way; count 0 clears it.
+void lighting_set_occluder_group(int group, const float* xyxy, int count);
+
+void lighting_set_ambient(float r, float g, float b);
+
+// Persistent lights (main thread). Return a handle, or -1 when full.
+int lighting_add_point(float x, float y, float radius, float r, float g, float b, float intensity);
+// dir is the cone axis in radians, half_angle half of the opening angle
+int lighting_add_cone(float x,
+                      float y,
+                      float radius,
+                      float dir,
+                      float half_angle,
+                      float r,
+                      float g,
+                      float b,
+                      float intensity);
+void lighting_set_light_transform(int id, float x, float y, float dir);
+void lighting_set_light_enabled(int id, bool enabled);
+void lighting_remove(int id);
+
+// Short point light that fades out over duration seconds. Safe to call from any thread.
+void lighting_flash(float x, float y, float radius, float r, float g, float b, float duration);
+
+// Advance transient lights (main thread, once per frame)
+void lighting_update(float dt);
+
+// Render the lightmap for this view and multiply it over the view's rect of the default
+// framebuffer (called by the GL pipeline between the composite and sprite passes, once per
+// view). Visibility polygons are camera-independent, so split-screen views share them.
+void lighting_apply(const AmeCamera* cam,
+                    int view_x,
+                    int view_y,
+                    int viewport_w,
+                    int viewport_h);
+
+// Backend-neutral half of lighting_apply: the lightmap triangles of one view (valid until the
+// next call) and the ambient color the lightmap starts from. False when there is nothing to
+// apply. The Vulkan pipeline draws these itself; GL objects are only created by lighting_apply.
+typedef struct {
+    float x, y;     // world position
+    float lx, ly;   // light center
+    float radius;   // light radius
+    float r, g, b;  // premultiplied by intensity
+} LightingVertex;
+bool lighting_build_view(const AmeCamera* cam,
+                         int viewport_w,
+                         int viewport_h,
+                         const LightingVertex** verts,
+                         size_t* count,
+                         float ambient[3]);
+
+typedef struct {
+    unsigned int segments;        // occluder segments after welding shared edges
+    unsigned int visible_lights;  // lights intersecting the view last frame
+    unsigned int rebuilt_lights;  // visible lights whose cached polygon had to be rebuilt
+} LightingStats;
+const LightingStats* lighting_get_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,346 @@
+#include "mesh_xform.h"
+#include <SDL3/SDL.h>
+#include <math.h>
+#include <stddef.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define XF_HAVE_X86 1
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define XF_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define XF_TARGET_AVX2
+#endif
+#endif
+
+#if defined(__aarch64__) || defined(_M_ARM64)
+#define XF_HAVE_NEON 1
+#include <arm_neon.h>
+#endif
+
+typedef void (*XformAosFn)(const float*, unsigned int, const MeshXform*, float*, float*, float*,
+                           float*);
+typedef void (*XformSoaFn)(const float*,
+                           const float*,
+                           const float*,
+                           unsigned int,
+                           const MeshXform*,
+                           float*,
+                           float*,
+                           float*,
+                           float*);
+
+typedef struct {
+    const char* name;
+    XformAosFn aos;
+    XformSoaFn soa;
+} XformBackend;
+
+// Scalar reference ----------------------------------------------------------------------------
+
+static inline float parallax_of(float z, float k) {
+    // Inverse falloff: far (large |z|) -> ~0 movement, near -> ~1
+    float par = 1.0f / (1.0f + fabsf(z) * k);
+    if (par < 0.0f)
+        par = 0.0f;
+    if (par > 1.0f)
+        par = 1.0f;
+    return par;
+}
+
+static void aos_scalar(const float* pos,
+                       unsigned int count,
+                       const MeshXform* xf,
+                       float* ox,
+                       float* oy,
+                       float* oz,
+                       float* opar) {
+    for (unsigned int i = 0; i < count; i++) {
+        ox[i] = pos[i * 3 + 0] * xf->sx + xf->tx;
+        oy[i] = pos[i * 3 + 1] * xf->sy + xf->ty;
+        oz[i] = pos[i * 3 + 2] * xf->sz + xf->tz;
+        opar[i] = parallax_of(oz[i], xf->parallax_k);
+    }
+}
+
+static void soa_scalar(const float* px,
+                       const float* py,
+                       const float* pz,
+                       unsigned int count,
+                       const MeshXform* xf,
+                       float* ox,
+                       float* oy,
+                       float* oz,
+                       float* opar) {
+    for (unsigned int i = 0; i < count; i++) {
+        ox[i] = px[i] * xf->sx + xf->tx;
+        oy[i] = py[i] * xf->sy + xf->ty;
+        oz[i] = pz[i] * xf->sz + xf->tz;
+        opar[i] = parallax_of(oz[i], xf->parallax_k);
+    }
+}
+
+// SSE2 / AVX2 ---------------------------------------------------------------------------------
+
+#ifdef XF_HAVE_X86
+// Deinterleave 4 xyz triplets (12 floats) into x, y, z lanes
+static inline void deinterleave4_sse(const float* p, __m128* x, __m128* y, __m128* z) {
+    __m128 a = _mm_loadu_ps(p + 0);  // x0 y0 z0 x1
+    __m128 b = _mm_loadu_ps(p + 4);  // y1 z1 x2 y2
+    __m128 c = _mm_loadu_ps(p + 8);  // z2 x3 y3 z3
+    __m128 t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));  // x2 y2 x3 y3
+    __m128 t1 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));  // y0 z0 y1 z1
+    *x = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));
+    *y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+    *z = _mm_shuffle_ps(t1, c, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+static inline void xform4_sse(__m128 x,
+                              __m128 y,
+                              __m128 z,
+                              const MeshXform* xf,
+                              float* ox,
+                              float* oy,
+                              float* oz,
+                              float* opar) {
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 absmask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    x = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(xf->sx)), _mm_set1_ps(xf->tx));
+    y = _mm_add_ps(_mm_mul_ps(y, _mm_set1_ps(xf->sy)), _mm_set1_ps(xf->ty));
+    z = _mm_add_ps(_mm_mul_ps(z, _mm_set1_ps(xf->sz)), _mm_set1_ps(xf->tz));
+    __m128 den = _mm_add_ps(one, _mm_mul_ps(_mm_and_ps(z, absmask), _mm_set1_ps(xf->parallax_k)));
+    __m128 par = _mm_min_ps(_mm_max_ps(_mm_div_ps(one, den), _mm_setzero_ps()), one);
+    _mm_storeu_ps(ox, x);
+    _mm_storeu_ps(oy, y);
+    _mm_storeu_ps(oz, z);
+    _mm_storeu_ps(opar, par);
+}
+
+static void aos_sse2(const float* pos,
+                     unsigned int count,
+                     const MeshXform* xf,
+                     float* ox,
+                     float* oy,
+                     float* oz,
+                     float* opar) {
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 x, y, z;
+        deinterleave4_sse(pos + i * 3, &x, &y, &z);
+        xform4_sse(x, y, z, xf, ox + i, oy + i, oz + i, opar + i);
+    }
+    aos_scalar(pos + i * 3, count - i, xf, ox + i, oy + i, oz + i, opar + i);
+}
+
+static void soa_sse2(const float* px,
+                     const float* py,
+                     const float* pz,
+                     unsigned int count,
+                     const MeshXform* xf,
+                     float* ox,
+                     float* oy,
+                     float* oz,
+                     float* opar) {
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        xform4_sse(_mm_loadu_ps(px + i), _mm_loadu_ps(py + i), _mm_loadu_ps(pz + i), xf, ox + i,
+                   oy + i, oz + i, opar + i);
+    }
+    soa_scalar(px + i, py + i, pz + i, count - i, xf, ox + i, oy + i, oz + i, opar + i);
+}
+
+XF_TARGET_AVX2 static inline void xform8_avx2(__m256 x,
+                                              __m256 y,
+                                              __m256 z,
+                                              const MeshXform* xf,
+                                              float* ox,
+                                              float* oy,
+                                              float* oz,
+                                              float* opar) {
+    const __m256 one = _mm256_set1_ps(1.0f);
+    const __m256 absmask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    // Explicit mul + add (no FMA) so results match the scalar path
+    x = _mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(xf->sx)), _mm256_set1_ps(xf->tx));
+    y = _mm256_add_ps(_mm256_mul_ps(y, _mm256_set1_ps(xf->sy)), _mm256_set1_ps(xf->ty));
+    z = _mm256_add_ps(_mm256_mul_ps(z, _mm256_set1_ps(xf->sz)), _mm256_set1_ps(xf->tz));
+    __m256 den = _mm256_add_ps(
+        one, _mm256_mul_ps(_mm256_and_ps(z, absmask), _mm256_set1_ps(xf->parallax_k)));
+    __m256 par = _mm256_min_ps(_mm256_max_ps(_mm256_div_ps(one, den), _mm256_setzero_ps()), one);
+    _mm256_storeu_ps(ox, x);
+    _mm256_storeu_ps(oy, y);
+    _mm256_storeu_ps(oz, z);
+    _mm256_storeu_ps(opar, par);
+}
+
+XF_TARGET_AVX2 static void aos_avx2(const float* pos,
+                                    unsigned int count,
+                                    const MeshXform* xf,
+                                    float* ox,
+                                    float* oy,
+                                    float* oz,
+                                    float* opar) {
+    unsigned int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128 xl, yl, zl, xh, yh, zh;
+        deinterleave4_sse(pos + i * 3, &xl, &yl, &zl);
+        deinterleave4_sse(pos + i * 3 + 12, &xh, &yh, &zh);
+        __m256 x = _mm256_insertf128_ps(_mm256_castps128_ps256(xl), xh, 1);
+        __m256 y = _mm256_insertf128_ps(_mm256_castps128_ps256(yl), yh, 1);
+        __m256 z = _mm256_insertf128_ps(_mm256_castps128_ps256(zl), zh, 1);
+        xform8_avx2(x, y, z, xf, ox + i, oy + i, oz + i, opar + i);
+    }
+    aos_sse2(pos + i * 3, count - i, xf, ox + i, oy + i, oz + i, opar + i);
+}
+
+XF_TARGET_AVX2 static void soa_avx2(const float* px,
+                                    const float* py,
+                                    const float* pz,
+                                    unsigned int count,
+                                    const MeshXform* xf,
+                                    float* ox,
+                                    float* oy,
+                                    float* oz,
+                                    float* opar) {
+    unsigned int i = 0;
+    for (; i + 8 <= count; i += 8) {
+        xform8_avx2(_mm256_loadu_ps(px + i), _mm256_loadu_ps(py + i), _mm256_loadu_ps(pz + i), xf,
+                    ox + i, oy + i, oz + i, opar + i);
+    }
+    soa_sse2(px + i, py + i, pz + i, count - i, xf, ox + i, oy + i, oz + i, opar + i);
+}
+#endif  // XF_HAVE_X86
+
+// NEON ----------------------------------------------------------------------------------------
+
+#ifdef XF_HAVE_NEON
+static inline void xform4_neon(float32x4_t x,
+                               float32x4_t y,
+                               float32x4_t z,
+                               const MeshXform* xf,
+                               float* ox,
+                               float* oy,
+                               float* oz,
+                               float* opar) {
+    const float32x4_t one = vdupq_n_f32(1.0f);
+    // vmul + vadd rather than vfma so results match the scalar path
+    x = vaddq_f32(vmulq_n_f32(x, xf->sx), vdupq_n_f32(xf->tx));
+    y = vaddq_f32(vmulq_n_f32(y, xf->sy), vdupq_n_f32(xf->ty));
+    z = vaddq_f32(vmulq_n_f32(z, xf->sz), vdupq_n_f32(xf->tz));
+    float32x4_t den = vaddq_f32(one, vmulq_n_f32(vabsq_f32(z), xf->parallax_k));
+    float32x4_t par = vminq_f32(vmaxq_f32(vdivq_f32(one, den), vdupq_n_f32(0.0f)), one);
+    vst1q_f32(ox, x);
+    vst1q_f32(oy, y);
+    vst1q_f32(oz, z);
+    vst1q_f32(opar, par);
+}
+
+static void aos_neon(const float* pos,
+                     unsigned int count,
+                     const MeshXform* xf,
+                     float* ox,
+                     float* oy,
+                     float* oz,
+                     float* opar) {
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        float32x4x3_t v = vld3q_f32(pos + i * 3);  // hardware deinterleave
+        xform4_neon(v.val[0], v.val[1], v.val[2], xf, ox + i, oy + i, oz + i, opar + i);
+    }
+    aos_scalar(pos + i * 3, count - i, xf, ox + i, oy + i, oz + i, opar + i);
+}
+
+static void soa_neon(const float* px,
+                     const float* py,
+                     const float* pz,
+                     unsigned int count,
+                     const MeshXform* xf,
+                     float* ox,
+                     float* oy,
+                     float* oz,
+                     float* opar) {
+    unsigned int i = 0;
+    for (; i + 4 <= count; i += 4) {
+        xform4_neon(vld1q_f32(px + i), vld1q_f32(py + i), vld1q_f32(pz + i), xf, ox + i, oy + i,
+                    oz + i, opar + i);
+    }
+    soa_scalar(px + i, py + i, pz + i, count - i, xf, ox + i, oy + i, oz + i, opar + i);
+}
+#endif  // XF_HAVE_NEON
+
+// Dispatch ------------------------------------------------------------------------------------
+
+static const XformBackend kScalar = {"scalar", aos_scalar, soa_scalar};
+#ifdef XF_HAVE_X86
+static const XformBackend kSse2 = {"sse2", aos_sse2, soa_sse2};
+static const XformBackend kAvx2 = {"avx2", aos_avx2, soa_avx2};
+#endif
+#ifdef XF_HAVE_NEON
+static const XformBackend kNeon = {"neon", aos_neon, soa_neon};
+#endif
+
+static const XformBackend* g_xf = &kScalar;
+
+// Available backends, best first
+static int available_backends(const XformBackend** out) {
+    int n = 0;
+#ifdef XF_HAVE_X86
+    if (SDL_HasAVX2())
+        out[n++] = &kAvx2;
+    if (SDL_HasSSE2())
+        out[n++] = &kSse2;
+#endif
+#ifdef XF_HAVE_NEON
+    if (SDL_HasNEON())
+        out[n++] = &kNeon;
+#endif
+    out[n++] = &kScalar;
+    return n;
+}
+
+void mesh_xform_init(void) {
+    const XformBackend* backends[4];
+    available_backends(backends);
+    g_xf = backends[0];
+    const char* force = SDL_getenv("GAME_MESH_XFORM");
+    if (force)
+        mesh_xform_select(force);
+    SDL_Log("mesh_xform: using %s kernel", g_xf->name);
+}
+
+bool mesh_xform_select(const char* name) {
+    const XformBackend* backends[4];
+    int n = available_backends(backends);
+    for (int i = 0; i < n; i++) {
+        if (SDL_strcasecmp(name, backends[i]->name) == 0) {
+            g_xf = backends[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* mesh_xform_backend(void) {
+    return g_xf->name;
+}
+
+void mesh_xform_aos(const float* pos,
+                    unsigned int count,
+                    const MeshXform* xf,
+                    float* out_x,
+                    float* out_y,
+                    float* out_z,
+                    float* out_par) {
+    g_xf->aos(pos, count, xf, out_x, out_y, out_z, out_par);
+}
+
+void mesh_xform_soa(const float* px,
+                    const float* py,
+                    const float* pz,
+                    unsigned int count,
+                    const MeshXform* xf,
+                    float* out_x,
+                    float* out_y,
+                    float* out_z,
+                    float* out_par) {
+    g_xf->soa(px, py, pz, count, xf, out_x, out_y, out_z, out_par);
+}
@@ -0,0 +1,44 @@
+#pragma once
+#include <stdbool.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Vectorized mesh vertex transform used by the mesh pass:
+//   p' = p * scale + translate, par = clamp(1 / (1 + |z'| * parallax_k), 0, 1)
+// Kernels: scalar, SSE2, AVX2 (x86) and NEON (ARM), picked at runtime by mesh_xform_init.
+// GAME_MESH_XFORM=scalar|sse2|avx2|neon forces a backend (if the CPU supports it).
+
+typedef struct {
+    float tx, ty, tz;
+    float sx, sy, sz;
+    float parallax_k;
+} MeshXform;
+
+void mesh_xform_init(void);
+// Switch to a backend by name; false (nothing changes) when this CPU or build lacks it
+bool mesh_xform_select(const char* name);
+const char* mesh_xform_backend(void);
+
+// AoS input: pos holds count x,y,z triplets
+void mesh_xform_aos(const float* pos,
+                    unsigned int count,
+                    const MeshXform* xf,
+                    float* out_x,
+                    float* out_y,
+                    float* out_z,
+                    float* out_par);
+// SoA input: separate x, y, z arrays of count floats each
+void mesh_xform_soa(const float* px,
+                    const float* py,
+                    const float* pz,
+                    unsigned int count,
+                    const MeshXform* xf,
+                    float* out_x,
+                    float* out_y,
+                    float* out_z,
+                    float* out_par);
+
+#ifdef __cplusplus
+}
+#endif
@@ -1,17 +1,26 @@
 #include "pipeline.h"
 #include <SDL3/SDL.h>
+#include <float.h>
 #include <glad/gl.h>
 #include <math.h>
 #include <stddef.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "ame/camera.h"
+#include "lighting.h"
+#include "mesh_xform.h"
+#include "pipeline_vk.h"
 
 // Parallax tuning (higher K => stronger reduction of movement with distance)
 #ifndef PARALLAX_K
 #define PARALLAX_K 0.01f
 #endif
 
+// Sprite streaming ring: one region per frame in flight (PIPELINE_FRAMES_IN_FLIGHT)
+#define PIPELINE_STREAM_INITIAL_VERTS (64 * 1024)
+#define PIPELINE_MAX_INSTANCE_BATCHES 16
+
 // 3-Pass Pipeline Implementation:
 // Pass 1: Sprites (batched by texture, full resolution)
 // Pass 2: Meshes (rendered to offscreen texture, supersampled)
@@ -47,6 +56,25 @@ static const char* SPRITE_FS =
     "  frag = texture(u_tex, v_uv) * v_col;\n"
     "}\n";
 
+// Instanced sprite shader: one unit quad per instance, expanded from gl_VertexID
+static const char* INST_VS =
+    "#version 450 core\n"
+    "layout(location=0) in vec3 i_pos_size;\n"
+    "layout(location=1) in vec4 i_col;\n"
+    "uniform vec2 u_res;\n"
+    "uniform vec4 u_cam; // x,y,zoom,rot\n"
+    "out vec4 v_col;\n"
+    "out vec2 v_uv;\n"
+    "const vec2 kCorners[6] = vec2[6](vec2(-0.5,-0.5), vec2(0.5,-0.5), vec2(-0.5,0.5),\n"
+    "                                 vec2(0.5,-0.5), vec2(0.5,0.5), vec2(-0.5,0.5));\n"
+    "void main(){\n"
+    "  vec2 c = kCorners[gl_VertexID];\n"
+    "  vec2 p = (i_pos_size.xy + c * i_pos_size.z - u_cam.xy) * u_cam.z;\n"
+    "  gl_Position = vec4((p.x/u_res.x)*2.0 - 1.0, (p.y/u_res.y)*2.0 - 1.0, 0.0, 1.0);\n"
+    "  v_col = i_col;\n"
+    "  v_uv = vec2(c.x + 0.5, 0.5 - c.y);\n"
+    "}\n";
+
 // Mesh shader (same as sprite for now, could add parallax later)
 static const char* MESH_VS =
     "#version 450 core\n"
@@ -238,10 +266,8 @@ static const char* SNOW_FS =
     "  frag = vec4(col, alpha * 0.9);\n"
     "}\n";
 
-// Vertex format
-typedef struct {
-    float x, y, u, v, r, g, b, a, par;
-} Vtx;
+// Vertex format (shared with the Vulkan backend)
+typedef PipelineVertex Vtx;
 
 // Triangle with depth for sorting
 typedef struct {
@@ -252,9 +278,12 @@ typedef struct {
 // Sprite batch (grouped by texture)
 typedef struct {
     GLuint texture;
+    int view;  // view this batch is drawn in (-1 = all)
     Vtx* vertices;
     size_t count;
     size_t capacity;
+    size_t gpu_first;                  // first vertex in this frame's upload
+    float min_x, min_y, max_x, max_y;  // world-space bounds for per-view culling
 } SpriteBatch;
 
 // Mesh batch
@@ -266,11 +295,22 @@ typedef struct {
     float depth;       // calculated depth for sorting (higher values render behind)
 } MeshBatch;
 
+typedef struct {
+    const PipelineInstance* instances;
+    unsigned int count;
+    unsigned int first;  // base instance in this frame's upload
+    GLuint texture;
+} InstanceBatch;
+
 // Pipeline state
 static struct {
+    PipelineBackend backend;
+    float clear[4];  // window clear color (Vulkan clears in its render pass)
+
     // Shaders
-    GLuint sprite_prog, mesh_prog, comp_prog, snow_prog;
+    GLuint sprite_prog, mesh_prog, comp_prog, snow_prog, inst_prog;
     GLint sprite_u_res, sprite_u_cam, sprite_u_tex;
+    GLint inst_u_res, inst_u_cam, inst_u_tex;
     GLint mesh_u_res, mesh_u_cam, mesh_u_tex;
     GLint comp_u_tex;
     // Snow uniforms
@@ -280,6 +320,26 @@ static struct {
     GLuint sprite_vao, sprite_vbo;
     GLuint mesh_vao, mesh_vbo;
     GLuint comp_vao;
+    GLuint inst_vao, inst_vbo;
+
+    // Persistent-mapped sprite stream (one region per frame in flight, guarded by fences)
+    bool streaming;
+    GLuint stream_vao, stream_vbo;
+    Vtx* stream_ptr;
+    size_t stream_region_verts;  // capacity of one region in vertices
+    int stream_region;           // region written this frame
+    GLsync stream_fence[PIPELINE_FRAMES_IN_FLIGHT];
+    bool stream_pending;  // region written this frame still needs its fence
+
+    // Mesh pass cache: sorted triangles stay in mesh_vbo while the submission is unchanged
+    uint64_t mesh_sig;
+    size_t mesh_cached_verts;
+    GLuint mesh_cached_tex;
+    bool mesh_cache_valid;
+
+    // Mesh transform scratch (SoA outputs of the vectorized kernel)
+    float *xf_x, *xf_y, *xf_z, *xf_par;
+    size_t xf_cap;
 
     // Framebuffers (Pass 2: mesh to texture, Pass 3: downscale)
     GLuint mesh_fbo, mesh_tex;
@@ -288,9 +348,18 @@ static struct {
     int supersample;
     int pixel_scale;
 
-    // Current frame state
+    // Current frame state (viewport_* and view_* describe the view being drawn)
     AmeCamera cam;
     int viewport_w, viewport_h;
+    int view_x, view_y;
+    int window_w, window_h;
+    int current_view;
+    int submit_view;
+
+    // Shared per-frame stage, done once no matter how many views are drawn
+    bool meshes_prepared;
+    bool sprites_uploaded;
+    bool instances_uploaded;
     float time_sec;        // time in seconds (from SDL)
     float wind_x, wind_y;  // wind vector (pixels/sec)
     float snow_density;    // 0..1
@@ -304,8 +373,17 @@ static struct {
     size_t mesh_batch_count;
     size_t mesh_batch_capacity;
 
+    InstanceBatch inst_batches[PIPELINE_MAX_INSTANCE_BATCHES];
+    int inst_batch_count;
+
+    // Vulkan: visible sprite batches of the view being recorded
+    PipelineVkDraw* vk_draws;
+    size_t vk_draw_cap;
+
     // White fallback texture
     GLuint white_tex;
+
+    PipelineStats stats;
 } g_pipe = {0};
 
 // Shader compilation helpers
@@ -340,25 +418,139 @@ static GLuint link_program(GLuint vs, GLuint fs) {
     return prog;
 }
 
+static void setup_vtx_attribs(void) {
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, x));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, u));
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, r));
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, par));
+}
+
+// Sprite stream management
+static void stream_wait_fence(int region) {
+    GLsync fence = g_pipe.stream_fence[region];
+    if (!fence)
+        return;
+    // Normally already signaled: the region was last used PIPELINE_FRAMES_IN_FLIGHT frames ago
+    g_pipe.stats.stream_fence_waits++;
+    GLenum r = glClientWaitSync(fence, 0, 0);
+    if (r == GL_TIMEOUT_EXPIRED) {
+        g_pipe.stats.stream_stalls++;
+        Uint64 t0 = SDL_GetTicksNS();
+        do {
+            r = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);  // 1 ms slices
+        } while (r == GL_TIMEOUT_EXPIRED);
+        g_pipe.stats.wait_ms += (double)(SDL_GetTicksNS() - t0) / 1.0e6;
+    }
+    glDeleteSync(fence);
+    g_pipe.stream_fence[region] = NULL;
+}
+
+static void stream_destroy(void) {
+    for (int i = 0; i < PIPELINE_FRAMES_IN_FLIGHT; i++) {
+        stream_wait_fence(i);
+    }
+    if (g_pipe.stream_vbo) {
+        if (g_pipe.stream_ptr) {
+            glBindBuffer(GL_ARRAY_BUFFER, g_pipe.stream_vbo);
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        }
+        glDeleteBuffers(1, &g_pipe.stream_vbo);
+    }
+    if (g_pipe.stream_vao)
+        glDeleteVertexArrays(1, &g_pipe.stream_vao);
+    g_pipe.stream_vbo = 0;
+    g_pipe.stream_vao = 0;
+    g_pipe.stream_ptr = NULL;
+    g_pipe.stream_region_verts = 0;
+    g_pipe.stream_region = 0;
+}
+
+static bool stream_create(size_t region_verts) {
+    GLsizeiptr size = (GLsizeiptr)(region_verts * PIPELINE_FRAMES_IN_FLIGHT * sizeof(Vtx));
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    glGenVertexArrays(1, &g_pipe.stream_vao);
+    glGenBuffers(1, &g_pipe.stream_vbo);
+    glBindVertexArray(g_pipe.stream_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, g_pipe.stream_vbo);
+    glBufferStorage(GL_ARRAY_BUFFER, size, NULL, flags);
+    g_pipe.stream_ptr = (Vtx*)glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags);
+    setup_vtx_attribs();
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (!g_pipe.stream_ptr) {
+        SDL_Log("pipeline: persistent mapping unavailable, using glBufferData for sprites");
+        stream_destroy();
+        return false;
+    }
+    g_pipe.stream_region_verts = region_verts;
+    g_pipe.stream_region = 0;
+    return true;
+}
+
+// Returns the first vertex index of a writable range of `count` vertices in this frame's region
+static size_t stream_reserve(size_t count) {
+    if (count > g_pipe.stream_region_verts) {
+        size_t cap = g_pipe.stream_region_verts ? g_pipe.stream_region_verts : 1024;
+        while (cap < count)
+            cap *= 2;
+        stream_destroy();
+        if (!stream_create(cap)) {
+            g_pipe.streaming = false;
+            return 0;
+        }
+    }
+    stream_wait_fence(g_pipe.stream_region);
+    return (size_t)g_pipe.stream_region * g_pipe.stream_region_verts;
+}
+
+unsigned int pipeline_texture_create(int w, int h, const void* rgba, bool linear) {
+    if (w <= 0 || h <= 0 || !rgba)
+        return 0;
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN)
+        return pipeline_vk_texture_create(w, h, rgba, linear);
+    if (g_pipe.backend != PIPELINE_BACKEND_GL)
+        return 0;
+    GLuint tex = 0;
+    GLint filter = linear ? GL_LINEAR : GL_NEAREST;
+    glGenTextures(1, &tex);
+    glBindTexture(GL_TEXTURE_2D, tex);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    return tex;
+}
+
+void pipeline_texture_destroy(unsigned int texture) {
+    if (!texture)
+        return;
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN) {
+        pipeline_vk_texture_destroy(texture);
+    } else if (g_pipe.backend == PIPELINE_BACKEND_GL) {
+        GLuint tex = texture;
+        glDeleteTextures(1, &tex);
+    }
+}
+
 // Create white fallback texture
 static void create_white_texture(void) {
     if (g_pipe.white_tex)
         return;
-
-    glGenTextures(1, &g_pipe.white_tex);
-    glBindTexture(GL_TEXTURE_2D, g_pipe.white_tex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-
     unsigned char white[4] = {255, 255, 255, 255};
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, white);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    g_pipe.white_tex = pipeline_texture_create(1, 1, white, false);
 }
 
 // Framebuffer management
 static void ensure_framebuffers(int viewport_w, int viewport_h) {
-    g_pipe.supersample = 2;  // 2x supersampling for mesh pass
-    g_pipe.pixel_scale = 4;  // 4x downscale for pixelation effect
+    g_pipe.supersample = PIPELINE_SUPERSAMPLE;  // 2x supersampling for mesh pass
+    g_pipe.pixel_scale = PIPELINE_PIXEL_SCALE;  // 4x downscale for pixelation effect
 
     int new_mesh_w = viewport_w * g_pipe.supersample;
     int new_mesh_h = viewport_h * g_pipe.supersample;
@@ -426,9 +618,17 @@ static void ensure_framebuffers(int viewport_w, int viewport_h) {
     }
 }
 
-bool pipeline_init(void) {
-    memset(&g_pipe, 0, sizeof(g_pipe));
+PipelineBackend pipeline_backend_from_env(void) {
+    const char* env = SDL_getenv("GAME_RENDER_BACKEND");
+    return env && SDL_strcasecmp(env, "vulkan") == 0 ? PIPELINE_BACKEND_VULKAN
+                                                     : PIPELINE_BACKEND_GL;
+}
 
+PipelineBackend pipeline_get_backend(void) {
+    return g_pipe.backend;
+}
+
+static bool init_gl(void) {
     // Compile shaders
     GLuint sprite_vs = compile_shader(GL_VERTEX_SHADER, SPRITE_VS);
     GLuint sprite_fs = compile_shader(GL_FRAGMENT_SHADER, SPRITE_FS);
@@ -448,6 +648,12 @@ bool pipeline_init(void) {
     glDeleteShader(comp_vs);
     glDeleteShader(comp_fs);
 
+    GLuint inst_vs = compile_shader(GL_VERTEX_SHADER, INST_VS);
+    GLuint inst_fs = compile_shader(GL_FRAGMENT_SHADER, SPRITE_FS);
+    g_pipe.inst_prog = link_program(inst_vs, inst_fs);
+    glDeleteShader(inst_vs);
+    glDeleteShader(inst_fs);
+
     // Snow shader program (uses COMP_VS for fullscreen triangle)
     GLuint snow_vs = compile_shader(GL_VERTEX_SHADER, COMP_VS);
     GLuint snow_fs = compile_shader(GL_FRAGMENT_SHADER, SNOW_FS);
@@ -466,6 +672,10 @@ bool pipeline_init(void) {
 
     g_pipe.comp_u_tex = glGetUniformLocation(g_pipe.comp_prog, "u_tex");
 
+    g_pipe.inst_u_res = glGetUniformLocation(g_pipe.inst_prog, "u_res");
+    g_pipe.inst_u_cam = glGetUniformLocation(g_pipe.inst_prog, "u_cam");
+    g_pipe.inst_u_tex = glGetUniformLocation(g_pipe.inst_prog, "u_tex");
+
     // Snow uniform locations
     g_pipe.snow_u_viewport = glGetUniformLocation(g_pipe.snow_prog, "u_viewport");
     g_pipe.snow_u_time = glGetUniformLocation(g_pipe.snow_prog, "u_time");
@@ -479,42 +689,75 @@ bool pipeline_init(void) {
     glGenBuffers(1, &g_pipe.sprite_vbo);
     glBindVertexArray(g_pipe.sprite_vao);
     glBindBuffer(GL_ARRAY_BUFFER, g_pipe.sprite_vbo);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, x));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, u));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, r));
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, par));
+    setup_vtx_attribs();
 
     glGenVertexArrays(1, &g_pipe.mesh_vao);
     glGenBuffers(1, &g_pipe.mesh_vbo);
     glBindVertexArray(g_pipe.mesh_vao);
     glBindBuffer(GL_ARRAY_BUFFER, g_pipe.mesh_vbo);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, x));
-    glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, u));
-    glEnableVertexAttribArray(2);
-    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, r));
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, sizeof(Vtx), (void*)offsetof(Vtx, par));
+    setup_vtx_attribs();
 
     glGenVertexArrays(1, &g_pipe.comp_vao);
 
+    // Instance attributes advance once per instance; quad corners come from gl_VertexID
+    glGenVertexArrays(1, &g_pipe.inst_vao);
+    glGenBuffers(1, &g_pipe.inst_vbo);
+    glBindVertexArray(g_pipe.inst_vao);
+    glBindBuffer(GL_ARRAY_BUFFER, g_pipe.inst_vbo);
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(PipelineInstance),
+                          (void*)offsetof(PipelineInstance, x));
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PipelineInstance),
+                          (void*)offsetof(PipelineInstance, rgba));
+    glVertexAttribDivisor(1, 1);
+
     glBindVertexArray(0);
     glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-    // Create white texture
-    create_white_texture();
+    // Persistent-mapped sprite stream (falls back to per-batch glBufferData if unavailable)
+    const char* streaming_env = SDL_getenv("GAME_RENDER_STREAMING");
+    g_pipe.streaming = !(streaming_env && SDL_strcmp(streaming_env, "0") == 0);
+    if (g_pipe.streaming)
+        g_pipe.streaming = stream_create(PIPELINE_STREAM_INITIAL_VERTS);
+
+    return g_pipe.sprite_prog && g_pipe.mesh_prog && g_pipe.comp_prog && g_pipe.snow_prog;
+}
+
+bool pipeline_init_backend(PipelineBackend backend, SDL_Window* window) {
+    memset(&g_pipe, 0, sizeof(g_pipe));
+    mesh_xform_init();
+
+    bool ok = false;
+    if (backend == PIPELINE_BACKEND_VULKAN) {
+        ok = pipeline_vk_init(window);
+        g_pipe.streaming = ok;  // sprites always go through the frame slot's mapped buffer
+    } else if (backend == PIPELINE_BACKEND_GL) {
+        ok = init_gl();
+    }
+    if (ok) {
+        g_pipe.backend = backend;
+        create_white_texture();
+        ok = g_pipe.white_tex != 0;
+    }
+    if (!ok) {
+        if (backend == PIPELINE_BACKEND_VULKAN)
+            g_pipe.backend = backend;  // releases whatever pipeline_vk_init left behind
+        pipeline_shutdown();
+        return false;
+    }
 
     // Defaults
+    g_pipe.clear[3] = 1.0f;
     g_pipe.wind_x = 5.0f;         // very slow horizontal drift
     g_pipe.wind_y = 10.0f;        // slow upward drift
     g_pipe.snow_density = 0.03f;  // very sparse - individual flakes visible
+    return true;
+}
 
-    return g_pipe.sprite_prog && g_pipe.mesh_prog && g_pipe.comp_prog && g_pipe.snow_prog;
+bool pipeline_init(void) {
+    return pipeline_init_backend(PIPELINE_BACKEND_GL, NULL);
 }
 
 void pipeline_shutdown(void) {
@@ -525,7 +768,20 @@ void pipeline_shutdown(void) {
     free(g_pipe.sprite_batches);
     free(g_pipe.mesh_batches);
 
+    free(g_pipe.xf_x);
+    free(g_pipe.xf_y);
+    free(g_pipe.xf_z);
+    free(g_pipe.xf_par);
+    free(g_pipe.vk_draws);
+
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN) {
+        pipeline_vk_shutdown();
+        memset(&g_pipe, 0, sizeof(g_pipe));
+        return;
+    }
+
     // Clean up GL objects
+    stream_destroy();
     if (g_pipe.white_tex)
         glDeleteTextures(1, &g_pipe.white_tex);
     if (g_pipe.mesh_tex)
@@ -547,6 +803,12 @@ void pipeline_shutdown(void) {
         glDeleteVertexArrays(1, &g_pipe.mesh_vao);
     if (g_pipe.comp_vao)
         glDeleteVertexArrays(1, &g_pipe.comp_vao);
+    if (g_pipe.inst_vbo)
+        glDeleteBuffers(1, &g_pipe.inst_vbo);
+    if (g_pipe.inst_vao)
+        glDeleteVertexArrays(1, &g_pipe.inst_vao);
+    if (g_pipe.inst_prog)
+        glDeleteProgram(g_pipe.inst_prog);
 
     if (g_pipe.sprite_prog)
         glDeleteProgram(g_pipe.sprite_prog);
@@ -566,9 +828,10 @@ static SpriteBatch* get_sprite_batch(GLuint texture) {
     if (texture == 0)
         texture = g_pipe.white_tex;
 
-    // Find existing batch for this texture
+    // Find existing batch for this texture and target view
     for (size_t i = 0; i < g_pipe.sprite_batch_count; i++) {
-        if (g_pipe.sprite_batches[i].texture == texture) {
+        if (g_pipe.sprite_batches[i].texture == texture &&
+            g_pipe.sprite_batches[i].view == g_pipe.submit_view) {
             return &g_pipe.sprite_batches[i];
         }
     }
@@ -582,9 +845,12 @@ static SpriteBatch* get_sprite_batch(GLuint texture) {
 
     SpriteBatch* batch = &g_pipe.sprite_batches[g_pipe.sprite_batch_count++];
     batch->texture = texture;
+    batch->view = g_pipe.submit_view;
     batch->vertices = NULL;
     batch->count = 0;
     batch->capacity = 0;
+    batch->min_x = batch->min_y = FLT_MAX;
+    batch->max_x = batch->max_y = -FLT_MAX;
 
     return batch;
 }
@@ -601,40 +867,234 @@ static void batch_add_vertices(SpriteBatch* batch, const Vtx* verts, size_t coun
 
     memcpy(batch->vertices + batch->count, verts, count * sizeof(Vtx));
     batch->count += count;
+
+    for (size_t i = 0; i < count; i++) {
+        batch->min_x = fminf(batch->min_x, verts[i].x);
+        batch->min_y = fminf(batch->min_y, verts[i].y);
+        batch->max_x = fmaxf(batch->max_x, verts[i].x);
+        batch->max_y = fmaxf(batch->max_y, verts[i].y);
+    }
 }
 
 // Frame management
-void pipeline_frame_begin(const AmeCamera* cam, int viewport_w, int viewport_h) {
-    g_pipe.viewport_w = viewport_w;
-    g_pipe.viewport_h = viewport_h;
-    if (cam)
-        g_pipe.cam = *cam;
+void pipeline_views_begin(int window_w, int window_h) {
+    g_pipe.window_w = window_w;
+    g_pipe.window_h = window_h;
+    g_pipe.viewport_w = window_w;
+    g_pipe.viewport_h = window_h;
+    g_pipe.view_x = 0;
+    g_pipe.view_y = 0;
+    g_pipe.current_view = -1;
+    g_pipe.submit_view = -1;
 
     // Update time from SDL
     g_pipe.time_sec = (float)SDL_GetTicks() / 1000.0f;
 
     // Clear batches (reuse previously allocated batches to avoid leaks and realloc thrash)
     for (size_t i = 0; i < g_pipe.sprite_batch_count; i++) {
-        g_pipe.sprite_batches[i].count = 0;
+        SpriteBatch* batch = &g_pipe.sprite_batches[i];
+        batch->count = 0;
+        batch->min_x = batch->min_y = FLT_MAX;
+        batch->max_x = batch->max_y = -FLT_MAX;
     }
     // Do NOT reset sprite_batch_count here; keep existing batches so get_sprite_batch can reuse
     // them
     g_pipe.mesh_batch_count = 0;
+    g_pipe.inst_batch_count = 0;
+
+    g_pipe.meshes_prepared = false;
+    g_pipe.sprites_uploaded = false;
+    g_pipe.instances_uploaded = false;
+}
+
+void pipeline_frame_begin(const AmeCamera* cam, int viewport_w, int viewport_h) {
+    pipeline_views_begin(viewport_w, viewport_h);
+    if (cam)
+        g_pipe.cam = *cam;
 
     // Ensure framebuffers are ready
-    ensure_framebuffers(viewport_w, viewport_h);
+    if (g_pipe.backend == PIPELINE_BACKEND_GL)
+        ensure_framebuffers(viewport_w, viewport_h);
+}
+
+void pipeline_set_submit_view(int view) {
+    g_pipe.submit_view = (view >= 0 && view < PIPELINE_MAX_VIEWS) ? view : -1;
+}
+
+static void prepare_meshes(void);
+static void upload_sprites(void);
+static void upload_instances(void);
+
+// Fence this frame's streaming region once every view has drawn from it
+static void stream_finish_frame(void) {
+    if (!g_pipe.stream_pending)
+        return;
+    g_pipe.stream_fence[g_pipe.stream_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    g_pipe.stream_region = (g_pipe.stream_region + 1) % PIPELINE_FRAMES_IN_FLIGHT;
+    g_pipe.stream_pending = false;
+}
+
+// Whether a sprite batch shows in the current view; counts the ones culled by the view rect
+static bool batch_visible(const SpriteBatch* batch) {
+    if (batch->count == 0)
+        return false;
+    if (batch->view >= 0 && g_pipe.current_view >= 0 && batch->view != g_pipe.current_view)
+        return false;
+    if (g_pipe.cam.zoom <= 0.0f)
+        return true;
+    // World-space rect of this view (sprites are submitted with parallax 1)
+    float vx0 = g_pipe.cam.x, vy0 = g_pipe.cam.y;
+    float vx1 = vx0 + (float)g_pipe.viewport_w / g_pipe.cam.zoom;
+    float vy1 = vy0 + (float)g_pipe.viewport_h / g_pipe.cam.zoom;
+    if (batch->max_x < vx0 || batch->min_x > vx1 || batch->max_y < vy0 || batch->min_y > vy1) {
+        g_pipe.stats.culled_batches++;
+        return false;
+    }
+    return true;
+}
+
+// Vulkan: the same shared stage, then each view's passes go into this frame's command buffer
+static void views_end_vulkan(const PipelineView* views, int count) {
+    PipelineVkFrame frame = {
+        {g_pipe.clear[0], g_pipe.clear[1], g_pipe.clear[2], g_pipe.clear[3]},
+        g_pipe.time_sec,
+        {g_pipe.wind_x, g_pipe.wind_y},
+        g_pipe.snow_density,
+    };
+    if (!pipeline_vk_frame_begin(g_pipe.window_w, g_pipe.window_h, &frame, &g_pipe.stats))
+        return;
+    prepare_meshes();
+    upload_sprites();
+    upload_instances();
+
+    if (g_pipe.vk_draw_cap < g_pipe.sprite_batch_count) {
+        g_pipe.vk_draws =
+            realloc(g_pipe.vk_draws, g_pipe.sprite_batch_count * sizeof(PipelineVkDraw));
+        g_pipe.vk_draw_cap = g_pipe.sprite_batch_count;
+    }
+    PipelineVkDraw instances[PIPELINE_MAX_INSTANCE_BATCHES];
+    for (int i = 0; i < g_pipe.inst_batch_count; i++) {
+        const InstanceBatch* b = &g_pipe.inst_batches[i];
+        instances[i] = (PipelineVkDraw){b->texture, b->first, b->count};
+    }
+
+    for (int i = 0; i < count; i++) {
+        const PipelineView* view = &views[i];
+        if (view->w <= 0 || view->h <= 0)
+            continue;
+        if (view->cam)
+            g_pipe.cam = *view->cam;
+        g_pipe.current_view = i;
+        g_pipe.viewport_w = view->w;
+        g_pipe.viewport_h = view->h;
+
+        PipelineVkView vk = {
+            {g_pipe.cam.x, g_pipe.cam.y, g_pipe.cam.zoom, g_pipe.cam.rotation},
+            view->x,
+            view->y,
+            view->w,
+            view->h,
+        };
+        int n = 0;
+        for (size_t b = 0; b < g_pipe.sprite_batch_count; b++) {
+            const SpriteBatch* batch = &g_pipe.sprite_batches[b];
+            if (batch_visible(batch))
+                g_pipe.vk_draws[n++] = (PipelineVkDraw){batch->texture,
+                                                        (unsigned int)batch->gpu_first,
+                                                        (unsigned int)batch->count};
+        }
+        vk.sprites = g_pipe.vk_draws;
+        vk.sprite_count = n;
+        vk.instances = instances;
+        vk.instance_count = g_pipe.inst_batch_count;
+        vk.lit = lighting_build_view(&g_pipe.cam, view->w, view->h, &vk.lights, &vk.light_count,
+                                     vk.ambient);
+        pipeline_vk_draw_view(i, &vk, &g_pipe.stats);
+        g_pipe.stats.views++;
+    }
+    pipeline_vk_frame_end(&g_pipe.stats);
+}
+
+void pipeline_views_end(const PipelineView* views, int count) {
+    Uint64 t0 = SDL_GetTicksNS();
+    g_pipe.stats.draw_calls = 0;
+    g_pipe.stats.sprite_vertices = 0;
+    g_pipe.stats.mesh_vertices = 0;
+    g_pipe.stats.mesh_rebuilt = 0;
+    g_pipe.stats.instances = 0;
+    g_pipe.stats.views = 0;
+    g_pipe.stats.culled_batches = 0;
+    g_pipe.stats.stream_region = 0;
+    g_pipe.stats.stream_fence_waits = 0;
+    g_pipe.stats.stream_stalls = 0;
+    g_pipe.stats.wait_ms = 0.0;
+    if (count > PIPELINE_MAX_VIEWS)
+        count = PIPELINE_MAX_VIEWS;
+
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN) {
+        views_end_vulkan(views, count);
+        g_pipe.stats.cpu_ms = (double)(SDL_GetTicksNS() - t0) / 1.0e6;
+        return;
+    }
+
+    // Shared stage: nothing here depends on the camera
+    prepare_meshes();
+    upload_sprites();
+    upload_instances();
+
+    for (int i = 0; i < count; i++) {
+        const PipelineView* view = &views[i];
+        if (view->w <= 0 || view->h <= 0)
+            continue;
+        if (view->cam)
+            g_pipe.cam = *view->cam;
+        g_pipe.current_view = i;
+        g_pipe.view_x = view->x;
+        g_pipe.view_y = view->y;
+        g_pipe.viewport_w = view->w;
+        g_pipe.viewport_h = view->h;
+        ensure_framebuffers(view->w, view->h);
+
+        // Pass 1: Render meshes to offscreen texture (supersampled)
+        pipeline_pass_meshes();
+
+        // Pass 2: Composite mesh texture to pixel buffer (downscaled), then into the view rect
+        pipeline_pass_composite();
+
+        // Multiply the 2D lightmap over the composited scene (no-op at full ambient)
+        lighting_apply(&g_pipe.cam, view->x, view->y, view->w, view->h);
+
+        // Pass 3: Render sprites directly to screen (full resolution)
+        pipeline_pass_sprites();
+        g_pipe.stats.views++;
+    }
+    stream_finish_frame();
+
+    g_pipe.stats.cpu_ms = (double)(SDL_GetTicksNS() - t0) / 1.0e6;
 }
 
 void pipeline_frame_end(void) {
-    // Execute multi-pass rendering:
-    // Pass 1: Render meshes to offscreen texture (supersampled)
-    pipeline_pass_meshes();
+    PipelineView view = {&g_pipe.cam, 0, 0, g_pipe.window_w, g_pipe.window_h};
+    pipeline_views_end(&view, 1);
+}
 
-    // Pass 2: Composite mesh texture to pixel buffer (downscaled)
-    pipeline_pass_composite();
+const PipelineStats* pipeline_get_stats(void) {
+    return &g_pipe.stats;
+}
 
-    // Pass 3: Render sprites directly to screen (full resolution)
-    pipeline_pass_sprites();
+void pipeline_set_streaming(bool enabled) {
+    if (enabled == g_pipe.streaming || g_pipe.backend != PIPELINE_BACKEND_GL)
+        return;
+    if (!enabled) {
+        stream_destroy();
+        g_pipe.streaming = false;
+        return;
+    }
+    g_pipe.streaming = stream_create(PIPELINE_STREAM_INITIAL_VERTS);
+}
+
+void pipeline_mesh_cache_invalidate(void) {
+    g_pipe.mesh_cache_valid = false;
 }
 
 // Sprite submission (batched by texture)
@@ -689,6 +1149,109 @@ void pipeline_sprite_quad_rot(float cx,
     batch_add_vertices(batch, quad, 6);
 }
 
+void pipeline_sprite_triangles(const float* xy,
+                               const float* uv,
+                               const unsigned int* rgba,
+                               unsigned int count,
+                               unsigned int texture) {
+    if (!xy || count < 3)
+        return;
+    SpriteBatch* batch = get_sprite_batch(texture);
+    Vtx chunk[384];  // multiple of 3
+    count -= count % 3;
+    for (unsigned int first = 0; first < count; first += 384) {
+        unsigned int n = SDL_min(count - first, 384u);
+        for (unsigned int i = 0; i < n; i++) {
+            unsigned int v = first + i;
+            unsigned int c = rgba ? rgba[v] : 0xffffffffu;
+            chunk[i] = (Vtx){xy[v * 2 + 0],
+                             xy[v * 2 + 1],
+                             uv ? uv[v * 2 + 0] : 0.5f,
+                             uv ? uv[v * 2 + 1] : 0.5f,
+                             (float)(c & 0xff) / 255.0f,
+                             (float)((c >> 8) & 0xff) / 255.0f,
+                             (float)((c >> 16) & 0xff) / 255.0f,
+                             (float)(c >> 24) / 255.0f,
+                             1.0f};
+        }
+        batch_add_vertices(batch, chunk, n);
+    }
+}
+
+void pipeline_sprite_instances(const PipelineInstance* instances,
+                               unsigned int count,
+                               unsigned int texture) {
+    if (!instances || count == 0 || g_pipe.inst_batch_count >= PIPELINE_MAX_INSTANCE_BATCHES)
+        return;
+    InstanceBatch* b = &g_pipe.inst_batches[g_pipe.inst_batch_count++];
+    b->instances = instances;
+    b->count = count;
+    b->texture = texture ? texture : g_pipe.white_tex;
+}
+
+// Upload every instance batch into one buffer so each view draws them by base instance
+static void upload_instances(void) {
+    g_pipe.instances_uploaded = true;
+    unsigned int total = 0;
+    for (int i = 0; i < g_pipe.inst_batch_count; i++) {
+        total += g_pipe.inst_batches[i].count;
+    }
+    g_pipe.stats.instances = total;
+    if (total == 0)
+        return;
+
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN) {
+        PipelineInstance* dst = pipeline_vk_instance_reserve(total);
+        if (!dst) {
+            g_pipe.inst_batch_count = 0;
+            return;
+        }
+        unsigned int first = 0;
+        for (int i = 0; i < g_pipe.inst_batch_count; i++) {
+            InstanceBatch* b = &g_pipe.inst_batches[i];
+            memcpy(dst + first, b->instances, b->count * sizeof(PipelineInstance));
+            b->first = first;
+            first += b->count;
+        }
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, g_pipe.inst_vbo);
+    glBufferData(GL_ARRAY_BUFFER, (GLsizeiptr)(total * sizeof(PipelineInstance)), NULL,
+                 GL_STREAM_DRAW);
+    unsigned int first = 0;
+    for (int i = 0; i < g_pipe.inst_batch_count; i++) {
+        InstanceBatch* b = &g_pipe.inst_batches[i];
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(first * sizeof(PipelineInstance)),
+                        (GLsizeiptr)(b->count * sizeof(PipelineInstance)), b->instances);
+        b->first = first;
+        first += b->count;
+    }
+}
+
+static void draw_instance_batches(void) {
+    if (!g_pipe.instances_uploaded)
+        upload_instances();
+    if (g_pipe.inst_batch_count == 0)
+        return;
+    glUseProgram(g_pipe.inst_prog);
+    glBindVertexArray(g_pipe.inst_vao);
+    if (g_pipe.inst_u_res >= 0)
+        glUniform2f(g_pipe.inst_u_res, (float)g_pipe.viewport_w, (float)g_pipe.viewport_h);
+    if (g_pipe.inst_u_cam >= 0)
+        glUniform4f(g_pipe.inst_u_cam, g_pipe.cam.x, g_pipe.cam.y, g_pipe.cam.zoom,
+                    g_pipe.cam.rotation);
+    if (g_pipe.inst_u_tex >= 0)
+        glUniform1i(g_pipe.inst_u_tex, 0);
+    for (int i = 0; i < g_pipe.inst_batch_count; i++) {
+        const InstanceBatch* b = &g_pipe.inst_batches[i];
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, b->texture);
+        glDrawArraysInstancedBaseInstance(GL_TRIANGLES, 0, 6, (GLsizei)b->count, b->first);
+        g_pipe.stats.draw_calls++;
+    }
+}
+
 // Mesh submission (for offscreen rendering)
 void pipeline_mesh_submit(const AmeLocalMesh* mesh,
                           float tx,
@@ -729,16 +1292,84 @@ void pipeline_mesh_submit(const AmeLocalMesh* mesh,
     batch->depth = 0.0f;  // Not used for triangle-level sorting
 }
 
+// Copy all sprite batches into one upload (this frame's streaming region, or a single
+// glBufferData in the fallback path) and remember where each batch landed
+static void upload_sprites(void) {
+    g_pipe.sprites_uploaded = true;
+    size_t total = 0;
+    for (size_t i = 0; i < g_pipe.sprite_batch_count; i++) {
+        total += g_pipe.sprite_batches[i].count;
+    }
+    g_pipe.stats.sprite_vertices = (unsigned int)total;
+    if (total == 0)
+        return;
+
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN) {
+        Vtx* dst = pipeline_vk_sprite_reserve(total);
+        size_t offset = 0;
+        for (size_t i = 0; i < g_pipe.sprite_batch_count; i++) {
+            SpriteBatch* batch = &g_pipe.sprite_batches[i];
+            if (!dst)
+                batch->count = 0;  // out of memory: draw none of them
+            if (batch->count == 0)
+                continue;
+            memcpy(dst + offset, batch->vertices, batch->count * sizeof(Vtx));
+            batch->gpu_first = offset;
+            offset += batch->count;
+        }
+        return;
+    }
+
+    size_t base = 0;
+    if (g_pipe.streaming)
+        base = stream_reserve(total);
+    if (g_pipe.streaming) {
+        g_pipe.stats.stream_region = (unsigned int)g_pipe.stream_region;
+        size_t offset = base;
+        for (size_t i = 0; i < g_pipe.sprite_batch_count; i++) {
+            SpriteBatch* batch = &g_pipe.sprite_batches[i];
+            if (batch->count == 0)
+                continue;
+            memcpy(g_pipe.stream_ptr + offset, batch->vertices, batch->count * sizeof(Vtx));
+            batch->gpu_first = offset;
+            offset += batch->count;
+        }
+        g_pipe.stream_pending = true;
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, g_pipe.sprite_vbo);
+    glBufferData(GL_ARRAY_BUFFER, total * sizeof(Vtx), NULL, GL_DYNAMIC_DRAW);
+    size_t offset = 0;
+    for (size_t i = 0; i < g_pipe.sprite_batch_count; i++) {
+        SpriteBatch* batch = &g_pipe.sprite_batches[i];
+        if (batch->count == 0)
+            continue;
+        glBufferSubData(GL_ARRAY_BUFFER, (GLintptr)(offset * sizeof(Vtx)),
+                        batch->count * sizeof(Vtx), batch->vertices);
+        batch->gpu_first = offset;
+        offset += batch->count;
+    }
+}
+
 // Pass 1: Render sprites to screen (full resolution)
 void pipeline_pass_sprites(void) {
+    if (g_pipe.backend != PIPELINE_BACKEND_GL)
+        return;
+    if (!g_pipe.sprites_uploaded)
+        upload_sprites();
+
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, g_pipe.viewport_w, g_pipe.viewport_h);
+    glViewport(g_pipe.view_x, g_pipe.view_y, g_pipe.viewport_w, g_pipe.viewport_h);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
+    // Instanced sprites (particles) go under entities and UI
+    draw_instance_batches();
+
     glUseProgram(g_pipe.sprite_prog);
-    glBindVertexArray(g_pipe.sprite_vao);
+    glBindVertexArray(g_pipe.streaming ? g_pipe.stream_vao : g_pipe.sprite_vao);
 
     if (g_pipe.sprite_u_res >= 0) {
         glUniform2f(g_pipe.sprite_u_res, (float)g_pipe.viewport_w, (float)g_pipe.viewport_h);
@@ -754,22 +1385,15 @@ void pipeline_pass_sprites(void) {
         glUniform1i(g_pipe.sprite_u_tex, 0);
     }
 
-    // Render each sprite batch
     for (size_t i = 0; i < g_pipe.sprite_batch_count; i++) {
         SpriteBatch* batch = &g_pipe.sprite_batches[i];
-        if (batch->count == 0)
+        if (!batch_visible(batch))
             continue;
 
-        // Upload vertices for this batch
-        glBindBuffer(GL_ARRAY_BUFFER, g_pipe.sprite_vbo);
-        glBufferData(GL_ARRAY_BUFFER, batch->count * sizeof(Vtx), batch->vertices, GL_DYNAMIC_DRAW);
-
-        // Bind texture
         glActiveTexture(GL_TEXTURE0);
         glBindTexture(GL_TEXTURE_2D, batch->texture);
-
-        // Draw
-        glDrawArrays(GL_TRIANGLES, 0, (GLsizei)batch->count);
+        glDrawArrays(GL_TRIANGLES, (GLint)batch->gpu_first, (GLsizei)batch->count);
+        g_pipe.stats.draw_calls++;
     }
 
     glDisable(GL_BLEND);
@@ -787,42 +1411,54 @@ static int compare_triangle_depth(const void* a, const void* b) {
     return 0;      // equal depth
 }
 
-// Pass 2: Render meshes to offscreen texture (supersampled)
-void pipeline_pass_meshes(void) {
-    if (g_pipe.mesh_batch_count == 0) {
-        // Clear mesh texture if no meshes to render
-        glBindFramebuffer(GL_FRAMEBUFFER, g_pipe.mesh_fbo);
-        glViewport(0, 0, g_pipe.mesh_w, g_pipe.mesh_h);
-        glClearColor(0, 0, 0, 0);
-        glClear(GL_COLOR_BUFFER_BIT);
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        return;
+// FNV-1a over everything that affects the mesh pass vertex data. Parallax is baked per vertex
+// from Z only, so the camera is not part of the signature.
+static uint64_t fnv1a(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; i++) {
+        h ^= p[i];
+        h *= 1099511628211ull;
     }
+    return h;
+}
 
-    glBindFramebuffer(GL_FRAMEBUFFER, g_pipe.mesh_fbo);
-    glViewport(0, 0, g_pipe.mesh_w, g_pipe.mesh_h);
-    glClearColor(0, 0, 0, 0);
-    glClear(GL_COLOR_BUFFER_BIT);
-
-    glDisable(GL_BLEND);
-
-    glUseProgram(g_pipe.mesh_prog);
-    glBindVertexArray(g_pipe.mesh_vao);
-
-    // Use supersampled resolution for mesh rendering
-    if (g_pipe.mesh_u_res >= 0) {
-        glUniform2f(g_pipe.mesh_u_res, (float)g_pipe.mesh_w, (float)g_pipe.mesh_h);
+static uint64_t mesh_batches_signature(void) {
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < g_pipe.mesh_batch_count; i++) {
+        const MeshBatch* b = &g_pipe.mesh_batches[i];
+        const AmeLocalMesh* m = b->mesh;
+        h = fnv1a(h, &m, sizeof(m));
+        h = fnv1a(h, &m->pos, sizeof(m->pos));
+        h = fnv1a(h, &m->uv, sizeof(m->uv));
+        h = fnv1a(h, &m->count, sizeof(m->count));
+        h = fnv1a(h, &m->texture, sizeof(m->texture));
+        float xf[10] = {b->tx, b->ty, b->tz, b->sx, b->sy, b->sz, b->r, b->g, b->b, b->a};
+        h = fnv1a(h, xf, sizeof(xf));
     }
+    return h;
+}
 
-    // Use exact camera position for smoother motion at high speed
-    if (g_pipe.mesh_u_cam >= 0) {
-        glUniform4f(g_pipe.mesh_u_cam, g_pipe.cam.x, g_pipe.cam.y,
-                    g_pipe.cam.zoom * g_pipe.supersample, g_pipe.cam.rotation);
+// Shared mesh stage: build, depth-sort and upload the triangles of all submitted meshes.
+// Vertex data is camera-independent (parallax is baked per vertex), so the result is reused
+// by every view and by later frames while the submission is unchanged.
+static void prepare_meshes(void) {
+    g_pipe.meshes_prepared = true;
+    if (g_pipe.mesh_batch_count == 0) {
+        g_pipe.mesh_cache_valid = false;
+        g_pipe.mesh_cached_verts = 0;
+        if (g_pipe.backend == PIPELINE_BACKEND_VULKAN)
+            pipeline_vk_mesh_upload(NULL, 0, 0);
+        return;
     }
 
-    if (g_pipe.mesh_u_tex >= 0) {
-        glUniform1i(g_pipe.mesh_u_tex, 0);
-    }
+    // Static geometry: reuse last frame's sorted upload when nothing changed
+    uint64_t sig = mesh_batches_signature();
+    if (g_pipe.mesh_cache_valid && sig == g_pipe.mesh_sig)
+        return;
+    g_pipe.stats.mesh_rebuilt = 1;
+    g_pipe.mesh_sig = sig;
+    g_pipe.mesh_cache_valid = true;
+    g_pipe.mesh_cached_verts = 0;
 
     // Collect all triangles from all meshes and sort them by depth
     size_t total_triangles = 0;
@@ -831,6 +1467,8 @@ void pipeline_pass_meshes(void) {
     }
 
     if (total_triangles == 0) {
+        if (g_pipe.backend == PIPELINE_BACKEND_VULKAN)
+            pipeline_vk_mesh_upload(NULL, 0, 0);
         return;
     }
 
@@ -842,6 +1480,26 @@ void pipeline_pass_meshes(void) {
         const MeshBatch* batch = &g_pipe.mesh_batches[i];
         const AmeLocalMesh* mesh = batch->mesh;
 
+        // Transform all vertices of this mesh at once (SIMD kernel). Parallax uses inverse
+        // falloff a_par = 1 / (1 + K*|Z|): far -> near zero movement, near -> ~1.0
+        if (mesh->count > g_pipe.xf_cap) {
+            g_pipe.xf_cap = mesh->count;
+            g_pipe.xf_x = realloc(g_pipe.xf_x, g_pipe.xf_cap * sizeof(float));
+            g_pipe.xf_y = realloc(g_pipe.xf_y, g_pipe.xf_cap * sizeof(float));
+            g_pipe.xf_z = realloc(g_pipe.xf_z, g_pipe.xf_cap * sizeof(float));
+            g_pipe.xf_par = realloc(g_pipe.xf_par, g_pipe.xf_cap * sizeof(float));
+        }
+        MeshXform xf = {batch->tx, batch->ty, batch->tz, batch->sx,
+                        batch->sy, batch->sz, PARALLAX_K};
+        if (mesh->pos_soa) {
+            mesh_xform_soa(mesh->pos_soa, mesh->pos_soa + mesh->count,
+                           mesh->pos_soa + 2 * (size_t)mesh->count, mesh->count, &xf, g_pipe.xf_x,
+                           g_pipe.xf_y, g_pipe.xf_z, g_pipe.xf_par);
+        } else {
+            mesh_xform_aos(mesh->pos, mesh->count, &xf, g_pipe.xf_x, g_pipe.xf_y, g_pipe.xf_z,
+                           g_pipe.xf_par);
+        }
+
         // Process triangles (groups of 3 vertices)
         for (size_t v = 0; v < mesh->count; v += 3) {
             if (v + 2 >= mesh->count)
@@ -853,32 +1511,14 @@ void pipeline_pass_meshes(void) {
             // Process 3 vertices of the triangle
             for (int j = 0; j < 3; j++) {
                 size_t vert_idx = v + j;
-
-                // Extract xyz from mesh, transform, and use xy for rendering
-                float vx = mesh->pos[vert_idx * 3 + 0];  // vertex x
-                float vy = mesh->pos[vert_idx * 3 + 1];  // vertex y
-                float vz = mesh->pos[vert_idx * 3 + 2];  // vertex z
-
-                // Apply object transformation
-                float px = vx * batch->sx + batch->tx;
-                float py = vy * batch->sy + batch->ty;
-                float pz = vz * batch->sz + batch->tz;  // transformed Z for depth & parallax
-
-                total_z += pz;
+                total_z += g_pipe.xf_z[vert_idx];
 
                 float u = mesh->uv ? mesh->uv[vert_idx * 2 + 0] : 0.0f;
                 float uv = mesh->uv ? mesh->uv[vert_idx * 2 + 1] : 0.0f;
 
-                // Map depth to parallax factor using inverse falloff: a_par = 1 / (1 + K*|Z|)
-                // Large |Z| (far) -> near zero movement; small |Z| (near) -> ~1.0
-                float par = 1.0f / (1.0f + fabsf(pz) * PARALLAX_K);
-                // Optional cap to avoid overscaling; keep within [0, 1]
-                if (par < 0.0f)
-                    par = 0.0f;
-                if (par > 1.0f)
-                    par = 1.0f;
-
-                tri->verts[j] = (Vtx){px, py, u, uv, batch->r, batch->g, batch->b, batch->a, par};
+                tri->verts[j] = (Vtx){g_pipe.xf_x[vert_idx], g_pipe.xf_y[vert_idx], u, uv,
+                                      batch->r, batch->g, batch->b, batch->a,
+                                      g_pipe.xf_par[vert_idx]};
             }
 
             // Calculate average depth for this triangle
@@ -891,7 +1531,7 @@ void pipeline_pass_meshes(void) {
         qsort(triangles, total_triangles, sizeof(Triangle), compare_triangle_depth);
     }
 
-    // Render all sorted triangles
+    // Flatten sorted triangles
     size_t total_vertices = total_triangles * 3;
     Vtx* all_verts = malloc(total_vertices * sizeof(Vtx));
 
@@ -899,21 +1539,66 @@ void pipeline_pass_meshes(void) {
         memcpy(&all_verts[i * 3], triangles[i].verts, 3 * sizeof(Vtx));
     }
 
-    // Upload and render all triangles at once
-    glBindBuffer(GL_ARRAY_BUFFER, g_pipe.mesh_vbo);
-    glBufferData(GL_ARRAY_BUFFER, total_vertices * sizeof(Vtx), all_verts, GL_DYNAMIC_DRAW);
-
-    glActiveTexture(GL_TEXTURE0);
     // Use the texture from the first mesh (assuming all share the same texture)
     GLuint tex = (g_pipe.mesh_batch_count > 0 && g_pipe.mesh_batches[0].mesh->texture)
                      ? g_pipe.mesh_batches[0].mesh->texture
                      : g_pipe.white_tex;
-    glBindTexture(GL_TEXTURE_2D, tex);
 
-    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)total_vertices);
+    // Upload all triangles at once; every view draws from this buffer
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN) {
+        pipeline_vk_mesh_upload(all_verts, total_vertices, tex);
+    } else {
+        glBindBuffer(GL_ARRAY_BUFFER, g_pipe.mesh_vbo);
+        glBufferData(GL_ARRAY_BUFFER, total_vertices * sizeof(Vtx), all_verts, GL_DYNAMIC_DRAW);
+    }
+    g_pipe.mesh_cached_verts = total_vertices;
+    g_pipe.mesh_cached_tex = tex;
 
     free(triangles);
     free(all_verts);
+}
+
+// Pass 2: Render meshes to offscreen texture (supersampled)
+void pipeline_pass_meshes(void) {
+    if (g_pipe.backend != PIPELINE_BACKEND_GL)
+        return;
+    if (!g_pipe.meshes_prepared)
+        prepare_meshes();
+
+    glBindFramebuffer(GL_FRAMEBUFFER, g_pipe.mesh_fbo);
+    glViewport(0, 0, g_pipe.mesh_w, g_pipe.mesh_h);
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    if (g_pipe.mesh_cached_verts == 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        return;
+    }
+
+    glDisable(GL_BLEND);
+
+    glUseProgram(g_pipe.mesh_prog);
+    glBindVertexArray(g_pipe.mesh_vao);
+
+    // Use supersampled resolution for mesh rendering
+    if (g_pipe.mesh_u_res >= 0) {
+        glUniform2f(g_pipe.mesh_u_res, (float)g_pipe.mesh_w, (float)g_pipe.mesh_h);
+    }
+
+    // Use exact camera position for smoother motion at high speed
+    if (g_pipe.mesh_u_cam >= 0) {
+        glUniform4f(g_pipe.mesh_u_cam, g_pipe.cam.x, g_pipe.cam.y,
+                    g_pipe.cam.zoom * g_pipe.supersample, g_pipe.cam.rotation);
+    }
+
+    if (g_pipe.mesh_u_tex >= 0) {
+        glUniform1i(g_pipe.mesh_u_tex, 0);
+    }
+
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, g_pipe.mesh_cached_tex);
+    glDrawArrays(GL_TRIANGLES, 0, (GLsizei)g_pipe.mesh_cached_verts);
+    g_pipe.stats.draw_calls++;
+    g_pipe.stats.mesh_vertices = (unsigned int)g_pipe.mesh_cached_verts;
 
     // Generate mipmaps for better downsampling
     glBindTexture(GL_TEXTURE_2D, g_pipe.mesh_tex);
@@ -925,6 +1610,8 @@ void pipeline_pass_meshes(void) {
 
 // Pass 3: Composite offscreen texture to screen (downscaled)
 void pipeline_pass_composite(void) {
+    if (g_pipe.backend != PIPELINE_BACKEND_GL)
+        return;
     // First, downsample mesh texture to pixel buffer and composite with snow
     glBindFramebuffer(GL_FRAMEBUFFER, g_pipe.pixel_fbo);
     glViewport(0, 0, g_pipe.pixel_w, g_pipe.pixel_h);
@@ -971,11 +1658,14 @@ void pipeline_pass_composite(void) {
 
     // Now composite the final low-res pixel buffer (containing both meshes and snow) to screen
     glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, g_pipe.viewport_w, g_pipe.viewport_h);
+    glViewport(g_pipe.view_x, g_pipe.view_y, g_pipe.viewport_w, g_pipe.viewport_h);
 
-    // Clear screen to background color
+    // Clear this view's rect to background color (scissor keeps other views intact)
+    glEnable(GL_SCISSOR_TEST);
+    glScissor(g_pipe.view_x, g_pipe.view_y, g_pipe.viewport_w, g_pipe.viewport_h);
     glClearColor(0.2f, 0.3f, 0.5f, 1.0f);  // Sky blue background
     glClear(GL_COLOR_BUFFER_BIT);
+    glDisable(GL_SCISSOR_TEST);
 
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
@@ -1002,6 +1692,8 @@ void pipeline_pass_composite(void) {
 }
 // Snow overlay helper (kept for compatibility, now targets pixel buffer by default)
 void pipeline_pass_snow(void) {
+    if (g_pipe.backend != PIPELINE_BACKEND_GL)
+        return;
     // Render into pixel buffer (low resolution) for performance
     glBindFramebuffer(GL_FRAMEBUFFER, g_pipe.pixel_fbo);
     glViewport(0, 0, g_pipe.pixel_w, g_pipe.pixel_h);
@@ -1026,6 +1718,47 @@ void pipeline_pass_snow(void) {
     glBindVertexArray(0);
 }
 
+void pipeline_set_snow(float density, float wind_x, float wind_y) {
+    g_pipe.snow_density = density;
+    g_pipe.wind_x = wind_x;
+    g_pipe.wind_y = wind_y;
+}
+
+void pipeline_clear(float r, float g, float b) {
+    g_pipe.clear[0] = r;
+    g_pipe.clear[1] = g;
+    g_pipe.clear[2] = b;
+    g_pipe.clear[3] = 1.0f;
+    if (g_pipe.backend == PIPELINE_BACKEND_GL) {
+        glClearColor(r, g, b, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+    }
+}
+
+void pipeline_present(SDL_Window* window) {
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN)
+        pipeline_vk_present();
+    else if (g_pipe.backend == PIPELINE_BACKEND_GL && window)
+        SDL_GL_SwapWindow(window);
+}
+
+void pipeline_wait_idle(void) {
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN)
+        pipeline_vk_wait_idle();
+    else if (g_pipe.backend == PIPELINE_BACKEND_GL)
+        glFinish();
+}
+
+bool pipeline_read_pixel(int x, int y, unsigned char rgba[4]) {
+    if (g_pipe.backend == PIPELINE_BACKEND_VULKAN)
+        return pipeline_vk_read_pixel(x, y, rgba);
+    if (g_pipe.backend != PIPELINE_BACKEND_GL)
+        return false;
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glReadPixels(x, y, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, rgba);
+    return true;
+}
+
 // Legacy compatibility functions
 void pipeline_begin(const AmeCamera* cam, int viewport_w, int viewport_h) {
     pipeline_frame_begin(cam, viewport_w, viewport_h);
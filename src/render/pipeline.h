@@ -7,13 +7,15 @@ extern "C" {
 
 // Forward declare camera from engine C API
 typedef struct AmeCamera AmeCamera;
+typedef struct SDL_Window SDL_Window;
 
 // Minimal mesh struct (positions are 3D x,y,z with optional UV)
 typedef struct {
     float* pos;            // interleaved x,y,z triplets
     float* uv;             // interleaved u,v pairs (can be NULL)
     unsigned int count;    // number of vertices (not floats)
-    unsigned int texture;  // GL texture id (0 if none)
+    unsigned int texture;  // pipeline texture id (0 if none)
+    float* pos_soa;        // optional SoA copy of pos: x[count], y[count], z[count] (can be NULL)
 } AmeLocalMesh;
 
 // 3-Pass rendering pipeline:
@@ -22,13 +24,55 @@ typedef struct {
 // Pass 3: Composite (downscale mesh texture to screen)
 // Pass 4: Snow overlay (fullscreen pixelated snow)
 
-bool pipeline_init(void);
+// Backends. GL draws into the framebuffer of the context current at init. Vulkan renders into
+// the window's swapchain (the window needs SDL_WINDOW_VULKAN) or, without a window, into an
+// offscreen image, and needs no GL context. GAME_RENDER_BACKEND=vulkan picks it at startup.
+typedef enum {
+    PIPELINE_BACKEND_NONE,  // not initialized (headless replay)
+    PIPELINE_BACKEND_GL,
+    PIPELINE_BACKEND_VULKAN,
+} PipelineBackend;
+PipelineBackend pipeline_backend_from_env(void);
+
+bool pipeline_init(void);  // GL
+bool pipeline_init_backend(PipelineBackend backend, SDL_Window* window);
 void pipeline_shutdown(void);
+PipelineBackend pipeline_get_backend(void);
+
+// Textures for sprites, instances and meshes. rgba holds w*h tightly packed RGBA8 pixels, the
+// first row at v=0; sampling clamps to the edge. Returns 0 on failure. Under GL the id is the
+// GL texture name.
+unsigned int pipeline_texture_create(int w, int h, const void* rgba, bool linear);
+void pipeline_texture_destroy(unsigned int texture);
 
 // Frame management - call these to setup the 3-pass rendering
 void pipeline_frame_begin(const AmeCamera* cam, int viewport_w, int viewport_h);
 void pipeline_frame_end(void);
 
+// Multi-view frames (split-screen). Submit once between views_begin and views_end; the
+// view-independent work (mesh build/sort/upload, sprite and instance uploads) runs once, then
+// every view draws the passes with its own camera and window rect. Views of equal size share
+// the offscreen targets; sprite batches outside a view are culled.
+#define PIPELINE_MAX_VIEWS 4
+typedef struct {
+    const AmeCamera* cam;
+    int x, y, w, h;  // window rect in pixels, origin bottom-left
+} PipelineView;
+void pipeline_views_begin(int window_w, int window_h);
+// Route the following sprite submissions to one view (e.g. per-player HUD); -1 = all views,
+// which is the default after every begin
+void pipeline_set_submit_view(int view);
+void pipeline_views_end(const PipelineView* views, int count);
+// Color the whole window is cleared to before the views are drawn (call after views_begin)
+void pipeline_clear(float r, float g, float b);
+// Show the last frame: SDL_GL_SwapWindow under GL, a queue present under Vulkan
+void pipeline_present(SDL_Window* window);
+// Block until the GPU has finished every frame submitted so far
+void pipeline_wait_idle(void);
+// Read one pixel of the last frame (origin bottom-left, like glReadPixels). Vulkan can only
+// read its offscreen image.
+bool pipeline_read_pixel(int x, int y, unsigned char rgba[4]);
+
 // Pass 1: Sprite submission (batched by texture)
 void pipeline_sprite_quad(float cx,
                           float cy,
@@ -51,6 +95,27 @@ void pipeline_sprite_quad_rot(float cx,
                               float b,
                               float a);
 
+// Triangle list batched like sprites (3 vertices per triangle, e.g. debug geometry or terrain
+// chunks). xy holds count (x,y) points, uv one (u,v) pair per vertex or NULL to sample the
+// texture centre, rgba one packed color per vertex (R in the lowest byte) or NULL for white.
+// texture picks the batch (0 = the shared white one).
+void pipeline_sprite_triangles(const float* xy,
+                               const float* uv,
+                               const unsigned int* rgba,
+                               unsigned int count,
+                               unsigned int texture);
+
+// Instanced sprite submission (particles and other large swarms of square sprites). Drawn under
+// the regular sprite batches in every view; the array must stay valid until pipeline_frame_end.
+typedef struct {
+    float x, y;         // world-space center
+    float size;         // edge length in world units
+    unsigned int rgba;  // packed 8-bit color, R in the lowest byte
+} PipelineInstance;
+void pipeline_sprite_instances(const PipelineInstance* instances,
+                               unsigned int count,
+                               unsigned int texture);
+
 // Pass 2: Mesh submission (rendered to offscreen target)
 void pipeline_mesh_submit(const AmeLocalMesh* mesh,
                           float tx,
@@ -64,7 +129,36 @@ void pipeline_mesh_submit(const AmeLocalMesh* mesh,
                           float b,
                           float a);
 
-// Internal pass management (automatically called by frame_begin/end)
+// Per-frame submission statistics (filled by pipeline_frame_end, valid until the next frame)
+typedef struct {
+    unsigned int draw_calls;          // draw calls issued by the pipeline this frame
+    unsigned int sprite_vertices;     // sprite vertices written to the streaming buffer
+    unsigned int mesh_vertices;       // mesh vertices drawn in the mesh pass
+    unsigned int mesh_rebuilt;        // 1 if the mesh pass had to rebuild/sort/upload its triangles
+    unsigned int instances;           // instanced sprites uploaded this frame
+    unsigned int views;               // views drawn this frame
+    unsigned int culled_batches;      // sprite batches skipped by per-view bounds culling
+    unsigned int stream_region;       // streaming ring region the sprites were written to
+    unsigned int stream_fence_waits;  // region fences retired (1 per frame once the ring wraps)
+    unsigned int stream_stalls;       // of those, fences the GPU had not signaled yet
+    double cpu_ms;                    // main-thread time spent in pipeline_frame_end
+    double wait_ms;                   // of which blocked on the GPU (fences, image acquire)
+} PipelineStats;
+const PipelineStats* pipeline_get_stats(void);
+
+// Sprite vertex streaming: true uses a persistent-mapped ring buffer with fences,
+// false falls back to one glBufferData per frame. Defaults to true unless the
+// GAME_RENDER_STREAMING=0 environment variable is set at init. Vulkan always streams.
+void pipeline_set_streaming(bool enabled);
+
+// Snow overlay: density 0..1 (0 turns it off), wind in pixels per second
+void pipeline_set_snow(float density, float wind_x, float wind_y);
+
+// The mesh pass reuses its last uploaded triangles while the submitted meshes and transforms
+// are unchanged. Call this after modifying mesh vertex data in place.
+void pipeline_mesh_cache_invalidate(void);
+
+// Internal pass management (automatically called by frame_begin/end; GL only)
 void pipeline_pass_sprites(void);    // Render batched sprites to screen
 void pipeline_pass_meshes(void);     // Render meshes to offscreen texture
 void pipeline_pass_composite(void);  // Composite offscreen texture to screen
@@ -0,0 +1,1910 @@
+#include "pipeline_vk.h"
+#include <SDL3/SDL.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef PIPELINE_VULKAN
+
+// vulkan.h first: SDL_vulkan.h only declares its own handle types when it is missing
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+
+#include <SDL3/SDL_vulkan.h>
+
+// SPIR-V compiled from src/render/shaders by glslc at build time
+static const uint32_t SPRITE_VERT[] =
+#include "sprite.vert.inc"
+    ;
+static const uint32_t MESH_VERT[] =
+#include "mesh.vert.inc"
+    ;
+static const uint32_t INSTANCE_VERT[] =
+#include "instance.vert.inc"
+    ;
+static const uint32_t TEXTURED_FRAG[] =
+#include "textured.frag.inc"
+    ;
+static const uint32_t FULLSCREEN_VERT[] =
+#include "fullscreen.vert.inc"
+    ;
+static const uint32_t COMPOSITE_FRAG[] =
+#include "composite.frag.inc"
+    ;
+static const uint32_t SNOW_FRAG[] =
+#include "snow.frag.inc"
+    ;
+static const uint32_t LIGHT_VERT[] =
+#include "light.vert.inc"
+    ;
+static const uint32_t LIGHT_FRAG[] =
+#include "light.frag.inc"
+    ;
+static const uint32_t APPLY_FRAG[] =
+#include "apply.frag.inc"
+    ;
+
+#define VK_MAX_TEXTURES 4096
+#define VK_MAX_SWAPCHAIN_IMAGES 8
+#define VK_MIN_BUFFER_BYTES (64 * 1024)
+
+// Entry points, loaded through SDL's Vulkan loader
+#define VK_INSTANCE_FUNCS(X)                     \
+    X(vkDestroyInstance)                         \
+    X(vkEnumeratePhysicalDevices)                \
+    X(vkGetPhysicalDeviceProperties)             \
+    X(vkGetPhysicalDeviceQueueFamilyProperties)  \
+    X(vkGetPhysicalDeviceMemoryProperties)       \
+    X(vkGetPhysicalDeviceSurfaceSupportKHR)      \
+    X(vkGetPhysicalDeviceSurfaceCapabilitiesKHR) \
+    X(vkGetPhysicalDeviceSurfaceFormatsKHR)      \
+    X(vkCreateDevice)                            \
+    X(vkGetDeviceProcAddr)
+#define VK_DEVICE_FUNCS(X)          \
+    X(vkDestroyDevice)              \
+    X(vkGetDeviceQueue)             \
+    X(vkDeviceWaitIdle)             \
+    X(vkQueueSubmit)                \
+    X(vkCreateFence)                \
+    X(vkDestroyFence)               \
+    X(vkWaitForFences)              \
+    X(vkResetFences)                \
+    X(vkGetFenceStatus)             \
+    X(vkCreateSemaphore)            \
+    X(vkDestroySemaphore)           \
+    X(vkCreateCommandPool)          \
+    X(vkDestroyCommandPool)         \
+    X(vkResetCommandPool)           \
+    X(vkAllocateCommandBuffers)     \
+    X(vkBeginCommandBuffer)         \
+    X(vkEndCommandBuffer)           \
+    X(vkCreateBuffer)               \
+    X(vkDestroyBuffer)              \
+    X(vkGetBufferMemoryRequirements) \
+    X(vkBindBufferMemory)           \
+    X(vkCreateImage)                \
+    X(vkDestroyImage)               \
+    X(vkGetImageMemoryRequirements) \
+    X(vkBindImageMemory)            \
+    X(vkAllocateMemory)             \
+    X(vkFreeMemory)                 \
+    X(vkMapMemory)                  \
+    X(vkCreateImageView)            \
+    X(vkDestroyImageView)           \
+    X(vkCreateSampler)              \
+    X(vkDestroySampler)             \
+    X(vkCreateDescriptorSetLayout)  \
+    X(vkDestroyDescriptorSetLayout) \
+    X(vkCreateDescriptorPool)       \
+    X(vkDestroyDescriptorPool)      \
+    X(vkAllocateDescriptorSets)     \
+    X(vkFreeDescriptorSets)         \
+    X(vkUpdateDescriptorSets)       \
+    X(vkCreatePipelineLayout)       \
+    X(vkDestroyPipelineLayout)      \
+    X(vkCreateShaderModule)         \
+    X(vkDestroyShaderModule)        \
+    X(vkCreateGraphicsPipelines)    \
+    X(vkDestroyPipeline)            \
+    X(vkCreateRenderPass)           \
+    X(vkDestroyRenderPass)          \
+    X(vkCreateFramebuffer)          \
+    X(vkDestroyFramebuffer)         \
+    X(vkCreateSwapchainKHR)         \
+    X(vkDestroySwapchainKHR)        \
+    X(vkGetSwapchainImagesKHR)      \
+    X(vkAcquireNextImageKHR)        \
+    X(vkQueuePresentKHR)            \
+    X(vkCmdBeginRenderPass)         \
+    X(vkCmdEndRenderPass)           \
+    X(vkCmdExecuteCommands)         \
+    X(vkCmdBindPipeline)            \
+    X(vkCmdBindDescriptorSets)      \
+    X(vkCmdBindVertexBuffers)       \
+    X(vkCmdPushConstants)           \
+    X(vkCmdSetViewport)             \
+    X(vkCmdSetScissor)              \
+    X(vkCmdDraw)                    \
+    X(vkCmdClearAttachments)        \
+    X(vkCmdPipelineBarrier)         \
+    X(vkCmdCopyBufferToImage)       \
+    X(vkCmdCopyImageToBuffer)       \
+    X(vkCmdBlitImage)
+
+#define VK_DECLARE(name) static PFN_##name name;
+static PFN_vkGetInstanceProcAddr vkGetInstanceProcAddr;
+static PFN_vkCreateInstance vkCreateInstance;
+VK_INSTANCE_FUNCS(VK_DECLARE)
+VK_DEVICE_FUNCS(VK_DECLARE)
+
+// Per-view uniforms, std140 (five vec4, mirrored by the View struct in the shaders)
+typedef struct {
+    float cam[4];
+    float mesh_cam[4];  // zoom scaled by PIPELINE_SUPERSAMPLE
+    float res[4];       // view w, h, mesh target w, h
+    float snow[4];      // pixel target w, h, time, density
+    float wind[4];
+} ViewUniforms;
+
+typedef struct {
+    ViewUniforms views[PIPELINE_MAX_VIEWS];
+} FrameUniforms;
+
+// Host-visible buffer, mapped for its whole life
+typedef struct {
+    VkBuffer buffer;
+    VkDeviceMemory memory;
+    void* ptr;
+    VkDeviceSize size;
+} MappedBuffer;
+
+// Render target sampled by a later pass (mesh target: every mip, rendered at mip 0)
+typedef struct {
+    VkImage image;
+    VkDeviceMemory memory;
+    VkImageView view;
+    VkImageView target;
+    VkFramebuffer framebuffer;
+    VkDescriptorSet set;
+    int w, h, mips;
+} Target;
+
+typedef struct {
+    VkImage image;
+    VkDeviceMemory memory;
+    VkImageView view;
+    VkDescriptorSet set;
+    MappedBuffer staging;  // pixels for the next frame's upload (pending)
+    int w, h;
+    bool used, pending;
+    int next_free;
+} Texture;
+
+// GPU objects a submitted frame may still use; released once frame `frame` has completed
+typedef struct {
+    uint64_t frame;
+    VkImage image;
+    VkImageView view;
+    VkDeviceMemory memory;
+    VkBuffer buffer;
+    VkDescriptorSet set;
+} Retired;
+
+typedef struct {
+    VkFence fence;
+    VkSemaphore acquired;
+    VkCommandPool pool;  // reset every frame: the primary and the per-view dynamic secondaries
+    VkCommandBuffer cmd;
+    VkCommandBuffer dynamic[PIPELINE_MAX_VIEWS];
+    VkDescriptorSet frame_set;
+    MappedBuffer ubo, sprites, instances, lights, mesh;
+    uint64_t mesh_gen;  // g_vk.mesh_gen the mesh buffer holds
+    size_t lights_used;
+} Slot;
+
+// Offscreen targets of one view and its static secondaries, one set per frame slot
+typedef struct {
+    int x, y_top, w, h, window_w, window_h;
+    uint64_t gen;  // bumped whenever a secondary would record differently
+    Target mesh, pixel, light;
+    VkCommandBuffer mesh_sec[PIPELINE_FRAMES_IN_FLIGHT];
+    VkCommandBuffer pixel_sec[PIPELINE_FRAMES_IN_FLIGHT];
+    VkCommandBuffer window_sec[PIPELINE_FRAMES_IN_FLIGHT];
+    uint64_t mesh_key[PIPELINE_FRAMES_IN_FLIGHT][2];  // gen, slot mesh_gen
+    uint64_t pixel_key[PIPELINE_FRAMES_IN_FLIGHT];
+    uint64_t window_key[PIPELINE_FRAMES_IN_FLIGHT];
+    bool drawn;  // recorded this frame
+} ViewState;
+
+enum { INPUT_NONE, INPUT_VERTEX, INPUT_INSTANCE, INPUT_LIGHT };
+
+static struct {
+    VkInstance instance;
+    VkPhysicalDevice gpu;
+    VkPhysicalDeviceMemoryProperties memory_props;
+    VkDevice device;
+    VkQueue queue;
+    uint32_t queue_family;
+    bool library;
+
+    VkSampler nearest, linear, mipmapped;
+    VkDescriptorSetLayout frame_layout, texture_layout;
+    VkPipelineLayout layout;
+    VkDescriptorPool descriptor_pool;
+    VkRenderPass rp_mesh, rp_pixel, rp_window;
+    VkPipeline sprite, instanced, mesh, comp_pixel, comp_window, snow, light, apply;
+    VkCommandPool static_pool;  // view secondaries, re-recorded one by one
+
+    // Window: swapchain, or an offscreen image when there is no window
+    SDL_Window* window;
+    VkSurfaceKHR surface;
+    VkSwapchainKHR swapchain;
+    VkFormat format;
+    int swap_w, swap_h;  // window size the swapchain was made for (0: recreate)
+    VkExtent2D extent;
+    uint32_t image_count, image;
+    VkImage images[VK_MAX_SWAPCHAIN_IMAGES];
+    VkImageView image_views[VK_MAX_SWAPCHAIN_IMAGES];
+    VkFramebuffer framebuffers[VK_MAX_SWAPCHAIN_IMAGES];
+    VkSemaphore rendered[VK_MAX_SWAPCHAIN_IMAGES];
+    Target offscreen;
+    bool offscreen_valid;  // holds a finished frame (TRANSFER_SRC layout)
+    bool present_pending;
+
+    Slot slots[PIPELINE_FRAMES_IN_FLIGHT];
+    ViewState views[PIPELINE_MAX_VIEWS];
+    uint64_t frame;  // frames submitted
+    bool recording;
+    PipelineVkFrame frame_params;
+    int window_w, window_h;
+
+    Texture* textures;
+    int texture_count, free_texture;
+    int* pending;
+    int pending_count, pending_cap;
+    Retired* retired;
+    int retired_count, retired_cap;
+
+    // Sorted mesh pass triangles; slots copy them in when their mesh_gen is stale
+    PipelineVertex* mesh_verts;
+    size_t mesh_count, mesh_cap;
+    unsigned int mesh_tex;
+    uint64_t mesh_gen;
+} g_vk;
+
+static bool vk_check(VkResult r, const char* what) {
+    if (r == VK_SUCCESS)
+        return true;
+    SDL_Log("pipeline_vk: %s failed (%d)", what, (int)r);
+    return false;
+}
+
+static uint32_t find_memory(uint32_t type_bits, VkMemoryPropertyFlags props) {
+    for (uint32_t i = 0; i < g_vk.memory_props.memoryTypeCount; i++) {
+        if ((type_bits & (1u << i)) &&
+            (g_vk.memory_props.memoryTypes[i].propertyFlags & props) == props)
+            return i;
+    }
+    return UINT32_MAX;
+}
+
+static bool alloc_memory(VkMemoryRequirements req,
+                         VkMemoryPropertyFlags props,
+                         VkDeviceMemory* memory) {
+    uint32_t type = find_memory(req.memoryTypeBits, props);
+    if (type == UINT32_MAX)
+        return false;
+    VkMemoryAllocateInfo info = {VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO};
+    info.allocationSize = req.size;
+    info.memoryTypeIndex = type;
+    return vk_check(vkAllocateMemory(g_vk.device, &info, NULL, memory), "vkAllocateMemory");
+}
+
+// Buffers and images ---------------------------------------------------------------------------
+
+static void retire(const Retired* r) {
+    if (g_vk.retired_count == g_vk.retired_cap) {
+        g_vk.retired_cap = g_vk.retired_cap ? g_vk.retired_cap * 2 : 64;
+        g_vk.retired = realloc(g_vk.retired, (size_t)g_vk.retired_cap * sizeof(Retired));
+    }
+    g_vk.retired[g_vk.retired_count] = *r;
+    g_vk.retired[g_vk.retired_count].frame = g_vk.frame;
+    g_vk.retired_count++;
+}
+
+static void release(const Retired* r) {
+    if (r->set)
+        vkFreeDescriptorSets(g_vk.device, g_vk.descriptor_pool, 1, &r->set);
+    if (r->view)
+        vkDestroyImageView(g_vk.device, r->view, NULL);
+    if (r->image)
+        vkDestroyImage(g_vk.device, r->image, NULL);
+    if (r->buffer)
+        vkDestroyBuffer(g_vk.device, r->buffer, NULL);
+    if (r->memory)
+        vkFreeMemory(g_vk.device, r->memory, NULL);
+}
+
+// Frees what the frames known to have completed were the last to use (all of it when `all`)
+static void release_retired(bool all) {
+    int kept = 0;
+    for (int i = 0; i < g_vk.retired_count; i++) {
+        Retired* r = &g_vk.retired[i];
+        if (all || r->frame + PIPELINE_FRAMES_IN_FLIGHT <= g_vk.frame)
+            release(r);
+        else
+            g_vk.retired[kept++] = *r;
+    }
+    g_vk.retired_count = kept;
+}
+
+static bool mapped_create(MappedBuffer* b, VkDeviceSize size, VkBufferUsageFlags usage) {
+    memset(b, 0, sizeof(*b));
+    VkBufferCreateInfo info = {VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO};
+    info.size = size;
+    info.usage = usage;
+    info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (!vk_check(vkCreateBuffer(g_vk.device, &info, NULL, &b->buffer), "vkCreateBuffer"))
+        return false;
+    VkMemoryRequirements req;
+    vkGetBufferMemoryRequirements(g_vk.device, b->buffer, &req);
+    if (!alloc_memory(req,
+                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                      &b->memory) ||
+        !vk_check(vkBindBufferMemory(g_vk.device, b->buffer, b->memory, 0), "vkBindBufferMemory") ||
+        !vk_check(vkMapMemory(g_vk.device, b->memory, 0, VK_WHOLE_SIZE, 0, &b->ptr),
+                  "vkMapMemory")) {
+        Retired r = {0, VK_NULL_HANDLE, VK_NULL_HANDLE, b->memory, b->buffer, VK_NULL_HANDLE};
+        release(&r);
+        memset(b, 0, sizeof(*b));
+        return false;
+    }
+    b->size = size;
+    return true;
+}
+
+static void mapped_retire(MappedBuffer* b) {
+    if (b->buffer) {
+        Retired r = {0, VK_NULL_HANDLE, VK_NULL_HANDLE, b->memory, b->buffer, VK_NULL_HANDLE};
+        retire(&r);
+    }
+    memset(b, 0, sizeof(*b));
+}
+
+// Grows a slot buffer; commands already recorded this frame keep the old one until it retires
+static bool mapped_reserve(MappedBuffer* b, VkDeviceSize size, VkBufferUsageFlags usage) {
+    if (b->size >= size)
+        return true;
+    VkDeviceSize grown = b->size * 2;
+    if (grown < size)
+        grown = size;
+    if (grown < VK_MIN_BUFFER_BYTES)
+        grown = VK_MIN_BUFFER_BYTES;
+    mapped_retire(b);
+    return mapped_create(b, grown, usage);
+}
+
+static bool image_create(int w,
+                         int h,
+                         int mips,
+                         VkFormat format,
+                         VkImageUsageFlags usage,
+                         VkImage* image,
+                         VkDeviceMemory* memory) {
+    VkImageCreateInfo info = {VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO};
+    info.imageType = VK_IMAGE_TYPE_2D;
+    info.format = format;
+    info.extent.width = (uint32_t)w;
+    info.extent.height = (uint32_t)h;
+    info.extent.depth = 1;
+    info.mipLevels = (uint32_t)mips;
+    info.arrayLayers = 1;
+    info.samples = VK_SAMPLE_COUNT_1_BIT;
+    info.tiling = VK_IMAGE_TILING_OPTIMAL;
+    info.usage = usage;
+    info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    if (!vk_check(vkCreateImage(g_vk.device, &info, NULL, image), "vkCreateImage"))
+        return false;
+    VkMemoryRequirements req;
+    vkGetImageMemoryRequirements(g_vk.device, *image, &req);
+    if (!alloc_memory(req, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, memory) ||
+        !vk_check(vkBindImageMemory(g_vk.device, *image, *memory, 0), "vkBindImageMemory")) {
+        vkDestroyImage(g_vk.device, *image, NULL);
+        *image = VK_NULL_HANDLE;
+        return false;
+    }
+    return true;
+}
+
+static VkImageView image_view(VkImage image, VkFormat format, int mips) {
+    VkImageViewCreateInfo info = {VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO};
+    info.image = image;
+    info.viewType = VK_IMAGE_VIEW_TYPE_2D;
+    info.format = format;
+    info.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    info.subresourceRange.levelCount = (uint32_t)mips;
+    info.subresourceRange.layerCount = 1;
+    VkImageView view = VK_NULL_HANDLE;
+    vk_check(vkCreateImageView(g_vk.device, &info, NULL, &view), "vkCreateImageView");
+    return view;
+}
+
+static VkDescriptorSet texture_set(VkImageView view, VkSampler sampler) {
+    VkDescriptorSetAllocateInfo alloc = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+    alloc.descriptorPool = g_vk.descriptor_pool;
+    alloc.descriptorSetCount = 1;
+    alloc.pSetLayouts = &g_vk.texture_layout;
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    if (!vk_check(vkAllocateDescriptorSets(g_vk.device, &alloc, &set), "vkAllocateDescriptorSets"))
+        return VK_NULL_HANDLE;
+    VkDescriptorImageInfo image = {sampler, view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL};
+    VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+    write.dstSet = set;
+    write.descriptorCount = 1;
+    write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    write.pImageInfo = &image;
+    vkUpdateDescriptorSets(g_vk.device, 1, &write, 0, NULL);
+    return set;
+}
+
+static void target_destroy(Target* t) {
+    if (t->framebuffer)
+        vkDestroyFramebuffer(g_vk.device, t->framebuffer, NULL);
+    if (t->target && t->target != t->view)
+        vkDestroyImageView(g_vk.device, t->target, NULL);
+    Retired r = {0, t->image, t->view, t->memory, VK_NULL_HANDLE, t->set};
+    release(&r);
+    memset(t, 0, sizeof(*t));
+}
+
+// Color target rendered through `pass`; sampled with `sampler` unless it is VK_NULL_HANDLE
+static bool target_create(Target* t,
+                          int w,
+                          int h,
+                          int mips,
+                          VkFormat format,
+                          VkImageUsageFlags usage,
+                          VkRenderPass pass,
+                          VkSampler sampler) {
+    memset(t, 0, sizeof(*t));
+    t->w = w > 0 ? w : 1;
+    t->h = h > 0 ? h : 1;
+    t->mips = mips;
+    usage |= VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (!image_create(t->w, t->h, mips, format, usage, &t->image, &t->memory))
+        return false;
+    t->view = image_view(t->image, format, mips);
+    t->target = mips > 1 ? image_view(t->image, format, 1) : t->view;
+    if (!t->view || !t->target) {
+        target_destroy(t);
+        return false;
+    }
+    VkFramebufferCreateInfo fb = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
+    fb.renderPass = pass;
+    fb.attachmentCount = 1;
+    fb.pAttachments = &t->target;
+    fb.width = (uint32_t)t->w;
+    fb.height = (uint32_t)t->h;
+    fb.layers = 1;
+    if (!vk_check(vkCreateFramebuffer(g_vk.device, &fb, NULL, &t->framebuffer),
+                  "vkCreateFramebuffer") ||
+        (sampler && !(t->set = texture_set(t->view, sampler)))) {
+        target_destroy(t);
+        return false;
+    }
+    return true;
+}
+
+static void image_barrier(VkCommandBuffer cmd,
+                          VkImage image,
+                          uint32_t first_mip,
+                          uint32_t mips,
+                          VkImageLayout from,
+                          VkImageLayout to,
+                          VkPipelineStageFlags src_stage,
+                          VkAccessFlags src_access,
+                          VkPipelineStageFlags dst_stage,
+                          VkAccessFlags dst_access) {
+    VkImageMemoryBarrier b = {VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER};
+    b.srcAccessMask = src_access;
+    b.dstAccessMask = dst_access;
+    b.oldLayout = from;
+    b.newLayout = to;
+    b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    b.image = image;
+    b.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    b.subresourceRange.baseMipLevel = first_mip;
+    b.subresourceRange.levelCount = mips;
+    b.subresourceRange.layerCount = 1;
+    vkCmdPipelineBarrier(cmd, src_stage, dst_stage, 0, 0, NULL, 0, NULL, 1, &b);
+}
+
+// Setup ----------------------------------------------------------------------------------------
+
+static bool load_instance_funcs(void) {
+    bool ok = true;
+#define VK_LOAD_INSTANCE(name)                                                       \
+    name = (PFN_##name)vkGetInstanceProcAddr(g_vk.instance, #name);                  \
+    ok = ok && (name || SDL_strstr(#name, "KHR")); /* surface functions: window only */
+    VK_INSTANCE_FUNCS(VK_LOAD_INSTANCE)
+#undef VK_LOAD_INSTANCE
+    return ok;
+}
+
+static bool load_device_funcs(void) {
+    bool ok = true;
+#define VK_LOAD_DEVICE(name)                                        \
+    name = (PFN_##name)vkGetDeviceProcAddr(g_vk.device, #name);     \
+    ok = ok && (name || SDL_strstr(#name, "KHR")); /* swapchain: window only */
+    VK_DEVICE_FUNCS(VK_LOAD_DEVICE)
+#undef VK_LOAD_DEVICE
+    return ok;
+}
+
+static bool create_instance(void) {
+    Uint32 ext_count = 0;
+    const char* const* exts = NULL;
+    if (g_vk.window) {
+        exts = SDL_Vulkan_GetInstanceExtensions(&ext_count);
+        if (!exts) {
+            SDL_Log("pipeline_vk: no instance extensions: %s", SDL_GetError());
+            return false;
+        }
+    }
+    VkApplicationInfo app = {VK_STRUCTURE_TYPE_APPLICATION_INFO};
+    app.pApplicationName = "sidescroller_racer";
+    app.apiVersion = VK_API_VERSION_1_1;  // negative viewport height flips the window pass
+    VkInstanceCreateInfo info = {VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO};
+    info.pApplicationInfo = &app;
+    info.enabledExtensionCount = ext_count;
+    info.ppEnabledExtensionNames = exts;
+    if (!vk_check(vkCreateInstance(&info, NULL, &g_vk.instance), "vkCreateInstance"))
+        return false;
+    if (!load_instance_funcs())
+        return false;
+    if (g_vk.window &&
+        !SDL_Vulkan_CreateSurface(g_vk.window, g_vk.instance, NULL, &g_vk.surface)) {
+        SDL_Log("pipeline_vk: no surface: %s", SDL_GetError());
+        return false;
+    }
+    return true;
+}
+
+// First Vulkan 1.1 device with a graphics queue that can present to the window
+static bool pick_device(void) {
+    VkPhysicalDevice gpus[16];
+    uint32_t count = SDL_arraysize(gpus);
+    VkResult r = vkEnumeratePhysicalDevices(g_vk.instance, &count, gpus);
+    if (r != VK_SUCCESS && r != VK_INCOMPLETE)
+        return vk_check(r, "vkEnumeratePhysicalDevices");
+    for (uint32_t i = 0; i < count; i++) {
+        VkPhysicalDeviceProperties props;
+        vkGetPhysicalDeviceProperties(gpus[i], &props);
+        if (props.apiVersion < VK_API_VERSION_1_1)
+            continue;
+        VkQueueFamilyProperties families[16];
+        uint32_t family_count = SDL_arraysize(families);
+        vkGetPhysicalDeviceQueueFamilyProperties(gpus[i], &family_count, families);
+        for (uint32_t f = 0; f < family_count; f++) {
+            if (!(families[f].queueFlags & VK_QUEUE_GRAPHICS_BIT))
+                continue;
+            VkBool32 present = VK_TRUE;
+            if (g_vk.surface)
+                vkGetPhysicalDeviceSurfaceSupportKHR(gpus[i], f, g_vk.surface, &present);
+            if (!present)
+                continue;
+            g_vk.gpu = gpus[i];
+            g_vk.queue_family = f;
+            vkGetPhysicalDeviceMemoryProperties(gpus[i], &g_vk.memory_props);
+            SDL_Log("pipeline_vk: using %s", props.deviceName);
+            return true;
+        }
+    }
+    SDL_Log("pipeline_vk: no suitable device");
+    return false;
+}
+
+static bool create_device(void) {
+    float priority = 1.0f;
+    VkDeviceQueueCreateInfo queue = {VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO};
+    queue.queueFamilyIndex = g_vk.queue_family;
+    queue.queueCount = 1;
+    queue.pQueuePriorities = &priority;
+    const char* swapchain_ext = VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+    VkDeviceCreateInfo info = {VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO};
+    info.queueCreateInfoCount = 1;
+    info.pQueueCreateInfos = &queue;
+    info.enabledExtensionCount = g_vk.surface ? 1 : 0;
+    info.ppEnabledExtensionNames = &swapchain_ext;
+    if (!vk_check(vkCreateDevice(g_vk.gpu, &info, NULL, &g_vk.device), "vkCreateDevice") ||
+        !load_device_funcs())
+        return false;
+    vkGetDeviceQueue(g_vk.device, g_vk.queue_family, 0, &g_vk.queue);
+    return true;
+}
+
+// Single-subpass color pass; the dependencies order it after earlier passes and transfers that
+// used the same image, and later samplers and transfers after it
+static VkRenderPass create_render_pass(VkFormat format, VkImageLayout final_layout) {
+    VkAttachmentDescription color = {0};
+    color.format = format;
+    color.samples = VK_SAMPLE_COUNT_1_BIT;
+    color.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    color.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    color.finalLayout = final_layout;
+    VkAttachmentReference ref = {0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL};
+    VkSubpassDescription subpass = {0};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &ref;
+    VkSubpassDependency deps[2] = {{0}};
+    deps[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+    deps[0].dstSubpass = 0;
+    deps[0].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+                           VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    deps[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    deps[0].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    deps[0].dstAccessMask =
+        VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    deps[1].srcSubpass = 0;
+    deps[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+    deps[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    deps[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    deps[1].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+    deps[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+    VkRenderPassCreateInfo info = {VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO};
+    info.attachmentCount = 1;
+    info.pAttachments = &color;
+    info.subpassCount = 1;
+    info.pSubpasses = &subpass;
+    info.dependencyCount = 2;
+    info.pDependencies = deps;
+    VkRenderPass pass = VK_NULL_HANDLE;
+    vk_check(vkCreateRenderPass(g_vk.device, &info, NULL, &pass), "vkCreateRenderPass");
+    return pass;
+}
+
+static VkSampler create_sampler(VkFilter filter, bool mipmapped) {
+    VkSamplerCreateInfo info = {VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO};
+    info.magFilter = filter;
+    info.minFilter = filter;
+    info.mipmapMode =
+        mipmapped ? VK_SAMPLER_MIPMAP_MODE_LINEAR : VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    info.maxLod = mipmapped ? VK_LOD_CLAMP_NONE : 0.0f;
+    VkSampler sampler = VK_NULL_HANDLE;
+    vk_check(vkCreateSampler(g_vk.device, &info, NULL, &sampler), "vkCreateSampler");
+    return sampler;
+}
+
+static bool create_layouts(void) {
+    VkDescriptorSetLayoutBinding ubo = {0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1,
+                                        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                                        NULL};
+    VkDescriptorSetLayoutBinding tex = {0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1,
+                                        VK_SHADER_STAGE_FRAGMENT_BIT, NULL};
+    VkDescriptorSetLayoutCreateInfo info = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO};
+    info.bindingCount = 1;
+    info.pBindings = &ubo;
+    if (!vk_check(vkCreateDescriptorSetLayout(g_vk.device, &info, NULL, &g_vk.frame_layout),
+                  "vkCreateDescriptorSetLayout"))
+        return false;
+    info.pBindings = &tex;
+    if (!vk_check(vkCreateDescriptorSetLayout(g_vk.device, &info, NULL, &g_vk.texture_layout),
+                  "vkCreateDescriptorSetLayout"))
+        return false;
+
+    VkDescriptorSetLayout sets[2] = {g_vk.frame_layout, g_vk.texture_layout};
+    VkPushConstantRange push = {VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0,
+                                sizeof(uint32_t)};
+    VkPipelineLayoutCreateInfo layout = {VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO};
+    layout.setLayoutCount = 2;
+    layout.pSetLayouts = sets;
+    layout.pushConstantRangeCount = 1;
+    layout.pPushConstantRanges = &push;
+    if (!vk_check(vkCreatePipelineLayout(g_vk.device, &layout, NULL, &g_vk.layout),
+                  "vkCreatePipelineLayout"))
+        return false;
+
+    // Textures, the three targets of every view and the headless window image
+    uint32_t image_sets = VK_MAX_TEXTURES + PIPELINE_MAX_VIEWS * 3 + 1;
+    VkDescriptorPoolSize sizes[2] = {
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, PIPELINE_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, image_sets},
+    };
+    VkDescriptorPoolCreateInfo pool = {VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO};
+    pool.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    pool.maxSets = PIPELINE_FRAMES_IN_FLIGHT + image_sets;
+    pool.poolSizeCount = 2;
+    pool.pPoolSizes = sizes;
+    return vk_check(vkCreateDescriptorPool(g_vk.device, &pool, NULL, &g_vk.descriptor_pool),
+                    "vkCreateDescriptorPool");
+}
+
+typedef struct {
+    VkPipeline* out;
+    const uint32_t* vs;
+    size_t vs_size;
+    const uint32_t* fs;
+    size_t fs_size;
+    int input;
+    bool blend;
+    VkBlendFactor src, dst;  // used for color and alpha, like glBlendFunc
+    VkRenderPass pass;
+} PipelineDesc;
+
+static VkShaderModule shader_module(const uint32_t* code, size_t size) {
+    VkShaderModuleCreateInfo info = {VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO};
+    info.codeSize = size;
+    info.pCode = code;
+    VkShaderModule module = VK_NULL_HANDLE;
+    vk_check(vkCreateShaderModule(g_vk.device, &info, NULL, &module), "vkCreateShaderModule");
+    return module;
+}
+
+static bool create_pipeline(const PipelineDesc* d) {
+    VkVertexInputBindingDescription binding = {0, sizeof(PipelineVertex),
+                                               VK_VERTEX_INPUT_RATE_VERTEX};
+    VkVertexInputAttributeDescription attrs[4];
+    uint32_t attr_count = 0;
+    switch (d->input) {
+        case INPUT_VERTEX:
+            attrs[0] = (VkVertexInputAttributeDescription){0, 0, VK_FORMAT_R32G32_SFLOAT,
+                                                           offsetof(PipelineVertex, x)};
+            attrs[1] = (VkVertexInputAttributeDescription){1, 0, VK_FORMAT_R32G32_SFLOAT,
+                                                           offsetof(PipelineVertex, u)};
+            attrs[2] = (VkVertexInputAttributeDescription){2, 0, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                                           offsetof(PipelineVertex, r)};
+            attrs[3] = (VkVertexInputAttributeDescription){3, 0, VK_FORMAT_R32_SFLOAT,
+                                                           offsetof(PipelineVertex, par)};
+            attr_count = 4;
+            break;
+        case INPUT_INSTANCE:
+            binding.stride = sizeof(PipelineInstance);
+            binding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+            attrs[0] = (VkVertexInputAttributeDescription){0, 0, VK_FORMAT_R32G32B32_SFLOAT,
+                                                           offsetof(PipelineInstance, x)};
+            attrs[1] = (VkVertexInputAttributeDescription){1, 0, VK_FORMAT_R8G8B8A8_UNORM,
+                                                           offsetof(PipelineInstance, rgba)};
+            attr_count = 2;
+            break;
+        case INPUT_LIGHT:
+            binding.stride = sizeof(LightingVertex);
+            attrs[0] = (VkVertexInputAttributeDescription){0, 0, VK_FORMAT_R32G32_SFLOAT,
+                                                           offsetof(LightingVertex, x)};
+            attrs[1] = (VkVertexInputAttributeDescription){1, 0, VK_FORMAT_R32G32B32_SFLOAT,
+                                                           offsetof(LightingVertex, lx)};
+            attrs[2] = (VkVertexInputAttributeDescription){2, 0, VK_FORMAT_R32G32B32_SFLOAT,
+                                                           offsetof(LightingVertex, r)};
+            attr_count = 3;
+            break;
+        default:
+            break;
+    }
+    VkPipelineVertexInputStateCreateInfo input = {
+        VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO};
+    input.vertexBindingDescriptionCount = attr_count ? 1 : 0;
+    input.pVertexBindingDescriptions = &binding;
+    input.vertexAttributeDescriptionCount = attr_count;
+    input.pVertexAttributeDescriptions = attrs;
+
+    VkPipelineInputAssemblyStateCreateInfo assembly = {
+        VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO};
+    assembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    VkPipelineViewportStateCreateInfo viewport = {
+        VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO};
+    viewport.viewportCount = 1;
+    viewport.scissorCount = 1;
+    VkPipelineRasterizationStateCreateInfo raster = {
+        VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO};
+    raster.polygonMode = VK_POLYGON_MODE_FILL;
+    raster.cullMode = VK_CULL_MODE_NONE;
+    raster.lineWidth = 1.0f;
+    VkPipelineMultisampleStateCreateInfo multisample = {
+        VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO};
+    multisample.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    VkPipelineColorBlendAttachmentState blend = {0};
+    blend.blendEnable = d->blend ? VK_TRUE : VK_FALSE;
+    blend.srcColorBlendFactor = d->src;
+    blend.dstColorBlendFactor = d->dst;
+    blend.colorBlendOp = VK_BLEND_OP_ADD;
+    blend.srcAlphaBlendFactor = d->src;
+    blend.dstAlphaBlendFactor = d->dst;
+    blend.alphaBlendOp = VK_BLEND_OP_ADD;
+    blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                           VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    VkPipelineColorBlendStateCreateInfo blend_state = {
+        VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO};
+    blend_state.attachmentCount = 1;
+    blend_state.pAttachments = &blend;
+    VkDynamicState dynamic[2] = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    VkPipelineDynamicStateCreateInfo dynamic_state = {
+        VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO};
+    dynamic_state.dynamicStateCount = 2;
+    dynamic_state.pDynamicStates = dynamic;
+
+    VkPipelineShaderStageCreateInfo stages[2] = {
+        {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO},
+        {VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO},
+    };
+    stages[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stages[0].module = shader_module(d->vs, d->vs_size);
+    stages[0].pName = "main";
+    stages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stages[1].module = shader_module(d->fs, d->fs_size);
+    stages[1].pName = "main";
+
+    VkGraphicsPipelineCreateInfo info = {VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO};
+    info.stageCount = 2;
+    info.pStages = stages;
+    info.pVertexInputState = &input;
+    info.pInputAssemblyState = &assembly;
+    info.pViewportState = &viewport;
+    info.pRasterizationState = &raster;
+    info.pMultisampleState = &multisample;
+    info.pColorBlendState = &blend_state;
+    info.pDynamicState = &dynamic_state;
+    info.layout = g_vk.layout;
+    info.renderPass = d->pass;
+    bool ok = stages[0].module && stages[1].module &&
+              vk_check(vkCreateGraphicsPipelines(g_vk.device, VK_NULL_HANDLE, 1, &info, NULL,
+                                                 d->out),
+                       "vkCreateGraphicsPipelines");
+    if (stages[0].module)
+        vkDestroyShaderModule(g_vk.device, stages[0].module, NULL);
+    if (stages[1].module)
+        vkDestroyShaderModule(g_vk.device, stages[1].module, NULL);
+    return ok;
+}
+
+#define SHADER(code) code, sizeof(code)
+
+static bool create_pipelines(void) {
+    const VkBlendFactor src_alpha = VK_BLEND_FACTOR_SRC_ALPHA;
+    const VkBlendFactor inv_src_alpha = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+    const VkBlendFactor one = VK_BLEND_FACTOR_ONE;
+    const PipelineDesc descs[] = {
+        {&g_vk.sprite, SHADER(SPRITE_VERT), SHADER(TEXTURED_FRAG), INPUT_VERTEX, true, src_alpha,
+         inv_src_alpha, g_vk.rp_window},
+        {&g_vk.instanced, SHADER(INSTANCE_VERT), SHADER(TEXTURED_FRAG), INPUT_INSTANCE, true,
+         src_alpha, inv_src_alpha, g_vk.rp_window},
+        {&g_vk.mesh, SHADER(MESH_VERT), SHADER(TEXTURED_FRAG), INPUT_VERTEX, false, one, one,
+         g_vk.rp_mesh},
+        {&g_vk.comp_pixel, SHADER(FULLSCREEN_VERT), SHADER(COMPOSITE_FRAG), INPUT_NONE, true,
+         src_alpha, inv_src_alpha, g_vk.rp_pixel},
+        {&g_vk.snow, SHADER(FULLSCREEN_VERT), SHADER(SNOW_FRAG), INPUT_NONE, true, src_alpha, one,
+         g_vk.rp_pixel},
+        {&g_vk.comp_window, SHADER(FULLSCREEN_VERT), SHADER(COMPOSITE_FRAG), INPUT_NONE, true,
+         src_alpha, inv_src_alpha, g_vk.rp_window},
+        {&g_vk.light, SHADER(LIGHT_VERT), SHADER(LIGHT_FRAG), INPUT_LIGHT, true, one, one,
+         g_vk.rp_pixel},
+        {&g_vk.apply, SHADER(FULLSCREEN_VERT), SHADER(APPLY_FRAG), INPUT_NONE, true,
+         VK_BLEND_FACTOR_DST_COLOR, VK_BLEND_FACTOR_ZERO, g_vk.rp_window},
+    };
+    for (size_t i = 0; i < SDL_arraysize(descs); i++) {
+        if (!create_pipeline(&descs[i]))
+            return false;
+    }
+    return true;
+}
+
+static VkFormat pick_window_format(void) {
+    if (!g_vk.surface)
+        return VK_FORMAT_R8G8B8A8_UNORM;
+    VkSurfaceFormatKHR formats[32];
+    uint32_t count = SDL_arraysize(formats);
+    VkResult r = vkGetPhysicalDeviceSurfaceFormatsKHR(g_vk.gpu, g_vk.surface, &count, formats);
+    if ((r != VK_SUCCESS && r != VK_INCOMPLETE) || count == 0)
+        return VK_FORMAT_B8G8R8A8_UNORM;
+    // UNORM like the GL default framebuffer (the shaders output display values)
+    for (uint32_t i = 0; i < count; i++) {
+        if (formats[i].format == VK_FORMAT_B8G8R8A8_UNORM ||
+            formats[i].format == VK_FORMAT_R8G8B8A8_UNORM)
+            return formats[i].format;
+    }
+    return formats[0].format == VK_FORMAT_UNDEFINED ? VK_FORMAT_B8G8R8A8_UNORM
+                                                    : formats[0].format;
+}
+
+static bool create_slots(void) {
+    VkCommandPoolCreateInfo pool = {VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO};
+    pool.queueFamilyIndex = g_vk.queue_family;
+    pool.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    if (!vk_check(vkCreateCommandPool(g_vk.device, &pool, NULL, &g_vk.static_pool),
+                  "vkCreateCommandPool"))
+        return false;
+    pool.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+
+    for (int s = 0; s < PIPELINE_FRAMES_IN_FLIGHT; s++) {
+        Slot* slot = &g_vk.slots[s];
+        VkFenceCreateInfo fence = {VK_STRUCTURE_TYPE_FENCE_CREATE_INFO};
+        fence.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+        VkSemaphoreCreateInfo sem = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        if (!vk_check(vkCreateFence(g_vk.device, &fence, NULL, &slot->fence), "vkCreateFence") ||
+            !vk_check(vkCreateSemaphore(g_vk.device, &sem, NULL, &slot->acquired),
+                      "vkCreateSemaphore") ||
+            !vk_check(vkCreateCommandPool(g_vk.device, &pool, NULL, &slot->pool),
+                      "vkCreateCommandPool"))
+            return false;
+
+        VkCommandBufferAllocateInfo alloc = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+        alloc.commandPool = slot->pool;
+        alloc.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        alloc.commandBufferCount = 1;
+        if (!vk_check(vkAllocateCommandBuffers(g_vk.device, &alloc, &slot->cmd),
+                      "vkAllocateCommandBuffers"))
+            return false;
+        alloc.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        alloc.commandBufferCount = PIPELINE_MAX_VIEWS;
+        if (!vk_check(vkAllocateCommandBuffers(g_vk.device, &alloc, slot->dynamic),
+                      "vkAllocateCommandBuffers"))
+            return false;
+
+        if (!mapped_create(&slot->ubo, sizeof(FrameUniforms), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT))
+            return false;
+        VkDescriptorSetAllocateInfo set = {VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO};
+        set.descriptorPool = g_vk.descriptor_pool;
+        set.descriptorSetCount = 1;
+        set.pSetLayouts = &g_vk.frame_layout;
+        if (!vk_check(vkAllocateDescriptorSets(g_vk.device, &set, &slot->frame_set),
+                      "vkAllocateDescriptorSets"))
+            return false;
+        VkDescriptorBufferInfo buffer = {slot->ubo.buffer, 0, sizeof(FrameUniforms)};
+        VkWriteDescriptorSet write = {VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET};
+        write.dstSet = slot->frame_set;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        write.pBufferInfo = &buffer;
+        vkUpdateDescriptorSets(g_vk.device, 1, &write, 0, NULL);
+    }
+
+    VkCommandBufferAllocateInfo alloc = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO};
+    alloc.commandPool = g_vk.static_pool;
+    alloc.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    alloc.commandBufferCount = PIPELINE_FRAMES_IN_FLIGHT;
+    for (int v = 0; v < PIPELINE_MAX_VIEWS; v++) {
+        ViewState* view = &g_vk.views[v];
+        if (!vk_check(vkAllocateCommandBuffers(g_vk.device, &alloc, view->mesh_sec),
+                      "vkAllocateCommandBuffers") ||
+            !vk_check(vkAllocateCommandBuffers(g_vk.device, &alloc, view->pixel_sec),
+                      "vkAllocateCommandBuffers") ||
+            !vk_check(vkAllocateCommandBuffers(g_vk.device, &alloc, view->window_sec),
+                      "vkAllocateCommandBuffers"))
+            return false;
+    }
+    return true;
+}
+
+bool pipeline_vk_init(SDL_Window* window) {
+    memset(&g_vk, 0, sizeof(g_vk));
+    g_vk.window = window;
+    g_vk.free_texture = -1;
+    g_vk.mesh_gen = 1;
+    if (!SDL_Vulkan_LoadLibrary(NULL)) {
+        SDL_Log("pipeline_vk: no Vulkan library: %s", SDL_GetError());
+        return false;
+    }
+    g_vk.library = true;
+    vkGetInstanceProcAddr = (PFN_vkGetInstanceProcAddr)SDL_Vulkan_GetVkGetInstanceProcAddr();
+    vkCreateInstance =
+        vkGetInstanceProcAddr ? (PFN_vkCreateInstance)vkGetInstanceProcAddr(NULL,
+                                                                             "vkCreateInstance")
+                              : NULL;
+    if (!vkCreateInstance || !create_instance() || !pick_device() || !create_device())
+        goto fail;
+
+    g_vk.format = pick_window_format();
+    g_vk.nearest = create_sampler(VK_FILTER_NEAREST, false);
+    g_vk.linear = create_sampler(VK_FILTER_LINEAR, false);
+    g_vk.mipmapped = create_sampler(VK_FILTER_LINEAR, true);
+    g_vk.rp_mesh = create_render_pass(VK_FORMAT_R8G8B8A8_UNORM,
+                                      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    g_vk.rp_pixel = create_render_pass(VK_FORMAT_R8G8B8A8_UNORM,
+                                       VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    g_vk.rp_window = create_render_pass(g_vk.format, g_vk.surface
+                                                         ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR
+                                                         : VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
+    if (!g_vk.nearest || !g_vk.linear || !g_vk.mipmapped || !g_vk.rp_mesh || !g_vk.rp_pixel ||
+        !g_vk.rp_window || !create_layouts() || !create_pipelines() || !create_slots())
+        goto fail;
+    return true;
+
+fail:
+    SDL_Log("pipeline_vk: init failed");
+    pipeline_vk_shutdown();
+    return false;
+}
+
+// Window ---------------------------------------------------------------------------------------
+
+static void swapchain_destroy_images(void) {
+    for (uint32_t i = 0; i < g_vk.image_count; i++) {
+        if (g_vk.framebuffers[i])
+            vkDestroyFramebuffer(g_vk.device, g_vk.framebuffers[i], NULL);
+        if (g_vk.image_views[i])
+            vkDestroyImageView(g_vk.device, g_vk.image_views[i], NULL);
+        if (g_vk.rendered[i])
+            vkDestroySemaphore(g_vk.device, g_vk.rendered[i], NULL);
+        g_vk.framebuffers[i] = VK_NULL_HANDLE;
+        g_vk.image_views[i] = VK_NULL_HANDLE;
+        g_vk.rendered[i] = VK_NULL_HANDLE;
+    }
+    g_vk.image_count = 0;
+}
+
+static bool create_swapchain(int w, int h) {
+    vkDeviceWaitIdle(g_vk.device);
+    swapchain_destroy_images();
+    g_vk.swap_w = 0;
+    VkSurfaceCapabilitiesKHR caps;
+    if (!vk_check(vkGetPhysicalDeviceSurfaceCapabilitiesKHR(g_vk.gpu, g_vk.surface, &caps),
+                  "vkGetPhysicalDeviceSurfaceCapabilitiesKHR"))
+        return false;
+    VkExtent2D extent = caps.currentExtent;
+    if (extent.width == UINT32_MAX) {
+        extent.width = SDL_clamp((uint32_t)w, caps.minImageExtent.width, caps.maxImageExtent.width);
+        extent.height =
+            SDL_clamp((uint32_t)h, caps.minImageExtent.height, caps.maxImageExtent.height);
+    }
+    if (extent.width == 0 || extent.height == 0)
+        return false;  // minimized
+    uint32_t images = caps.minImageCount + 1;
+    if (caps.maxImageCount && images > caps.maxImageCount)
+        images = caps.maxImageCount;
+
+    VkSwapchainKHR old = g_vk.swapchain;
+    VkSwapchainCreateInfoKHR info = {VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR};
+    info.surface = g_vk.surface;
+    info.minImageCount = images;
+    info.imageFormat = g_vk.format;
+    info.imageColorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR;
+    info.imageExtent = extent;
+    info.imageArrayLayers = 1;
+    info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    info.imageSharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    info.preTransform = caps.currentTransform;
+    info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
+    info.presentMode = VK_PRESENT_MODE_FIFO_KHR;  // vsync, like SDL_GL_SetSwapInterval(1)
+    info.clipped = VK_TRUE;
+    info.oldSwapchain = old;
+    VkResult r = vkCreateSwapchainKHR(g_vk.device, &info, NULL, &g_vk.swapchain);
+    if (old)
+        vkDestroySwapchainKHR(g_vk.device, old, NULL);
+    if (!vk_check(r, "vkCreateSwapchainKHR")) {
+        g_vk.swapchain = VK_NULL_HANDLE;
+        return false;
+    }
+
+    uint32_t count = VK_MAX_SWAPCHAIN_IMAGES;
+    r = vkGetSwapchainImagesKHR(g_vk.device, g_vk.swapchain, &count, g_vk.images);
+    if (r != VK_SUCCESS && r != VK_INCOMPLETE)
+        return vk_check(r, "vkGetSwapchainImagesKHR");
+    g_vk.image_count = count;
+    for (uint32_t i = 0; i < count; i++) {
+        g_vk.image_views[i] = image_view(g_vk.images[i], g_vk.format, 1);
+        VkFramebufferCreateInfo fb = {VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO};
+        fb.renderPass = g_vk.rp_window;
+        fb.attachmentCount = 1;
+        fb.pAttachments = &g_vk.image_views[i];
+        fb.width = extent.width;
+        fb.height = extent.height;
+        fb.layers = 1;
+        VkSemaphoreCreateInfo sem = {VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO};
+        if (!g_vk.image_views[i] ||
+            !vk_check(vkCreateFramebuffer(g_vk.device, &fb, NULL, &g_vk.framebuffers[i]),
+                      "vkCreateFramebuffer") ||
+            !vk_check(vkCreateSemaphore(g_vk.device, &sem, NULL, &g_vk.rendered[i]),
+                      "vkCreateSemaphore"))
+            return false;
+    }
+    g_vk.extent = extent;
+    g_vk.swap_w = w;
+    g_vk.swap_h = h;
+    return true;
+}
+
+// Picks the image this frame renders to (waits for a swapchain image, signals slot->acquired)
+static bool acquire_image(Slot* slot, int w, int h) {
+    if (!g_vk.surface) {
+        if (g_vk.offscreen.image && g_vk.offscreen.w == w && g_vk.offscreen.h == h)
+            return true;
+        vkDeviceWaitIdle(g_vk.device);
+        target_destroy(&g_vk.offscreen);
+        g_vk.offscreen_valid = false;
+        if (!target_create(&g_vk.offscreen, w, h, 1, g_vk.format,
+                           VK_IMAGE_USAGE_TRANSFER_SRC_BIT, g_vk.rp_window, VK_NULL_HANDLE))
+            return false;
+        g_vk.extent.width = (uint32_t)w;
+        g_vk.extent.height = (uint32_t)h;
+        return true;
+    }
+    for (int attempt = 0; attempt < 2; attempt++) {
+        if ((!g_vk.swapchain || g_vk.swap_w != w || g_vk.swap_h != h) && !create_swapchain(w, h))
+            return false;
+        VkResult r = vkAcquireNextImageKHR(g_vk.device, g_vk.swapchain, UINT64_MAX,
+                                           slot->acquired, VK_NULL_HANDLE, &g_vk.image);
+        if (r == VK_SUCCESS || r == VK_SUBOPTIMAL_KHR)
+            return true;
+        if (r != VK_ERROR_OUT_OF_DATE_KHR)
+            return vk_check(r, "vkAcquireNextImageKHR");
+        g_vk.swap_w = 0;
+    }
+    return false;
+}
+
+// Textures -------------------------------------------------------------------------------------
+
+static Texture* texture_get(unsigned int id) {
+    if (id == 0 || (int)id > g_vk.texture_count)
+        return NULL;
+    Texture* t = &g_vk.textures[id - 1];
+    return t->used ? t : NULL;
+}
+
+unsigned int pipeline_vk_texture_create(int w, int h, const void* rgba, bool linear) {
+    if (!g_vk.device)
+        return 0;
+    int index = g_vk.free_texture;
+    if (index >= 0) {
+        g_vk.free_texture = g_vk.textures[index].next_free;
+    } else {
+        if (g_vk.texture_count >= VK_MAX_TEXTURES) {
+            SDL_Log("pipeline_vk: more than %d textures", VK_MAX_TEXTURES);
+            return 0;
+        }
+        if (!g_vk.textures)
+            g_vk.textures = calloc(VK_MAX_TEXTURES, sizeof(Texture));
+        index = g_vk.texture_count++;
+    }
+    Texture* t = &g_vk.textures[index];
+    memset(t, 0, sizeof(*t));
+    t->w = w;
+    t->h = h;
+    VkDeviceSize bytes = (VkDeviceSize)w * (VkDeviceSize)h * 4;
+    if (!image_create(w, h, 1, VK_FORMAT_R8G8B8A8_UNORM,
+                      VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT, &t->image,
+                      &t->memory) ||
+        !(t->view = image_view(t->image, VK_FORMAT_R8G8B8A8_UNORM, 1)) ||
+        !mapped_create(&t->staging, bytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT) ||
+        !(t->set = texture_set(t->view, linear ? g_vk.linear : g_vk.nearest))) {
+        Retired r = {0, t->image, t->view, t->memory, t->staging.buffer, VK_NULL_HANDLE};
+        release(&r);
+        if (t->staging.memory)
+            vkFreeMemory(g_vk.device, t->staging.memory, NULL);
+        memset(t, 0, sizeof(*t));
+        t->next_free = g_vk.free_texture;
+        g_vk.free_texture = index;
+        return 0;
+    }
+    memcpy(t->staging.ptr, rgba, (size_t)bytes);
+    t->used = true;
+    t->pending = true;
+    if (g_vk.pending_count == g_vk.pending_cap) {
+        g_vk.pending_cap = g_vk.pending_cap ? g_vk.pending_cap * 2 : 64;
+        g_vk.pending = realloc(g_vk.pending, (size_t)g_vk.pending_cap * sizeof(int));
+    }
+    g_vk.pending[g_vk.pending_count++] = index;
+    return (unsigned int)index + 1;
+}
+
+void pipeline_vk_texture_destroy(unsigned int texture) {
+    Texture* t = texture_get(texture);
+    if (!t)
+        return;
+    if (t->pending) {
+        // Never reached the GPU
+        Retired r = {0, VK_NULL_HANDLE, VK_NULL_HANDLE, t->staging.memory, t->staging.buffer,
+                     VK_NULL_HANDLE};
+        release(&r);
+    }
+    Retired r = {0, t->image, t->view, t->memory, VK_NULL_HANDLE, t->set};
+    retire(&r);
+    if (texture == g_vk.mesh_tex)
+        g_vk.mesh_gen++;  // the mesh pass secondaries hold its descriptor set
+    memset(t, 0, sizeof(*t));
+    t->next_free = g_vk.free_texture;
+    g_vk.free_texture = (int)texture - 1;
+}
+
+// Copies the textures created since the last frame, ahead of everything that samples them
+static void record_uploads(VkCommandBuffer cmd) {
+    for (int i = 0; i < g_vk.pending_count; i++) {
+        Texture* t = &g_vk.textures[g_vk.pending[i]];
+        if (!t->used || !t->pending)
+            continue;
+        image_barrier(cmd, t->image, 0, 1, VK_IMAGE_LAYOUT_UNDEFINED,
+                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0,
+                      VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+        VkBufferImageCopy copy = {0};
+        copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        copy.imageSubresource.layerCount = 1;
+        copy.imageExtent.width = (uint32_t)t->w;
+        copy.imageExtent.height = (uint32_t)t->h;
+        copy.imageExtent.depth = 1;
+        vkCmdCopyBufferToImage(cmd, t->staging.buffer, t->image,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copy);
+        image_barrier(cmd, t->image, 0, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                      VK_ACCESS_SHADER_READ_BIT);
+        mapped_retire(&t->staging);
+        t->pending = false;
+    }
+    g_vk.pending_count = 0;
+}
+
+// Frame ----------------------------------------------------------------------------------------
+
+static Slot* current_slot(void) {
+    return &g_vk.slots[g_vk.frame % PIPELINE_FRAMES_IN_FLIGHT];
+}
+
+bool pipeline_vk_frame_begin(int window_w,
+                             int window_h,
+                             const PipelineVkFrame* frame,
+                             PipelineStats* stats) {
+    if (!g_vk.device || g_vk.recording || window_w <= 0 || window_h <= 0)
+        return false;
+    Slot* slot = current_slot();
+    Uint64 t0 = SDL_GetTicksNS();
+    stats->stream_region = (unsigned int)(g_vk.frame % PIPELINE_FRAMES_IN_FLIGHT);
+    if (g_vk.frame >= PIPELINE_FRAMES_IN_FLIGHT) {
+        stats->stream_fence_waits++;
+        if (vkGetFenceStatus(g_vk.device, slot->fence) == VK_NOT_READY) {
+            stats->stream_stalls++;
+            vkWaitForFences(g_vk.device, 1, &slot->fence, VK_TRUE, UINT64_MAX);
+        }
+    }
+    release_retired(false);
+    bool acquired = acquire_image(slot, window_w, window_h);
+    stats->wait_ms += (double)(SDL_GetTicksNS() - t0) / 1.0e6;
+    if (!acquired)
+        return false;
+
+    vkResetCommandPool(g_vk.device, slot->pool, 0);
+    VkCommandBufferBeginInfo begin = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(slot->cmd, &begin);
+    record_uploads(slot->cmd);
+
+    g_vk.frame_params = *frame;
+    g_vk.window_w = window_w;
+    g_vk.window_h = window_h;
+    slot->lights_used = 0;
+    for (int v = 0; v < PIPELINE_MAX_VIEWS; v++) {
+        g_vk.views[v].drawn = false;
+    }
+    g_vk.recording = true;
+    return true;
+}
+
+PipelineVertex* pipeline_vk_sprite_reserve(size_t count) {
+    Slot* slot = current_slot();
+    if (!g_vk.recording ||
+        !mapped_reserve(&slot->sprites, count * sizeof(PipelineVertex),
+                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT))
+        return NULL;
+    return (PipelineVertex*)slot->sprites.ptr;
+}
+
+PipelineInstance* pipeline_vk_instance_reserve(size_t count) {
+    Slot* slot = current_slot();
+    if (!g_vk.recording ||
+        !mapped_reserve(&slot->instances, count * sizeof(PipelineInstance),
+                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT))
+        return NULL;
+    return (PipelineInstance*)slot->instances.ptr;
+}
+
+void pipeline_vk_mesh_upload(const PipelineVertex* verts, size_t count, unsigned int texture) {
+    if (count == 0 && g_vk.mesh_count == 0)
+        return;
+    if (count > g_vk.mesh_cap) {
+        g_vk.mesh_verts = realloc(g_vk.mesh_verts, count * sizeof(PipelineVertex));
+        g_vk.mesh_cap = count;
+    }
+    if (count)
+        memcpy(g_vk.mesh_verts, verts, count * sizeof(PipelineVertex));
+    g_vk.mesh_count = count;
+    g_vk.mesh_tex = texture;
+    g_vk.mesh_gen++;
+}
+
+// Brings the slot's mesh buffer up to the latest upload
+static void sync_mesh(Slot* slot) {
+    if (slot->mesh_gen == g_vk.mesh_gen)
+        return;
+    slot->mesh_gen = g_vk.mesh_gen;
+    if (g_vk.mesh_count == 0)
+        return;
+    if (!mapped_reserve(&slot->mesh, g_vk.mesh_count * sizeof(PipelineVertex),
+                        VK_BUFFER_USAGE_VERTEX_BUFFER_BIT)) {
+        slot->mesh_gen = 0;
+        return;
+    }
+    memcpy(slot->mesh.ptr, g_vk.mesh_verts, g_vk.mesh_count * sizeof(PipelineVertex));
+}
+
+static int mip_count(int w, int h) {
+    int mips = 1;
+    while ((w | h) >> mips) {
+        mips++;
+    }
+    return mips;
+}
+
+// Matches the view's targets to its rect; a new size recreates them once the GPU is idle
+static bool view_update(ViewState* vs, const PipelineVkView* view) {
+    int y_top = g_vk.window_h - (view->y + view->h);
+    bool resized = !vs->mesh.image || vs->w != view->w || vs->h != view->h;
+    if (!resized && vs->x == view->x && vs->y_top == y_top && vs->window_w == g_vk.window_w &&
+        vs->window_h == g_vk.window_h)
+        return true;
+    vs->gen++;
+    vs->x = view->x;
+    vs->y_top = y_top;
+    vs->window_w = g_vk.window_w;
+    vs->window_h = g_vk.window_h;
+    if (!resized)
+        return true;
+
+    vkDeviceWaitIdle(g_vk.device);
+    target_destroy(&vs->mesh);
+    target_destroy(&vs->pixel);
+    target_destroy(&vs->light);
+    vs->w = view->w;
+    vs->h = view->h;
+    int mesh_w = view->w * PIPELINE_SUPERSAMPLE, mesh_h = view->h * PIPELINE_SUPERSAMPLE;
+    const VkImageUsageFlags sampled = VK_IMAGE_USAGE_SAMPLED_BIT;
+    if (target_create(&vs->mesh, mesh_w, mesh_h, mip_count(mesh_w, mesh_h),
+                      VK_FORMAT_R8G8B8A8_UNORM,
+                      sampled | VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                      g_vk.rp_mesh, g_vk.mipmapped) &&
+        target_create(&vs->pixel, view->w / PIPELINE_PIXEL_SCALE, view->h / PIPELINE_PIXEL_SCALE,
+                      1, VK_FORMAT_R8G8B8A8_UNORM, sampled, g_vk.rp_pixel, g_vk.nearest) &&
+        target_create(&vs->light, view->w / LIGHTING_DOWNSCALE, view->h / LIGHTING_DOWNSCALE, 1,
+                      VK_FORMAT_R8G8B8A8_UNORM, sampled, g_vk.rp_pixel, g_vk.linear))
+        return true;
+    target_destroy(&vs->mesh);
+    target_destroy(&vs->pixel);
+    target_destroy(&vs->light);
+    vs->w = vs->h = 0;
+    return false;
+}
+
+static void begin_secondary(VkCommandBuffer cmd,
+                            VkRenderPass pass,
+                            VkFramebuffer framebuffer,
+                            VkCommandBufferUsageFlags flags) {
+    VkCommandBufferInheritanceInfo inherit = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO};
+    inherit.renderPass = pass;
+    inherit.framebuffer = framebuffer;
+    VkCommandBufferBeginInfo begin = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    begin.flags = flags | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    begin.pInheritanceInfo = &inherit;
+    vkBeginCommandBuffer(cmd, &begin);
+}
+
+// Viewport over (x, y, w, h) with y down; flip puts NDC -1 at the bottom like GL (window pass)
+static void set_viewport(VkCommandBuffer cmd, int x, int y, int w, int h, bool flip) {
+    VkViewport vp = {(float)x, (float)y, (float)w, (float)h, 0.0f, 1.0f};
+    if (flip) {
+        vp.y = (float)(y + h);
+        vp.height = -(float)h;
+    }
+    VkRect2D scissor = {{x, y}, {(uint32_t)w, (uint32_t)h}};
+    if (scissor.offset.x < 0) {
+        scissor.extent.width = (uint32_t)SDL_max(w + x, 0);
+        scissor.offset.x = 0;
+    }
+    if (scissor.offset.y < 0) {
+        scissor.extent.height = (uint32_t)SDL_max(h + y, 0);
+        scissor.offset.y = 0;
+    }
+    vkCmdSetViewport(cmd, 0, 1, &vp);
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+}
+
+static void bind(VkCommandBuffer cmd,
+                 VkPipeline pipeline,
+                 const Slot* slot,
+                 VkDescriptorSet texture,
+                 uint32_t view) {
+    VkDescriptorSet sets[2] = {slot->frame_set, texture};
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vk.layout, 0,
+                            texture ? 2 : 1, sets, 0, NULL);
+    vkCmdPushConstants(cmd, g_vk.layout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+                       0, sizeof(view), &view);
+}
+
+// Static secondaries: replayed every frame, recorded again only when their key changes
+
+static void record_mesh_pass(ViewState* vs, const Slot* slot, int s, uint32_t index) {
+    VkCommandBuffer cmd = vs->mesh_sec[s];
+    begin_secondary(cmd, g_vk.rp_mesh, vs->mesh.framebuffer, 0);
+    set_viewport(cmd, 0, 0, vs->mesh.w, vs->mesh.h, false);
+    Texture* tex = texture_get(g_vk.mesh_tex);
+    if (g_vk.mesh_count > 0 && tex) {
+        VkDeviceSize offset = 0;
+        bind(cmd, g_vk.mesh, slot, tex->set, index);
+        vkCmdBindVertexBuffers(cmd, 0, 1, &slot->mesh.buffer, &offset);
+        vkCmdDraw(cmd, (uint32_t)g_vk.mesh_count, 1, 0, 0);
+    }
+    vkEndCommandBuffer(cmd);
+    vs->mesh_key[s][0] = vs->gen;
+    vs->mesh_key[s][1] = slot->mesh_gen;
+}
+
+static void record_pixel_pass(ViewState* vs, const Slot* slot, int s, uint32_t index) {
+    VkCommandBuffer cmd = vs->pixel_sec[s];
+    begin_secondary(cmd, g_vk.rp_pixel, vs->pixel.framebuffer, 0);
+    set_viewport(cmd, 0, 0, vs->pixel.w, vs->pixel.h, false);
+    // Downsample the mesh target, then snow over it
+    bind(cmd, g_vk.comp_pixel, slot, vs->mesh.set, index);
+    vkCmdDraw(cmd, 3, 1, 0, 0);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vk.snow);
+    vkCmdDraw(cmd, 3, 1, 0, 0);
+    vkEndCommandBuffer(cmd);
+    vs->pixel_key[s] = vs->gen;
+}
+
+static void record_window_pass(ViewState* vs, const Slot* slot, int s, uint32_t index) {
+    VkCommandBuffer cmd = vs->window_sec[s];
+    begin_secondary(cmd, g_vk.rp_window, VK_NULL_HANDLE, 0);
+    set_viewport(cmd, vs->x, vs->y_top, vs->w, vs->h, true);
+    // Sky behind this view's rect, clipped to the window
+    int x0 = SDL_max(vs->x, 0), y0 = SDL_max(vs->y_top, 0);
+    int x1 = SDL_min(vs->x + vs->w, (int)g_vk.extent.width);
+    int y1 = SDL_min(vs->y_top + vs->h, (int)g_vk.extent.height);
+    if (x1 > x0 && y1 > y0) {
+        VkClearAttachment clear = {VK_IMAGE_ASPECT_COLOR_BIT, 0, {{{0.2f, 0.3f, 0.5f, 1.0f}}}};
+        VkClearRect rect = {{{x0, y0}, {(uint32_t)(x1 - x0), (uint32_t)(y1 - y0)}}, 0, 1};
+        vkCmdClearAttachments(cmd, 1, &clear, 1, &rect);
+    }
+    bind(cmd, g_vk.comp_window, slot, vs->pixel.set, index);
+    vkCmdDraw(cmd, 3, 1, 0, 0);
+    vkEndCommandBuffer(cmd);
+    vs->window_key[s] = vs->gen;
+}
+
+// Builds the mesh target's mip chain from mip 0 and leaves every level ready for sampling
+static void build_mips(VkCommandBuffer cmd, const Target* t) {
+    if (t->mips > 1)
+        image_barrier(cmd, t->image, 1, (uint32_t)t->mips - 1, VK_IMAGE_LAYOUT_UNDEFINED,
+                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                      0, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+    int w = t->w, h = t->h;
+    for (int i = 1; i < t->mips; i++) {
+        int nw = SDL_max(w / 2, 1), nh = SDL_max(h / 2, 1);
+        VkImageBlit blit = {0};
+        blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+        blit.srcSubresource.mipLevel = (uint32_t)i - 1;
+        blit.srcSubresource.layerCount = 1;
+        blit.srcOffsets[1] = (VkOffset3D){w, h, 1};
+        blit.dstSubresource = blit.srcSubresource;
+        blit.dstSubresource.mipLevel = (uint32_t)i;
+        blit.dstOffsets[1] = (VkOffset3D){nw, nh, 1};
+        vkCmdBlitImage(cmd, t->image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, t->image,
+                       VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, VK_FILTER_LINEAR);
+        image_barrier(cmd, t->image, (uint32_t)i, 1, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                      VK_ACCESS_TRANSFER_READ_BIT);
+        w = nw;
+        h = nh;
+    }
+    image_barrier(cmd, t->image, 0, (uint32_t)t->mips, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                  VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                  VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                  VK_ACCESS_SHADER_READ_BIT);
+}
+
+static void begin_pass(VkCommandBuffer cmd,
+                       VkRenderPass pass,
+                       VkFramebuffer framebuffer,
+                       int w,
+                       int h,
+                       const float clear[4],
+                       VkSubpassContents contents) {
+    VkClearValue value;
+    memcpy(value.color.float32, clear, sizeof(value.color.float32));
+    VkRenderPassBeginInfo begin = {VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO};
+    begin.renderPass = pass;
+    begin.framebuffer = framebuffer;
+    begin.renderArea.extent.width = (uint32_t)w;
+    begin.renderArea.extent.height = (uint32_t)h;
+    begin.clearValueCount = 1;
+    begin.pClearValues = &value;
+    vkCmdBeginRenderPass(cmd, &begin, contents);
+}
+
+// Lightmap at 1/LIGHTING_DOWNSCALE, cleared to the ambient and lit additively (inline)
+static void record_lightmap(VkCommandBuffer cmd,
+                            Slot* slot,
+                            const ViewState* vs,
+                            const PipelineVkView* view,
+                            uint32_t index) {
+    const float ambient[4] = {view->ambient[0], view->ambient[1], view->ambient[2], 1.0f};
+    size_t bytes = view->light_count * sizeof(LightingVertex);
+    if (bytes && slot->lights_used + bytes > slot->lights.size) {
+        slot->lights_used = 0;  // a new buffer; draws already recorded keep the old one
+        if (!mapped_reserve(&slot->lights, slot->lights.size + bytes,
+                            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT))
+            bytes = 0;
+    }
+    begin_pass(cmd, g_vk.rp_pixel, vs->light.framebuffer, vs->light.w, vs->light.h, ambient,
+               VK_SUBPASS_CONTENTS_INLINE);
+    if (bytes) {
+        memcpy((char*)slot->lights.ptr + slot->lights_used, view->lights, bytes);
+        VkDeviceSize offset = slot->lights_used;
+        set_viewport(cmd, 0, 0, vs->light.w, vs->light.h, false);
+        bind(cmd, g_vk.light, slot, VK_NULL_HANDLE, index);
+        vkCmdBindVertexBuffers(cmd, 0, 1, &slot->lights.buffer, &offset);
+        vkCmdDraw(cmd, (uint32_t)view->light_count, 1, 0, 0);
+        slot->lights_used += bytes;
+    }
+    vkCmdEndRenderPass(cmd);
+}
+
+// Per-frame window draws of one view: lightmap multiply, instances, then sprites
+static unsigned int record_dynamic(VkCommandBuffer cmd,
+                                   const Slot* slot,
+                                   const ViewState* vs,
+                                   const PipelineVkView* view,
+                                   uint32_t index) {
+    unsigned int draws = 0;
+    VkDeviceSize offset = 0;
+    begin_secondary(cmd, g_vk.rp_window, VK_NULL_HANDLE,
+                    VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
+    set_viewport(cmd, vs->x, vs->y_top, vs->w, vs->h, true);
+    if (view->lit) {
+        bind(cmd, g_vk.apply, slot, vs->light.set, index);
+        vkCmdDraw(cmd, 3, 1, 0, 0);
+    }
+    if (view->instance_count > 0) {
+        bind(cmd, g_vk.instanced, slot, VK_NULL_HANDLE, index);
+        vkCmdBindVertexBuffers(cmd, 0, 1, &slot->instances.buffer, &offset);
+        for (int i = 0; i < view->instance_count; i++) {
+            const PipelineVkDraw* d = &view->instances[i];
+            Texture* tex = texture_get(d->texture);
+            if (!tex)
+                continue;
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vk.layout, 1, 1,
+                                    &tex->set, 0, NULL);
+            vkCmdDraw(cmd, 6, d->count, 0, d->first);
+            draws++;
+        }
+    }
+    if (view->sprite_count > 0) {
+        bind(cmd, g_vk.sprite, slot, VK_NULL_HANDLE, index);
+        vkCmdBindVertexBuffers(cmd, 0, 1, &slot->sprites.buffer, &offset);
+        unsigned int bound = 0;
+        for (int i = 0; i < view->sprite_count; i++) {
+            const PipelineVkDraw* d = &view->sprites[i];
+            if (d->texture != bound) {
+                Texture* tex = texture_get(d->texture);
+                if (!tex)
+                    continue;
+                vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g_vk.layout, 1, 1,
+                                        &tex->set, 0, NULL);
+                bound = d->texture;
+            }
+            vkCmdDraw(cmd, d->count, 1, d->first, 0);
+            draws++;
+        }
+    }
+    vkEndCommandBuffer(cmd);
+    return draws;
+}
+
+void pipeline_vk_draw_view(int index, const PipelineVkView* view, PipelineStats* stats) {
+    if (!g_vk.recording || index < 0 || index >= PIPELINE_MAX_VIEWS)
+        return;
+    int s = (int)(g_vk.frame % PIPELINE_FRAMES_IN_FLIGHT);
+    Slot* slot = &g_vk.slots[s];
+    ViewState* vs = &g_vk.views[index];
+    uint32_t vi = (uint32_t)index;
+    sync_mesh(slot);
+    if (!view_update(vs, view))
+        return;
+
+    const PipelineVkFrame* f = &g_vk.frame_params;
+    ViewUniforms* u = &((FrameUniforms*)slot->ubo.ptr)->views[index];
+    *u = (ViewUniforms){
+        {view->cam[0], view->cam[1], view->cam[2], view->cam[3]},
+        {view->cam[0], view->cam[1], view->cam[2] * PIPELINE_SUPERSAMPLE, view->cam[3]},
+        {(float)vs->w, (float)vs->h, (float)vs->mesh.w, (float)vs->mesh.h},
+        {(float)vs->pixel.w, (float)vs->pixel.h, f->time, f->snow_density},
+        {f->wind[0], f->wind[1], 0.0f, 0.0f},
+    };
+
+    if (vs->mesh_key[s][0] != vs->gen || vs->mesh_key[s][1] != slot->mesh_gen)
+        record_mesh_pass(vs, slot, s, vi);
+    if (vs->pixel_key[s] != vs->gen)
+        record_pixel_pass(vs, slot, s, vi);
+    if (vs->window_key[s] != vs->gen)
+        record_window_pass(vs, slot, s, vi);
+
+    static const float kTransparent[4] = {0.0f, 0.0f, 0.0f, 0.0f};
+    VkCommandBuffer cmd = slot->cmd;
+    begin_pass(cmd, g_vk.rp_mesh, vs->mesh.framebuffer, vs->mesh.w, vs->mesh.h, kTransparent,
+               VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    vkCmdExecuteCommands(cmd, 1, &vs->mesh_sec[s]);
+    vkCmdEndRenderPass(cmd);
+    build_mips(cmd, &vs->mesh);
+    begin_pass(cmd, g_vk.rp_pixel, vs->pixel.framebuffer, vs->pixel.w, vs->pixel.h, kTransparent,
+               VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    vkCmdExecuteCommands(cmd, 1, &vs->pixel_sec[s]);
+    vkCmdEndRenderPass(cmd);
+    if (view->lit)
+        record_lightmap(cmd, slot, vs, view, vi);
+
+    stats->draw_calls += record_dynamic(slot->dynamic[index], slot, vs, view, vi);
+    if (g_vk.mesh_count > 0 && texture_get(g_vk.mesh_tex)) {
+        stats->draw_calls++;
+        stats->mesh_vertices = (unsigned int)g_vk.mesh_count;
+    }
+    vs->drawn = true;
+}
+
+void pipeline_vk_frame_end(PipelineStats* stats) {
+    (void)stats;
+    if (!g_vk.recording)
+        return;
+    int s = (int)(g_vk.frame % PIPELINE_FRAMES_IN_FLIGHT);
+    Slot* slot = &g_vk.slots[s];
+    VkCommandBuffer cmd = slot->cmd;
+
+    // One window pass: each drawn view's composite, then its per-frame draws
+    VkCommandBuffer secondaries[PIPELINE_MAX_VIEWS * 2];
+    uint32_t count = 0;
+    for (int v = 0; v < PIPELINE_MAX_VIEWS; v++) {
+        if (!g_vk.views[v].drawn)
+            continue;
+        secondaries[count++] = g_vk.views[v].window_sec[s];
+        secondaries[count++] = slot->dynamic[v];
+    }
+    VkFramebuffer fb = g_vk.surface ? g_vk.framebuffers[g_vk.image] : g_vk.offscreen.framebuffer;
+    begin_pass(cmd, g_vk.rp_window, fb, (int)g_vk.extent.width, (int)g_vk.extent.height,
+               g_vk.frame_params.clear, VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS);
+    if (count)
+        vkCmdExecuteCommands(cmd, count, secondaries);
+    vkCmdEndRenderPass(cmd);
+    vkEndCommandBuffer(cmd);
+
+    VkPipelineStageFlags wait_stage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    VkSubmitInfo submit = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers = &cmd;
+    if (g_vk.surface) {
+        submit.waitSemaphoreCount = 1;
+        submit.pWaitSemaphores = &slot->acquired;
+        submit.pWaitDstStageMask = &wait_stage;
+        submit.signalSemaphoreCount = 1;
+        submit.pSignalSemaphores = &g_vk.rendered[g_vk.image];
+    }
+    vkResetFences(g_vk.device, 1, &slot->fence);
+    vk_check(vkQueueSubmit(g_vk.queue, 1, &submit, slot->fence), "vkQueueSubmit");
+    g_vk.present_pending = g_vk.surface != VK_NULL_HANDLE;
+    g_vk.offscreen_valid = !g_vk.surface;
+    g_vk.recording = false;
+    g_vk.frame++;
+}
+
+void pipeline_vk_present(void) {
+    if (!g_vk.present_pending)
+        return;
+    g_vk.present_pending = false;
+    VkPresentInfoKHR info = {VK_STRUCTURE_TYPE_PRESENT_INFO_KHR};
+    info.waitSemaphoreCount = 1;
+    info.pWaitSemaphores = &g_vk.rendered[g_vk.image];
+    info.swapchainCount = 1;
+    info.pSwapchains = &g_vk.swapchain;
+    info.pImageIndices = &g_vk.image;
+    VkResult r = vkQueuePresentKHR(g_vk.queue, &info);
+    if (r == VK_ERROR_OUT_OF_DATE_KHR || r == VK_SUBOPTIMAL_KHR)
+        g_vk.swap_w = 0;  // recreated by the next frame
+}
+
+void pipeline_vk_wait_idle(void) {
+    if (g_vk.device)
+        vkDeviceWaitIdle(g_vk.device);
+}
+
+bool pipeline_vk_read_pixel(int x, int y, unsigned char rgba[4]) {
+    if (!g_vk.device || !g_vk.offscreen_valid || x < 0 || y < 0 || x >= g_vk.offscreen.w ||
+        y >= g_vk.offscreen.h)
+        return false;
+    vkDeviceWaitIdle(g_vk.device);
+    MappedBuffer out;
+    if (!mapped_create(&out, 4, VK_BUFFER_USAGE_TRANSFER_DST_BIT))
+        return false;
+    Slot* slot = current_slot();  // idle: its pool is reset again before the next frame
+    vkResetCommandPool(g_vk.device, slot->pool, 0);
+    VkCommandBufferBeginInfo begin = {VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO};
+    begin.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(slot->cmd, &begin);
+    VkBufferImageCopy copy = {0};
+    copy.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    copy.imageSubresource.layerCount = 1;
+    copy.imageOffset.x = x;
+    copy.imageOffset.y = g_vk.offscreen.h - 1 - y;  // rows run top-down
+    copy.imageExtent = (VkExtent3D){1, 1, 1};
+    vkCmdCopyImageToBuffer(slot->cmd, g_vk.offscreen.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                           out.buffer, 1, &copy);
+    vkEndCommandBuffer(slot->cmd);
+    VkSubmitInfo submit = {VK_STRUCTURE_TYPE_SUBMIT_INFO};
+    submit.commandBufferCount = 1;
+    submit.pCommandBuffers = &slot->cmd;
+    bool ok = vk_check(vkQueueSubmit(g_vk.queue, 1, &submit, VK_NULL_HANDLE), "vkQueueSubmit");
+    vkDeviceWaitIdle(g_vk.device);
+    if (ok)
+        memcpy(rgba, out.ptr, 4);
+    Retired r = {0, VK_NULL_HANDLE, VK_NULL_HANDLE, out.memory, out.buffer, VK_NULL_HANDLE};
+    release(&r);
+    return ok;
+}
+
+static void mapped_destroy(MappedBuffer* b) {
+    Retired r = {0, VK_NULL_HANDLE, VK_NULL_HANDLE, b->memory, b->buffer, VK_NULL_HANDLE};
+    release(&r);
+    memset(b, 0, sizeof(*b));
+}
+
+void pipeline_vk_shutdown(void) {
+    if (g_vk.device) {
+        vkDeviceWaitIdle(g_vk.device);
+        release_retired(true);
+        for (int i = 0; i < g_vk.texture_count; i++) {
+            Texture* t = &g_vk.textures[i];
+            if (!t->used)
+                continue;
+            mapped_destroy(&t->staging);
+            Retired r = {0, t->image, t->view, t->memory, VK_NULL_HANDLE, VK_NULL_HANDLE};
+            release(&r);
+        }
+        for (int v = 0; v < PIPELINE_MAX_VIEWS; v++) {
+            target_destroy(&g_vk.views[v].mesh);
+            target_destroy(&g_vk.views[v].pixel);
+            target_destroy(&g_vk.views[v].light);
+        }
+        target_destroy(&g_vk.offscreen);
+        for (int s = 0; s < PIPELINE_FRAMES_IN_FLIGHT; s++) {
+            Slot* slot = &g_vk.slots[s];
+            mapped_destroy(&slot->ubo);
+            mapped_destroy(&slot->sprites);
+            mapped_destroy(&slot->instances);
+            mapped_destroy(&slot->lights);
+            mapped_destroy(&slot->mesh);
+            if (slot->pool)
+                vkDestroyCommandPool(g_vk.device, slot->pool, NULL);
+            if (slot->acquired)
+                vkDestroySemaphore(g_vk.device, slot->acquired, NULL);
+            if (slot->fence)
+                vkDestroyFence(g_vk.device, slot->fence, NULL);
+        }
+        swapchain_destroy_images();
+        if (g_vk.swapchain)
+            vkDestroySwapchainKHR(g_vk.device, g_vk.swapchain, NULL);
+        if (g_vk.static_pool)
+            vkDestroyCommandPool(g_vk.device, g_vk.static_pool, NULL);
+        VkPipeline pipelines[] = {g_vk.sprite,      g_vk.instanced, g_vk.mesh,
+                                  g_vk.comp_pixel,  g_vk.snow,     g_vk.comp_window,
+                                  g_vk.light,       g_vk.apply};
+        for (size_t i = 0; i < SDL_arraysize(pipelines); i++) {
+            if (pipelines[i])
+                vkDestroyPipeline(g_vk.device, pipelines[i], NULL);
+        }
+        VkRenderPass passes[] = {g_vk.rp_mesh, g_vk.rp_pixel, g_vk.rp_window};
+        for (size_t i = 0; i < SDL_arraysize(passes); i++) {
+            if (passes[i])
+                vkDestroyRenderPass(g_vk.device, passes[i], NULL);
+        }
+        VkSampler samplers[] = {g_vk.nearest, g_vk.linear, g_vk.mipmapped};
+        for (size_t i = 0; i < SDL_arraysize(samplers); i++) {
+            if (samplers[i])
+                vkDestroySampler(g_vk.device, samplers[i], NULL);
+        }
+        if (g_vk.descriptor_pool)
+            vkDestroyDescriptorPool(g_vk.device, g_vk.descriptor_pool, NULL);
+        if (g_vk.layout)
+            vkDestroyPipelineLayout(g_vk.device, g_vk.layout, NULL);
+        if (g_vk.frame_layout)
+            vkDestroyDescriptorSetLayout(g_vk.device, g_vk.frame_layout, NULL);
+        if (g_vk.texture_layout)
+            vkDestroyDescriptorSetLayout(g_vk.device, g_vk.texture_layout, NULL);
+        vkDestroyDevice(g_vk.device, NULL);
+    }
+    if (g_vk.surface)
+        SDL_Vulkan_DestroySurface(g_vk.instance, g_vk.surface, NULL);
+    if (g_vk.instance)
+        vkDestroyInstance(g_vk.instance, NULL);
+    if (g_vk.library)
+        SDL_Vulkan_UnloadLibrary();
+    free(g_vk.textures);
+    free(g_vk.pending);
+    free(g_vk.retired);
+    free(g_vk.mesh_verts);
+    memset(&g_vk, 0, sizeof(g_vk));
+}
+
+#else  // !PIPELINE_VULKAN
+
+// Built without the Vulkan headers or glslc: the backend is never available
+bool pipeline_vk_init(SDL_Window* window) {
+    (void)window;
+    SDL_Log("pipeline_vk: not built with Vulkan support");
+    return false;
+}
+
+void pipeline_vk_shutdown(void) {}
+
+unsigned int pipeline_vk_texture_create(int w, int h, const void* rgba, bool linear) {
+    (void)w;
+    (void)h;
+    (void)rgba;
+    (void)linear;
+    return 0;
+}
+
+void pipeline_vk_texture_destroy(unsigned int texture) {
+    (void)texture;
+}
+
+bool pipeline_vk_frame_begin(int window_w,
+                             int window_h,
+                             const PipelineVkFrame* frame,
+                             PipelineStats* stats) {
+    (void)window_w;
+    (void)window_h;
+    (void)frame;
+    (void)stats;
+    return false;
+}
+
+PipelineVertex* pipeline_vk_sprite_reserve(size_t count) {
+    (void)count;
+    return NULL;
+}
+
+PipelineInstance* pipeline_vk_instance_reserve(size_t count) {
+    (void)count;
+    return NULL;
+}
+
+void pipeline_vk_mesh_upload(const PipelineVertex* verts, size_t count, unsigned int texture) {
+    (void)verts;
+    (void)count;
+    (void)texture;
+}
+
+void pipeline_vk_draw_view(int index, const PipelineVkView* view, PipelineStats* stats) {
+    (void)index;
+    (void)view;
+    (void)stats;
+}
+
+void pipeline_vk_frame_end(PipelineStats* stats) {
+    (void)stats;
+}
+
+void pipeline_vk_present(void) {}
+
+void pipeline_vk_wait_idle(void) {}
+
+bool pipeline_vk_read_pixel(int x, int y, unsigned char rgba[4]) {
+    (void)x;
+    (void)y;
+    (void)rgba;
+    return false;
+}
+
+#endif  // PIPELINE_VULKAN
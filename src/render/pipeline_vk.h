@@ -0,0 +1,86 @@
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include "lighting.h"
+#include "pipeline.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Vulkan backend of the render pipeline, driven by pipeline.c: batching, culling and the mesh
+// sort stay there, this side owns the GPU objects. Built when CMake finds the Vulkan headers and
+// glslc (PIPELINE_VULKAN); without them pipeline_vk_init fails and the game stays on GL.
+//
+// Per frame slot (PIPELINE_FRAMES_IN_FLIGHT): a fence, a primary command buffer, one
+// persistent-mapped buffer each for uniforms, sprite vertices, instances, lightmap triangles and
+// the mesh pass, and a descriptor set for the uniforms. Textures get one descriptor set each when
+// they are created. The static passes (mesh, composite + snow, composite to the window) are
+// secondary command buffers recorded once per view and slot and replayed until the view size or
+// the cached mesh changes; only the sprite, instance and lighting draws are recorded every frame.
+
+// Frames the GPU may still be reading while the CPU writes the next one (GL ring, Vulkan slots)
+#define PIPELINE_FRAMES_IN_FLIGHT 3
+#define PIPELINE_SUPERSAMPLE 2  // mesh pass resolution multiplier
+#define PIPELINE_PIXEL_SCALE 4  // composite target is 1/N of the view (pixelated look)
+
+// Vertex layout shared by both backends
+typedef struct {
+    float x, y, u, v, r, g, b, a, par;
+} PipelineVertex;
+
+// A range of this frame's sprite vertices (or instances) drawn with one texture
+typedef struct {
+    unsigned int texture;
+    unsigned int first, count;
+} PipelineVkDraw;
+
+typedef struct {
+    float cam[4];    // x, y, zoom, rotation
+    int x, y, w, h;  // window rect, origin bottom-left
+    const PipelineVkDraw* sprites;
+    int sprite_count;
+    const PipelineVkDraw* instances;
+    int instance_count;
+    // Lightmap triangles and ambient (lit false: no lighting pass)
+    bool lit;
+    const LightingVertex* lights;
+    size_t light_count;
+    float ambient[3];
+} PipelineVkView;
+
+typedef struct {
+    float clear[4];  // window clear color
+    float time;      // seconds, snow animation
+    float wind[2];
+    float snow_density;
+} PipelineVkFrame;
+
+bool pipeline_vk_init(SDL_Window* window);
+void pipeline_vk_shutdown(void);
+
+unsigned int pipeline_vk_texture_create(int w, int h, const void* rgba, bool linear);
+void pipeline_vk_texture_destroy(unsigned int texture);
+
+// Waits for the slot this frame reuses and acquires the window image; false skips the frame
+// (minimized window, lost swapchain)
+bool pipeline_vk_frame_begin(int window_w,
+                             int window_h,
+                             const PipelineVkFrame* frame,
+                             PipelineStats* stats);
+// Writable ranges in this frame's slot, valid until pipeline_vk_frame_end; first element is 0
+PipelineVertex* pipeline_vk_sprite_reserve(size_t count);
+PipelineInstance* pipeline_vk_instance_reserve(size_t count);
+// New sorted mesh pass triangles (count 0: no meshes); each slot copies them in when it is next
+// used, and the mesh pass secondaries are re-recorded then
+void pipeline_vk_mesh_upload(const PipelineVertex* verts, size_t count, unsigned int texture);
+// Records the offscreen passes of view `index` and its window-pass draws
+void pipeline_vk_draw_view(int index, const PipelineVkView* view, PipelineStats* stats);
+// Draws every recorded view into the window image and submits the frame
+void pipeline_vk_frame_end(PipelineStats* stats);
+void pipeline_vk_present(void);
+void pipeline_vk_wait_idle(void);
+bool pipeline_vk_read_pixel(int x, int y, unsigned char rgba[4]);
+
+#ifdef __cplusplus
+}
+#endif
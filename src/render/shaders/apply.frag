@@ -0,0 +1,9 @@
+// Lightmap, multiplied over the composited scene by the blend state
+#version 450
+layout(location = 0) in vec2 v_uv;
+layout(location = 0) out vec4 frag;
+layout(set = 1, binding = 0) uniform sampler2D u_tex;
+
+void main() {
+    frag = vec4(texture(u_tex, v_uv).rgb, 1.0);
+}
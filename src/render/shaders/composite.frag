@@ -0,0 +1,9 @@
+// Copies a pass target (mesh target into the pixel target, pixel target into the window)
+#version 450
+layout(location = 0) in vec2 v_uv;
+layout(location = 0) out vec4 frag;
+layout(set = 1, binding = 0) uniform sampler2D u_tex;
+
+void main() {
+    frag = texture(u_tex, v_uv);
+}
@@ -0,0 +1,9 @@
+// Fullscreen triangle for the composite, snow and lightmap passes
+#version 450
+layout(location = 0) out vec2 v_uv;
+
+void main() {
+    vec2 uv = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    v_uv = uv;
+    gl_Position = vec4(uv * 2.0 - 1.0, 0.0, 1.0);
+}
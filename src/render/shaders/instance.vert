@@ -0,0 +1,31 @@
+// Instanced sprites: one unit quad per instance, expanded from the vertex index
+#version 450
+layout(location = 0) in vec3 i_pos_size;
+layout(location = 1) in vec4 i_col;
+layout(location = 0) out vec4 v_col;
+layout(location = 1) out vec2 v_uv;
+struct View {
+    vec4 cam;       // x, y, zoom, rotation
+    vec4 mesh_cam;  // cam with the mesh pass supersampling in zoom
+    vec4 res;       // view w, h, mesh target w, h
+    vec4 snow;      // pixel target w, h, time, density
+    vec4 wind;      // wind x, y
+};
+layout(set = 0, binding = 0) uniform Frame {
+    View views[4];
+};
+layout(push_constant) uniform Push {
+    uint view;
+} pc;
+
+const vec2 kCorners[6] = vec2[6](vec2(-0.5, -0.5), vec2(0.5, -0.5), vec2(-0.5, 0.5),
+                                 vec2(0.5, -0.5), vec2(0.5, 0.5), vec2(-0.5, 0.5));
+
+void main() {
+    vec4 cam = views[pc.view].cam;
+    vec2 c = kCorners[gl_VertexIndex];
+    vec2 p = (i_pos_size.xy + c * i_pos_size.z - cam.xy) * cam.z;
+    gl_Position = vec4(p / views[pc.view].res.xy * 2.0 - 1.0, 0.0, 1.0);
+    v_col = i_col;
+    v_uv = vec2(c.x + 0.5, 0.5 - c.y);
+}
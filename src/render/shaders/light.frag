@@ -0,0 +1,12 @@
+// Lightmap triangles: quadratic falloff from the light center, added up by the blend state
+#version 450
+layout(location = 0) in vec2 v_world;
+layout(location = 1) in vec3 v_light;
+layout(location = 2) in vec3 v_col;
+layout(location = 0) out vec4 frag;
+
+void main() {
+    float d = clamp(length(v_world - v_light.xy) / v_light.z, 0.0, 1.0);
+    float att = (1.0 - d) * (1.0 - d);
+    frag = vec4(v_col * att, 1.0);
+}
@@ -0,0 +1,30 @@
+// Lightmap triangles: light polygons in world space, attenuated per pixel
+#version 450
+layout(location = 0) in vec2 a_pos;
+layout(location = 1) in vec3 a_light;  // center x, y and radius
+layout(location = 2) in vec3 a_col;
+layout(location = 0) out vec2 v_world;
+layout(location = 1) out vec3 v_light;
+layout(location = 2) out vec3 v_col;
+struct View {
+    vec4 cam;       // x, y, zoom, rotation
+    vec4 mesh_cam;  // cam with the mesh pass supersampling in zoom
+    vec4 res;       // view w, h, mesh target w, h
+    vec4 snow;      // pixel target w, h, time, density
+    vec4 wind;      // wind x, y
+};
+layout(set = 0, binding = 0) uniform Frame {
+    View views[4];
+};
+layout(push_constant) uniform Push {
+    uint view;
+} pc;
+
+void main() {
+    vec4 cam = views[pc.view].cam;
+    vec2 p = (a_pos - cam.xy) * cam.z;
+    gl_Position = vec4(p / views[pc.view].res.xy * 2.0 - 1.0, 0.0, 1.0);
+    v_world = a_pos;
+    v_light = a_light;
+    v_col = a_col;
+}
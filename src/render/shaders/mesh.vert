@@ -0,0 +1,29 @@
+// Mesh pass: sprite mapping at the supersampled target resolution
+#version 450
+layout(location = 0) in vec2 a_pos;
+layout(location = 1) in vec2 a_uv;
+layout(location = 2) in vec4 a_col;
+layout(location = 3) in float a_par;
+layout(location = 0) out vec4 v_col;
+layout(location = 1) out vec2 v_uv;
+struct View {
+    vec4 cam;       // x, y, zoom, rotation
+    vec4 mesh_cam;  // cam with the mesh pass supersampling in zoom
+    vec4 res;       // view w, h, mesh target w, h
+    vec4 snow;      // pixel target w, h, time, density
+    vec4 wind;      // wind x, y
+};
+layout(set = 0, binding = 0) uniform Frame {
+    View views[4];
+};
+layout(push_constant) uniform Push {
+    uint view;
+} pc;
+
+void main() {
+    vec4 cam = views[pc.view].mesh_cam;
+    vec2 p = (a_pos - cam.xy * a_par) * cam.z;
+    gl_Position = vec4(p / views[pc.view].res.zw * 2.0 - 1.0, 0.0, 1.0);
+    v_col = a_col;
+    v_uv = vec2(a_uv.x, 1.0 - a_uv.y);
+}
@@ -0,0 +1,156 @@
+// Pixelated snow over the pixel target (port of the GL snow shader), camera and wind influenced
+#version 450
+layout(location = 0) in vec2 v_uv;
+layout(location = 0) out vec4 frag;
+struct View {
+    vec4 cam;       // x, y, zoom, rotation
+    vec4 mesh_cam;  // cam with the mesh pass supersampling in zoom
+    vec4 res;       // view w, h, mesh target w, h
+    vec4 snow;      // pixel target w, h, time, density
+    vec4 wind;      // wind x, y
+};
+layout(set = 0, binding = 0) uniform Frame {
+    View views[4];
+};
+layout(push_constant) uniform Push {
+    uint view;
+} pc;
+
+float hash12(vec2 p) {
+    vec3 p3 = fract(vec3(p.xyx) * 0.1031);
+    p3 += dot(p3, p3.yzx + 33.33);
+    return fract((p3.x + p3.y) * p3.z);
+}
+
+vec2 hash22(vec2 p) {
+    vec3 p3 = fract(vec3(p.xyx) * vec3(0.1031, 0.1030, 0.0973));
+    p3 += dot(p3, p3.yzx + 33.33);
+    return fract((p3.xx + p3.yz) * p3.zy);
+}
+
+// Proper hexagonal snowflake with 6-fold symmetry
+float flake_shape(vec2 q, float t, vec2 rnd) {
+    // Apply 6-fold symmetry for hexagonal structure
+    float angle = atan(q.y, q.x);
+    float r = length(q);
+    // Fold into 60-degree wedge
+    angle = abs(mod(angle + 3.14159, 1.0471975512) - 0.523598776);  // PI/6 wedge
+    q = vec2(cos(angle), sin(angle)) * r;
+
+    float d = 100.0;
+
+    // Main hexagonal arm (straight out from center)
+    float arm_width = 0.03 + rnd.x * 0.02;
+    float arm_length = 0.6 + rnd.y * 0.15;
+    // Taper the arm
+    float taper = 1.0 - smoothstep(0.0, arm_length, q.x) * 0.5;
+    d = min(d, max(abs(q.y) - arm_width * taper, q.x - arm_length));
+
+    // Hexagonal branches at 60-degree angles
+    // Branch 1 - closer to center
+    vec2 b1_pos = vec2(0.2, 0.0);
+    vec2 q1 = q - b1_pos;
+    // Rotate by 60 degrees for hexagonal pattern
+    q1 = vec2(q1.x * 0.5 - q1.y * 0.866, q1.x * 0.866 + q1.y * 0.5);
+    float b1_len = 0.15 + rnd.x * 0.05;
+    d = min(d, max(abs(q1.y) - 0.02, q1.x - b1_len));
+    // Opposite branch
+    q1 = q - b1_pos;
+    q1 = vec2(q1.x * 0.5 + q1.y * 0.866, -q1.x * 0.866 + q1.y * 0.5);
+    d = min(d, max(abs(q1.y) - 0.02, q1.x - b1_len));
+
+    // Branch 2 - middle
+    vec2 b2_pos = vec2(0.35, 0.0);
+    vec2 q2 = q - b2_pos;
+    q2 = vec2(q2.x * 0.5 - q2.y * 0.866, q2.x * 0.866 + q2.y * 0.5);
+    float b2_len = 0.12 + rnd.y * 0.04;
+    d = min(d, max(abs(q2.y) - 0.018, q2.x - b2_len));
+    q2 = q - b2_pos;
+    q2 = vec2(q2.x * 0.5 + q2.y * 0.866, -q2.x * 0.866 + q2.y * 0.5);
+    d = min(d, max(abs(q2.y) - 0.018, q2.x - b2_len));
+
+    // Branch 3 - outer
+    vec2 b3_pos = vec2(0.5, 0.0);
+    vec2 q3 = q - b3_pos;
+    q3 = vec2(q3.x * 0.5 - q3.y * 0.866, q3.x * 0.866 + q3.y * 0.5);
+    float b3_len = 0.08 + rnd.x * 0.03;
+    d = min(d, max(abs(q3.y) - 0.015, q3.x - b3_len));
+    q3 = q - b3_pos;
+    q3 = vec2(q3.x * 0.5 + q3.y * 0.866, -q3.x * 0.866 + q3.y * 0.5);
+    d = min(d, max(abs(q3.y) - 0.015, q3.x - b3_len));
+
+    // Hexagonal center
+    float hex_size = 0.08 + rnd.y * 0.02;
+    vec2 qh = abs(q);
+    float hex = max(qh.x * 0.866 + qh.y * 0.5, qh.y) - hex_size;
+    d = min(d, hex);
+
+    // Small decorative tips
+    d = min(d, length(q - vec2(arm_length - 0.03, 0.0)) - 0.03);
+
+    // Add fine details - smaller branches
+    vec2 b4_pos = vec2(0.15, 0.0);
+    vec2 q4 = q - b4_pos;
+    q4 = vec2(q4.x * 0.5 - q4.y * 0.866, q4.x * 0.866 + q4.y * 0.5);
+    d = min(d, max(abs(q4.y) - 0.01, max(q4.x - 0.06, -q4.x - 0.01)));
+
+    return 1.0 - smoothstep(0.0, 0.02, d);
+}
+
+vec2 rot2(vec2 v, float a) {
+    float s = sin(a), c = cos(a);
+    return mat2(c, -s, s, c) * v;
+}
+
+void main() {
+    View v = views[pc.view];
+    vec2 u_viewport = v.snow.xy;
+    float u_time = v.snow.z;
+    vec2 u_cam = v.cam.xy;
+    vec2 u_wind = v.wind.xy;
+    float u_density = v.snow.w;
+    vec2 p = v_uv * u_viewport;
+
+    vec2 cam_off = u_cam * 0.5;
+    vec2 wind_off = u_wind * u_time;
+
+    // Layer 1 - foreground
+    vec2 w = p + cam_off + wind_off;
+    float cellsize = 80.0;
+    vec2 cell = floor(w / cellsize);
+    vec2 celluv = fract(w / cellsize);
+
+    vec2 rnd = hash22(cell + vec2(13.0, 7.0));
+    float spawn = step(rnd.x, u_density);
+
+    vec2 center = vec2(0.5) + (hash22(cell + vec2(23.0, 11.0)) - 0.5) * 0.3;
+    vec2 local = (celluv - center) * 3.0;
+
+    // Z-axis rotation
+    float rot_speed = 0.3 + rnd.y * 0.4;
+    float rotation = u_time * rot_speed + rnd.x * 6.28;
+    vec2 q = rot2(local, rotation);
+
+    // Animated flake with 3D tilt
+    float anim_offset = hash12(cell + vec2(41.0, 37.0)) * 6.28;
+    float shape = flake_shape(q, u_time + anim_offset, rnd) * spawn;
+
+    // Layer 2 - background
+    vec2 w2 = p + cam_off * 0.3 + wind_off * 0.6;
+    float cellsize2 = 120.0;
+    vec2 cell2 = floor(w2 / cellsize2);
+    vec2 celluv2 = fract(w2 / cellsize2);
+    vec2 rnd2 = hash22(cell2 + vec2(53.0, 29.0));
+    float spawn2 = step(rnd2.x, u_density * 0.7);
+    vec2 center2 = vec2(0.5) + (hash22(cell2 + vec2(43.0, 19.0)) - 0.5) * 0.3;
+    vec2 local2 = (celluv2 - center2) * 4.0;
+    float rot_speed2 = 0.2 + rnd2.y * 0.3;
+    float rotation2 = u_time * rot_speed2 + rnd2.x * 6.28;
+    vec2 q2 = rot2(local2, rotation2);
+    float anim_offset2 = hash12(cell2 + vec2(61.0, 67.0)) * 6.28;
+    float shape2 = flake_shape(q2 * 1.3, u_time * 0.7 + anim_offset2, rnd2) * spawn2 * 0.5;
+
+    float alpha = clamp(shape + shape2, 0.0, 1.0);
+    vec3 col = vec3(0.98, 0.99, 1.0);
+    frag = vec4(col, alpha * 0.9);
+}
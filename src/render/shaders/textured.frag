@@ -0,0 +1,10 @@
+// Sprites, instances and meshes: texture times vertex color
+#version 450
+layout(location = 0) in vec4 v_col;
+layout(location = 1) in vec2 v_uv;
+layout(location = 0) out vec4 frag;
+layout(set = 1, binding = 0) uniform sampler2D u_tex;
+
+void main() {
+    frag = texture(u_tex, v_uv) * v_col;
+}
@@ -0,0 +1,281 @@
+#include "replay.h"
+#include <SDL3/SDL.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "abilities.h"
+#include "input.h"
+
+#define REPLAY_MAGIC "GRPL"
+#define REPLAY_VERSION 1u
+#define REPLAY_TICK_INPUT (1 << 0)  // frame and abilities follow
+
+#define INPUT_EDGES (INPUT_BTN_JUMP_EDGE | INPUT_BTN_SWITCH_EDGE | INPUT_BTN_RESTART_EDGE)
+
+#define ABILITY_JUMP (1 << 0)
+#define ABILITY_BOOST (1 << 1)
+#define ABILITY_FLY (1 << 2)
+
+static struct {
+    ReplayMode mode;
+    float dt;
+
+    // Recording: bytes not yet written to io
+    SDL_IOStream* io;
+    uint8_t* buf;
+    size_t len, cap;
+    bool have_last;
+    InputFrame last;
+    uint8_t last_abilities;
+
+    // Replay: the whole file, read front to back
+    uint8_t* data;
+    size_t size, pos;
+    InputFrame frame;
+    uint32_t expected;
+    bool have_expected;
+
+    uint64_t frames;
+    uint64_t bytes;
+    atomic_ullong ticks;
+    atomic_ullong mismatches;
+    atomic_ullong first_mismatch;
+    atomic_bool finished;
+} g_replay;
+
+static uint32_t fold(uint64_t h) {
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+static uint8_t abilities_bits(void) {
+    return (uint8_t)((ability_get_car_jump() ? ABILITY_JUMP : 0) |
+                     (ability_get_car_boost() ? ABILITY_BOOST : 0) |
+                     (ability_get_car_fly() ? ABILITY_FLY : 0));
+}
+
+static bool flush(void) {
+    if (!g_replay.io || g_replay.len == 0)
+        return true;
+    bool ok = SDL_WriteIO(g_replay.io, g_replay.buf, g_replay.len) == g_replay.len;
+    if (!ok)
+        SDL_Log("replay: write failed: %s", SDL_GetError());
+    g_replay.len = 0;
+    return ok;
+}
+
+static void put(const void* p, size_t n) {
+    if (g_replay.len + n > g_replay.cap) {
+        size_t cap = g_replay.cap ? g_replay.cap * 2 : REPLAY_FLUSH_BYTES * 2;
+        while (cap < g_replay.len + n)
+            cap *= 2;
+        uint8_t* buf = (uint8_t*)SDL_realloc(g_replay.buf, cap);
+        if (!buf)
+            return;
+        g_replay.buf = buf;
+        g_replay.cap = cap;
+    }
+    memcpy(g_replay.buf + g_replay.len, p, n);
+    g_replay.len += n;
+    g_replay.bytes += n;
+}
+
+static void put_u32(uint32_t v) {
+    uint8_t b[4] = {(uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24)};
+    put(b, 4);
+}
+
+static bool get(void* p, size_t n) {
+    if (g_replay.pos + n > g_replay.size)
+        return false;
+    memcpy(p, g_replay.data + g_replay.pos, n);
+    g_replay.pos += n;
+    return true;
+}
+
+static bool get_u32(uint32_t* v) {
+    uint8_t b[4];
+    if (!get(b, 4))
+        return false;
+    *v = (uint32_t)b[0] | ((uint32_t)b[1] << 8) | ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+    return true;
+}
+
+static void reset(void) {
+    memset(&g_replay, 0, sizeof(g_replay));
+    g_replay.mode = REPLAY_OFF;
+}
+
+bool replay_start_recording(const char* path, float dt) {
+    if (!path || g_replay.mode != REPLAY_OFF)
+        return false;
+    reset();
+    g_replay.io = SDL_IOFromFile(path, "wb");
+    if (!g_replay.io) {
+        SDL_Log("replay: cannot record to %s: %s", path, SDL_GetError());
+        return false;
+    }
+    g_replay.dt = dt;
+    uint32_t dt_bits;
+    memcpy(&dt_bits, &dt, sizeof(dt_bits));
+    put(REPLAY_MAGIC, 4);
+    put_u32(REPLAY_VERSION);
+    put_u32(dt_bits);
+    g_replay.mode = REPLAY_RECORD;
+    SDL_Log("replay: recording to %s", path);
+    return true;
+}
+
+bool replay_start_playback(const char* path, float dt) {
+    if (!path || g_replay.mode != REPLAY_OFF)
+        return false;
+    reset();
+    size_t size = 0;
+    g_replay.data = (uint8_t*)SDL_LoadFile(path, &size);
+    if (!g_replay.data) {
+        SDL_Log("replay: cannot read %s: %s", path, SDL_GetError());
+        return false;
+    }
+    g_replay.size = size;
+    g_replay.bytes = size;
+    char magic[4];
+    uint32_t version = 0, dt_bits = 0;
+    float file_dt = 0.0f;
+    bool ok = get(magic, 4) && memcmp(magic, REPLAY_MAGIC, 4) == 0 && get_u32(&version) &&
+              version == REPLAY_VERSION && get_u32(&dt_bits);
+    if (ok)
+        memcpy(&file_dt, &dt_bits, sizeof(file_dt));
+    if (!ok || file_dt != dt) {
+        SDL_Log("replay: %s is not a version %u recording at dt %g", path, REPLAY_VERSION,
+                (double)dt);
+        SDL_free(g_replay.data);
+        reset();
+        return false;
+    }
+    g_replay.dt = dt;
+    g_replay.mode = REPLAY_PLAY;
+    SDL_Log("replay: playing %s (%zu bytes)", path, size);
+    return true;
+}
+
+void replay_stop(void) {
+    if (g_replay.mode == REPLAY_OFF)
+        return;
+    ReplayStats st;
+    replay_get_stats(&st);
+    if (g_replay.mode == REPLAY_RECORD) {
+        flush();
+        SDL_CloseIO(g_replay.io);
+        SDL_free(g_replay.buf);
+        SDL_Log("replay: recorded %llu ticks, %llu input changes, %llu bytes",
+                (unsigned long long)st.ticks, (unsigned long long)st.frames,
+                (unsigned long long)st.bytes);
+    } else {
+        SDL_free(g_replay.data);
+        if (st.mismatches)
+            SDL_Log("replay: %llu ticks, %llu diverged (first at tick %llu)",
+                    (unsigned long long)st.ticks, (unsigned long long)st.mismatches,
+                    (unsigned long long)st.first_mismatch);
+        else
+            SDL_Log("replay: %llu ticks, all checksums match", (unsigned long long)st.ticks);
+    }
+    reset();
+}
+
+ReplayMode replay_mode(void) {
+    return g_replay.mode;
+}
+
+static void record_input(void) {
+    InputFrame f;
+    input_capture_frame(&f);
+    uint8_t abilities = abilities_bits();
+    // A tick without a frame replays with the edges cleared, so every edge gets written
+    bool changed = !g_replay.have_last || memcmp(&f, &g_replay.last, sizeof(f)) != 0 ||
+                   abilities != g_replay.last_abilities || (f.buttons & INPUT_EDGES);
+    uint8_t flags = changed ? REPLAY_TICK_INPUT : 0;
+    put(&flags, 1);
+    if (changed) {
+        uint8_t b[5] = {(uint8_t)f.move, (uint8_t)f.accel, (uint8_t)f.yaw, f.buttons, abilities};
+        put(b, sizeof(b));
+        g_replay.last = f;
+        g_replay.last_abilities = abilities;
+        g_replay.have_last = true;
+        g_replay.frames++;
+    }
+    // The sim reads the recorded frame, not the devices, so nothing unrecorded gets in
+    input_set_frame(&f);
+}
+
+static void play_input(void) {
+    uint8_t flags;
+    bool ok = get(&flags, 1);
+    if (ok && (flags & REPLAY_TICK_INPUT)) {
+        uint8_t b[5];
+        ok = get(b, sizeof(b));
+        if (ok) {
+            g_replay.frame = (InputFrame){(int8_t)b[0], (int8_t)b[1], (int8_t)b[2], b[3]};
+            ability_set_car_jump((b[4] & ABILITY_JUMP) != 0);
+            ability_set_car_boost((b[4] & ABILITY_BOOST) != 0);
+            ability_set_car_fly((b[4] & ABILITY_FLY) != 0);
+            g_replay.frames++;
+        }
+    } else if (ok) {
+        // Held state carries over; edges happen once
+        g_replay.frame.buttons &= (uint8_t)~INPUT_EDGES;
+    }
+    ok = ok && get_u32(&g_replay.expected);
+    g_replay.have_expected = ok;
+    if (!ok) {
+        // Out of ticks: hands off, and stay that way for however long the caller keeps ticking
+        g_replay.frame = (InputFrame){0, 0, 0, 0};
+        atomic_store(&g_replay.finished, true);
+    }
+    input_set_frame(&g_replay.frame);
+}
+
+void replay_tick_input(void) {
+    if (g_replay.mode == REPLAY_RECORD)
+        record_input();
+    else if (g_replay.mode == REPLAY_PLAY)
+        play_input();
+}
+
+void replay_tick_end(uint64_t state_hash) {
+    if (g_replay.mode == REPLAY_RECORD) {
+        put_u32(fold(state_hash));
+        if (g_replay.len >= REPLAY_FLUSH_BYTES)
+            flush();
+    } else if (g_replay.mode == REPLAY_PLAY) {
+        if (!g_replay.have_expected)
+            return;
+        uint32_t got = fold(state_hash);
+        uint64_t tick = atomic_load_explicit(&g_replay.ticks, memory_order_relaxed);
+        if (got != g_replay.expected &&
+            atomic_fetch_add_explicit(&g_replay.mismatches, 1, memory_order_relaxed) == 0) {
+            atomic_store_explicit(&g_replay.first_mismatch, tick, memory_order_relaxed);
+            SDL_Log("replay: diverged at tick %llu (state %08x, recorded %08x)",
+                    (unsigned long long)tick, got, g_replay.expected);
+        }
+    } else {
+        return;
+    }
+    atomic_fetch_add_explicit(&g_replay.ticks, 1, memory_order_relaxed);
+}
+
+bool replay_finished(void) {
+    return atomic_load(&g_replay.finished);
+}
+
+bool replay_diverged(void) {
+    return atomic_load_explicit(&g_replay.mismatches, memory_order_relaxed) > 0;
+}
+
+void replay_get_stats(ReplayStats* out) {
+    if (!out)
+        return;
+    out->mode = g_replay.mode;
+    out->ticks = atomic_load_explicit(&g_replay.ticks, memory_order_relaxed);
+    out->frames = g_replay.frames;
+    out->bytes = g_replay.bytes;
+    out->mismatches = atomic_load_explicit(&g_replay.mismatches, memory_order_relaxed);
+    out->first_mismatch = atomic_load_explicit(&g_replay.first_mismatch, memory_order_relaxed);
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Input recording and replay. Recording logs, per sim tick, the input the simulation saw
+// (InputFrame plus the car abilities) and a checksum of the resulting state. Replay feeds the
+// same frames back in place of the devices and compares checksums after every tick, so the first
+// divergent tick is reported as it happens.
+// File: "GRPL", u32 version, f32 tick dt, then per tick a flags byte, the frame and abilities
+// when they changed (REPLAY_TICK_INPUT), and the low 32 bits of the folded state hash. Little
+// endian throughout.
+
+#define REPLAY_HASH_SEED 1469598103934665603ull  // FNV-1a offset basis
+#define REPLAY_FLUSH_BYTES (64 * 1024)           // recording buffer written out past this size
+
+typedef enum {
+    REPLAY_OFF,
+    REPLAY_RECORD,
+    REPLAY_PLAY,
+} ReplayMode;
+
+typedef struct {
+    ReplayMode mode;
+    uint64_t ticks;           // ticks recorded or replayed
+    uint64_t frames;          // input changes
+    uint64_t bytes;           // file size so far (recording) or total (replay)
+    uint64_t mismatches;      // replay: ticks whose checksum differed
+    uint64_t first_mismatch;  // replay: tick of the first difference (valid when mismatches > 0)
+} ReplayStats;
+
+// Before the sim starts. dt is the fixed tick; a replay recorded at another rate is refused.
+bool replay_start_recording(const char* path, float dt);
+bool replay_start_playback(const char* path, float dt);
+// Write out the rest of a recording, log the summary and return to REPLAY_OFF
+void replay_stop(void);
+ReplayMode replay_mode(void);
+
+// Sim thread, after input_update: record the frame (and make the sim read exactly that), or load
+// the next recorded one into input_set_frame and the ability flags
+void replay_tick_input(void);
+// Sim thread, at the end of the tick: record or check the state hash
+void replay_tick_end(uint64_t state_hash);
+
+// Any thread: replay ran out of ticks / some checksum differed
+bool replay_finished(void);
+bool replay_diverged(void);
+void replay_get_stats(ReplayStats* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,508 @@
+#include "sim_scheduler.h"
+#include <SDL3/SDL.h>
+#include <stdatomic.h>
+#include <string.h>
+#include "tick_timer.h"
+
+#define SIM_MAX_WORKERS 3
+#define SIM_SPIN_NS 50000  // spin the last 50 us before each deadline
+#define SIM_LOAD_ALPHA 0.02f         // per-tick weight of the newest load sample
+#define SIM_RECOVER_NS 1000000000ull  // load must stay below exit_load this long
+
+const uint32_t kSimStageBucketUs[SIM_STAGE_BUCKETS] = {50, 100, 250, 500, 1000, 2500, 5000,
+                                                       UINT32_MAX};
+
+typedef struct {
+    const char* name;
+    SimStageFn fn;
+    void* user;
+    uint32_t budget_us;
+    int flags;
+    // Stats are written by the thread that ran the stage and read from anywhere
+    atomic_uint last_us;
+    atomic_uint max_us;
+    atomic_ullong total_us;
+    atomic_ullong runs;
+    atomic_ullong over_budget;
+    atomic_ullong hist[SIM_STAGE_BUCKETS];
+} SimStage;
+
+static struct {
+    SimStage stages[SIM_MAX_STAGES];
+    int stage_count;
+    float dt;
+    float step_dt;  // dt handed to the stages (2 * dt while the overload policy halves the rate)
+    bool ready;
+
+    SDL_Thread* thread;
+    bool manual;  // ticks were run by sim_scheduler_run_ticks
+    atomic_bool running;
+    atomic_ullong tick;
+    TickTimer timer;
+    // Deadline the latest ticks ran for and the period after it (render interpolation)
+    atomic_ullong tick_deadline_ns;
+    atomic_ullong tick_period_ns;
+
+    // Idle mode: wake at idle_hz once idle_check has held for idle_after_ticks ticks
+    SimIdleFn idle_check;
+    void* idle_user;
+    float idle_hz;
+    uint32_t idle_after_ticks;
+    uint32_t idle_streak;
+    atomic_bool idle;
+    uint64_t idle_debt_ns;  // idle wakeup time not yet covered by whole ticks
+
+    // Load monitor and overload policy
+    SimOverloadPolicy policy;
+    float enter_load, exit_load;
+    SimOverloadFn overload_fn;
+    void* overload_user;
+    float load;             // sim thread only; published as load_milli
+    uint64_t calm_since_ns;  // when the load last dropped below exit_load while overloaded
+    atomic_uint load_milli;
+    atomic_bool overloaded;
+    atomic_ullong catchup_ticks;
+    atomic_ullong overloads;
+
+    // Worker pool for parallel groups: the sim thread posts work_sem once per worker, everyone
+    // pulls stage indices from group_next, each worker posts done_sem when the group is empty
+    SDL_Thread* workers[SIM_MAX_WORKERS];
+    int worker_count;
+    SDL_Semaphore* work_sem;
+    SDL_Semaphore* done_sem;
+    atomic_bool workers_quit;
+    atomic_int group_next;
+    int group_end;
+} g_sim;
+
+static void run_stage(SimStage* st) {
+    Uint64 t0 = SDL_GetTicksNS();
+    st->fn(g_sim.step_dt, st->user);
+    uint32_t us = (uint32_t)((SDL_GetTicksNS() - t0) / 1000);
+    int b = 0;
+    while (b < SIM_STAGE_BUCKETS - 1 && us >= kSimStageBucketUs[b])
+        b++;
+    atomic_fetch_add_explicit(&st->hist[b], 1, memory_order_relaxed);
+    atomic_store_explicit(&st->last_us, us, memory_order_relaxed);
+    if (us > atomic_load_explicit(&st->max_us, memory_order_relaxed))
+        atomic_store_explicit(&st->max_us, us, memory_order_relaxed);
+    atomic_fetch_add_explicit(&st->total_us, us, memory_order_relaxed);
+    atomic_fetch_add_explicit(&st->runs, 1, memory_order_relaxed);
+    if (st->budget_us && us > st->budget_us)
+        atomic_fetch_add_explicit(&st->over_budget, 1, memory_order_relaxed);
+}
+
+static void pull_group(void) {
+    for (;;) {
+        int i = atomic_fetch_add_explicit(&g_sim.group_next, 1, memory_order_acq_rel);
+        if (i >= g_sim.group_end)
+            break;
+        run_stage(&g_sim.stages[i]);
+    }
+}
+
+static int worker_main(void* ud) {
+    (void)ud;
+    for (;;) {
+        SDL_WaitSemaphore(g_sim.work_sem);
+        if (atomic_load(&g_sim.workers_quit))
+            break;
+        pull_group();
+        SDL_SignalSemaphore(g_sim.done_sem);
+    }
+    return 0;
+}
+
+static void run_group(int begin, int end) {
+    if (g_sim.worker_count == 0 || end - begin < 2) {
+        for (int i = begin; i < end; i++) {
+            run_stage(&g_sim.stages[i]);
+        }
+        return;
+    }
+    g_sim.group_end = end;
+    atomic_store_explicit(&g_sim.group_next, begin, memory_order_release);
+    for (int w = 0; w < g_sim.worker_count; w++) {
+        SDL_SignalSemaphore(g_sim.work_sem);
+    }
+    pull_group();
+    for (int w = 0; w < g_sim.worker_count; w++) {
+        SDL_WaitSemaphore(g_sim.done_sem);
+    }
+}
+
+static const char* policy_name(SimOverloadPolicy p) {
+    switch (p) {
+        case SIM_OVERLOAD_HALVE_RATE:
+            return "halve rate";
+        case SIM_OVERLOAD_REDUCE_QUALITY:
+            return "reduce quality";
+        case SIM_OVERLOAD_SLOW_TIME:
+            return "slow time";
+        default:
+            return "none";
+    }
+}
+
+static uint64_t active_period_ns(void) {
+    return (uint64_t)(g_sim.step_dt * 1.0e9);
+}
+
+static void set_overloaded(bool on) {
+    atomic_store_explicit(&g_sim.overloaded, on, memory_order_relaxed);
+    if (on)
+        atomic_fetch_add_explicit(&g_sim.overloads, 1, memory_order_relaxed);
+    g_sim.calm_since_ns = 0;
+    if (g_sim.policy == SIM_OVERLOAD_HALVE_RATE) {
+        g_sim.step_dt = on ? g_sim.dt * 2.0f : g_sim.dt;
+        if (!atomic_load_explicit(&g_sim.idle, memory_order_relaxed))
+            tick_timer_set_period(&g_sim.timer, active_period_ns());
+    }
+    // Name the stage that cost the most in the last tick, the usual suspect for a hitch
+    SimOverloadEvent ev = {on, g_sim.policy, g_sim.load, "none", 0, 0};
+    for (int i = 0; i < g_sim.stage_count; i++) {
+        uint32_t us = atomic_load_explicit(&g_sim.stages[i].last_us, memory_order_relaxed);
+        if (us >= ev.stage_us) {
+            ev.stage = g_sim.stages[i].name;
+            ev.stage_us = us;
+        }
+    }
+    ev.tick = atomic_load_explicit(&g_sim.tick, memory_order_relaxed);
+    SDL_Log("sim: overload %s at tick %llu (load %.2f, policy %s, slowest stage %s %u us)",
+            on ? "entered" : "cleared", (unsigned long long)ev.tick, ev.load,
+            policy_name(g_sim.policy), ev.stage, ev.stage_us);
+    if (g_sim.overload_fn)
+        g_sim.overload_fn(&ev, g_sim.overload_user);
+}
+
+static void update_load(uint64_t tick_ns) {
+    float sample = (float)tick_ns / (g_sim.dt * 1.0e9f);
+    g_sim.load += (sample - g_sim.load) * SIM_LOAD_ALPHA;
+    atomic_store_explicit(&g_sim.load_milli, (unsigned)(g_sim.load * 1000.0f),
+                          memory_order_relaxed);
+    if (!atomic_load_explicit(&g_sim.overloaded, memory_order_relaxed)) {
+        if (g_sim.load > g_sim.enter_load)
+            set_overloaded(true);
+        return;
+    }
+    if (g_sim.load >= g_sim.exit_load) {
+        g_sim.calm_since_ns = 0;
+        return;
+    }
+    uint64_t now = SDL_GetTicksNS();
+    if (!g_sim.calm_since_ns)
+        g_sim.calm_since_ns = now;
+    else if (now - g_sim.calm_since_ns >= SIM_RECOVER_NS)
+        set_overloaded(false);
+}
+
+static void run_tick(bool monitor) {
+    Uint64 t0 = SDL_GetTicksNS();
+    int i = 0;
+    while (i < g_sim.stage_count) {
+        int end = i + 1;
+        if (g_sim.stages[i].flags & SIM_STAGE_PARALLEL) {
+            while (end < g_sim.stage_count && (g_sim.stages[end].flags & SIM_STAGE_PARALLEL))
+                end++;
+        }
+        run_group(i, end);
+        i = end;
+    }
+    atomic_fetch_add_explicit(&g_sim.tick, 1, memory_order_release);
+    if (monitor)
+        update_load(SDL_GetTicksNS() - t0);
+}
+
+static void update_idle(void) {
+    if (!g_sim.idle_check || g_sim.idle_hz <= 0.0f)
+        return;
+    bool quiet = g_sim.idle_check(g_sim.idle_user);
+    g_sim.idle_streak = quiet ? g_sim.idle_streak + 1 : 0;
+    bool idle = g_sim.idle_streak >= g_sim.idle_after_ticks;
+    if (idle == atomic_load_explicit(&g_sim.idle, memory_order_relaxed))
+        return;
+    atomic_store_explicit(&g_sim.idle, idle, memory_order_relaxed);
+    g_sim.idle_debt_ns = 0;
+    tick_timer_set_period(&g_sim.timer,
+                          idle ? (uint64_t)(1.0e9 / g_sim.idle_hz) : active_period_ns());
+}
+
+static int sim_thread_main(void* ud) {
+    (void)ud;
+    while (atomic_load(&g_sim.running)) {
+        int due = tick_timer_wait(&g_sim.timer);
+        bool slow = g_sim.policy == SIM_OVERLOAD_SLOW_TIME &&
+                    atomic_load_explicit(&g_sim.overloaded, memory_order_relaxed);
+        int ticks = slow ? 1 : due;
+        if (atomic_load_explicit(&g_sim.idle, memory_order_relaxed)) {
+            // Idle: fewer wakeups, same game time. Each wakeup runs the whole ticks its periods
+            // cover, so timers and cooldowns keep pace with the wall clock.
+            g_sim.idle_debt_ns += (uint64_t)due * g_sim.timer.period_ns;
+            ticks = (int)(g_sim.idle_debt_ns / active_period_ns());
+            g_sim.idle_debt_ns -= (uint64_t)ticks * active_period_ns();
+        } else if (ticks > 1) {
+            atomic_fetch_add_explicit(&g_sim.catchup_ticks, (unsigned long long)(ticks - 1),
+                                      memory_order_relaxed);
+        }
+        for (int i = 0; i < ticks; i++) {
+            run_tick(true);
+        }
+        atomic_store_explicit(&g_sim.tick_period_ns, active_period_ns(), memory_order_relaxed);
+        atomic_store_explicit(&g_sim.tick_deadline_ns, g_sim.timer.next_ns - g_sim.timer.period_ns,
+                              memory_order_release);
+        // Slowing time: whatever fell due meanwhile is dropped rather than caught up
+        if (slow)
+            tick_timer_drop_backlog(&g_sim.timer);
+        update_idle();
+    }
+    return 0;
+}
+
+bool sim_scheduler_init(float dt) {
+    memset(&g_sim, 0, sizeof(g_sim));
+    g_sim.dt = dt > 0.0f ? dt : 0.001f;
+    g_sim.step_dt = g_sim.dt;
+    g_sim.policy = SIM_OVERLOAD_NONE;
+    g_sim.enter_load = 0.9f;
+    g_sim.exit_load = 0.6f;
+    g_sim.ready = true;
+    return true;
+}
+
+void sim_scheduler_shutdown(void) {
+    sim_scheduler_stop();
+    g_sim.stage_count = 0;
+    g_sim.ready = false;
+}
+
+int sim_scheduler_add_stage(const char* name,
+                            SimStageFn fn,
+                            void* user,
+                            uint32_t budget_us,
+                            int flags) {
+    if (!g_sim.ready || !fn || g_sim.thread || g_sim.stage_count >= SIM_MAX_STAGES)
+        return -1;
+    SimStage* st = &g_sim.stages[g_sim.stage_count];
+    memset(st, 0, sizeof(*st));
+    st->name = name ? name : "stage";
+    st->fn = fn;
+    st->user = user;
+    st->budget_us = budget_us;
+    st->flags = flags;
+    return g_sim.stage_count++;
+}
+
+void sim_scheduler_set_order(const char* csv) {
+    if (!csv || g_sim.thread)
+        return;
+    SimStage sorted[SIM_MAX_STAGES];
+    bool used[SIM_MAX_STAGES] = {0};
+    int n = 0;
+    const char* p = csv;
+    while (*p) {
+        const char* end = strchr(p, ',');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        for (int i = 0; i < g_sim.stage_count; i++) {
+            if (!used[i] && strlen(g_sim.stages[i].name) == len &&
+                strncmp(g_sim.stages[i].name, p, len) == 0) {
+                sorted[n++] = g_sim.stages[i];
+                used[i] = true;
+                break;
+            }
+        }
+        if (!end)
+            break;
+        p = end + 1;
+    }
+    for (int i = 0; i < g_sim.stage_count; i++) {
+        if (!used[i])
+            sorted[n++] = g_sim.stages[i];
+    }
+    memcpy(g_sim.stages, sorted, sizeof(SimStage) * (size_t)n);
+}
+
+bool sim_scheduler_start(void) {
+    if (!g_sim.ready || g_sim.thread)
+        return false;
+
+    // Workers only exist when some stage can actually run in parallel
+    bool parallel = false;
+    for (int i = 0; i + 1 < g_sim.stage_count; i++) {
+        if ((g_sim.stages[i].flags & SIM_STAGE_PARALLEL) &&
+            (g_sim.stages[i + 1].flags & SIM_STAGE_PARALLEL))
+            parallel = true;
+    }
+    if (parallel) {
+        int cores = SDL_GetNumLogicalCPUCores();
+        int want = cores - 2;  // main + sim threads
+        if (want > SIM_MAX_WORKERS)
+            want = SIM_MAX_WORKERS;
+        g_sim.work_sem = SDL_CreateSemaphore(0);
+        g_sim.done_sem = SDL_CreateSemaphore(0);
+        atomic_store(&g_sim.workers_quit, false);
+        for (int w = 0; w < want && g_sim.work_sem && g_sim.done_sem; w++) {
+            SDL_Thread* t = SDL_CreateThread(worker_main, "sim_worker", NULL);
+            if (!t)
+                break;
+            g_sim.workers[g_sim.worker_count++] = t;
+        }
+    }
+
+    atomic_store(&g_sim.tick, 0);
+    atomic_store(&g_sim.tick_deadline_ns, 0);
+    atomic_store(&g_sim.idle, false);
+    g_sim.idle_streak = 0;
+    g_sim.idle_debt_ns = 0;
+    g_sim.step_dt = g_sim.dt;
+    g_sim.load = 0.0f;
+    atomic_store(&g_sim.overloaded, false);
+    tick_timer_init(&g_sim.timer, "sim", active_period_ns(), SIM_SPIN_NS);
+    atomic_store(&g_sim.running, true);
+    g_sim.thread = SDL_CreateThread(sim_thread_main, "sim", NULL);
+    if (!g_sim.thread) {
+        SDL_Log("sim: failed to start thread: %s", SDL_GetError());
+        atomic_store(&g_sim.running, false);
+        tick_timer_destroy(&g_sim.timer);
+        sim_scheduler_stop();
+        return false;
+    }
+    return true;
+}
+
+void sim_scheduler_run_ticks(uint64_t count) {
+    if (!g_sim.ready || g_sim.thread)
+        return;
+    g_sim.manual = true;
+    for (uint64_t i = 0; i < count; i++) {
+        run_tick(false);
+    }
+}
+
+static void log_stats(void) {
+    for (int i = 0; i < g_sim.stage_count; i++) {
+        SimStageStats st;
+        sim_scheduler_get_stage_stats(i, &st);
+        char line[256];
+        int n = 0;
+        for (int b = 0; b < SIM_STAGE_BUCKETS && n < (int)sizeof(line); b++) {
+            if (kSimStageBucketUs[b] == UINT32_MAX)
+                n += SDL_snprintf(line + n, sizeof(line) - (size_t)n, " >=%uus:%llu",
+                                  kSimStageBucketUs[b - 1], (unsigned long long)st.hist[b]);
+            else
+                n += SDL_snprintf(line + n, sizeof(line) - (size_t)n, " <%uus:%llu",
+                                  kSimStageBucketUs[b], (unsigned long long)st.hist[b]);
+        }
+        SDL_Log("sim stage %s: avg %.1f us, max %u us, %llu over budget, duration%s", st.name,
+                st.avg_us, st.max_us, (unsigned long long)st.over_budget, line);
+    }
+    SimLoadStats ls;
+    sim_scheduler_get_load_stats(&ls);
+    SDL_Log("sim load: %.2f, %llu catch-up ticks, %llu dropped, %llu overloads (policy %s)",
+            ls.load, (unsigned long long)ls.catchup_ticks, (unsigned long long)ls.dropped_ticks,
+            (unsigned long long)ls.overloads, policy_name(g_sim.policy));
+}
+
+void sim_scheduler_stop(void) {
+    atomic_store(&g_sim.running, false);
+    if (g_sim.thread) {
+        SDL_WaitThread(g_sim.thread, NULL);
+        g_sim.thread = NULL;
+        log_stats();
+        tick_timer_log_stats(&g_sim.timer);
+        tick_timer_destroy(&g_sim.timer);
+    } else if (g_sim.manual) {
+        log_stats();
+    }
+    g_sim.manual = false;
+    atomic_store(&g_sim.workers_quit, true);
+    for (int w = 0; w < g_sim.worker_count; w++) {
+        SDL_SignalSemaphore(g_sim.work_sem);
+    }
+    for (int w = 0; w < g_sim.worker_count; w++) {
+        SDL_WaitThread(g_sim.workers[w], NULL);
+        g_sim.workers[w] = NULL;
+    }
+    g_sim.worker_count = 0;
+    if (g_sim.work_sem) {
+        SDL_DestroySemaphore(g_sim.work_sem);
+        g_sim.work_sem = NULL;
+    }
+    if (g_sim.done_sem) {
+        SDL_DestroySemaphore(g_sim.done_sem);
+        g_sim.done_sem = NULL;
+    }
+}
+
+void sim_scheduler_set_idle(SimIdleFn check, void* user, float idle_hz, float idle_after_sec) {
+    g_sim.idle_check = check;
+    g_sim.idle_user = user;
+    g_sim.idle_hz = idle_hz;
+    g_sim.idle_after_ticks = (uint32_t)(idle_after_sec / g_sim.dt);
+}
+
+bool sim_scheduler_is_idle(void) {
+    return atomic_load_explicit(&g_sim.idle, memory_order_relaxed);
+}
+
+void sim_scheduler_set_overload(SimOverloadPolicy policy,
+                                float enter_load,
+                                float exit_load,
+                                SimOverloadFn fn,
+                                void* user) {
+    if (g_sim.thread)
+        return;
+    g_sim.policy = policy;
+    g_sim.enter_load = enter_load > 0.0f ? enter_load : 0.9f;
+    g_sim.exit_load = exit_load < g_sim.enter_load ? exit_load : g_sim.enter_load * 0.5f;
+    g_sim.overload_fn = fn;
+    g_sim.overload_user = user;
+}
+
+bool sim_scheduler_get_load_stats(SimLoadStats* out) {
+    if (!out)
+        return false;
+    out->load = atomic_load_explicit(&g_sim.load_milli, memory_order_relaxed) / 1000.0f;
+    out->overloaded = atomic_load_explicit(&g_sim.overloaded, memory_order_relaxed);
+    out->catchup_ticks = atomic_load_explicit(&g_sim.catchup_ticks, memory_order_relaxed);
+    out->dropped_ticks = atomic_load_explicit(&g_sim.timer.dropped, memory_order_relaxed);
+    out->overloads = atomic_load_explicit(&g_sim.overloads, memory_order_relaxed);
+    return true;
+}
+
+uint64_t sim_scheduler_tick(void) {
+    return atomic_load_explicit(&g_sim.tick, memory_order_acquire);
+}
+
+float sim_scheduler_alpha(void) {
+    uint64_t deadline = atomic_load_explicit(&g_sim.tick_deadline_ns, memory_order_acquire);
+    uint64_t period = atomic_load_explicit(&g_sim.tick_period_ns, memory_order_relaxed);
+    if (!g_sim.thread || !deadline || !period)
+        return 1.0f;
+    uint64_t now = tick_timer_now_ns();
+    if (now <= deadline)
+        return 0.0f;
+    float alpha = (float)((double)(now - deadline) / (double)period);
+    return alpha < 1.0f ? alpha : 1.0f;
+}
+
+int sim_scheduler_stage_count(void) {
+    return g_sim.stage_count;
+}
+
+bool sim_scheduler_get_stage_stats(int index, SimStageStats* out) {
+    if (!out || index < 0 || index >= g_sim.stage_count)
+        return false;
+    const SimStage* st = &g_sim.stages[index];
+    uint64_t runs = atomic_load_explicit(&st->runs, memory_order_relaxed);
+    out->name = st->name;
+    out->budget_us = st->budget_us;
+    out->last_us = atomic_load_explicit(&st->last_us, memory_order_relaxed);
+    out->max_us = atomic_load_explicit(&st->max_us, memory_order_relaxed);
+    out->avg_us =
+        runs ? (double)atomic_load_explicit(&st->total_us, memory_order_relaxed) / (double)runs : 0.0;
+    out->over_budget = atomic_load_explicit(&st->over_budget, memory_order_relaxed);
+    for (int b = 0; b < SIM_STAGE_BUCKETS; b++) {
+        out->hist[b] = atomic_load_explicit(&st->hist[b], memory_order_relaxed);
+    }
+    return true;
+}
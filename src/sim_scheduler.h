@@ -0,0 +1,113 @@
+#pragma once
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Single fixed-step simulation scheduler. One "sim" thread runs every registered stage once per
+// tick, in a defined order, so gameplay and physics never drift relative to each other.
+// - Stages run in registration order, optionally reordered with sim_scheduler_set_order
+// - Each stage has a time budget; overruns are counted and reported in the stage stats
+// - Consecutive stages flagged SIM_STAGE_PARALLEL form a group that runs concurrently on
+//   worker threads; the group is joined before the next stage starts
+// - Ticks are paced by an absolute-deadline tick timer (tick_timer.h); an optional idle check
+//   drops the wakeup rate while nothing is moving
+// - Load monitor: the cost of each tick against the nominal period is averaged; past a threshold
+//   the configured overload policy kicks in and an event is emitted, and again on recovery
+
+#define SIM_MAX_STAGES 16
+#define SIM_STAGE_PARALLEL (1 << 0)
+#define SIM_STAGE_BUCKETS 8
+
+// Upper bounds of the stage duration histogram buckets in microseconds (last bucket is open)
+extern const uint32_t kSimStageBucketUs[SIM_STAGE_BUCKETS];
+
+typedef void (*SimStageFn)(float dt, void* user);
+typedef bool (*SimIdleFn)(void* user);
+
+typedef struct {
+    const char* name;
+    uint32_t budget_us;    // per-tick budget for this stage (0 = unbudgeted)
+    uint32_t last_us;      // duration of the last run
+    uint32_t max_us;       // worst run since start
+    double avg_us;         // mean over all runs
+    uint64_t over_budget;  // runs that exceeded budget_us
+    uint64_t hist[SIM_STAGE_BUCKETS];
+} SimStageStats;
+
+typedef enum {
+    SIM_OVERLOAD_NONE,            // only report
+    SIM_OVERLOAD_HALVE_RATE,      // half as many ticks, each advancing 2 * dt
+    SIM_OVERLOAD_REDUCE_QUALITY,  // the listener makes ticks cheaper (e.g. solver iterations)
+    SIM_OVERLOAD_SLOW_TIME,       // never catch up: game time runs slower than real time
+} SimOverloadPolicy;
+
+typedef struct {
+    bool overloaded;  // true on entering overload, false on recovery
+    SimOverloadPolicy policy;
+    float load;         // averaged tick cost / nominal period
+    const char* stage;  // most expensive stage of the last tick
+    uint32_t stage_us;
+    uint64_t tick;
+} SimOverloadEvent;
+
+typedef void (*SimOverloadFn)(const SimOverloadEvent* ev, void* user);
+
+typedef struct {
+    float load;              // averaged tick cost / nominal period
+    bool overloaded;
+    uint64_t catchup_ticks;  // ticks run after their deadline to catch up
+    uint64_t dropped_ticks;  // ticks never run (backlog beyond the catch-up limit, slowed time)
+    uint64_t overloads;      // times overload was entered
+} SimLoadStats;
+
+bool sim_scheduler_init(float dt);
+void sim_scheduler_shutdown(void);
+
+// Register a stage before sim_scheduler_start. name must stay valid (string literal).
+// Returns the stage index or -1 when full.
+int sim_scheduler_add_stage(const char* name,
+                            SimStageFn fn,
+                            void* user,
+                            uint32_t budget_us,
+                            int flags);
+// Reorder stages from a comma-separated list of names (e.g. "input,control,gameplay,physics").
+// Stages not listed keep their relative order after the listed ones. Call before start.
+void sim_scheduler_set_order(const char* csv);
+
+// Idle mode: once check (run on the sim thread after every wakeup) has returned true for
+// idle_after_sec, wake at idle_hz instead of 1/dt; the first false restores the full rate.
+// Every wakeup runs the dt ticks that fell due since the last one, back to back, so game time
+// keeps pace with real time and runs stay deterministic: idle saves wakeups and spinning, not
+// ticks (quiet ticks are cheap, Box2D skips sleeping bodies). Pass NULL to disable.
+void sim_scheduler_set_idle(SimIdleFn check, void* user, float idle_hz, float idle_after_sec);
+bool sim_scheduler_is_idle(void);
+
+// Overload: entered when the load stays above enter_load, left once it has been below exit_load
+// for a second. fn (may be NULL) runs on the sim thread for each transition. Call before start.
+void sim_scheduler_set_overload(SimOverloadPolicy policy,
+                                float enter_load,
+                                float exit_load,
+                                SimOverloadFn fn,
+                                void* user);
+bool sim_scheduler_get_load_stats(SimLoadStats* out);
+
+bool sim_scheduler_start(void);
+// Stops the sim thread and logs its timer, stage and load statistics
+void sim_scheduler_stop(void);
+// Without the sim thread: run count ticks back to back on the calling thread, as fast as they go
+// (headless replay). No pacing, idle mode or load monitor; parallel groups run in order.
+void sim_scheduler_run_ticks(uint64_t count);
+
+// Ticks completed since start
+uint64_t sim_scheduler_tick(void);
+// Render interpolation: the part of a tick period elapsed since the deadline of the latest
+// completed tick, in [0, 1] (1 without the sim thread)
+float sim_scheduler_alpha(void);
+int sim_scheduler_stage_count(void);
+bool sim_scheduler_get_stage_stats(int index, SimStageStats* out);
+
+#ifdef __cplusplus
+}
+#endif
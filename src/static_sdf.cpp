@@ -0,0 +1,458 @@
+#include "static_sdf.h"
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "physics.h"
+
+#define STATIC_SDF_MAX_CELLS (2048 * 2048)  // the cell size grows to stay under this
+#define STATIC_SDF_FAR 1.0e6f
+#define STATIC_SDF_MAX_STEPS 256  // sphere-tracing iterations per ray
+
+static_assert(STATIC_SDF_TILE == 8, "tile addressing below uses shifts by 3");
+
+namespace {
+
+struct Seg {
+    float ax, ay, bx, by;
+};
+
+// Per tile: 0 while the tile is fresh, otherwise the invalidation that last made it stale.
+// Shared by a field and the partial re-bakes that replace it.
+struct Stale {
+    std::unique_ptr<std::atomic<unsigned int>[]> gen;
+    std::atomic<int> count{0};  // stale tiles
+};
+
+struct Field {
+    float x0, y0;  // lower-left corner of the grid
+    float cell, inv_cell;
+    int w, h;  // cells
+    int tiles_x, tiles_y;
+    float reach;  // how far a geometry change can move distances that matter (the bake margin)
+    std::vector<float> d;  // tile by tile, row-major inside a tile
+    std::shared_ptr<Stale> stale;
+
+    float at(int i, int j) const {
+        size_t tile = (size_t)((j >> 3) * tiles_x + (i >> 3));
+        return d[(tile << 6) + (size_t)((j & 7) << 3) + (size_t)(i & 7)];
+    }
+    float& at(int i, int j) {
+        size_t tile = (size_t)((j >> 3) * tiles_x + (i >> 3));
+        return d[(tile << 6) + (size_t)((j & 7) << 3) + (size_t)(i & 7)];
+    }
+    // Tiles overlapping the world rect, clamped to the grid (what the border samples read)
+    void tile_range(float ax, float ay, float bx, float by, int* t) const {
+        t[0] = SDL_clamp((int)floorf((fminf(ax, bx) - x0) * inv_cell - 0.5f), 0, w - 1) >> 3;
+        t[1] = SDL_clamp((int)floorf((fminf(ay, by) - y0) * inv_cell - 0.5f), 0, h - 1) >> 3;
+        t[2] = SDL_clamp((int)ceilf((fmaxf(ax, bx) - x0) * inv_cell - 0.5f), 0, w - 1) >> 3;
+        t[3] = SDL_clamp((int)ceilf((fmaxf(ay, by) - y0) * inv_cell - 0.5f), 0, h - 1) >> 3;
+    }
+};
+
+static std::atomic<Field*> g_field{nullptr};
+static std::atomic<unsigned int> g_stale_gen{0};
+// Bakes and re-bakes publish one at a time; g_retired is only touched under this lock
+static SDL_Mutex* g_bake_mtx = nullptr;
+// Replaced fields wait here until no query is pinned, since a query may still be reading one
+static std::vector<Field*> g_retired;
+static std::atomic<int> g_readers{0};
+
+// A query's hold on the current field
+struct Pin {
+    const Field* f;
+    Pin() {
+        g_readers.fetch_add(1);
+        f = g_field.load();
+    }
+    ~Pin() { g_readers.fetch_sub(1, std::memory_order_release); }
+    Pin(const Pin&) = delete;
+    Pin& operator=(const Pin&) = delete;
+};
+
+// Bake lock held: swap f in and free the replaced fields no query can still see. A query that
+// loaded one of them pinned before its load, so a zero count after the exchange means none did.
+static void publish(Field* f) {
+    Field* old = g_field.exchange(f);
+    if (old)
+        g_retired.push_back(old);
+    if (g_readers.load() == 0) {
+        for (Field* r : g_retired) {
+            delete r;
+        }
+        g_retired.clear();
+    }
+}
+
+static float seg_dist2(const Seg& s, float px, float py) {
+    float dx = s.bx - s.ax, dy = s.by - s.ay;
+    float len2 = dx * dx + dy * dy;
+    float t = len2 > 0.0f ? ((px - s.ax) * dx + (py - s.ay) * dy) / len2 : 0.0f;
+    t = fminf(fmaxf(t, 0.0f), 1.0f);
+    float ex = s.ax + dx * t - px, ey = s.ay + dy * t - py;
+    return ex * ex + ey * ey;
+}
+
+// Nearest segment per cell of the w x h grid at (ox,oy): seed the cells along every segment,
+// then sweep the nearest candidates through the grid (forward and backward over the
+// 8-neighbourhood), always keeping the exact squared distance to the candidate segment
+static void nearest_segments(const Seg* segs,
+                             int n,
+                             float ox,
+                             float oy,
+                             float cell,
+                             int w,
+                             int h,
+                             std::vector<int>& nearest,
+                             std::vector<float>& best) {
+    size_t cells = (size_t)w * (size_t)h;
+    nearest.assign(cells, -1);
+    best.assign(cells, FLT_MAX);
+    auto consider = [&](int i, int j, int s) {
+        size_t k = (size_t)j * (size_t)w + (size_t)i;
+        float d2 = seg_dist2(segs[s], ox + (i + 0.5f) * cell, oy + (j + 0.5f) * cell);
+        if (d2 < best[k]) {
+            best[k] = d2;
+            nearest[k] = s;
+        }
+    };
+    auto pull = [&](int i, int j, int ni, int nj) {
+        if (ni < 0 || nj < 0 || ni >= w || nj >= h)
+            return;
+        int s = nearest[(size_t)nj * (size_t)w + (size_t)ni];
+        if (s >= 0)
+            consider(i, j, s);
+    };
+    for (int s = 0; s < n; s++) {
+        const Seg& g = segs[s];
+        float len = sqrtf((g.bx - g.ax) * (g.bx - g.ax) + (g.by - g.ay) * (g.by - g.ay));
+        int steps = (int)ceilf(len / (cell * 0.5f)) + 1;
+        for (int k = 0; k <= steps; k++) {
+            float t = (float)k / (float)steps;
+            // Clamped: a segment off the grid seeds the border cells nearest to it
+            int ci = SDL_clamp((int)floorf((g.ax + (g.bx - g.ax) * t - ox) / cell), 0, w - 1);
+            int cj = SDL_clamp((int)floorf((g.ay + (g.by - g.ay) * t - oy) / cell), 0, h - 1);
+            for (int dj = -1; dj <= 1; dj++) {
+                for (int di = -1; di <= 1; di++) {
+                    int i = ci + di, j = cj + dj;
+                    if (i >= 0 && j >= 0 && i < w && j < h)
+                        consider(i, j, s);
+                }
+            }
+        }
+    }
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            pull(i, j, i - 1, j);
+            pull(i, j, i - 1, j - 1);
+            pull(i, j, i, j - 1);
+            pull(i, j, i + 1, j - 1);
+        }
+        for (int i = w - 1; i >= 0; i--) {
+            pull(i, j, i + 1, j);
+        }
+    }
+    for (int j = h - 1; j >= 0; j--) {
+        for (int i = w - 1; i >= 0; i--) {
+            pull(i, j, i + 1, j);
+            pull(i, j, i + 1, j + 1);
+            pull(i, j, i, j + 1);
+            pull(i, j, i - 1, j + 1);
+        }
+        for (int i = 0; i < w; i++) {
+            pull(i, j, i - 1, j);
+        }
+    }
+}
+
+static float field_distance(const Field* f, float x, float y) {
+    float fx = (x - f->x0) * f->inv_cell - 0.5f;
+    float fy = (y - f->y0) * f->inv_cell - 0.5f;
+    float cx = fminf(fmaxf(fx, 0.0f), (float)(f->w - 1));
+    float cy = fminf(fmaxf(fy, 0.0f), (float)(f->h - 1));
+    int i0 = SDL_min((int)cx, f->w - 2), j0 = SDL_min((int)cy, f->h - 2);
+    float tx = cx - (float)i0, ty = cy - (float)j0;
+    float d0 = f->at(i0, j0) + (f->at(i0 + 1, j0) - f->at(i0, j0)) * tx;
+    float d1 = f->at(i0, j0 + 1) + (f->at(i0 + 1, j0 + 1) - f->at(i0, j0 + 1)) * tx;
+    float d = d0 + (d1 - d0) * ty;
+    // Past the border all geometry is behind the border, and at most d away from it
+    float ox = (fx - cx) * f->cell, oy = (fy - cy) * f->cell;
+    float out = sqrtf(ox * ox + oy * oy);
+    return out > 0.0f ? fmaxf(out, d - out) : d;
+}
+
+static void field_gradient(const Field* f, float x, float y, float* gx, float* gy) {
+    float h = f->cell;
+    float nx = field_distance(f, x + h, y) - field_distance(f, x - h, y);
+    float ny = field_distance(f, x, y + h) - field_distance(f, x, y - h);
+    float len = sqrtf(nx * nx + ny * ny);
+    if (len > 1e-6f) {
+        nx /= len;
+        ny /= len;
+    } else {
+        nx = 0.0f;
+        ny = 1.0f;
+    }
+    if (gx)
+        *gx = nx;
+    if (gy)
+        *gy = ny;
+}
+
+}  // namespace
+
+bool static_sdf_bake(float cell, float margin) {
+    Uint64 t0 = SDL_GetTicksNS();
+    int n = physics_collect_static_segments(NULL, 0);
+    if (n <= 0)
+        return false;
+    std::vector<Seg> segs((size_t)n);
+    n = physics_collect_static_segments(&segs[0].ax, n);
+    float minx = FLT_MAX, miny = FLT_MAX, maxx = -FLT_MAX, maxy = -FLT_MAX;
+    for (const Seg& s : segs) {
+        minx = fminf(minx, fminf(s.ax, s.bx));
+        miny = fminf(miny, fminf(s.ay, s.by));
+        maxx = fmaxf(maxx, fmaxf(s.ax, s.bx));
+        maxy = fmaxf(maxy, fmaxf(s.ay, s.by));
+    }
+    margin = fmaxf(margin, 0.0f);
+    minx -= margin;
+    miny -= margin;
+    maxx += margin;
+    maxy += margin;
+    float requested = cell > 0.0f ? cell : 2.0f;
+    cell = requested;
+    int w, h;
+    for (;;) {
+        w = SDL_max((int)ceilf((maxx - minx) / cell), 2);
+        h = SDL_max((int)ceilf((maxy - miny) / cell), 2);
+        if ((size_t)w * (size_t)h <= STATIC_SDF_MAX_CELLS)
+            break;
+        cell *= 1.25f;
+    }
+    if (cell != requested)
+        SDL_Log("sdf: cell size raised from %.2f to %.2f to fit the grid", requested, cell);
+
+    size_t cells = (size_t)w * (size_t)h;
+    std::vector<int> nearest;
+    std::vector<float> best;
+    nearest_segments(segs.data(), n, minx, miny, cell, w, h, nearest, best);
+
+    // Sign from the solid fixtures. Inside values measure to the nearest fixture edge, which
+    // can be a seam between two merged polygons: only the sign is meaningful there.
+    std::vector<unsigned char> inside(cells, 0);
+    physics_rasterize_static_solids(minx, miny, cell, w, h, inside.data());
+
+    Field* f = new Field();
+    f->x0 = minx;
+    f->y0 = miny;
+    f->cell = cell;
+    f->inv_cell = 1.0f / cell;
+    f->w = w;
+    f->h = h;
+    f->tiles_x = (w + STATIC_SDF_TILE - 1) / STATIC_SDF_TILE;
+    f->tiles_y = (h + STATIC_SDF_TILE - 1) / STATIC_SDF_TILE;
+    f->reach = fmaxf(margin, cell * STATIC_SDF_TILE);
+    size_t tiles = (size_t)f->tiles_x * (size_t)f->tiles_y;
+    f->d.assign(tiles * STATIC_SDF_TILE * STATIC_SDF_TILE, STATIC_SDF_FAR);
+    for (int j = 0; j < h; j++) {
+        for (int i = 0; i < w; i++) {
+            size_t k = (size_t)j * (size_t)w + (size_t)i;
+            float d = nearest[k] >= 0 ? sqrtf(best[k]) : STATIC_SDF_FAR;
+            f->at(i, j) = inside[k] ? -d : d;
+        }
+    }
+    f->stale = std::make_shared<Stale>();
+    f->stale->gen.reset(new std::atomic<unsigned int>[tiles]());
+    if (!g_bake_mtx)
+        g_bake_mtx = SDL_CreateMutex();
+    if (!g_bake_mtx) {
+        delete f;
+        return false;
+    }
+    SDL_LockMutex(g_bake_mtx);
+    publish(f);
+    SDL_UnlockMutex(g_bake_mtx);
+    SDL_Log("sdf: %dx%d cells of %.2f (%d segments, %.1f MB) baked in %.1f ms", w, h, cell, n,
+            f->d.size() * sizeof(float) / (1024.0 * 1024.0), (SDL_GetTicksNS() - t0) / 1.0e6);
+    return true;
+}
+
+void static_sdf_shutdown(void) {
+    delete g_field.exchange(nullptr);
+    for (Field* f : g_retired) {
+        delete f;
+    }
+    g_retired.clear();
+    if (g_bake_mtx) {
+        SDL_DestroyMutex(g_bake_mtx);
+        g_bake_mtx = nullptr;
+    }
+}
+
+bool static_sdf_ready(void) {
+    return g_field.load() != nullptr;
+}
+
+float static_sdf_distance(float x, float y) {
+    Pin pin;
+    return pin.f ? field_distance(pin.f, x, y) : STATIC_SDF_FAR;
+}
+
+float static_sdf_sample(float x, float y, float* gx, float* gy) {
+    Pin pin;
+    const Field* f = pin.f;
+    if (!f) {
+        if (gx)
+            *gx = 0.0f;
+        if (gy)
+            *gy = 1.0f;
+        return STATIC_SDF_FAR;
+    }
+    field_gradient(f, x, y, gx, gy);
+    return field_distance(f, x, y);
+}
+
+StaticSdfHit static_sdf_raycast(float x0, float y0, float x1, float y1) {
+    StaticSdfHit r{};
+    r.x = x1;
+    r.y = y1;
+    r.fraction = 1.0f;
+    Pin pin;
+    const Field* f = pin.f;
+    float dx = x1 - x0, dy = y1 - y0;
+    float len = sqrtf(dx * dx + dy * dy);
+    if (!f || len < 1e-6f)
+        return r;
+    dx /= len;
+    dy /= len;
+    // A surface within half a cell counts as hit; the minimum step keeps grazing rays moving
+    float eps = f->cell * 0.5f;
+    float min_step = f->cell * 0.25f;
+    float t = 0.0f;
+    for (int it = 0; it < STATIC_SDF_MAX_STEPS && t <= len; it++) {
+        float px = x0 + dx * t, py = y0 + dy * t;
+        float d = field_distance(f, px, py);
+        if (d <= eps) {
+            r.hit = true;
+            r.x = px;
+            r.y = py;
+            r.fraction = t / len;
+            field_gradient(f, px, py, &r.nx, &r.ny);
+            return r;
+        }
+        t += fmaxf(d, min_step);
+    }
+    return r;
+}
+
+void static_sdf_invalidate(float x0, float y0, float x1, float y1) {
+    Pin pin;
+    const Field* f = pin.f;
+    if (!f)
+        return;
+    unsigned int gen = g_stale_gen.fetch_add(1, std::memory_order_relaxed) + 1;
+    if (gen == 0)
+        gen = g_stale_gen.fetch_add(1, std::memory_order_relaxed) + 1;
+    float r = f->reach;
+    int t[4];
+    f->tile_range(fminf(x0, x1) - r, fminf(y0, y1) - r, fmaxf(x0, x1) + r, fmaxf(y0, y1) + r, t);
+    Stale& st = *f->stale;
+    for (int ty = t[1]; ty <= t[3]; ty++) {
+        for (int tx = t[0]; tx <= t[2]; tx++) {
+            if (st.gen[(size_t)ty * (size_t)f->tiles_x + (size_t)tx].exchange(gen) == 0)
+                st.count.fetch_add(1);
+        }
+    }
+}
+
+bool static_sdf_rebake(float x0, float y0, float x1, float y1) {
+    if (!g_bake_mtx)
+        return false;
+    SDL_LockMutex(g_bake_mtx);
+    const Field* old = g_field.load();
+    if (!old) {
+        SDL_UnlockMutex(g_bake_mtx);
+        return false;
+    }
+    // The tiles invalidate marks for this rect, and what they are marked with now: a tile marked
+    // again while this runs may miss the newer change and stays stale
+    float reach = old->reach, cell = old->cell;
+    int t[4];
+    old->tile_range(fminf(x0, x1) - reach, fminf(y0, y1) - reach, fmaxf(x0, x1) + reach,
+                    fmaxf(y0, y1) + reach, t);
+    Stale& st = *old->stale;
+    std::vector<unsigned int> seen;
+    for (int ty = t[1]; ty <= t[3]; ty++) {
+        for (int tx = t[0]; tx <= t[2]; tx++) {
+            seen.push_back(st.gen[(size_t)ty * (size_t)old->tiles_x + (size_t)tx].load());
+        }
+    }
+
+    // The tiles' cells, and around them the grid the nearest segments are swept through: reach
+    // wide, so the sweep reaches the tiles from every side as in a full bake. A cell with no
+    // segment within reach is at least reach from any geometry and gets exactly that.
+    int i0 = t[0] * STATIC_SDF_TILE, j0 = t[1] * STATIC_SDF_TILE;
+    int i1 = SDL_min((t[2] + 1) * STATIC_SDF_TILE, old->w);
+    int j1 = SDL_min((t[3] + 1) * STATIC_SDF_TILE, old->h);
+    int pad = (int)ceilf(reach * old->inv_cell);
+    int gi0 = SDL_max(i0 - pad, 0), gj0 = SDL_max(j0 - pad, 0);
+    int gw = SDL_min(i1 + pad, old->w) - gi0, gh = SDL_min(j1 + pad, old->h) - gj0;
+    float gx = old->x0 + (float)gi0 * cell, gy = old->y0 + (float)gj0 * cell;
+    float ex = gx + (float)gw * cell, ey = gy + (float)gh * cell;
+    int n = physics_collect_static_segments_in(gx, gy, ex, ey, NULL, 0);
+    std::vector<Seg> segs((size_t)SDL_max(n, 1));
+    n = SDL_min(physics_collect_static_segments_in(gx, gy, ex, ey, &segs[0].ax, n), n);
+    std::vector<int> nearest;
+    std::vector<float> best;
+    nearest_segments(segs.data(), n, gx, gy, cell, gw, gh, nearest, best);
+    int w = i1 - i0, h = j1 - j0;
+    std::vector<unsigned char> inside((size_t)w * (size_t)h, 0);
+    physics_rasterize_static_solids(old->x0 + (float)i0 * cell, old->y0 + (float)j0 * cell, cell,
+                                    w, h, inside.data());
+
+    Field* f = new Field(*old);
+    for (int j = j0; j < j1; j++) {
+        for (int i = i0; i < i1; i++) {
+            size_t k = (size_t)(j - gj0) * (size_t)gw + (size_t)(i - gi0);
+            float d = nearest[k] >= 0 ? fminf(sqrtf(best[k]), reach) : reach;
+            f->at(i, j) = inside[(size_t)(j - j0) * (size_t)w + (size_t)(i - i0)] ? -d : d;
+        }
+    }
+    publish(f);
+    // After the swap: a query that sees a tile fresh also sees the field it was re-baked into
+    size_t k = 0;
+    for (int ty = t[1]; ty <= t[3]; ty++) {
+        for (int tx = t[0]; tx <= t[2]; tx++, k++) {
+            unsigned int g = seen[k];
+            std::atomic<unsigned int>& mark = st.gen[(size_t)ty * (size_t)f->tiles_x + (size_t)tx];
+            if (g && mark.compare_exchange_strong(g, 0u))
+                st.count.fetch_sub(1);
+        }
+    }
+    SDL_UnlockMutex(g_bake_mtx);
+    return true;
+}
+
+bool static_sdf_covers(float x0, float y0, float x1, float y1) {
+    Pin pin;
+    const Field* f = pin.f;
+    if (!f)
+        return false;
+    const Stale& st = *f->stale;
+    if (st.count.load() == 0)
+        return true;
+    // The gradient taps reach a cell past the ray
+    float c = f->cell;
+    int t[4];
+    f->tile_range(fminf(x0, x1) - c, fminf(y0, y1) - c, fmaxf(x0, x1) + c, fmaxf(y0, y1) + c, t);
+    for (int ty = t[1]; ty <= t[3]; ty++) {
+        for (int tx = t[0]; tx <= t[2]; tx++) {
+            if (st.gen[(size_t)ty * (size_t)f->tiles_x + (size_t)tx].load() != 0)
+                return false;
+        }
+    }
+    return true;
+}
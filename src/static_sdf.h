@@ -0,0 +1,53 @@
+#pragma once
+#include <stdbool.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Signed distance field of the static world, baked from the static collider outlines after the
+// map is loaded. Distances are in world units, negative inside solid fixtures (edges and chains
+// have no inside). Cells are stored in STATIC_SDF_TILE x STATIC_SDF_TILE tiles, each contiguous,
+// so the four cells of a bilinear sample almost always share a tile. A baked field is immutable
+// and published through an atomic pointer: queries take no lock and work from any thread. A
+// re-bake publishes a copy with some tiles replaced.
+// Kinematic and dynamic bodies are not part of the field.
+
+#define STATIC_SDF_TILE 8
+
+typedef struct {
+    bool hit;
+    float x, y;      // hit point (world)
+    float nx, ny;    // surface normal (field gradient)
+    float fraction;  // along the ray [0,1]
+} StaticSdfHit;
+
+// Bake from the current static fixtures. cell is the grid spacing (world units); margin extends
+// the field past the geometry bounds. Replaces any previous field. Returns false when there is no
+// static geometry.
+bool static_sdf_bake(float cell, float margin);
+void static_sdf_shutdown(void);
+bool static_sdf_ready(void);
+
+// Bilinear distance to the nearest static surface. Outside the baked area a conservative lower
+// bound is returned. Large positive when no field is baked.
+float static_sdf_distance(float x, float y);
+// Distance plus the unit gradient (pointing away from the nearest surface)
+float static_sdf_sample(float x, float y, float* gx, float* gy);
+// Sphere-traced ray from (x0,y0) to (x1,y1); a ray starting inside geometry hits at fraction 0
+StaticSdfHit static_sdf_raycast(float x0, float y0, float x1, float y1);
+
+// Static geometry changed inside the rect (destructible terrain): the tiles within the bake
+// margin of it are stale until static_sdf_rebake covers the rect. Marking a tile again is free,
+// so repeated changes in one place never pile up. Callable from any thread.
+void static_sdf_invalidate(float x0, float y0, float x1, float y1);
+// Re-bake the tiles static_sdf_invalidate marks for the rect from the current static fixtures
+// into a new published field, then clear their stale marks (a tile marked again meanwhile stays
+// stale). Takes the world read lock: meant for a worker thread. Returns false without a field.
+bool static_sdf_rebake(float x0, float y0, float x1, float y1);
+// True when a field is baked and the rect misses every stale tile, i.e. queries inside it can
+// use the field; callers fall back to Box2D otherwise
+bool static_sdf_covers(float x0, float y0, float x1, float y1);
+
+#ifdef __cplusplus
+}
+#endif
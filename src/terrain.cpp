@@ -0,0 +1,586 @@
+#include "terrain.h"
+#include <SDL3/SDL.h>
+#include <atomic>
+#include <cmath>
+#include <deque>
+#include <utility>
+#include <vector>
+#include "collider_opt.h"
+#include "config.h"
+#include "physics.h"
+#include "render/lighting.h"
+#include "render/pipeline.h"
+#include "static_sdf.h"
+
+#define TERRAIN_FRICTION 0.8f        // same as the map colliders
+#define TERRAIN_MAX_CELLS (1 << 20)  // the chunk size grows to stay under this
+#define TERRAIN_MAX_PENDING 32       // queued carve jobs
+#define TERRAIN_WELD 0.02f           // clipped vertices closer than this become one
+#define TERRAIN_TINT 0xffccccccu     // matches the map mesh tint
+#define TERRAIN_PI 3.14159265358979f
+
+namespace {
+
+struct Vert {
+    float x, y, u, v;
+};
+
+struct Poly {
+    std::vector<Vert> v;  // convex, counter-clockwise
+};
+
+struct SrcTri {
+    Vert v[3];
+    int flags;
+};
+
+struct Chunk {
+    int flags;
+    float x0, y0, x1, y1;       // cell rect
+    bool sdf_queued;            // g_mtx: waiting for a distance field re-bake
+    std::vector<Poly> pieces;   // worker (and terrain_build)
+    b2Body* body;               // sim thread
+    std::vector<float> xy, uv;  // main thread: triangles
+};
+
+// One rebuilt chunk on its way from the worker through the sim thread to the main thread
+struct Result {
+    int chunk;
+    PhysicsShapeSet* shapes;
+    std::vector<float> xy, uv;
+    std::vector<float> occluders;  // x0,y0,x1,y1 per piece edge
+};
+
+struct Job {
+    float x, y, r;
+};
+
+static std::vector<SrcTri> g_src;
+static std::vector<Chunk> g_chunks;
+static std::vector<std::vector<int>> g_cells;  // chunk indices per grid cell, fixed after build
+static float g_grid_x0, g_grid_y0, g_chunk_size;
+static int g_grid_w, g_grid_h;
+static unsigned int g_texture;
+static std::vector<unsigned int> g_tint;
+
+static SDL_Thread* g_worker = nullptr;
+static SDL_Semaphore* g_kick = nullptr;
+static SDL_Mutex* g_mtx = nullptr;  // the four queues below
+static std::deque<Job> g_jobs;
+static std::deque<int> g_rebakes;     // chunks swapped in, for the distance field
+static std::deque<Result*> g_ready;   // worker -> sim thread
+static std::deque<Result*> g_visual;  // sim thread -> main thread
+static std::atomic<int> g_ready_count{0};
+static std::atomic<int> g_pending{0};  // carve and re-bake jobs queued or running
+static bool g_deterministic = false;
+static std::atomic<bool> g_quit{false};
+
+static std::atomic<int> g_piece_count{0};
+static std::atomic<unsigned int> g_carves{0};
+static std::atomic<unsigned int> g_rebuilt{0};
+static std::atomic<unsigned int> g_dropped{0};
+static std::atomic<unsigned int> g_sdf_rebakes{0};
+static std::atomic<float> g_last_worker_ms{0.0f};
+static std::atomic<float> g_max_apply_us{0.0f};
+
+static float poly_area(const std::vector<Vert>& p) {
+    float a = 0.0f;
+    for (size_t i = 0, n = p.size(); i < n; i++) {
+        const Vert& s = p[i];
+        const Vert& t = p[(i + 1) % n];
+        a += s.x * t.y - s.y * t.x;
+    }
+    return 0.5f * a;
+}
+
+// Keep the part of in with nx*x + ny*y <= d (Sutherland-Hodgman, attributes interpolated)
+static void clip(const std::vector<Vert>& in, float nx, float ny, float d, std::vector<Vert>& out) {
+    out.clear();
+    size_t n = in.size();
+    for (size_t i = 0; i < n; i++) {
+        const Vert& a = in[i];
+        const Vert& b = in[(i + 1) % n];
+        float da = nx * a.x + ny * a.y - d;
+        float db = nx * b.x + ny * b.y - d;
+        if (da <= 0.0f)
+            out.push_back(a);
+        if ((da < 0.0f && db > 0.0f) || (da > 0.0f && db < 0.0f)) {
+            float t = da / (da - db);
+            out.push_back(Vert{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t,
+                               a.u + (b.u - a.u) * t, a.v + (b.v - a.v) * t});
+        }
+    }
+}
+
+// Weld near-duplicate neighbours and keep the polygon when it is still big enough
+static void emit(const std::vector<Vert>& p, float min_area, std::vector<Poly>& out) {
+    Poly q;
+    q.v.reserve(p.size());
+    for (const Vert& v : p) {
+        if (!q.v.empty() && fabsf(v.x - q.v.back().x) < TERRAIN_WELD &&
+            fabsf(v.y - q.v.back().y) < TERRAIN_WELD)
+            continue;
+        q.v.push_back(v);
+    }
+    while (q.v.size() > 1 && fabsf(q.v.front().x - q.v.back().x) < TERRAIN_WELD &&
+           fabsf(q.v.front().y - q.v.back().y) < TERRAIN_WELD)
+        q.v.pop_back();
+    if (q.v.size() >= 3 && poly_area(q.v) >= min_area)
+        out.push_back(std::move(q));
+}
+
+// Separating axis test between two convex counter-clockwise polygons
+static bool separated_by(const std::vector<Vert>& a, const std::vector<Vert>& b) {
+    for (size_t i = 0, n = a.size(); i < n; i++) {
+        const Vert& p = a[i];
+        const Vert& q = a[(i + 1) % n];
+        float nx = q.y - p.y, ny = p.x - q.x;  // outward
+        float d = nx * p.x + ny * p.y;
+        bool all_out = true;
+        for (const Vert& v : b) {
+            if (nx * v.x + ny * v.y < d) {
+                all_out = false;
+                break;
+            }
+        }
+        if (all_out)
+            return true;
+    }
+    return false;
+}
+
+static bool overlaps(const std::vector<Vert>& a, const std::vector<Vert>& b) {
+    return !separated_by(a, b) && !separated_by(b, a);
+}
+
+// a minus the convex hole: the part outside each hole edge in turn, as convex pieces
+static void subtract(const Poly& a, const std::vector<Vert>& hole, std::vector<Poly>& out) {
+    std::vector<Vert> cur = a.v, rest, outside;
+    for (size_t i = 0, n = hole.size(); i < n && cur.size() >= 3; i++) {
+        const Vert& p = hole[i];
+        const Vert& q = hole[(i + 1) % n];
+        float nx = q.y - p.y, ny = p.x - q.x;
+        float d = nx * p.x + ny * p.y;
+        clip(cur, -nx, -ny, -d, outside);
+        emit(outside, APP_TERRAIN_MIN_AREA, out);
+        clip(cur, nx, ny, d, rest);
+        cur.swap(rest);
+    }
+}
+
+static int cell_x(float x) {
+    return SDL_clamp((int)floorf((x - g_grid_x0) / g_chunk_size), 0, g_grid_w - 1);
+}
+
+static int cell_y(float y) {
+    return SDL_clamp((int)floorf((y - g_grid_y0) / g_chunk_size), 0, g_grid_h - 1);
+}
+
+// Worker side of a chunk rebuild: triangles, merged collider shapes and occluder edges
+static Result* build_result(int ci) {
+    const Chunk& c = g_chunks[(size_t)ci];
+    Result* r = new Result();
+    r->chunk = ci;
+    for (const Poly& p : c.pieces) {
+        const std::vector<Vert>& v = p.v;
+        for (size_t k = 1; k + 1 < v.size(); k++) {
+            const Vert* t[3] = {&v[0], &v[k], &v[k + 1]};
+            for (const Vert* e : t) {
+                r->xy.push_back(e->x);
+                r->xy.push_back(e->y);
+                r->uv.push_back(e->u);
+                r->uv.push_back(e->v);
+            }
+        }
+        for (size_t k = 0; k < v.size(); k++) {
+            const Vert& a = v[k];
+            const Vert& b = v[(k + 1) % v.size()];
+            r->occluders.insert(r->occluders.end(), {a.x, a.y, b.x, b.y});
+        }
+    }
+    r->shapes = nullptr;
+    if (!r->xy.empty()) {
+        ColliderOptConfig oc = collider_opt_default_config();
+        oc.weld_eps = APP_COLLIDER_WELD_EPS;
+        oc.merge_polygons = APP_COLLIDER_MERGE != 0;
+        oc.boundary_loops = false;
+        ColliderOptMesh m;
+        if (collider_opt_build(r->xy.data(), (int)(r->xy.size() / 2), &oc, &m)) {
+            std::vector<int> flags((size_t)m.poly_count, c.flags | PHYS_FLAG_DESTRUCTIBLE);
+            r->shapes = physics_shape_set_create(m.xy, m.poly_counts, flags.data(), m.poly_count);
+        }
+        collider_opt_free(&m);
+    }
+    if (!r->shapes)
+        r->shapes = physics_shape_set_create(nullptr, nullptr, nullptr, 0);
+    return r;
+}
+
+static void apply_body(Result* r) {
+    Chunk& c = g_chunks[(size_t)r->chunk];
+    c.body = physics_swap_static_body(c.body, r->shapes, TERRAIN_FRICTION);
+    physics_shape_set_destroy(r->shapes);
+    r->shapes = nullptr;
+}
+
+static void apply_visual(Result* r) {
+    Chunk& c = g_chunks[(size_t)r->chunk];
+    c.xy.swap(r->xy);
+    c.uv.swap(r->uv);
+    lighting_set_occluder_group(r->chunk, r->occluders.data(), (int)(r->occluders.size() / 4));
+    if (g_tint.size() < c.xy.size() / 2)
+        g_tint.resize(c.xy.size() / 2, TERRAIN_TINT);
+}
+
+static void carve(const Job& job) {
+    Uint64 t0 = SDL_GetTicksNS();
+    std::vector<Vert> hole((size_t)APP_TERRAIN_CARVE_SIDES);
+    for (int i = 0; i < APP_TERRAIN_CARVE_SIDES; i++) {
+        float a = 2.0f * TERRAIN_PI * (float)i / (float)APP_TERRAIN_CARVE_SIDES;
+        hole[(size_t)i] = Vert{job.x + cosf(a) * job.r, job.y + sinf(a) * job.r, 0.0f, 0.0f};
+    }
+    int pieces_delta = 0;
+    std::vector<Poly> next;
+    int cx0 = cell_x(job.x - job.r), cx1 = cell_x(job.x + job.r);
+    int cy0 = cell_y(job.y - job.r), cy1 = cell_y(job.y + job.r);
+    for (int cy = cy0; cy <= cy1; cy++) {
+        for (int cx = cx0; cx <= cx1; cx++) {
+            for (int ci : g_cells[(size_t)cy * (size_t)g_grid_w + (size_t)cx]) {
+                Chunk& c = g_chunks[(size_t)ci];
+                bool changed = false;
+                next.clear();
+                for (Poly& p : c.pieces) {
+                    if (!overlaps(p.v, hole)) {
+                        next.push_back(std::move(p));
+                        continue;
+                    }
+                    changed = true;
+                    subtract(p, hole, next);
+                }
+                pieces_delta += (int)next.size() - (int)c.pieces.size();
+                c.pieces.swap(next);
+                if (!changed)
+                    continue;
+                Result* r = build_result(ci);
+                SDL_LockMutex(g_mtx);
+                g_ready.push_back(r);
+                SDL_UnlockMutex(g_mtx);
+                g_ready_count.fetch_add(1, std::memory_order_release);
+            }
+        }
+    }
+    g_piece_count.fetch_add(pieces_delta, std::memory_order_relaxed);
+    g_carves.fetch_add(1, std::memory_order_relaxed);
+    g_last_worker_ms.store((float)((SDL_GetTicksNS() - t0) / 1.0e6), std::memory_order_relaxed);
+}
+
+static int terrain_worker(void* ud) {
+    (void)ud;
+    for (;;) {
+        SDL_WaitSemaphore(g_kick);
+        if (g_quit.load(std::memory_order_acquire))
+            break;
+        SDL_LockMutex(g_mtx);
+        if (!g_rebakes.empty()) {
+            // Cleared first: a swap from here on queues the chunk again
+            int ci = g_rebakes.front();
+            g_rebakes.pop_front();
+            Chunk& c = g_chunks[(size_t)ci];
+            c.sdf_queued = false;
+            SDL_UnlockMutex(g_mtx);
+            if (static_sdf_rebake(c.x0, c.y0, c.x1, c.y1))
+                g_sdf_rebakes.fetch_add(1, std::memory_order_relaxed);
+            g_pending.fetch_sub(1, std::memory_order_release);
+            continue;
+        }
+        if (g_jobs.empty()) {
+            SDL_UnlockMutex(g_mtx);
+            continue;
+        }
+        Job job = g_jobs.front();
+        g_jobs.pop_front();
+        SDL_UnlockMutex(g_mtx);
+        carve(job);
+        g_pending.fetch_sub(1, std::memory_order_release);
+    }
+    return 0;
+}
+
+}  // namespace
+
+void terrain_add_region(const float* xyz, const float* uv, int vertex_count, int flags) {
+    if (!xyz || vertex_count < 3)
+        return;
+    for (int i = 0; i + 2 < vertex_count; i += 3) {
+        SrcTri t;
+        for (int k = 0; k < 3; k++) {
+            int v = i + k;
+            t.v[k] = Vert{xyz[v * 3 + 0], xyz[v * 3 + 1], uv ? uv[v * 2 + 0] : 0.0f,
+                          uv ? uv[v * 2 + 1] : 0.0f};
+        }
+        // Counter-clockwise like the Box2D polygons; degenerate ones are left out
+        float cross = (t.v[1].x - t.v[0].x) * (t.v[2].y - t.v[0].y) -
+                      (t.v[1].y - t.v[0].y) * (t.v[2].x - t.v[0].x);
+        if (fabsf(cross) < 1e-6f)
+            continue;
+        if (cross < 0.0f)
+            std::swap(t.v[1], t.v[2]);
+        t.flags = flags;
+        g_src.push_back(t);
+    }
+}
+
+void terrain_set_texture(unsigned int texture) {
+    g_texture = texture;
+}
+
+bool terrain_build(void) {
+    if (g_src.empty())
+        return false;
+    Uint64 t0 = SDL_GetTicksNS();
+    float minx = INFINITY, miny = INFINITY, maxx = -INFINITY, maxy = -INFINITY;
+    for (const SrcTri& t : g_src) {
+        for (const Vert& v : t.v) {
+            minx = fminf(minx, v.x);
+            miny = fminf(miny, v.y);
+            maxx = fmaxf(maxx, v.x);
+            maxy = fmaxf(maxy, v.y);
+        }
+    }
+    g_chunk_size = APP_TERRAIN_CHUNK;
+    for (;;) {
+        g_grid_w = (int)((maxx - minx) / g_chunk_size) + 1;
+        g_grid_h = (int)((maxy - miny) / g_chunk_size) + 1;
+        if ((size_t)g_grid_w * (size_t)g_grid_h <= TERRAIN_MAX_CELLS)
+            break;
+        g_chunk_size *= 2.0f;
+    }
+    g_grid_x0 = minx;
+    g_grid_y0 = miny;
+    g_cells.assign((size_t)g_grid_w * (size_t)g_grid_h, std::vector<int>());
+
+    // Every triangle clipped to the cells it overlaps; one chunk per cell and flag set
+    std::vector<Vert> a, b;
+    std::vector<Poly> out;
+    for (const SrcTri& t : g_src) {
+        float tx0 = fminf(t.v[0].x, fminf(t.v[1].x, t.v[2].x));
+        float tx1 = fmaxf(t.v[0].x, fmaxf(t.v[1].x, t.v[2].x));
+        float ty0 = fminf(t.v[0].y, fminf(t.v[1].y, t.v[2].y));
+        float ty1 = fmaxf(t.v[0].y, fmaxf(t.v[1].y, t.v[2].y));
+        for (int cy = cell_y(ty0); cy <= cell_y(ty1); cy++) {
+            for (int cx = cell_x(tx0); cx <= cell_x(tx1); cx++) {
+                float x0 = g_grid_x0 + (float)cx * g_chunk_size, x1 = x0 + g_chunk_size;
+                float y0 = g_grid_y0 + (float)cy * g_chunk_size, y1 = y0 + g_chunk_size;
+                a.assign(t.v, t.v + 3);
+                clip(a, 1.0f, 0.0f, x1, b);
+                clip(b, -1.0f, 0.0f, -x0, a);
+                clip(a, 0.0f, 1.0f, y1, b);
+                clip(b, 0.0f, -1.0f, -y0, a);
+                out.clear();
+                emit(a, 1e-4f, out);
+                if (out.empty())
+                    continue;
+                std::vector<int>& cell = g_cells[(size_t)cy * (size_t)g_grid_w + (size_t)cx];
+                int ci = -1;
+                for (int k : cell) {
+                    if (g_chunks[(size_t)k].flags == t.flags)
+                        ci = k;
+                }
+                if (ci < 0) {
+                    ci = (int)g_chunks.size();
+                    g_chunks.emplace_back();
+                    Chunk& c = g_chunks.back();
+                    c.flags = t.flags;
+                    c.x0 = x0;
+                    c.y0 = y0;
+                    c.x1 = x1;
+                    c.y1 = y1;
+                    c.sdf_queued = false;
+                    c.body = nullptr;
+                    cell.push_back(ci);
+                }
+                g_chunks[(size_t)ci].pieces.push_back(std::move(out[0]));
+            }
+        }
+    }
+    g_src.clear();
+    g_src.shrink_to_fit();
+
+    int pieces = 0, fixtures = 0;
+    for (size_t i = 0; i < g_chunks.size(); i++) {
+        pieces += (int)g_chunks[i].pieces.size();
+        Result* r = build_result((int)i);
+        fixtures += physics_shape_set_count(r->shapes);
+        apply_body(r);
+        apply_visual(r);
+        delete r;
+    }
+    g_piece_count.store(pieces, std::memory_order_relaxed);
+
+    g_mtx = SDL_CreateMutex();
+    g_kick = SDL_CreateSemaphore(0);
+    g_quit.store(false, std::memory_order_release);
+    g_worker = SDL_CreateThread(terrain_worker, "terrain", nullptr);
+    SDL_Log("terrain: %d chunks of %.0f, %d pieces, %d fixtures, built in %.1f ms",
+            (int)g_chunks.size(), g_chunk_size, pieces, fixtures,
+            (SDL_GetTicksNS() - t0) / 1.0e6);
+    return g_mtx && g_kick && g_worker;
+}
+
+void terrain_shutdown(void) {
+    if (g_worker) {
+        g_quit.store(true, std::memory_order_release);
+        SDL_SignalSemaphore(g_kick);
+        SDL_WaitThread(g_worker, nullptr);
+        g_worker = nullptr;
+    }
+    for (Result* r : g_ready) {
+        physics_shape_set_destroy(r->shapes);
+        delete r;
+    }
+    for (Result* r : g_visual) {
+        delete r;
+    }
+    g_ready.clear();
+    g_visual.clear();
+    g_jobs.clear();
+    g_rebakes.clear();
+    g_ready_count.store(0, std::memory_order_relaxed);
+    g_pending.store(0, std::memory_order_relaxed);
+    g_deterministic = false;
+    if (g_kick)
+        SDL_DestroySemaphore(g_kick);
+    if (g_mtx)
+        SDL_DestroyMutex(g_mtx);
+    g_kick = nullptr;
+    g_mtx = nullptr;
+    // Chunk bodies go with the world in physics_shutdown, occluder groups in lighting_shutdown
+    g_chunks.clear();
+    g_cells.clear();
+    g_src.clear();
+    g_tint.clear();
+    g_texture = 0;
+}
+
+bool terrain_carve(float x, float y, float radius) {
+    if (!g_worker || radius <= 0.0f)
+        return false;
+    if (x + radius < g_grid_x0 || y + radius < g_grid_y0 ||
+        x - radius > g_grid_x0 + (float)g_grid_w * g_chunk_size ||
+        y - radius > g_grid_y0 + (float)g_grid_h * g_chunk_size)
+        return false;
+    bool any = false;
+    for (int cy = cell_y(y - radius); cy <= cell_y(y + radius) && !any; cy++) {
+        for (int cx = cell_x(x - radius); cx <= cell_x(x + radius) && !any; cx++) {
+            any = !g_cells[(size_t)cy * (size_t)g_grid_w + (size_t)cx].empty();
+        }
+    }
+    if (!any)
+        return false;
+    SDL_LockMutex(g_mtx);
+    bool queued = g_jobs.size() < TERRAIN_MAX_PENDING;
+    if (queued) {
+        g_jobs.push_back(Job{x, y, radius});
+        g_pending.fetch_add(1, std::memory_order_relaxed);
+    }
+    SDL_UnlockMutex(g_mtx);
+    if (!queued) {
+        g_dropped.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    SDL_SignalSemaphore(g_kick);
+    return true;
+}
+
+void terrain_set_deterministic(bool on) {
+    g_deterministic = on;
+}
+
+void terrain_apply(void) {
+    // Deterministic: the carves queued this tick land this tick, however long the worker takes
+    while (g_deterministic && g_pending.load(std::memory_order_acquire) > 0)
+        SDL_DelayNS(20000);
+    if (g_ready_count.load(std::memory_order_acquire) == 0)
+        return;
+    Uint64 t0 = SDL_GetTicksNS();
+    Uint64 budget = g_deterministic ? UINT64_MAX : (Uint64)APP_TERRAIN_APPLY_BUDGET_US * 1000u;
+    do {
+        SDL_LockMutex(g_mtx);
+        Result* r = nullptr;
+        if (!g_ready.empty()) {
+            r = g_ready.front();
+            g_ready.pop_front();
+        }
+        SDL_UnlockMutex(g_mtx);
+        if (!r)
+            break;
+        g_ready_count.fetch_sub(1, std::memory_order_relaxed);
+        apply_body(r);
+        Chunk& c = g_chunks[(size_t)r->chunk];
+        static_sdf_invalidate(c.x0, c.y0, c.x1, c.y1);
+        g_rebuilt.fetch_add(1, std::memory_order_relaxed);
+        SDL_LockMutex(g_mtx);
+        bool rebake = !c.sdf_queued;
+        if (rebake) {
+            c.sdf_queued = true;
+            g_rebakes.push_back(r->chunk);
+            g_pending.fetch_add(1, std::memory_order_relaxed);
+        }
+        // A newer rebuild of a chunk supersedes the one the main thread has not picked up yet
+        Result* stale = nullptr;
+        for (Result*& v : g_visual) {
+            if (v->chunk == r->chunk) {
+                stale = v;
+                v = r;
+                break;
+            }
+        }
+        if (!stale)
+            g_visual.push_back(r);
+        SDL_UnlockMutex(g_mtx);
+        delete stale;
+        if (rebake)
+            SDL_SignalSemaphore(g_kick);
+    } while (SDL_GetTicksNS() - t0 < budget);
+    // Deterministic: so are the re-baked field tiles, for the rays cast after this stage
+    while (g_deterministic && g_pending.load(std::memory_order_acquire) > 0)
+        SDL_DelayNS(20000);
+    float us = (float)((SDL_GetTicksNS() - t0) / 1.0e3);
+    if (us > g_max_apply_us.load(std::memory_order_relaxed))
+        g_max_apply_us.store(us, std::memory_order_relaxed);
+}
+
+void terrain_render(float x0, float y0, float x1, float y1) {
+    if (g_chunks.empty())
+        return;
+    if (g_mtx) {
+        std::deque<Result*> done;
+        SDL_LockMutex(g_mtx);
+        done.swap(g_visual);
+        SDL_UnlockMutex(g_mtx);
+        for (Result* r : done) {
+            apply_visual(r);
+            delete r;
+        }
+    }
+    float minx = fminf(x0, x1), miny = fminf(y0, y1), maxx = fmaxf(x0, x1), maxy = fmaxf(y0, y1);
+    for (const Chunk& c : g_chunks) {
+        if (c.xy.empty() || c.x1 < minx || c.x0 > maxx || c.y1 < miny || c.y0 > maxy)
+            continue;
+        pipeline_sprite_triangles(c.xy.data(), c.uv.data(), g_tint.data(),
+                                  (unsigned int)(c.xy.size() / 2), g_texture);
+    }
+}
+
+void terrain_get_stats(TerrainStats* out) {
+    if (!out)
+        return;
+    out->chunks = (int)g_chunks.size();
+    out->pieces = g_piece_count.load(std::memory_order_relaxed);
+    out->carves = g_carves.load(std::memory_order_relaxed);
+    out->rebuilt_chunks = g_rebuilt.load(std::memory_order_relaxed);
+    out->dropped_carves = g_dropped.load(std::memory_order_relaxed);
+    out->sdf_rebakes = g_sdf_rebakes.load(std::memory_order_relaxed);
+    out->last_worker_ms = g_last_worker_ms.load(std::memory_order_relaxed);
+    out->max_apply_us = g_max_apply_us.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,60 @@
+#pragma once
+#include <stdbool.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Destructible terrain. Map shapes tagged "Destructible" are cut into a grid of chunks
+// (APP_TERRAIN_CHUNK); a chunk keeps its geometry as convex pieces and owns one static body
+// (fixtures flagged PHYS_FLAG_DESTRUCTIBLE), its own textured triangles and its own light
+// occluder group. An explosion carves a polygon out of the chunks it touches:
+// - worker thread: subtract the polygon from the touched pieces, re-merge the chunk collider
+//   (collider_opt) and prepare its Box2D shapes, without the world lock
+// - sim thread, between steps (terrain_apply): swap each rebuilt chunk body in under one write
+//   lock, mark the chunk stale in the static distance field and queue it for a re-bake (once,
+//   however often it is swapped before the worker gets to it)
+// - worker thread: re-bake the field tiles around the chunk, which clears its stale mark
+// - main thread (terrain_render): swap the chunk triangles and occluders
+// Chunks the carve misses are never touched. They draw in the sprite pass (the mesh pass would
+// re-sort the whole map after every carve), in the gameplay plane under the other sprites.
+// Static bodies are not part of physics snapshots, so craters survive a checkpoint restore.
+
+typedef struct {
+    int chunks;
+    int pieces;                   // convex pieces over all chunks
+    unsigned int carves;          // carve jobs finished by the worker
+    unsigned int rebuilt_chunks;  // chunk rebuilds swapped in
+    unsigned int dropped_carves;  // carve requests refused because the queue was full
+    unsigned int sdf_rebakes;     // distance field re-bakes after chunk swaps
+    float last_worker_ms;         // worker time of the last carve job
+    float max_apply_us;           // longest terrain_apply so far
+} TerrainStats;
+
+// Load time, before terrain_build: vertex_count (x,y,z) points, three per triangle, with one
+// (u,v) pair each (uv may be NULL). flags (PHYS_FLAG_*) are added to the region's fixtures.
+void terrain_add_region(const float* xyz, const float* uv, int vertex_count, int flags);
+// Texture of the chunk triangles (the map texture)
+void terrain_set_texture(unsigned int texture);
+// Cut the regions into chunks, create their bodies and occluders and start the carve worker.
+// Call once after the map is loaded, before the static distance field is baked.
+bool terrain_build(void);
+void terrain_shutdown(void);
+
+// Any thread: carve a circle of the given radius (an APP_TERRAIN_CARVE_SIDES-gon) around (x,y).
+// Returns false when no chunk is in range or the carve queue is full.
+bool terrain_carve(float x, float y, float radius);
+// Sim thread, between physics steps: swap in chunk bodies rebuilt by the worker, for at most
+// APP_TERRAIN_APPLY_BUDGET_US (at least one chunk)
+void terrain_apply(void);
+// Record and replay: terrain_apply first waits for every queued carve, then swaps in all rebuilt
+// chunks and waits for their field re-bakes, so craters land on the tick of their explosion on
+// every run
+void terrain_set_deterministic(bool on);
+// Main thread, between pipeline begin/end: pick up rebuilt chunk triangles and occluders, then
+// submit the chunks overlapping the world rect (x0,y0)-(x1,y1)
+void terrain_render(float x0, float y0, float x1, float y1);
+void terrain_get_stats(TerrainStats* out);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,178 @@
+#include "tick_timer.h"
+#include <SDL3/SDL.h>
+#include <string.h>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <errno.h>
+#include <time.h>
+#endif
+#if defined(__linux__) || defined(__FreeBSD__) || defined(__NetBSD__)
+#define TICK_TIMER_ABSTIME 1  // clock_nanosleep with TIMER_ABSTIME
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TICK_TIMER_PAUSE() _mm_pause()
+#elif defined(__aarch64__)
+#define TICK_TIMER_PAUSE() __asm__ __volatile__("yield")
+#else
+#define TICK_TIMER_PAUSE() ((void)0)
+#endif
+
+#define TICK_TIMER_MAX_REGISTERED 8
+
+const uint32_t kTickTimerBucketUs[TICK_TIMER_BUCKETS] = {10, 25, 50, 100, 250, 500, 1000,
+                                                         UINT32_MAX};
+
+static TickTimer* _Atomic g_timers[TICK_TIMER_MAX_REGISTERED];
+
+uint64_t tick_timer_now_ns(void) {
+#if defined(TICK_TIMER_ABSTIME)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+#else
+    return SDL_GetTicksNS();
+#endif
+}
+
+static void sleep_until(uint64_t deadline_ns) {
+#if defined(TICK_TIMER_ABSTIME)
+    struct timespec ts;
+    ts.tv_sec = (time_t)(deadline_ns / 1000000000ull);
+    ts.tv_nsec = (long)(deadline_ns % 1000000000ull);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+    }
+#else
+    uint64_t now = tick_timer_now_ns();
+    if (deadline_ns > now)
+        SDL_DelayNS(deadline_ns - now);
+#endif
+}
+
+void tick_timer_init(TickTimer* t, const char* name, uint64_t period_ns, uint64_t spin_ns) {
+    memset(t, 0, sizeof(*t));
+    t->name = name ? name : "timer";
+    t->period_ns = period_ns ? period_ns : 1000000;
+    t->spin_ns = spin_ns;
+    t->next_ns = tick_timer_now_ns() + t->period_ns;
+    t->window_start_ns = t->next_ns - t->period_ns;
+    for (int i = 0; i < TICK_TIMER_MAX_REGISTERED; i++) {
+        TickTimer* expected = NULL;
+        if (atomic_compare_exchange_strong(&g_timers[i], &expected, t))
+            break;
+    }
+}
+
+void tick_timer_destroy(TickTimer* t) {
+    for (int i = 0; i < TICK_TIMER_MAX_REGISTERED; i++) {
+        TickTimer* expected = t;
+        if (atomic_compare_exchange_strong(&g_timers[i], &expected, NULL))
+            break;
+    }
+}
+
+void tick_timer_set_period(TickTimer* t, uint64_t period_ns) {
+    if (!period_ns || period_ns == t->period_ns)
+        return;
+    // Re-anchor on the previous deadline so the switch does not produce a burst of catch-up ticks
+    t->next_ns = t->next_ns - t->period_ns + period_ns;
+    t->period_ns = period_ns;
+}
+
+static void record_wakeup(TickTimer* t, uint64_t now, uint64_t deadline) {
+    uint64_t late_us = now > deadline ? (now - deadline) / 1000 : 0;
+    int b = 0;
+    while (b < TICK_TIMER_BUCKETS - 1 && late_us >= kTickTimerBucketUs[b])
+        b++;
+    atomic_fetch_add_explicit(&t->late_hist[b], 1, memory_order_relaxed);
+    if (late_us > atomic_load_explicit(&t->max_late_us, memory_order_relaxed))
+        atomic_store_explicit(&t->max_late_us, (unsigned)late_us, memory_order_relaxed);
+
+    t->window_wakeups++;
+    uint64_t span = now - t->window_start_ns;
+    if (span >= 1000000000ull) {
+        unsigned rate = (unsigned)((uint64_t)t->window_wakeups * 1000000000ull / span);
+        atomic_store_explicit(&t->wakeups_per_sec, rate, memory_order_relaxed);
+        t->window_wakeups = 0;
+        t->window_start_ns = now;
+    }
+}
+
+int tick_timer_wait(TickTimer* t) {
+    uint64_t deadline = t->next_ns;
+    uint64_t now = tick_timer_now_ns();
+    if (now + t->spin_ns < deadline)
+        sleep_until(deadline - t->spin_ns);
+    // Final stretch: spin instead of trusting the scheduler with the last microseconds
+    while ((now = tick_timer_now_ns()) < deadline)
+        TICK_TIMER_PAUSE();
+    record_wakeup(t, now, deadline);
+
+    uint64_t behind = (now - deadline) / t->period_ns;
+    if (behind >= TICK_TIMER_MAX_CATCHUP) {
+        // Too far behind (debugger, suspend): drop the backlog instead of fast-forwarding
+        atomic_fetch_add_explicit(&t->dropped, behind + 1 - TICK_TIMER_MAX_CATCHUP,
+                                  memory_order_relaxed);
+        t->next_ns = now + t->period_ns;
+        return TICK_TIMER_MAX_CATCHUP;
+    }
+    t->next_ns = deadline + (behind + 1) * t->period_ns;
+    return (int)behind + 1;
+}
+
+int tick_timer_drop_backlog(TickTimer* t) {
+    uint64_t now = tick_timer_now_ns();
+    if (now < t->next_ns)
+        return 0;
+    uint64_t due = (now - t->next_ns) / t->period_ns + 1;
+    atomic_fetch_add_explicit(&t->dropped, due, memory_order_relaxed);
+    t->next_ns += due * t->period_ns;
+    return (int)due;
+}
+
+int tick_timer_count(void) {
+    int n = 0;
+    for (int i = 0; i < TICK_TIMER_MAX_REGISTERED; i++) {
+        if (atomic_load(&g_timers[i]))
+            n++;
+    }
+    return n;
+}
+
+bool tick_timer_get_stats(int index, TickTimerStats* out) {
+    if (!out)
+        return false;
+    for (int i = 0; i < TICK_TIMER_MAX_REGISTERED; i++) {
+        TickTimer* t = atomic_load(&g_timers[i]);
+        if (!t || index-- > 0)
+            continue;
+        out->name = t->name;
+        out->period_us = (uint32_t)(t->period_ns / 1000);
+        out->wakeups_per_sec = atomic_load_explicit(&t->wakeups_per_sec, memory_order_relaxed);
+        out->max_late_us = atomic_load_explicit(&t->max_late_us, memory_order_relaxed);
+        for (int b = 0; b < TICK_TIMER_BUCKETS; b++) {
+            out->late_hist[b] = atomic_load_explicit(&t->late_hist[b], memory_order_relaxed);
+        }
+        out->dropped = atomic_load_explicit(&t->dropped, memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+void tick_timer_log_stats(const TickTimer* t) {
+    char line[256];
+    int n = 0;
+    for (int b = 0; b < TICK_TIMER_BUCKETS && n < (int)sizeof(line); b++) {
+        unsigned long long c = atomic_load_explicit(&t->late_hist[b], memory_order_relaxed);
+        if (kTickTimerBucketUs[b] == UINT32_MAX)
+            n += SDL_snprintf(line + n, sizeof(line) - (size_t)n, " >=%uus:%llu",
+                              kTickTimerBucketUs[b - 1], c);
+        else
+            n += SDL_snprintf(line + n, sizeof(line) - (size_t)n, " <%uus:%llu",
+                              kTickTimerBucketUs[b], c);
+    }
+    SDL_Log("timer %s: %u wakeups/s, max late %u us, %llu periods dropped, lateness%s", t->name,
+            atomic_load_explicit(&t->wakeups_per_sec, memory_order_relaxed),
+            atomic_load_explicit(&t->max_late_us, memory_order_relaxed),
+            (unsigned long long)atomic_load_explicit(&t->dropped, memory_order_relaxed), line);
+}
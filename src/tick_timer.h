@@ -0,0 +1,62 @@
+#pragma once
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdint.h>
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Absolute-deadline tick timer for fixed-rate threads. Sleeps with clock_nanosleep(TIMER_ABSTIME)
+// on POSIX (SDL_DelayNS elsewhere) until spin_ns before the deadline, then spins the rest.
+// Deadlines advance by whole periods, so sleep error never accumulates into drift.
+// Every timer records wakeups per second and a histogram of wakeup lateness.
+
+#define TICK_TIMER_BUCKETS 8
+#define TICK_TIMER_MAX_CATCHUP 8  // periods returned by one wait before dropping time
+
+// Upper bounds of the lateness histogram buckets in microseconds (last bucket is open)
+extern const uint32_t kTickTimerBucketUs[TICK_TIMER_BUCKETS];
+
+typedef struct {
+    const char* name;
+    uint64_t period_ns;
+    uint64_t spin_ns;
+    uint64_t next_ns;  // absolute deadline of the next wakeup
+    uint64_t window_start_ns;
+    uint32_t window_wakeups;
+    atomic_uint wakeups_per_sec;
+    atomic_uint max_late_us;
+    atomic_ullong late_hist[TICK_TIMER_BUCKETS];
+    atomic_ullong dropped;  // periods skipped instead of being caught up
+} TickTimer;
+
+typedef struct {
+    const char* name;
+    uint32_t period_us;
+    uint32_t wakeups_per_sec;
+    uint32_t max_late_us;
+    uint64_t late_hist[TICK_TIMER_BUCKETS];
+    uint64_t dropped;
+} TickTimerStats;
+
+uint64_t tick_timer_now_ns(void);
+
+// Registers the timer for tick_timer_get_stats; name must stay valid (string literal)
+void tick_timer_init(TickTimer* t, const char* name, uint64_t period_ns, uint64_t spin_ns);
+void tick_timer_destroy(TickTimer* t);
+// Takes effect from the next deadline
+void tick_timer_set_period(TickTimer* t, uint64_t period_ns);
+// Block until the next deadline. Returns the number of periods due (1 when on time, more when
+// the caller fell behind, at most TICK_TIMER_MAX_CATCHUP).
+int tick_timer_wait(TickTimer* t);
+// Skip every period already due (the caller chose not to catch up). Returns how many were dropped.
+int tick_timer_drop_backlog(TickTimer* t);
+
+// Registered timers, one per timed thread
+int tick_timer_count(void);
+bool tick_timer_get_stats(int index, TickTimerStats* out);
+void tick_timer_log_stats(const TickTimer* t);
+
+#ifdef __cplusplus
+}
+#endif
@@ -3,9 +3,16 @@
 #include <string.h>
 
 #define MAX_TRIGGERS 128
+#define MAX_QUEUED_FIRES 16
+#define TRIGGER_NAME_MAX 64
 static Trigger g_triggers[MAX_TRIGGERS];
 static int g_count = 0;
 
+// Manual fires from other threads, drained by triggers_update
+static SDL_Mutex* g_fire_mtx = NULL;
+static char g_fire_queue[MAX_QUEUED_FIRES][TRIGGER_NAME_MAX];
+static int g_fire_count = 0;
+
 static inline int aabb_overlap(Aabb a, Aabb b) {
     float ax0 = a.x - a.w * 0.5f, ay0 = a.y - a.h * 0.5f, ax1 = a.x + a.w * 0.5f,
           ay1 = a.y + a.h * 0.5f;
@@ -17,6 +24,9 @@ static inline int aabb_overlap(Aabb a, Aabb b) {
 void triggers_init(void) {
     g_count = 0;
     memset(g_triggers, 0, sizeof(g_triggers));
+    if (!g_fire_mtx)
+        g_fire_mtx = SDL_CreateMutex();
+    g_fire_count = 0;
 }
 void triggers_clear(void) {
     g_count = 0;
@@ -34,6 +44,22 @@ void triggers_add(const char* name, Aabb box, int once, TriggerCallback cb, void
     g_count++;
 }
 
+static void fire_now(const char* name) {
+    for (int i = 0; i < g_count; i++) {
+        if (g_triggers[i].name && SDL_strcmp(g_triggers[i].name, name) == 0) {
+            if (g_triggers[i].once && g_triggers[i].fired)
+                return;
+            if (g_triggers[i].cb) {
+                g_triggers[i].cb(g_triggers[i].name, g_triggers[i].user);
+            }
+            if (g_triggers[i].once) {
+                g_triggers[i].fired = 1;
+            }
+            return;
+        }
+    }
+}
+
 void triggers_update(float player_x,
                      float player_y,
                      float player_w,
@@ -42,11 +68,25 @@ void triggers_update(float player_x,
                      float car_y,
                      float car_w,
                      float car_h) {
+    char fires[MAX_QUEUED_FIRES][TRIGGER_NAME_MAX];
+    int fire_count = 0;
+    if (g_fire_mtx) {
+        SDL_LockMutex(g_fire_mtx);
+        fire_count = g_fire_count;
+        memcpy(fires, g_fire_queue, sizeof(fires[0]) * (size_t)fire_count);
+        g_fire_count = 0;
+        SDL_UnlockMutex(g_fire_mtx);
+    }
+    for (int f = 0; f < fire_count; f++) {
+        fire_now(fires[f]);
+    }
     Aabb pa = {player_x, player_y, player_w, player_h};
     Aabb ca = {car_x, car_y, car_w, car_h};
     for (int i = 0; i < g_count; i++) {
         if (g_triggers[i].once && g_triggers[i].fired)
             continue;
+        if (g_triggers[i].box.w <= 0.0f || g_triggers[i].box.h <= 0.0f)
+            continue;
         int hit = aabb_overlap(g_triggers[i].box, pa) || aabb_overlap(g_triggers[i].box, ca);
         if (hit) {
             if (g_triggers[i].cb) {
@@ -60,19 +100,12 @@ void triggers_update(float player_x,
 }
 
 void triggers_fire(const char* name) {
-    if (!name)
+    if (!name || !g_fire_mtx)
         return;
-    for (int i = 0; i < g_count; i++) {
-        if (g_triggers[i].name && SDL_strcmp(g_triggers[i].name, name) == 0) {
-            if (g_triggers[i].once && g_triggers[i].fired)
-                return;
-            if (g_triggers[i].cb) {
-                g_triggers[i].cb(g_triggers[i].name, g_triggers[i].user);
-            }
-            if (g_triggers[i].once) {
-                g_triggers[i].fired = 1;
-            }
-            return;
-        }
-    }
+    SDL_LockMutex(g_fire_mtx);
+    if (g_fire_count < MAX_QUEUED_FIRES)
+        SDL_strlcpy(g_fire_queue[g_fire_count++], name, TRIGGER_NAME_MAX);
+    else
+        SDL_Log("trigger '%s' dropped: fire queue full", name);
+    SDL_UnlockMutex(g_fire_mtx);
 }
@@ -8,7 +8,8 @@ typedef struct { float x,y,w,h; } Aabb;
 
 typedef void (*TriggerCallback)(const char* name, void* user);
 
-// Fire a trigger by name manually (e.g., from dialogue trigger callback)
+// Fire a trigger by name manually (e.g., from dialogue trigger callback). Any thread: the trigger
+// is queued and fires from the next triggers_update, on the sim tick.
 void triggers_fire(const char* name);
 
 typedef struct Trigger {
@@ -26,7 +27,8 @@ void triggers_clear(void);
 // Add a box trigger with callback
 void triggers_add(const char* name, Aabb box, int once, TriggerCallback cb, void* user);
 
-// Update with world-space positions (Y-up) and simple extents for player/car
+// Sim thread, once per tick: fire queued triggers, then test the player and car boxes (world
+// space, Y-up). Callbacks run here. Zero-size boxes are manual only.
 void triggers_update(float player_x, float player_y, float player_w, float player_h,
                      float car_x, float car_y, float car_w, float car_h);
 
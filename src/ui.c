@@ -50,16 +50,7 @@ static GLuint make_text_texture(const char* text, int wrap_w_pixels, int* out_w,
         }
     }
 
-    GLuint tex = 0;
-    glGenTextures(1, &tex);
-    glBindTexture(GL_TEXTURE_2D, tex);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
-    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, conv->w, conv->h, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                 conv->pixels);
+    GLuint tex = pipeline_texture_create(conv->w, conv->h, conv->pixels, false);
 
     if (out_w)
         *out_w = conv->w;
@@ -187,11 +178,11 @@ void ui_shutdown(void) {
         g_font = NULL;
     }
     if (g_hud_texture) {
-        glDeleteTextures(1, &g_hud_texture);
+        pipeline_texture_destroy(g_hud_texture);
         g_hud_texture = 0;
     }
     if (g_dialogue_texture) {
-        glDeleteTextures(1, &g_dialogue_texture);
+        pipeline_texture_destroy(g_dialogue_texture);
         g_dialogue_texture = 0;
     }
     g_loaded_font_px = 0;
@@ -231,7 +222,7 @@ void ui_render_hud(const AmeCamera* cam,
     // Only recreate texture if text changed
     if (SDL_strcmp(hud, g_last_hud_text) != 0) {
         if (g_hud_texture) {
-            glDeleteTextures(1, &g_hud_texture);
+            pipeline_texture_destroy(g_hud_texture);
             g_hud_texture = 0;
         }
         g_hud_texture =
@@ -291,7 +282,7 @@ void ui_render_dialogue(const AmeCamera* cam,
     // Only recreate texture if text changed
     if (SDL_strcmp(buf, g_last_dialogue_text) != 0) {
         if (g_dialogue_texture) {
-            glDeleteTextures(1, &g_dialogue_texture);
+            pipeline_texture_destroy(g_dialogue_texture);
             g_dialogue_texture = 0;
         }
         g_dialogue_texture = make_text_texture(buf, wrap_w, &g_dialogue_tw, &g_dialogue_th);
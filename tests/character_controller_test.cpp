@@ -0,0 +1,78 @@
+// Character controller: a body dropped from just above the floor (inside the ground probe) must
+// fall like any other body and come to rest on the floor, standing still or walking.
+#include <SDL3/SDL.h>
+#include <cmath>
+#include "character_controller.h"
+#include "physics.h"
+
+#define TICK_DT 0.001f  // APP_FIXED_DT default
+#define FLOOR_TOP 5.0f
+#define BOX 16.0f       // about the human sprite
+#define DROP 1.5f       // inside the default ground probe (2.0)
+#define GRAVITY 100.0f  // physics_init
+#define MAX_TICKS 2000
+
+static int g_failures = 0;
+
+#define CHECK(cond, ...)                   \
+    do {                                   \
+        if (!(cond)) {                     \
+            SDL_Log("FAIL: " __VA_ARGS__); \
+            g_failures++;                  \
+        }                                  \
+    } while (0)
+
+// Ticks until the feet are within tolerance of the floor, or MAX_TICKS
+static int drop_and_land(float walk_vx, const char* what) {
+    physics_init();
+    physics_create_static_box(0.0f, 0.0f, 2000.0f, FLOOR_TOP * 2.0f, 0.4f);
+    b2Body* body = physics_create_dynamic_box(0.0f, FLOOR_TOP + BOX * 0.5f + DROP, BOX, BOX, 1.0f,
+                                              0.4f);
+    CharacterController cc;
+    CharacterControllerConfig cfg = character_controller_default_config(BOX, BOX);
+    character_controller_init(&cc, body, &cfg);
+    int landed = MAX_TICKS;
+    for (int t = 0; t < MAX_TICKS; t++) {
+        character_controller_update(&cc, TICK_DT);
+        character_controller_move(&cc, walk_vx, TICK_DT);
+        physics_step(TICK_DT);
+        float x, y;
+        physics_get_position(body, &x, &y);
+        if (y - BOX * 0.5f - FLOOR_TOP <= 0.05f) {
+            landed = t + 1;
+            break;
+        }
+    }
+    // A few more ticks on the floor: it must stay there and count as grounded
+    for (int t = 0; t < 50; t++) {
+        character_controller_update(&cc, TICK_DT);
+        character_controller_move(&cc, walk_vx, TICK_DT);
+        physics_step(TICK_DT);
+    }
+    float x, y, vx, vy;
+    physics_get_position(body, &x, &y);
+    physics_get_velocity(body, &vx, &vy);
+    float gap = y - BOX * 0.5f - FLOOR_TOP;
+    CHECK(cc.grounded, "%s: not grounded after landing", what);
+    CHECK(fabsf(gap) <= 0.05f, "%s: resting %.3f above the floor", what, (double)gap);
+    CHECK(fabsf(vy) <= 1.0f, "%s: vertical speed %.3f at rest", what, (double)vy);
+    CHECK(fabsf(vx - walk_vx) <= 1.0f, "%s: walking at %.3f, want %.3f", what, (double)vx,
+          (double)walk_vx);
+    physics_shutdown();
+    return landed;
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    // Free fall over DROP, plus slack for the contact slop
+    float fall_s = sqrtf(2.0f * DROP / GRAVITY);
+    int budget = (int)(fall_s * 1.5f / TICK_DT) + 10;
+    int still = drop_and_land(0.0f, "standing");
+    int walking = drop_and_land(30.0f, "walking");
+    SDL_Log("landing: free fall %d ticks, standing %d, walking %d", (int)(fall_s / TICK_DT), still,
+            walking);
+    CHECK(still <= budget, "standing: landed after %d ticks (budget %d)", still, budget);
+    CHECK(walking <= budget, "walking: landed after %d ticks (budget %d)", walking, budget);
+    return g_failures ? 1 : 0;
+}
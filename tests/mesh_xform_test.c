@@ -0,0 +1,126 @@
+// Mesh transform kernels: every backend this CPU has (SSE2/AVX2 or NEON), through both the AoS and
+// the SoA entry point, must reproduce the scalar path for counts that leave vector tails and for
+// unaligned buffers.
+#include <SDL3/SDL.h>
+#include <math.h>
+#include <stdbool.h>
+#include "mesh_xform.h"
+
+#define MAX_COUNT 1031
+#define TOL 1e-6f  // relative
+
+static int g_failures = 0;
+
+#define CHECK(cond, ...)                   \
+    do {                                   \
+        if (!(cond)) {                     \
+            SDL_Log("FAIL: " __VA_ARGS__); \
+            g_failures++;                  \
+        }                                  \
+    } while (0)
+
+// Around the 4- and 8-wide vector steps, plus a long run with an odd tail
+static const unsigned int kCounts[] = {0,  1,  2,  3,  4,  5,  7,  8,
+                                       9, 15, 16, 17, 31, 33, 67, MAX_COUNT};
+static const MeshXform kXforms[] = {
+    {12.5f, -3.0f, 40.0f, 1.5f, 0.75f, -2.0f, 0.01f},
+    {0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.0f},  // identity, no parallax falloff
+    {-500.0f, 250.0f, -8.0f, 0.1f, -3.0f, 0.5f, 2.0f},
+};
+
+// One extra float in front of every buffer: offset 1 makes the pointers unaligned
+static float g_aos[MAX_COUNT * 3 + 1], g_x[MAX_COUNT + 1], g_y[MAX_COUNT + 1], g_z[MAX_COUNT + 1];
+static float g_ref[4][MAX_COUNT], g_out[4][MAX_COUNT + 1];
+
+static bool close_enough(float a, float b) {
+    return fabsf(a - b) <= TOL * fmaxf(1.0f, fabsf(b));
+}
+
+static void fill_inputs(void) {
+    unsigned int seed = 12345u;
+    for (int i = 0; i < MAX_COUNT * 3 + 1; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        g_aos[i] = ((float)(seed >> 8) / 16777216.0f - 0.5f) * 4000.0f;
+    }
+    g_aos[3] = 0.0f;  // z = 0: parallax exactly 1
+}
+
+// The scalar path must match the documented formula
+static void check_scalar_formula(const float* pos, unsigned int count, const MeshXform* xf) {
+    for (unsigned int i = 0; i < count; i++) {
+        float z = pos[i * 3 + 2] * xf->sz + xf->tz;
+        float par = fminf(fmaxf(1.0f / (1.0f + fabsf(z) * xf->parallax_k), 0.0f), 1.0f);
+        CHECK(close_enough(g_ref[0][i], pos[i * 3] * xf->sx + xf->tx), "scalar x[%u]", i);
+        CHECK(close_enough(g_ref[1][i], pos[i * 3 + 1] * xf->sy + xf->ty), "scalar y[%u]", i);
+        CHECK(close_enough(g_ref[2][i], z), "scalar z[%u]", i);
+        CHECK(close_enough(g_ref[3][i], par), "scalar par[%u]", i);
+    }
+}
+
+static void compare(const char* backend,
+                    const char* entry,
+                    const float* const* out,
+                    unsigned int count,
+                    int xf,
+                    int offset) {
+    static const char* kChannel[4] = {"x", "y", "z", "par"};
+    for (int c = 0; c < 4; c++) {
+        for (unsigned int i = 0; i < count; i++) {
+            if (!close_enough(out[c][i], g_ref[c][i])) {
+                CHECK(false, "%s %s: %s[%u] = %g, scalar %g (count %u, xform %d, offset %d)",
+                      backend, entry, kChannel[c], i, (double)out[c][i], (double)g_ref[c][i],
+                      count, xf, offset);
+                return;  // one report per run
+            }
+        }
+    }
+}
+
+static void check_backend(const char* backend) {
+    for (int xf = 0; xf < (int)SDL_arraysize(kXforms); xf++) {
+        for (int k = 0; k < (int)SDL_arraysize(kCounts); k++) {
+            for (int offset = 0; offset < 2; offset++) {
+                unsigned int count = kCounts[k];
+                const float* pos = g_aos + offset;
+                for (unsigned int i = 0; i < count; i++) {
+                    g_x[offset + i] = pos[i * 3 + 0];
+                    g_y[offset + i] = pos[i * 3 + 1];
+                    g_z[offset + i] = pos[i * 3 + 2];
+                }
+                mesh_xform_select("scalar");
+                mesh_xform_aos(pos, count, &kXforms[xf], g_ref[0], g_ref[1], g_ref[2], g_ref[3]);
+                check_scalar_formula(pos, count, &kXforms[xf]);
+
+                mesh_xform_select(backend);
+                float* out[4] = {g_out[0] + offset, g_out[1] + offset, g_out[2] + offset,
+                                 g_out[3] + offset};
+                mesh_xform_aos(pos, count, &kXforms[xf], out[0], out[1], out[2], out[3]);
+                compare(backend, "aos", (const float* const*)out, count, xf, offset);
+                mesh_xform_soa(g_x + offset, g_y + offset, g_z + offset, count, &kXforms[xf],
+                               out[0], out[1], out[2], out[3]);
+                compare(backend, "soa", (const float* const*)out, count, xf, offset);
+            }
+        }
+    }
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    mesh_xform_init();
+    fill_inputs();
+    static const char* kBackends[] = {"scalar", "sse2", "avx2", "neon"};
+    int tested = 0;
+    for (int b = 0; b < (int)SDL_arraysize(kBackends); b++) {
+        if (!mesh_xform_select(kBackends[b])) {
+            SDL_Log("%s: not available here, skipped", kBackends[b]);
+            continue;
+        }
+        check_backend(kBackends[b]);
+        SDL_Log("%s: checked", kBackends[b]);
+        tested++;
+    }
+    CHECK(tested > 0 && mesh_xform_select("scalar"), "no scalar backend");
+    CHECK(!mesh_xform_select("bogus"), "selected a backend that does not exist");
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,75 @@
+// World snapshot: pool bodies parked through the command ring just before the first-tick save
+// must come back parked after every restore, and live bodies must come back where they were.
+#include <SDL3/SDL.h>
+#include <cmath>
+#include "physics.h"
+
+#define TICK_DT 0.001f
+#define POOL 8  // parked, like the grenade/rocket pools
+#define LIVE 4  // enabled crates
+#define RUNS 3  // restores in a row (restart after restart)
+
+static int g_failures = 0;
+
+#define CHECK(cond, ...)                   \
+    do {                                   \
+        if (!(cond)) {                     \
+            SDL_Log("FAIL: " __VA_ARGS__); \
+            g_failures++;                  \
+        }                                  \
+    } while (0)
+
+static int enabled_bodies(void) {
+    PhysicsDebugStats st;
+    physics_get_debug_stats(&st);
+    return st.enabled_bodies;
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    physics_init();
+    physics_create_static_box(0.0f, 0.0f, 2000.0f, 10.0f, 0.4f);
+    b2Body* pool[POOL];
+    b2Body* live[LIVE];
+    for (int i = 0; i < POOL; i++) {
+        pool[i] = physics_create_dynamic_box(0.0f, 0.0f, 4.0f, 4.0f, 1.0f, 0.4f);
+        physics_set_body_enabled(pool[i], false);  // queued, not yet applied
+    }
+    for (int i = 0; i < LIVE; i++) {
+        live[i] = physics_create_dynamic_box(40.0f * i, 50.0f, 8.0f, 8.0f, 1.0f, 0.4f);
+    }
+
+    // Save before the first step, with the disables still in the ring
+    size_t size = physics_snapshot_save(NULL, 0);
+    void* snap = SDL_malloc(size);
+    CHECK(physics_snapshot_save(snap, size) == size, "snapshot size changed between calls");
+    int saved = enabled_bodies();
+    CHECK(saved == LIVE, "%d enabled bodies at save, want %d", saved, LIVE);
+
+    for (int run = 0; run < RUNS; run++) {
+        // Play on: throw a pooled body, let the crates fall
+        physics_set_body_enabled(pool[run % POOL], true);
+        physics_set_velocity(pool[run % POOL], 30.0f, 60.0f);
+        for (int t = 0; t < 200; t++) {
+            physics_step(TICK_DT);
+        }
+        CHECK(enabled_bodies() == LIVE + 1, "run %d: %d enabled bodies before restore", run,
+              enabled_bodies());
+
+        CHECK(physics_snapshot_restore(snap, size), "run %d: restore rejected the snapshot", run);
+        CHECK(enabled_bodies() == saved, "run %d: %d enabled bodies after restore, %d saved", run,
+              enabled_bodies(), saved);
+        physics_step(TICK_DT);
+        CHECK(enabled_bodies() == saved, "run %d: %d enabled bodies a tick later, %d saved", run,
+              enabled_bodies(), saved);
+        float x, y;
+        physics_get_position(live[LIVE - 1], &x, &y);
+        CHECK(fabsf(y - 50.0f) <= 0.1f, "run %d: crate restored at y=%.3f, want ~50", run,
+              (double)y);
+    }
+
+    SDL_free(snap);
+    physics_shutdown();
+    return g_failures ? 1 : 0;
+}
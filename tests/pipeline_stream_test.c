@@ -0,0 +1,210 @@
+// Render pipeline: the persistent-mapped sprite ring must rotate through its regions, retire a
+// fence each time it reuses one, survive a mid-run reallocation and draw the same pixels as the
+// glBufferData fallback. Also logs per-frame timings for streaming on/off and the mesh cache.
+// Needs a GL 4.5 context; exits with 77 (ctest skip) when none can be created.
+#include <SDL3/SDL.h>
+#include <glad/gl.h>
+#include <stdlib.h>
+#include "ame/camera.h"
+#include "pipeline.h"
+
+#define WIN_W 256
+#define WIN_H 256
+#define RING 3            // PIPELINE_FRAMES_IN_FLIGHT
+#define GROW_QUADS 12000  // 72000 vertices, past the 64K initial region
+#define BENCH_FRAMES 200
+#define BENCH_QUADS 4000
+#define BENCH_GRID 96  // mesh grid cells per side (2 triangles each)
+#define SKIP 77
+
+static int g_failures = 0;
+static AmeCamera g_cam;
+
+#define CHECK(cond, ...)                   \
+    do {                                   \
+        if (!(cond)) {                     \
+            SDL_Log("FAIL: " __VA_ARGS__); \
+            g_failures++;                  \
+        }                                  \
+    } while (0)
+
+// Never black, so a missed draw cannot pass
+static void frame_color(int frame, float* r, float* g, float* b) {
+    int c = frame % 7 + 1;
+    *r = (float)(c & 1);
+    *g = (float)((c >> 1) & 1);
+    *b = (float)((c >> 2) & 1);
+}
+
+// One frame: `quads` small quads under a full-window quad in the frame's color
+static const PipelineStats* draw_frame(int frame, int quads) {
+    float r, g, b;
+    frame_color(frame, &r, &g, &b);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    pipeline_frame_begin(&g_cam, WIN_W, WIN_H);
+    for (int i = 0; i < quads; i++) {
+        pipeline_sprite_quad((float)(i % WIN_W), (float)((i / WIN_W) % WIN_H), 4.0f, 4.0f, 0,
+                             0.5f, 0.5f, 0.5f, 0.25f);
+    }
+    pipeline_sprite_quad(WIN_W * 0.5f, WIN_H * 0.5f, WIN_W, WIN_H, 0, r, g, b, 1.0f);
+    pipeline_frame_end();
+    return pipeline_get_stats();
+}
+
+static bool pixel_matches(int frame) {
+    float r, g, b;
+    frame_color(frame, &r, &g, &b);
+    unsigned char px[4];
+    glReadPixels(WIN_W / 2, WIN_H / 2, 1, 1, GL_RGBA, GL_UNSIGNED_BYTE, px);
+    return abs(px[0] - (int)(r * 255.0f)) <= 2 && abs(px[1] - (int)(g * 255.0f)) <= 2 &&
+           abs(px[2] - (int)(b * 255.0f)) <= 2;
+}
+
+// Region index and fence retirement across several laps of a freshly created ring
+static void check_ring(int frames, int quads, bool readback, const char* what) {
+    unsigned int waits = 0, stalls = 0;
+    for (int f = 0; f < frames; f++) {
+        const PipelineStats* st = draw_frame(f, quads);
+        waits += st->stream_fence_waits;
+        stalls += st->stream_stalls;
+        CHECK(st->stream_region == (unsigned int)(f % RING), "%s: frame %d wrote region %u",
+              what, f, st->stream_region);
+        unsigned int want_waits = f >= RING ? 1 : 0;
+        CHECK(st->stream_fence_waits == want_waits, "%s: frame %d retired %u fences, want %u",
+              what, f, st->stream_fence_waits, want_waits);
+        CHECK(st->stream_stalls <= st->stream_fence_waits, "%s: frame %d stalls %u > waits %u",
+              what, f, st->stream_stalls, st->stream_fence_waits);
+        if (readback)
+            CHECK(pixel_matches(f), "%s: frame %d drew the wrong color", what, f);
+    }
+    CHECK(pixel_matches(frames - 1), "%s: last frame drew the wrong color", what);
+    SDL_Log("%s: %d frames, %u fence waits, %u stalled", what, frames, waits, stalls);
+}
+
+// Mean pipeline_frame_end CPU time and mean frame time up to glFinish, in ms
+static void bench(const char* what, int quads, const AmeLocalMesh* mesh, bool invalidate) {
+    double cpu = 0.0;
+    Uint64 t0 = SDL_GetTicksNS();
+    for (int f = 0; f < BENCH_FRAMES; f++) {
+        pipeline_frame_begin(&g_cam, WIN_W, WIN_H);
+        for (int i = 0; i < quads; i++) {
+            pipeline_sprite_quad((float)(i % WIN_W), (float)((i / WIN_W) % WIN_H), 4.0f, 4.0f,
+                                 0, 1.0f, 1.0f, 1.0f, 0.25f);
+        }
+        if (mesh) {
+            if (invalidate)
+                pipeline_mesh_cache_invalidate();
+            pipeline_mesh_submit(mesh, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+                                 1.0f);
+        }
+        pipeline_frame_end();
+        cpu += pipeline_get_stats()->cpu_ms;
+    }
+    glFinish();
+    double frame = (double)(SDL_GetTicksNS() - t0) / 1.0e6 / BENCH_FRAMES;
+    SDL_Log("bench %-30s cpu %.3f ms/frame, frame %.3f ms", what, cpu / BENCH_FRAMES, frame);
+}
+
+// Flat grid of BENCH_GRID^2 quads as a triangle list covering the window
+static AmeLocalMesh make_grid(void) {
+    AmeLocalMesh mesh = {0};
+    mesh.count = BENCH_GRID * BENCH_GRID * 6;
+    mesh.pos = (float*)malloc(mesh.count * 3 * sizeof(float));
+    float cell = (float)WIN_W / BENCH_GRID;
+    float* p = mesh.pos;
+    for (int y = 0; y < BENCH_GRID; y++) {
+        for (int x = 0; x < BENCH_GRID; x++) {
+            float x0 = x * cell, y0 = y * cell, x1 = x0 + cell, y1 = y0 + cell;
+            float z = (float)((x + y) % 8);
+            float tri[18] = {x0, y0, z, x1, y0, z, x1, y1, z, x0, y0, z, x1, y1, z, x0, y1, z};
+            SDL_memcpy(p, tri, sizeof(tri));
+            p += 18;
+        }
+    }
+    return mesh;
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        SDL_Log("skip: no video: %s", SDL_GetError());
+        return SKIP;
+    }
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+    SDL_GL_SetAttribute(SDL_GL_DOUBLEBUFFER, 1);
+    SDL_GL_SetAttribute(SDL_GL_DEPTH_SIZE, 0);
+    SDL_Window* window = SDL_CreateWindow("pipeline_stream_test", WIN_W, WIN_H,
+                                          SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    SDL_GLContext gl = window ? SDL_GL_CreateContext(window) : NULL;
+    if (!gl || !gladLoadGL((GLADloadfunc)SDL_GL_GetProcAddress)) {
+        SDL_Log("skip: no GL 4.5 context: %s", SDL_GetError());
+        SDL_Quit();
+        return SKIP;
+    }
+    SDL_Log("GL: %s | %s", (const char*)glGetString(GL_RENDERER),
+            (const char*)glGetString(GL_VERSION));
+    glDisable(GL_CULL_FACE);
+    glDisable(GL_DEPTH_TEST);
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glViewport(0, 0, WIN_W, WIN_H);
+    ame_camera_init(&g_cam);
+    g_cam.x = 0.0f;
+    g_cam.y = 0.0f;
+    g_cam.zoom = 1.0f;
+    g_cam.rotation = 0.0f;
+    ame_camera_set_viewport(&g_cam, WIN_W, WIN_H);
+
+    CHECK(pipeline_init(), "pipeline_init");
+    pipeline_set_streaming(true);  // whatever GAME_RENDER_STREAMING says
+
+    // Several laps reading back every frame, then laps that leave the GPU queue full
+    check_ring(4 * RING + 1, 64, true, "readback");
+    pipeline_set_streaming(false);
+    pipeline_set_streaming(true);
+    check_ring(20 * RING, 2000, false, "queued");
+
+    // Outgrowing the region reallocates: every pending fence is retired, the ring restarts
+    const PipelineStats* st = draw_frame(0, GROW_QUADS);
+    CHECK(st->sprite_vertices > 64 * 1024, "grow frame only had %u vertices", st->sprite_vertices);
+    CHECK(st->stream_region == 0, "grow frame wrote region %u", st->stream_region);
+    CHECK(st->stream_fence_waits == RING, "grow frame retired %u fences", st->stream_fence_waits);
+    CHECK(pixel_matches(0), "grow frame drew the wrong color");
+    for (int f = 1; f <= 2 * RING; f++) {
+        st = draw_frame(f, GROW_QUADS);
+        CHECK(st->stream_region == (unsigned int)(f % RING), "after grow: frame %d region %u", f,
+              st->stream_region);
+        CHECK(st->stream_fence_waits == (f >= RING ? 1u : 0u), "after grow: frame %d waits %u", f,
+              st->stream_fence_waits);
+    }
+    CHECK(pixel_matches(2 * RING), "after grow: wrong color");
+
+    // The fallback path draws the same pixels and touches no fences
+    pipeline_set_streaming(false);
+    for (int f = 0; f < 2 * RING; f++) {
+        st = draw_frame(f, 2000);
+        CHECK(st->stream_fence_waits == 0, "fallback: frame %d retired fences", f);
+        CHECK(pixel_matches(f), "fallback: frame %d drew the wrong color", f);
+    }
+
+    AmeLocalMesh grid = make_grid();
+    pipeline_set_streaming(false);
+    bench("sprites, glBufferData", BENCH_QUADS, NULL, false);
+    pipeline_set_streaming(true);
+    bench("sprites, streaming", BENCH_QUADS, NULL, false);
+    bench("mesh, invalidated every frame", 0, &grid, true);
+    bench("mesh, cached", 0, &grid, false);
+    free(grid.pos);
+
+    pipeline_shutdown();
+    SDL_GL_DestroyContext(gl);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    if (g_failures)
+        SDL_Log("%d check(s) failed", g_failures);
+    return g_failures ? 1 : 0;
+}
@@ -0,0 +1,367 @@
+// Vulkan pipeline backend: frame slots must rotate and retire one fence per frame once the ring
+// wraps, and the offscreen image must hold the pixels the GL backend draws for the same sprites,
+// instances, mesh pass and lightmap. Also logs the per-frame CPU cost of both backends on the
+// same scenes. Runs without a window (Vulkan renders into an offscreen image); exits with 77
+// (ctest skip) when there is no Vulkan device. The GL half needs a GL 4.5 context and is
+// skipped without one.
+#include <SDL3/SDL.h>
+#include <glad/gl.h>
+#include <stdlib.h>
+#include "ame/camera.h"
+#include "lighting.h"
+#include "pipeline.h"
+
+#define WIN_W 256
+#define WIN_H 256
+#define RING 3  // PIPELINE_FRAMES_IN_FLIGHT
+#define TOL 8   // per channel: different rasterizers and filters
+#define WARMUP_FRAMES 10
+#define BENCH_FRAMES 200
+#define BENCH_QUADS 4000
+#define BENCH_TEXTURES 256
+#define BENCH_GRID 96  // mesh grid cells per side (2 triangles each)
+#define BENCH_INSTANCES 2000
+#define SKIP 77
+
+static int g_failures = 0;
+static AmeCamera g_cam;
+
+#define CHECK(cond, ...)                   \
+    do {                                   \
+        if (!(cond)) {                     \
+            SDL_Log("FAIL: " __VA_ARGS__); \
+            g_failures++;                  \
+        }                                  \
+    } while (0)
+
+enum { SCENE_SPRITES, SCENE_TEXTURES, SCENE_MESH, SCENE_FULL, SCENE_COUNT };
+static const char* kSceneNames[SCENE_COUNT] = {
+    "4000 quads, 1 texture",
+    "4000 quads, 256 textures",
+    "mesh grid, cached",
+    "2 views, full frame",
+};
+
+// Pixels read back from the reference scenes
+static const int kProbes[][2] = {
+    {8, 128},    // sky left of the mesh
+    {80, 80},    // mesh quadrants (texture orientation through the mesh pass)
+    {176, 80},   //
+    {80, 176},   //
+    {176, 176},  //
+    {120, 120},  // sprite texels (orientation of sprite textures)
+    {136, 136},  //
+    {40, 244},   // instance
+    {216, 244},  // lit scene: light center
+};
+#define PROBES ((int)SDL_arraysize(kProbes))
+
+typedef struct {
+    unsigned int checker;  // 2x2 texels: red, green / blue, yellow (first row at v=0)
+    unsigned int many[BENCH_TEXTURES];
+    AmeLocalMesh grid;
+    PipelineInstance instances[BENCH_INSTANCES];
+} Assets;
+
+static Assets g_assets;
+
+static void create_assets(void) {
+    static const unsigned char kChecker[16] = {
+        255, 0, 0, 255, 0, 255, 0, 255,    // red, green
+        0, 0, 255, 255, 255, 255, 0, 255,  // blue, yellow
+    };
+    g_assets.checker = pipeline_texture_create(2, 2, kChecker, false);
+    for (int i = 0; i < BENCH_TEXTURES; i++) {
+        unsigned char px[4] = {(unsigned char)i, (unsigned char)(255 - i), 128, 255};
+        g_assets.many[i] = pipeline_texture_create(1, 1, px, false);
+    }
+    // Grid over (32..224)^2, uv spanning the checker once
+    AmeLocalMesh* m = &g_assets.grid;
+    m->count = BENCH_GRID * BENCH_GRID * 6;
+    m->pos = (float*)malloc(m->count * 3 * sizeof(float));
+    m->uv = (float*)malloc(m->count * 2 * sizeof(float));
+    m->texture = g_assets.checker;
+    float cell = 192.0f / BENCH_GRID;
+    float* p = m->pos;
+    float* t = m->uv;
+    for (int y = 0; y < BENCH_GRID; y++) {
+        for (int x = 0; x < BENCH_GRID; x++) {
+            float x0 = 32.0f + x * cell, y0 = 32.0f + y * cell, x1 = x0 + cell, y1 = y0 + cell;
+            float u0 = (float)x / BENCH_GRID, v0 = (float)y / BENCH_GRID;
+            float u1 = (float)(x + 1) / BENCH_GRID, v1 = (float)(y + 1) / BENCH_GRID;
+            float tri[18] = {x0, y0, 0, x1, y0, 0, x1, y1, 0, x0, y0, 0, x1, y1, 0, x0, y1, 0};
+            float uv[12] = {u0, v0, u1, v0, u1, v1, u0, v0, u1, v1, u0, v1};
+            SDL_memcpy(p, tri, sizeof(tri));
+            SDL_memcpy(t, uv, sizeof(uv));
+            p += 18;
+            t += 12;
+        }
+    }
+    for (int i = 0; i < BENCH_INSTANCES; i++) {
+        g_assets.instances[i] = (PipelineInstance){(float)(i * 7 % WIN_W),
+                                                   (float)(i * 13 % WIN_H), 3.0f, 0x80ffffffu};
+    }
+}
+
+static void destroy_assets(void) {
+    pipeline_texture_destroy(g_assets.checker);
+    for (int i = 0; i < BENCH_TEXTURES; i++) {
+        pipeline_texture_destroy(g_assets.many[i]);
+    }
+    free(g_assets.grid.pos);
+    free(g_assets.grid.uv);
+    SDL_memset(&g_assets, 0, sizeof(g_assets));
+}
+
+static void submit_mesh(void) {
+    pipeline_mesh_submit(&g_assets.grid, 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f,
+                         1.0f);
+}
+
+// The reference scene: mesh, a checker sprite over it and one instance, snow off
+static void draw_reference(void) {
+    static const PipelineInstance kInstance = {40.0f, 244.0f, 10.0f, 0xff00ffffu};
+    pipeline_views_begin(WIN_W, WIN_H);
+    pipeline_clear(0.0f, 0.0f, 0.0f);
+    submit_mesh();
+    pipeline_sprite_quad(128.0f, 128.0f, 32.0f, 32.0f, g_assets.checker, 1.0f, 1.0f, 1.0f, 1.0f);
+    pipeline_sprite_instances(&kInstance, 1, 0);
+    PipelineView view = {&g_cam, 0, 0, WIN_W, WIN_H};
+    pipeline_views_end(&view, 1);
+}
+
+static void read_probes(unsigned char out[][4]) {
+    pipeline_wait_idle();
+    for (int i = 0; i < PROBES; i++) {
+        if (!pipeline_read_pixel(kProbes[i][0], kProbes[i][1], out[i]))
+            SDL_memset(out[i], 0, 4);
+    }
+}
+
+// Reference pixels: unlit, then under a dim ambient with one light
+static void render_reference(unsigned char unlit[][4], unsigned char lit[][4]) {
+    pipeline_set_snow(0.0f, 0.0f, 0.0f);
+    lighting_set_ambient(1.0f, 1.0f, 1.0f);
+    draw_reference();
+    read_probes(unlit);
+    lighting_set_ambient(0.25f, 0.25f, 0.25f);
+    int light = lighting_add_point(216.0f, 244.0f, 48.0f, 1.0f, 1.0f, 1.0f, 1.0f);
+    draw_reference();
+    read_probes(lit);
+    lighting_remove(light);
+    lighting_set_ambient(1.0f, 1.0f, 1.0f);
+}
+
+static bool near(const unsigned char* a, const unsigned char* b) {
+    for (int c = 0; c < 3; c++) {
+        if (abs((int)a[c] - (int)b[c]) > TOL)
+            return false;
+    }
+    return true;
+}
+
+static void submit_scene(int scene, int frame) {
+    switch (scene) {
+        case SCENE_SPRITES:
+        case SCENE_TEXTURES:
+            for (int i = 0; i < BENCH_QUADS; i++) {
+                unsigned int tex = scene == SCENE_SPRITES
+                                       ? g_assets.checker
+                                       : g_assets.many[(i + frame) % BENCH_TEXTURES];
+                pipeline_sprite_quad((float)(i % WIN_W), (float)((i / WIN_W) % WIN_H), 4.0f,
+                                     4.0f, tex, 1.0f, 1.0f, 1.0f, 0.25f);
+            }
+            break;
+        case SCENE_MESH:
+            submit_mesh();
+            break;
+        default:
+            submit_mesh();
+            for (int i = 0; i < BENCH_QUADS / 2; i++) {
+                pipeline_sprite_quad((float)(i % WIN_W), (float)((i / WIN_W) % WIN_H), 4.0f,
+                                     4.0f, g_assets.many[i % 16], 1.0f, 1.0f, 1.0f, 0.5f);
+            }
+            pipeline_sprite_instances(g_assets.instances, BENCH_INSTANCES, 0);
+            break;
+    }
+}
+
+// Mean pipeline_views_end CPU time not spent waiting on the GPU, and mean frame time up to idle
+static void bench(const char* backend, int scene) {
+    static AmeCamera right;
+    right = g_cam;
+    right.x = WIN_W / 2;
+    PipelineView split[2] = {{&g_cam, 0, 0, WIN_W / 2, WIN_H},
+                             {&right, WIN_W / 2, 0, WIN_W / 2, WIN_H}};
+    PipelineView full = {&g_cam, 0, 0, WIN_W, WIN_H};
+    int light = scene == SCENE_FULL
+                    ? lighting_add_point(64.0f, 128.0f, 80.0f, 1.0f, 0.8f, 0.6f, 1.0f)
+                    : -1;
+    lighting_set_ambient(scene == SCENE_FULL ? 0.5f : 1.0f, scene == SCENE_FULL ? 0.5f : 1.0f,
+                         scene == SCENE_FULL ? 0.5f : 1.0f);
+    double cpu = 0.0, wait = 0.0;
+    Uint64 t0 = 0;
+    for (int f = 0; f < WARMUP_FRAMES + BENCH_FRAMES; f++) {
+        if (f == WARMUP_FRAMES) {
+            pipeline_wait_idle();
+            t0 = SDL_GetTicksNS();
+        }
+        pipeline_views_begin(WIN_W, WIN_H);
+        pipeline_clear(0.0f, 0.0f, 0.0f);
+        submit_scene(scene, f);
+        pipeline_views_end(scene == SCENE_FULL ? split : &full, scene == SCENE_FULL ? 2 : 1);
+        if (f >= WARMUP_FRAMES) {
+            cpu += pipeline_get_stats()->cpu_ms;
+            wait += pipeline_get_stats()->wait_ms;
+        }
+    }
+    pipeline_wait_idle();
+    double frame = (double)(SDL_GetTicksNS() - t0) / 1.0e6 / BENCH_FRAMES;
+    SDL_Log("bench %-26s %-6s cpu %.3f ms/frame (+%.3f waiting), frame %.3f ms",
+            kSceneNames[scene], backend, (cpu - wait) / BENCH_FRAMES, wait / BENCH_FRAMES, frame);
+    if (light >= 0)
+        lighting_remove(light);
+    lighting_set_ambient(1.0f, 1.0f, 1.0f);
+}
+
+// Slot index, fence retirement and the drawn color over several laps of the frame ring
+static void check_slots(void) {
+    unsigned int stalls = 0;
+    for (int f = 0; f < 4 * RING + 1; f++) {
+        float c = (float)(f % 4 + 1) / 4.0f;
+        pipeline_views_begin(WIN_W, WIN_H);
+        pipeline_clear(0.0f, 0.0f, 0.0f);
+        pipeline_sprite_quad(WIN_W * 0.5f, WIN_H * 0.5f, WIN_W, WIN_H, 0, c, 1.0f - c, 0.5f,
+                             1.0f);
+        PipelineView view = {&g_cam, 0, 0, WIN_W, WIN_H};
+        pipeline_views_end(&view, 1);
+        const PipelineStats* st = pipeline_get_stats();
+        stalls += st->stream_stalls;
+        CHECK(st->stream_region == (unsigned int)(f % RING), "frame %d used slot %u", f,
+              st->stream_region);
+        CHECK(st->stream_fence_waits == (f >= RING ? 1u : 0u), "frame %d retired %u fences", f,
+              st->stream_fence_waits);
+        CHECK(st->draw_calls >= 1 && st->views == 1, "frame %d: %u draws, %u views", f,
+              st->draw_calls, st->views);
+        if (f % 4 == 3) {
+            unsigned char px[4] = {0};
+            CHECK(pipeline_read_pixel(WIN_W / 2, WIN_H / 2, px), "frame %d: no read-back", f);
+            unsigned char want[4] = {(unsigned char)(c * 255.0f),
+                                     (unsigned char)((1.0f - c) * 255.0f), 128, 255};
+            CHECK(near(px, want), "frame %d drew %u,%u,%u, want %u,%u,%u", f, px[0], px[1], px[2],
+                  want[0], want[1], want[2]);
+        }
+    }
+    SDL_Log("slots: %d frames, %u stalled", 4 * RING + 1, stalls);
+}
+
+// Expected colors of the reference scene, whatever the backend
+static void check_reference(const char* backend,
+                            unsigned char unlit[][4],
+                            unsigned char lit[][4]) {
+    static const unsigned char kWant[][4] = {
+        {51, 77, 128, 255}, {0, 0, 255, 255}, {255, 255, 0, 255}, {255, 0, 0, 255},
+        {0, 255, 0, 255},   {0, 0, 255, 255}, {0, 255, 0, 255},   {255, 255, 0, 255},
+    };
+    for (int i = 0; i < (int)SDL_arraysize(kWant); i++) {
+        CHECK(near(unlit[i], kWant[i]), "%s: pixel (%d,%d) is %u,%u,%u, want %u,%u,%u", backend,
+              kProbes[i][0], kProbes[i][1], unlit[i][0], unlit[i][1], unlit[i][2], kWant[i][0],
+              kWant[i][1], kWant[i][2]);
+    }
+    // Ambient darkens the sky; the light center is lit back up
+    CHECK(lit[0][2] < unlit[0][2] / 2 && lit[0][2] > 0, "%s: ambient left the sky at %u",
+          backend, lit[0][2]);
+    CHECK(lit[8][2] > lit[0][2] + 64, "%s: light center %u not above ambient %u", backend,
+          lit[8][2], lit[0][2]);
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    if (!SDL_Init(SDL_INIT_VIDEO)) {
+        SDL_Log("skip: no video: %s", SDL_GetError());
+        return SKIP;
+    }
+    ame_camera_init(&g_cam);
+    g_cam.zoom = 1.0f;
+    ame_camera_set_viewport(&g_cam, WIN_W, WIN_H);
+    lighting_init();
+
+    // GL half: reference pixels and timings, when there is a context
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 4);
+    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 5);
+    SDL_Window* window = SDL_CreateWindow("pipeline_vk_test", WIN_W, WIN_H,
+                                          SDL_WINDOW_OPENGL | SDL_WINDOW_HIDDEN);
+    SDL_GLContext gl = window ? SDL_GL_CreateContext(window) : NULL;
+    bool have_gl = gl && gladLoadGL((GLADloadfunc)SDL_GL_GetProcAddress);
+    unsigned char gl_unlit[PROBES][4], gl_lit[PROBES][4];
+    if (have_gl && pipeline_init()) {
+        glViewport(0, 0, WIN_W, WIN_H);
+        create_assets();
+        render_reference(gl_unlit, gl_lit);
+        check_reference("GL", gl_unlit, gl_lit);
+        for (int s = 0; s < SCENE_COUNT; s++) {
+            bench("GL", s);
+        }
+        destroy_assets();
+        pipeline_shutdown();
+    } else {
+        have_gl = false;
+        SDL_Log("GL: no 4.5 context, comparing against the expected colors only");
+    }
+    if (gl)
+        SDL_GL_DestroyContext(gl);
+    if (window)
+        SDL_DestroyWindow(window);
+
+    if (!pipeline_init_backend(PIPELINE_BACKEND_VULKAN, NULL)) {
+        SDL_Log("skip: no Vulkan device");
+        lighting_shutdown();
+        SDL_Quit();
+        return g_failures ? 1 : SKIP;
+    }
+    CHECK(pipeline_get_backend() == PIPELINE_BACKEND_VULKAN, "backend not Vulkan");
+    create_assets();
+    check_slots();
+
+    unsigned char vk_unlit[PROBES][4], vk_lit[PROBES][4];
+    render_reference(vk_unlit, vk_lit);
+    check_reference("Vulkan", vk_unlit, vk_lit);
+    for (int i = 0; have_gl && i < PROBES; i++) {
+        CHECK(near(vk_unlit[i], gl_unlit[i]) && near(vk_lit[i], gl_lit[i]),
+              "pixel (%d,%d): Vulkan %u,%u,%u / lit %u,%u,%u, GL %u,%u,%u / lit %u,%u,%u",
+              kProbes[i][0], kProbes[i][1], vk_unlit[i][0], vk_unlit[i][1], vk_unlit[i][2],
+              vk_lit[i][0], vk_lit[i][1], vk_lit[i][2], gl_unlit[i][0], gl_unlit[i][1],
+              gl_unlit[i][2], gl_lit[i][0], gl_lit[i][1], gl_lit[i][2]);
+    }
+
+    // The mesh pass follows a texture swap, and a texture destroyed while frames that sample it
+    // are in flight stays alive until they retire
+    unsigned char red[4] = {255, 0, 0, 255};
+    unsigned int tex = pipeline_texture_create(1, 1, red, false);
+    g_assets.grid.texture = tex;
+    pipeline_mesh_cache_invalidate();
+    draw_reference();
+    unsigned char px[4] = {0};
+    CHECK(pipeline_read_pixel(80, 80, px) && near(px, red),
+          "mesh pass over a new texture drew %u,%u,%u", px[0], px[1], px[2]);
+    draw_reference();
+    pipeline_texture_destroy(tex);
+    g_assets.grid.texture = g_assets.checker;
+    pipeline_mesh_cache_invalidate();
+    draw_reference();
+    CHECK(pipeline_read_pixel(80, 80, px) && near(px, vk_unlit[1]),
+          "mesh pass after a texture swap drew %u,%u,%u", px[0], px[1], px[2]);
+
+    for (int s = 0; s < SCENE_COUNT; s++) {
+        bench("Vulkan", s);
+    }
+    destroy_assets();
+    pipeline_shutdown();
+    lighting_shutdown();
+    SDL_Quit();
+    if (g_failures)
+        SDL_Log("%d check(s) failed", g_failures);
+    return g_failures ? 1 : 0;
+}
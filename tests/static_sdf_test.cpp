@@ -0,0 +1,93 @@
+// Static distance field: a chunk swapped in over and over stays one stale area (nothing latches
+// the whole field stale), and re-baking its tiles gives the field a full bake would give.
+#include <SDL3/SDL.h>
+#include <cmath>
+#include <vector>
+#include "physics.h"
+#include "static_sdf.h"
+
+#define CELL 1.0f
+#define MARGIN 16.0f
+#define SWAPS 300  // more than the old 256-rect dirty list held
+#define TOL 1e-4f
+
+static int g_failures = 0;
+
+#define CHECK(cond, ...)                   \
+    do {                                   \
+        if (!(cond)) {                     \
+            SDL_Log("FAIL: " __VA_ARGS__); \
+            g_failures++;                  \
+        }                                  \
+    } while (0)
+
+// One convex quad (x0,y0)-(x1,y1), counter-clockwise
+static PhysicsShapeSet* quad(float x0, float y0, float x1, float y1) {
+    float xy[8] = {x0, y0, x1, y0, x1, y1, x0, y1};
+    int count = 4, flags = PHYS_FLAG_DESTRUCTIBLE;
+    return physics_shape_set_create(xy, &count, &flags, 1);
+}
+
+static b2Body* swap(b2Body* body, float top) {
+    PhysicsShapeSet* set = quad(100.0f, 0.0f, 140.0f, top);
+    body = physics_swap_static_body(body, set, 0.8f);
+    physics_shape_set_destroy(set);
+    return body;
+}
+
+// Distances on a half-cell lattice over the chunk and everything within MARGIN of it
+static std::vector<float> sample(void) {
+    std::vector<float> d;
+    for (float y = -MARGIN; y <= 40.0f + MARGIN; y += CELL * 0.5f) {
+        for (float x = 100.0f - MARGIN; x <= 140.0f + MARGIN; x += CELL * 0.5f) {
+            d.push_back(static_sdf_distance(x, y));
+        }
+    }
+    return d;
+}
+
+int main(int argc, char** argv) {
+    (void)argc;
+    (void)argv;
+    physics_init();
+    physics_create_static_box(0.0f, -10.0f, 400.0f, 4.0f, 0.8f);  // ground
+    // Far away, and taller than the chunk so both bakes cover the same grid
+    physics_create_static_box(300.0f, 30.0f, 20.0f, 40.0f, 0.8f);
+    b2Body* chunk = swap(NULL, 40.0f);
+    CHECK(static_sdf_bake(CELL, MARGIN), "bake failed");
+    CHECK(static_sdf_covers(90.0f, 10.0f, 150.0f, 10.0f), "fresh field does not cover the chunk");
+
+    // Carved again and again before the re-bake gets to it
+    for (int i = 0; i < SWAPS; i++) {
+        chunk = swap(chunk, 40.0f - 20.0f * (float)(i + 1) / SWAPS);
+        static_sdf_invalidate(100.0f, 0.0f, 140.0f, 40.0f);
+    }
+    CHECK(!static_sdf_covers(90.0f, 10.0f, 150.0f, 10.0f), "stale chunk still covered");
+    CHECK(static_sdf_covers(280.0f, 50.0f, 320.0f, 50.0f), "far rect stale after %d swaps", SWAPS);
+
+    CHECK(static_sdf_rebake(100.0f, 0.0f, 140.0f, 40.0f), "re-bake failed");
+    CHECK(static_sdf_covers(90.0f, 10.0f, 150.0f, 10.0f), "re-baked chunk not covered");
+    CHECK(static_sdf_covers(-200.0f, -20.0f, 400.0f, 60.0f), "field still stale somewhere");
+    StaticSdfHit h = static_sdf_raycast(120.0f, 35.0f, 120.0f, -5.0f);
+    CHECK(h.hit && fabsf(h.y - 20.0f) <= CELL, "ray down the crater hit at y=%.2f, want ~20",
+          (double)h.y);
+
+    // Same values as a full bake wherever the distance matters (re-baked cells stop at the margin,
+    // so a bilinear sample within two cells of it may come out lower), never more anywhere
+    std::vector<float> rebaked = sample();
+    CHECK(static_sdf_bake(CELL, MARGIN), "second bake failed");
+    std::vector<float> full = sample();
+    int off = 0, over = 0;
+    for (size_t i = 0; i < full.size(); i++) {
+        if (full[i] < MARGIN - 2.0f * CELL && fabsf(rebaked[i] - full[i]) > TOL)
+            off++;
+        if (rebaked[i] > full[i] + TOL)
+            over++;
+    }
+    CHECK(off == 0, "%d of %d samples differ from a full bake", off, (int)full.size());
+    CHECK(over == 0, "%d samples further than a full bake says", over);
+
+    static_sdf_shutdown();
+    physics_shutdown();
+    return g_failures ? 1 : 0;
+}